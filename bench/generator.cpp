@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "generator.hpp"
+
+namespace xlang {
+
+	static const char *locals[] = {"a", "b", "x", "y", "z"};
+	static const char *operators[] = {" + ", " - ", " * ", " / "};
+	static const char *comparisons[] = {" < ", " > ", " <= ", " >= ", " == ", " != "};
+
+	unsigned Generator::random(unsigned n) {
+		// xorshift32, only has to be cheap and repeatable
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return n == 0 ? 0 : state % n;
+	}
+
+	std::string Generator::operand() {
+		switch (random(3)) {
+			case 0:
+				if (cfg.globals > 0)
+					return "g" + std::to_string(random(cfg.globals));
+				break;
+			case 1:
+				return std::to_string(1 + random(1000));
+			default:
+				break;
+		}
+		return locals[random(5)];
+	}
+
+	std::string Generator::expression(unsigned depth, bool nested) {
+
+		// the parser can't take some groups inside groups, like "(5 - (a))",
+		// so parentheses are only one level deep. a divisor is never a group,
+		// the optimizer would stop at one that folds to 0
+
+		if (depth == 0)
+			return operand();
+		std::string left = expression(depth - 1, nested);
+		const char *op = operators[random(4)];
+		bool group = !nested && op[1] != '/' && random(2) == 0;
+		return left + op + (group ? "(" + expression(depth - 1, true) + ")" : operand());
+	}
+
+	std::string Generator::condition() {
+		return locals[random(5)] + std::string(comparisons[random(6)]) + operand();
+	}
+
+	void Generator::statement(std::ostream &out, unsigned func, unsigned &left, int indent) {
+		std::string pad(indent * 2, ' ');
+		if (left > 0)
+			left--;
+
+		// nested blocks take their statements from the same budget
+		// so the size of a function doesn't depend on the shape
+
+		unsigned kind = random(indent > 2 || left < 2 ? 5 : 8);
+		switch (kind) {
+			case 0:
+				if (func > 0) {
+					out << pad << locals[2 + random(3)] << " = f" << random(func) << "("
+						<< operand() << ", " << operand() << ");\n";
+					return;
+				}
+				break;
+			case 1:
+				if (cfg.strings > 0) {
+					out << pad << "printf(\"s" << random(cfg.strings) << " = %d\\n\", "
+						<< locals[random(5)] << ");\n";
+					return;
+				}
+				break;
+			case 2:
+				if (cfg.globals > 0) {
+					out << pad << "g" << random(cfg.globals) << " = " << expression(cfg.depth, false) << ";\n";
+					return;
+				}
+				break;
+			case 3:
+				// sizeof can't be part of a larger expression
+				if (cfg.records > 0) {
+					out << pad << locals[2 + random(3)] << " = sizeof(r" << random(cfg.records) << ");\n";
+					return;
+				}
+				break;
+			case 5: {
+				out << pad << "if(" << condition() << "){\n";
+				unsigned n = 1 + random(left / 2);
+				for (unsigned i = 0; i < n && left > 0; i++)
+					statement(out, func, left, indent + 1);
+				out << pad << "}else{\n";
+				statement(out, func, left, indent + 1);
+				out << pad << "}\n";
+				return;
+			}
+			case 6: {
+				const char *v = locals[2 + random(3)];
+				out << pad << "for(" << v << " = 0; " << v << " < " << 1 + random(100) << "; " << v << "++){\n";
+				unsigned n = 1 + random(left / 2);
+				for (unsigned i = 0; i < n && left > 0; i++)
+					statement(out, func, left, indent + 1);
+				out << pad << "}\n";
+				return;
+			}
+			case 7: {
+				out << pad << "while(" << condition() << "){\n";
+				unsigned n = random(left / 2);
+				for (unsigned i = 0; i < n && left > 0; i++)
+					statement(out, func, left, indent + 1);
+				out << pad << "  " << locals[random(5)] << "++;\n";
+				out << pad << "}\n";
+				return;
+			}
+			default:
+				break;
+		}
+		out << pad << locals[2 + random(3)] << " = " << expression(cfg.depth, false) << ";\n";
+	}
+
+	void Generator::function(std::ostream &out, unsigned func, unsigned &strings) {
+		out << "int f" << func << "(int a, int b)\n{\n";
+		out << "  int x, y, z;\n";
+		out << "  x = a;\n  y = b;\n  z = 0;\n";
+
+		// string literals are spread over the functions
+		// so all of them show up in the data section
+		unsigned per_function = cfg.functions > 0 ? (cfg.strings + cfg.functions - 1) / cfg.functions : 0;
+		for (unsigned i = 0; i < per_function && strings < cfg.strings; i++, strings++)
+			out << "  printf(\"string literal " << strings << " %d\\n\", x);\n";
+
+		unsigned left = cfg.statements;
+		while (left > 0)
+			statement(out, func, left, 1);
+		out << "  return x + y + z;\n}\n\n";
+	}
+
+	void Generator::write(std::ostream &out) {
+		state = cfg.seed == 0 ? 1 : cfg.seed;
+
+		out << "extern void printf(char*, int);\n\n";
+
+		for (unsigned i = 0; i < cfg.records; i++) {
+			out << "record r" << i << "{\n";
+			unsigned members = 1 + random(6);
+			for (unsigned m = 0; m < members; m++) {
+				switch (random(4)) {
+					case 0:
+						out << "  char c" << i << "_" << m << ";\n";
+						break;
+					case 1:
+						out << "  int v" << i << "_" << m << "[" << 1 + random(16) << "];\n";
+						break;
+					case 2:
+						out << "  double d" << i << "_" << m << ";\n";
+						break;
+					default:
+						out << "  int i" << i << "_" << m << ";\n";
+						break;
+				}
+			}
+			out << "}\n\n";
+		}
+
+		for (unsigned i = 0; i < cfg.globals; i++)
+			out << "int g" << i << ";\n";
+		out << "\n";
+
+		unsigned strings = 0;
+		for (unsigned f = 0; f < cfg.functions; f++)
+			function(out, f, strings);
+
+		out << "global void main()\n{\n  int r;\n  r = 0;\n";
+		for (unsigned f = cfg.functions > 8 ? cfg.functions - 8 : 0; f < cfg.functions; f++)
+			out << "  r = f" << f << "(" << f << ", r);\n";
+		for (; strings < cfg.strings; strings++)
+			out << "  printf(\"string literal " << strings << " %d\\n\", r);\n";
+		out << "  printf(\"%d\\n\", r);\n}\n";
+	}
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+namespace xlang {
+
+	struct GeneratorConfig {
+		unsigned functions{100};
+		unsigned statements{20};     // per function
+		unsigned depth{4};           // of every expression
+		unsigned globals{100};
+		unsigned records{10};
+		unsigned strings{100};
+		uint32_t seed{1};
+	};
+
+	// writes synthetic xlang programs for xlang_bench
+	//
+	// the same config always gives the same program. functions only call
+	// functions defined before them and every statement is something the
+	// compiler accepts, so the whole pipeline runs on it
+
+	class Generator {
+	public:
+		explicit Generator(const GeneratorConfig &c) : cfg(c), state(c.seed) {}
+
+		void write(std::ostream &);
+
+	private:
+		GeneratorConfig cfg;
+		uint32_t state;
+
+		unsigned random(unsigned);
+
+		std::string operand();
+
+		std::string expression(unsigned, bool);
+
+		std::string condition();
+
+		void statement(std::ostream &, unsigned, unsigned &, int);
+
+		void function(std::ostream &, unsigned, unsigned &);
+	};
+}
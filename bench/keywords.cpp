@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// xlang_keyword_bench: keyword lookup of identifiers
+//
+// every identifier and keyword of a generated program is looked up in an
+// unordered_map, the way the lexer used to, and with Lexer::keyword. then
+// the whole program is lexed to show what it means for lexing
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+#include "generator.hpp"
+#include "lex.hpp"
+
+using namespace xlang;
+
+using Clock = std::chrono::steady_clock;
+
+// the table Lexer had before keyword() replaced it
+static const std::unordered_map<std::string, TokenId> key_tokens = {
+		{"asm",      KEY_ASM},
+		{"break",    KEY_BREAK},
+		{"char",     KEY_CHAR},
+		{"const",    KEY_CONST},
+		{"continue", KEY_CONTINUE},
+		{"do",       KEY_DO},
+		{"double",   KEY_DOUBLE},
+		{"else",     KEY_ELSE},
+		{"extern",   KEY_EXTERN},
+		{"float",    KEY_FLOAT},
+		{"for",      KEY_FOR},
+		{"global",   KEY_GLOBAL},
+		{"goto",     KEY_GOTO},
+		{"if",       KEY_IF},
+		{"int",      KEY_INT},
+		{"long",     KEY_LONG},
+		{"record",   KEY_RECORD},
+		{"return",   KEY_RETURN},
+		{"short",    KEY_SHORT},
+		{"sizeof",   KEY_SIZEOF},
+		{"static",   KEY_STATIC},
+		{"void",     KEY_VOID},
+		{"while",    KEY_WHILE}};
+
+static void Help() {
+	std::vector<std::string> lines = {
+			"  usage: ./xlang_keyword_bench [options]",
+			"    --functions N (functions in the generated program, default 2000)",
+			"    --repeat N (best of N runs, default 5)",
+			"    -h  or --help (this message)"
+	};
+	for (const auto &l: lines)
+		std::cout << l << "\n";
+}
+
+static bool word_char(char c) {
+	return c == '_' || c == '$' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+// identifiers and keywords of the source, as the lexer would see them
+static std::vector<std::string> words(const std::string &source) {
+	std::vector<std::string> result;
+	for (size_t i = 0; i < source.size();) {
+		if (source[i] == '"') {
+			i = source.find('"', i + 1);
+			i = (i == std::string::npos ? source.size() : i + 1);
+		}
+		else if (word_char(source[i]) && !(source[i] >= '0' && source[i] <= '9')) {
+			size_t start = i;
+			while (i < source.size() && word_char(source[i]))
+				i++;
+			result.push_back(source.substr(start, i - start));
+		}
+		else
+			i++;
+	}
+	return result;
+}
+
+// best time of a number of runs of f, in ms
+template<typename F>
+static double best_of(unsigned repeat, F f) {
+	double best = 0;
+	for (unsigned r = 0; r < repeat; r++) {
+		auto start = Clock::now();
+		f();
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		if (r == 0 || ms < best)
+			best = ms;
+	}
+	return best;
+}
+
+int main(int argc, char **argv) {
+	GeneratorConfig gen;
+	gen.functions = 2000;
+	gen.globals = 2000;
+	unsigned repeat = 5;
+
+	for (int i = 1; i < argc; i++) {
+		std::string str = argv[i];
+		if (str == "--functions" && i + 1 < argc)
+			gen.functions = gen.globals = std::stoul(argv[++i]);
+		else if (str == "--repeat" && i + 1 < argc)
+			repeat = std::max(1ul, std::stoul(argv[++i]));
+		else {
+			Help();
+			return str == "-h" || str == "--help" ? 0 : -1;
+		}
+	}
+
+	std::ostringstream program;
+	Generator(gen).write(program);
+	std::string source = program.str();
+	std::vector<std::string> list = words(source);
+
+	size_t keywords = 0;
+	for (const auto &w: list)
+		keywords += key_tokens.count(w);
+
+	// the sums keep the lookups from being optimized away, both
+	// have to agree
+	unsigned long map_sum = 0, switch_sum = 0;
+	double map_ms = best_of(repeat, [&]() {
+		for (const auto &w: list) {
+			auto it = key_tokens.find(w);
+			map_sum += (it != key_tokens.end() ? it->second : IDENTIFIER);
+		}
+	});
+	double switch_ms = best_of(repeat, [&]() {
+		for (const auto &w: list)
+			switch_sum += Lexer::keyword(w);
+	});
+	if (map_sum != switch_sum) {
+		std::cerr << "lookups disagree\n";
+		return -1;
+	}
+
+	size_t tokens = 0;
+	double lex_ms = best_of(repeat, [&]() {
+		SourceFile file;
+		file.name = "generated.x";
+		file.buffer = SourceBuffer::copy(source);
+		Lexer lex(file);
+		lex.init();
+		tokens = 0;
+		while (lex.get_next().number != END)
+			tokens++;
+	});
+
+	double kb = source.size() / 1024.0;
+	std::cout << std::fixed << std::setprecision(2)
+			  << "program: " << kb << " kB, " << tokens << " tokens, " << list.size() << " words, "
+			  << keywords << " of them keywords\n"
+			  << "  " << std::left << std::setw(16) << "lookup" << std::right << std::setw(12) << "ms"
+			  << std::setw(12) << "ns/word" << "\n"
+			  << "  " << std::left << std::setw(16) << "unordered_map" << std::right << std::setw(12) << map_ms
+			  << std::setw(12) << map_ms * 1e6 / list.size() << "\n"
+			  << "  " << std::left << std::setw(16) << "Lexer::keyword" << std::right << std::setw(12) << switch_ms
+			  << std::setw(12) << switch_ms * 1e6 / list.size() << "  " << map_ms / switch_ms << "x faster\n"
+			  << "lexing (" << Scan::name() << "): " << lex_ms << " ms, " << kb / lex_ms << " kB/ms, keyword lookup was "
+			  << std::setprecision(1) << 100 * map_ms / (lex_ms + map_ms - switch_ms) << "% of it before\n";
+	return 0;
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// xlang_bench: compile time of every pass on generated programs
+//
+// the program is doubled in size a number of times and each pass is timed
+// at every size. growth is the exponent of time against source size, 1 is
+// linear, passes above 1.5 (about 2.8 times the time for twice the input)
+// are flagged. allocations are the count of operator new calls in a pass,
+// teardown is the time it takes to destroy the compiler afterwards
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <unistd.h>
+#include "generator.hpp"
+#include "compiler.hpp"
+
+using namespace xlang;
+
+struct BenchConfig {
+	GeneratorConfig gen;
+	unsigned steps{5};
+	unsigned repeat{3};
+	bool optimize{true};
+	bool stream{false};
+	std::string generate;
+};
+
+struct PassTime {
+	double ms{0};
+	uint64_t allocations{0};
+	bool seen{false};
+};
+
+static void Help() {
+	std::vector<std::string> lines = {
+			"  usage: ./xlang_bench [options]",
+			"    --functions N (functions in the smallest program, default 100)",
+			"    --statements N (statements per function, default 20)",
+			"    --depth N (depth of expressions, default 4)",
+			"    --globals N (global variables in the smallest program, default 100)",
+			"    --records N (records in the smallest program, default 10)",
+			"    --strings N (string literals in the smallest program, default 100)",
+			"    --steps N (times the program is doubled, default 5)",
+			"    --repeat N (best of N compilations per size, default 3)",
+			"    --no-optimize (don't run the optimizer)",
+			"    --stream (compile one function at a time, see xlang --stream)",
+			"    --seed N (seed of the generator)",
+			"    --generate FILE (write the smallest program to FILE and exit)",
+			"    -h  or --help (this message)"
+	};
+	for (const auto &l: lines)
+		std::cout << l << "\n";
+}
+
+static bool process_args(BenchConfig &cfg, int argc, char **argv) {
+	for (int i = 1; i < argc; i++) {
+		std::string str = argv[i];
+		auto value = [&]() -> unsigned {
+			return i + 1 < argc ? std::stoul(argv[++i]) : 0;
+		};
+		if (str == "--functions")
+			cfg.gen.functions = value();
+		else if (str == "--statements")
+			cfg.gen.statements = value();
+		else if (str == "--depth")
+			cfg.gen.depth = value();
+		else if (str == "--globals")
+			cfg.gen.globals = value();
+		else if (str == "--records")
+			cfg.gen.records = value();
+		else if (str == "--strings")
+			cfg.gen.strings = value();
+		else if (str == "--steps")
+			cfg.steps = std::max(1u, value());
+		else if (str == "--repeat")
+			cfg.repeat = std::max(1u, value());
+		else if (str == "--seed")
+			cfg.gen.seed = value();
+		else if (str == "--no-optimize")
+			cfg.optimize = false;
+		else if (str == "--stream")
+			cfg.stream = true;
+		else if (str == "--generate" && i + 1 < argc)
+			cfg.generate = argv[++i];
+		else {
+			Help();
+			return false;
+		}
+	}
+	return true;
+}
+
+// best time of every pass over a number of compilations of one file
+static std::map<std::string, PassTime> compile(const BenchConfig &cfg, const std::string &path, int &status) {
+	std::map<std::string, PassTime> best;
+	for (unsigned r = 0; r < cfg.repeat; r++) {
+		GlobalConfig global;
+		global.file.path = path;
+		global.file.name = std::filesystem::path(path).filename();
+		global.optimize = cfg.optimize;
+		global.stream = cfg.stream;
+		global.assemble = false;
+		global.link = false;
+		global.in_memory = true;
+		global.time_passes = true;
+
+		auto comp = std::make_unique<Compiler>(global);
+		std::ostringstream out;
+		status = comp->run(out);
+		if (status != 0) {
+			std::cerr << out.str();
+			return best;
+		}
+
+		std::vector<PassStats> passes = comp->stats.passes;
+		Usage start = Usage::now(false);
+		comp.reset();
+		PassStats teardown;
+		teardown.name = "teardown";
+		teardown.used = Usage::now(false) - start;
+		passes.push_back(teardown);
+
+		for (const auto &p: passes) {
+			PassTime &t = best[p.name];
+			if (!t.seen || p.used.wall_ms < t.ms)
+				t.ms = p.used.wall_ms;
+			t.allocations = p.used.allocations;
+			t.seen = true;
+		}
+	}
+	return best;
+}
+
+int main(int argc, char **argv) {
+	BenchConfig cfg;
+	if (!process_args(cfg, argc, argv))
+		return -1;
+
+	if (!cfg.generate.empty()) {
+		std::ofstream out(cfg.generate);
+		Generator(cfg.gen).write(out);
+		return out.good() ? 0 : -1;
+	}
+
+	std::string path = std::filesystem::temp_directory_path() / ("xlang_bench_" + std::to_string(getpid()) + ".x");
+	const char *order[] = {"lex", "parse", "analyze", "optimize", "codegen", "write_asm", "teardown"};
+
+	std::vector<std::map<std::string, PassTime>> results;
+	std::vector<double> sizes;
+	int status = 0;
+
+	std::cout << std::fixed;
+	for (unsigned step = 0; step < cfg.steps && status == 0; step++) {
+		GeneratorConfig gen = cfg.gen;
+		unsigned scale = 1u << step;
+		gen.functions *= scale;
+		gen.globals *= scale;
+		gen.records *= scale;
+		gen.strings *= scale;
+		{
+			std::ofstream out(path);
+			Generator(gen).write(out);
+		}
+		double kb = std::filesystem::file_size(path) / 1024.0;
+		sizes.push_back(kb);
+
+		std::cout << "size " << scale << "x: " << gen.functions << " functions, "
+				  << gen.functions * gen.statements << " statements, " << gen.globals << " globals, "
+				  << gen.records << " records, " << gen.strings << " strings, "
+				  << std::setprecision(1) << kb << " kB\n";
+
+		results.push_back(compile(cfg, path, status));
+		const auto &res = results.back();
+		std::cout << "  " << std::left << std::setw(14) << "pass" << std::right
+				  << std::setw(12) << "ms" << std::setw(12) << "allocs" << std::setw(12) << "kB/ms" << std::setw(12) << "growth" << "\n";
+		for (const char *name: order) {
+			auto it = res.find(name);
+			if (it == res.end())
+				continue;
+			double ms = it->second.ms;
+			std::cout << "  " << std::left << std::setw(14) << name << std::right << std::setprecision(3)
+					  << std::setw(12) << ms << std::setw(12) << it->second.allocations
+					  << std::setw(12) << (ms > 0 ? kb / ms : 0.0);
+
+			// exponent of the time against the source size, 1 is linear
+			if (results.size() > 1) {
+				auto prev = results[results.size() - 2].find(name);
+				if (prev != results[results.size() - 2].end() && prev->second.ms > 0.05 && ms > 0.05) {
+					double e = std::log(ms / prev->second.ms) / std::log(kb / sizes[sizes.size() - 2]);
+					std::cout << std::setw(12) << std::setprecision(2) << e << (e > 1.5 ? "  superlinear" : "");
+				}
+			}
+			std::cout << "\n";
+		}
+		std::cout << std::flush;
+	}
+
+	std::filesystem::remove(path);
+	if (status != 0)
+		std::cerr << "generated program failed to compile\n";
+	return status;
+}
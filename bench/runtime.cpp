@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// xlang_runtime_bench: run time of the binaries xlang builds
+//
+// every program is built by xlang with and without --optimize, and the
+// same program in C by gcc -O2 -m32. each binary is run a
+// number of times with the same input, its output is checked against the
+// C binary and the best and median times are kept. --output writes them
+// as JSON, --compare reads a baseline written before and flags programs
+// that got slower
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <csignal>
+#include <cstring>
+#include <unistd.h>
+#include "process.hpp"
+#include "stats.hpp"
+
+using namespace xlang;
+
+struct RuntimeConfig {
+	std::string xlang;
+	std::string source{XLANG_SOURCE_DIR};
+	std::string output;
+	std::string compare;
+	unsigned runs{5};
+	double threshold{1.10};
+	bool keep{false};
+};
+
+struct Program {
+	const char *name;
+	const char *source;     // .x, relative to the source tree
+	const char *c_source;   // same program in C
+	const char *input;      // written to stdin
+};
+
+// examples/ reading a number take the one that makes them run longest
+static const Program programs[] = {
+		{"quick_sort", "examples/quick_sort.x", "bench/runtime/quick_sort.c", ""},
+		{"prime", "examples/prime.x", "bench/runtime/prime.c", "100000007\n"},
+		{"fibbo", "examples/fibbo.x", "bench/runtime/fibbo.c", "40\n"},
+		{"armstrong", "examples/armstrong.x", "bench/runtime/armstrong.c", "153\n"},
+		{"n_sums_recursion", "examples/n_sums_recursion.x", "bench/runtime/n_sums_recursion.c", "10000\n"},
+		{"matmul", "bench/runtime/matmul.x", "bench/runtime/matmul.c", ""},
+		{"sieve", "bench/runtime/sieve.x", "bench/runtime/sieve.c", ""},
+		{"strscan", "bench/runtime/strscan.x", "bench/runtime/strscan.c", ""},
+};
+
+struct Variant {
+	const char *name;
+	bool optimize;
+};
+
+// 32 bit code only, 64 bit code generation isn't complete and the
+// driver has no option for it
+static const Variant variants[] = {
+		{"m32", false},
+		{"m32-optimize", true},
+};
+
+struct Timing {
+	std::string status;     // ok, build failed, run failed, wrong output
+	double best_ms{0};
+	double median_ms{0};
+};
+
+static void Help() {
+	std::vector<std::string> lines = {
+			"  usage: ./xlang_runtime_bench [options] [program]...",
+			"    --xlang PATH (compiler to benchmark, default xlang next to this program)",
+			"    --source DIR (xlang source tree with examples/ and bench/runtime/)",
+			"    --runs N (times each binary is run, default 5)",
+			"    --output FILE (write the results as JSON)",
+			"    --compare FILE (flag programs slower than in a JSON baseline)",
+			"    --threshold X (median slowdown that is flagged, default 1.10)",
+			"    --keep (keep the work directory with the binaries)",
+			"    -h  or --help (this message)"
+	};
+	for (const auto &l: lines)
+		std::cout << l << "\n";
+}
+
+static bool process_args(RuntimeConfig &cfg, std::vector<std::string> &only, int argc, char **argv) {
+	for (int i = 1; i < argc; i++) {
+		std::string str = argv[i];
+		auto value = [&]() -> std::string {
+			return i + 1 < argc ? argv[++i] : "";
+		};
+		if (str == "--xlang")
+			cfg.xlang = value();
+		else if (str == "--source")
+			cfg.source = value();
+		else if (str == "--runs")
+			cfg.runs = std::max(1, atoi(value().c_str()));
+		else if (str == "--output")
+			cfg.output = value();
+		else if (str == "--compare")
+			cfg.compare = value();
+		else if (str == "--threshold")
+			cfg.threshold = atof(value().c_str());
+		else if (str == "--keep")
+			cfg.keep = true;
+		else if (str.empty() || str[0] == '-') {
+			Help();
+			return false;
+		}
+		else
+			only.push_back(str);
+	}
+	return true;
+}
+
+// runs a build command, its messages are only shown when it fails
+static bool build(const std::vector<std::string> &args) {
+	ProcessResult res;
+	if (!Process::run(args, res)) {
+		std::cerr << "couldn't run " << args[0] << ": " << strerror(errno) << "\n";
+		return false;
+	}
+	if (res.status != 0) {
+		std::cerr << Process::command_line(args) << "\n" << res.out << res.err;
+		return false;
+	}
+	return true;
+}
+
+// best and median wall time of a number of runs, the output
+// of every run has to be the expected one
+static Timing run(const RuntimeConfig &cfg, const std::string &binary, const std::string &input,
+				  const std::string *expected, std::string *output) {
+	Timing t;
+	std::vector<double> ms;
+	for (unsigned r = 0; r < cfg.runs; r++) {
+		ProcessResult res;
+		auto start = std::chrono::steady_clock::now();
+		bool started = Process::run({binary}, res, &input);
+		auto end = std::chrono::steady_clock::now();
+		if (!started || res.signal != 0) {
+			t.status = "run failed";
+			return t;
+		}
+		if (expected != nullptr && res.out != *expected) {
+			t.status = "wrong output";
+			return t;
+		}
+		if (output != nullptr)
+			*output = res.out;
+		ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+	}
+	std::sort(ms.begin(), ms.end());
+	t.status = "ok";
+	t.best_ms = ms.front();
+	t.median_ms = ms[ms.size() / 2];
+	return t;
+}
+
+// baseline written by --output, "program variant" -> median ms
+static std::map<std::string, double> read_baseline(const std::string &path) {
+	std::map<std::string, double> medians;
+	std::ifstream in(path);
+	std::string line;
+	while (std::getline(in, line)) {
+		auto field = [&](const std::string &key) -> std::string {
+			size_t p = line.find("\"" + key + "\": ");
+			if (p == std::string::npos)
+				return "";
+			p += key.size() + 4;
+			if (line[p] == '"')
+				return line.substr(p + 1, line.find('"', p + 1) - p - 1);
+			return line.substr(p, line.find_first_of(",}", p) - p);
+		};
+		if (field("status") == "ok")
+			medians[field("program") + " " + field("variant")] = atof(field("median_ms").c_str());
+	}
+	return medians;
+}
+
+int main(int argc, char **argv) {
+	RuntimeConfig cfg;
+	std::vector<std::string> only;
+	if (!process_args(cfg, only, argc, argv))
+		return -1;
+
+	// the binaries are given their input through a pipe and
+	// may exit before reading it
+	signal(SIGPIPE, SIG_IGN);
+
+	if (cfg.xlang.empty())
+		cfg.xlang = std::filesystem::read_symlink("/proc/self/exe").parent_path() / "xlang";
+	cfg.xlang = std::filesystem::absolute(cfg.xlang);
+	cfg.source = std::filesystem::absolute(cfg.source);
+	if (!cfg.output.empty())
+		cfg.output = std::filesystem::absolute(cfg.output);
+
+	std::map<std::string, double> baseline;
+	if (!cfg.compare.empty())
+		baseline = read_baseline(cfg.compare);
+
+	// xlang writes the object and binary next to where it runs
+	std::filesystem::path work = std::filesystem::temp_directory_path() / ("xlang_runtime_" + std::to_string(getpid()));
+	std::filesystem::create_directories(work);
+	std::filesystem::path home = std::filesystem::current_path();
+	std::filesystem::current_path(work);
+
+	std::ostringstream json;
+	json << std::fixed << std::setprecision(3);
+	int slower = 0;
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << std::left << std::setw(18) << "program" << std::setw(14) << "variant" << std::right
+			  << std::setw(12) << "best ms" << std::setw(12) << "median ms" << std::setw(10) << "vs gcc" << "\n";
+
+	for (const auto &p: programs) {
+		if (!only.empty() && std::find(only.begin(), only.end(), p.name) == only.end())
+			continue;
+
+		std::string c_binary = std::string(p.name) + "-gcc";
+		std::string x = (std::filesystem::path(cfg.source) / p.source).string();
+		std::string c = (std::filesystem::path(cfg.source) / p.c_source).string();
+
+		// the C program decides what the right output is
+		Timing ref;
+		std::string expected;
+		if (build({"gcc", "-m32", "-O2", c, "-o", c_binary}))
+			ref = run(cfg, "./" + c_binary, p.input, nullptr, &expected);
+		else
+			ref.status = "build failed";
+
+		for (const auto &v: variants) {
+			Timing t;
+			std::string bin = std::string(p.name) + "-" + v.name;
+			std::vector<std::string> args = {cfg.xlang, "-m32", "-c", x};
+			if (v.optimize)
+				args.emplace_back("-o");
+
+			// the binary is named after the source, renamed so all variants stay
+			std::error_code ec;
+			std::filesystem::remove(p.name, ec);
+			if (!build(args) || !std::filesystem::exists(p.name))
+				t.status = "build failed";
+			else {
+				std::filesystem::rename(p.name, bin);
+				t = run(cfg, "./" + bin, p.input, ref.status == "ok" ? &expected : nullptr, nullptr);
+			}
+
+			std::cout << std::left << std::setw(18) << p.name << std::setw(14) << v.name << std::right;
+			if (t.status != "ok")
+				std::cout << "  " << t.status;
+			else {
+				std::cout << std::setw(12) << t.best_ms << std::setw(12) << t.median_ms;
+				if (ref.status == "ok" && ref.median_ms > 0)
+					std::cout << std::setw(9) << std::setprecision(2) << t.median_ms / ref.median_ms << "x"
+							  << std::setprecision(3);
+				auto it = baseline.find(std::string(p.name) + " " + v.name);
+				if (it != baseline.end() && it->second > 0 && t.median_ms > it->second * cfg.threshold) {
+					std::cout << "  slower than baseline (" << it->second << " ms)";
+					slower++;
+				}
+			}
+			std::cout << "\n" << std::flush;
+
+			json << (json.tellp() > 0 ? ",\n  " : "\n  ")
+				 << "{\"program\": " << json_string(p.name) << ", \"variant\": " << json_string(v.name)
+				 << ", \"status\": " << json_string(t.status) << ", \"best_ms\": " << t.best_ms
+				 << ", \"median_ms\": " << t.median_ms << ", \"gcc_status\": " << json_string(ref.status)
+				 << ", \"gcc_median_ms\": " << ref.median_ms << "}";
+		}
+	}
+
+	std::filesystem::current_path(home);
+	if (!cfg.keep)
+		std::filesystem::remove_all(work);
+	else
+		std::cout << "binaries kept in " << work.string() << "\n";
+
+	if (!cfg.output.empty()) {
+		std::ofstream out(cfg.output);
+		out << std::fixed << std::setprecision(3)
+			<< "{\"runs\": " << cfg.runs << ", \"results\": [" << json.str() << "\n]}\n";
+		if (!out.good()) {
+			std::cerr << "can't write " << cfg.output << "\n";
+			return -1;
+		}
+	}
+
+	if (slower > 0)
+		std::cerr << slower << " slower than the baseline\n";
+	return slower > 0 ? 1 : 0;
+}
@@ -0,0 +1,30 @@
+/* same program as examples/armstrong.x */
+
+#include <stdio.h>
+
+int power_of_3(int num)
+{
+	return num * num * num;
+}
+
+int is_armstrong_number(int num)
+{
+	int orig_num = num, result = 0;
+	while (orig_num > 0) {
+		result += power_of_3(orig_num % 10);
+		orig_num /= 10;
+	}
+	return num == result;
+}
+
+int main(void)
+{
+	int num;
+	printf("Enter a number: ");
+	scanf("%d", &num);
+	if (is_armstrong_number(num))
+		printf("%d is armstrong number\n", num);
+	else
+		printf("%d is not armstrong number\n", num);
+	return 0;
+}
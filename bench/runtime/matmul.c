@@ -0,0 +1,39 @@
+/* same kernel as matmul.x */
+
+#include <stdio.h>
+
+int a[4096], b[4096], c[4096];
+
+void init(void)
+{
+	int i;
+	for (i = 0; i < 4096; i++) {
+		a[i] = i % 17;
+		b[i] = i % 13;
+	}
+}
+
+void multiply(void)
+{
+	int i, j, k, sum;
+	for (i = 0; i < 64; i++) {
+		for (j = 0; j < 64; j++) {
+			sum = 0;
+			for (k = 0; k < 64; k++)
+				sum += a[i * 64 + k] * b[k * 64 + j];
+			c[i * 64 + j] = sum;
+		}
+	}
+}
+
+int main(void)
+{
+	int r, i, check = 0;
+	init();
+	for (r = 0; r < 20; r++)
+		multiply();
+	for (i = 0; i < 4096; i++)
+		check += c[i];
+	printf("checksum %d\n", check);
+	return 0;
+}
@@ -0,0 +1,55 @@
+extern void printf(char*, int);
+
+int a[4096];
+int b[4096];
+int c[4096];
+
+void init()
+{
+  int i, v;
+  for(i = 0; i < 4096; i++){
+    v = i % 17;
+    a[i] = v;
+    v = i % 13;
+    b[i] = v;
+  }
+}
+
+void multiply()
+{
+  int i, j, k, sum, x, y, ai, bi, ci;
+  for(i = 0; i < 64; i++){
+    for(j = 0; j < 64; j++){
+      sum = 0;
+      for(k = 0; k < 64; k++){
+        ai = i * 64;
+        ai = ai + k;
+        bi = k * 64;
+        bi = bi + j;
+        x = a[ai];
+        y = b[bi];
+        x = x * y;
+        sum = sum + x;
+      }
+      ci = i * 64;
+      ci = ci + j;
+      c[ci] = sum;
+    }
+  }
+}
+
+global int main()
+{
+  int r, i, v, check;
+  init();
+  for(r = 0; r < 20; r++){
+    multiply();
+  }
+  check = 0;
+  for(i = 0; i < 4096; i++){
+    v = c[i];
+    check = check + v;
+  }
+  printf("checksum %d\n", check);
+  return 0;
+}
@@ -0,0 +1,20 @@
+/* same program as examples/n_sums_recursion.x */
+
+#include <stdio.h>
+
+int sum_of_natural_no(int x)
+{
+	if (x <= 0)
+		return 0;
+	return sum_of_natural_no(x - 1) + x;
+}
+
+int main(void)
+{
+	int num, sum;
+	printf("Enter a number: ");
+	scanf("%d", &num);
+	sum = sum_of_natural_no(num);
+	printf("sum of first %d natual numbers = %d\n", num, sum);
+	return 0;
+}
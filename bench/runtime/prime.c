@@ -0,0 +1,23 @@
+/* same program as examples/prime.x */
+
+#include <stdio.h>
+
+int main(void)
+{
+	int num, c;
+	printf("Enter a number: ");
+	scanf("%d", &num);
+	if (num == 2) {
+		printf("%d is prime\n", num);
+		return 0;
+	}
+	for (c = 2; c < num; c++) {
+		if (num % c == 0)
+			break;
+	}
+	if (c != num)
+		printf("%d is not prime\n", num);
+	else
+		printf("%d is prime\n", num);
+	return 0;
+}
@@ -0,0 +1,49 @@
+/* same program as examples/quick_sort.x */
+
+#include <stdio.h>
+
+int array[10] = {7, 4, 9, 1, 2, 5, 6, 8, 3};
+
+int partition(int p, int r)
+{
+	int x = array[r], i = p - 1, j, t;
+	for (j = p; j < r; j++) {
+		if (array[j] <= x) {
+			i++;
+			t = array[i];
+			array[i] = array[j];
+			array[j] = t;
+		}
+	}
+	t = array[i + 1];
+	array[i + 1] = array[r];
+	array[r] = t;
+	return i + 1;
+}
+
+void quick_sort(int p, int r)
+{
+	if (p < r) {
+		int q = partition(p, r);
+		quick_sort(p, q - 1);
+		quick_sort(q + 1, r);
+	}
+}
+
+void print_array(void)
+{
+	int i;
+	for (i = 0; i < 9; i++)
+		printf("%d ", array[i]);
+	printf("\n");
+}
+
+int main(void)
+{
+	printf("Before Sorting: ");
+	print_array();
+	quick_sort(0, 9);
+	printf("After Sorting: ");
+	print_array();
+	return 0;
+}
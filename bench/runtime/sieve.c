@@ -0,0 +1,29 @@
+/* same kernel as sieve.x */
+
+#include <stdio.h>
+
+int flags[1000000];
+
+int sieve(void)
+{
+	int i, j, count = 0;
+	for (i = 0; i < 1000000; i++)
+		flags[i] = 1;
+	for (i = 2; i < 1000000; i++) {
+		if (flags[i] == 1) {
+			count++;
+			for (j = i + i; j < 1000000; j += i)
+				flags[j] = 0;
+		}
+	}
+	return count;
+}
+
+int main(void)
+{
+	int r, count = 0;
+	for (r = 0; r < 10; r++)
+		count = sieve();
+	printf("primes below 1000000: %d\n", count);
+	return 0;
+}
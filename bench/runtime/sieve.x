@@ -0,0 +1,34 @@
+extern void printf(char*, int);
+
+int flags[1000000];
+
+int sieve()
+{
+  int i, j, v, count;
+  for(i = 0; i < 1000000; i++){
+    flags[i] = 1;
+  }
+  count = 0;
+  for(i = 2; i < 1000000; i++){
+    v = flags[i];
+    if(v == 1){
+      count++;
+      j = i + i;
+      while(j < 1000000){
+        flags[j] = 0;
+        j = j + i;
+      }
+    }
+  }
+  return count;
+}
+
+global int main()
+{
+  int r, count;
+  for(r = 0; r < 10; r++){
+    count = sieve();
+  }
+  printf("primes below 1000000: %d\n", count);
+  return 0;
+}
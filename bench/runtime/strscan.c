@@ -0,0 +1,25 @@
+/* same kernel as strscan.x */
+
+#include <stdio.h>
+
+char *text = "the quick brown fox jumps over the lazy dog, pack my box with five dozen liquor jugs. how vexingly quick daft zebras jump! sphinx of black quartz, judge my vow.";
+
+int scan(void)
+{
+	int index = 0, count = 0;
+	while (text[index] != 0) {
+		if (text[index] == 'o')
+			count++;
+		index++;
+	}
+	return count;
+}
+
+int main(void)
+{
+	int r, total = 0;
+	for (r = 0; r < 200000; r++)
+		total += scan();
+	printf("found %d\n", total);
+	return 0;
+}
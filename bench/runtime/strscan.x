@@ -0,0 +1,32 @@
+extern void printf(char*, int);
+
+char* text;
+text="the quick brown fox jumps over the lazy dog, pack my box with five dozen liquor jugs. how vexingly quick daft zebras jump! sphinx of black quartz, judge my vow.";
+
+int scan()
+{
+  int index, val, count;
+  index = 0;
+  count = 0;
+  val = text[index];
+  while(val != 0){
+    if(val == 111){
+      count++;
+    }
+    index++;
+    val = text[index];
+  }
+  return count;
+}
+
+global int main()
+{
+  int r, count, total;
+  total = 0;
+  for(r = 0; r < 200000; r++){
+    count = scan();
+    total = total + count;
+  }
+  printf("found %d\n", total);
+  return 0;
+}
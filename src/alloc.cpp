@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include <new>
+#include <cstdlib>
+#include <malloc.h>
+#include "stats.hpp"
+
+// allocations and the bytes in use are counted for every thread all the
+// time, it is a few thread local adds and lets --mem-stats work without a
+// special build.
+// only the xlang executable and xlang_bench have this, libxlang leaves
+// operator new alone
+
+void *operator new(std::size_t size) {
+	void *p = std::malloc(size == 0 ? 1 : size);
+	if (p == nullptr)
+		throw std::bad_alloc();
+	xlang::Stats::count_allocation(size, malloc_usable_size(p));
+	return p;
+}
+
+void *operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+	void *p = std::malloc(size == 0 ? 1 : size);
+	if (p != nullptr)
+		xlang::Stats::count_allocation(size, malloc_usable_size(p));
+	return p;
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+	return operator new(size, std::nothrow);
+}
+
+void operator delete(void *p) noexcept {
+	xlang::Stats::count_free(malloc_usable_size(p));
+	std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+	operator delete(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+	operator delete(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+	operator delete(p);
+}
@@ -21,7 +21,7 @@ namespace xlang {
 		if (func_info->param_list.size() > 0) {
 			for (const auto &syminf: func_info->param_list) {
 				if (syminf->symbol_info != nullptr) {
-					if (syminf->symbol_info->symbol == tok.string)
+					if (tok.name != NO_NAME && syminf->symbol_info->tok.name == tok.name)
 						return syminf->symbol_info;
 				}
 			}
@@ -34,19 +34,19 @@ namespace xlang {
 
 		SymbolInfo *syminf = nullptr;
 		if (func_symtab != nullptr) {
-			syminf = SymbolTable::search_symbol_node(func_symtab, tok.string);
+			syminf = SymbolTable::search_symbol_node(func_symtab, tok.name);
 			if (syminf == nullptr) {
 				//if null, then search in function parameters
 				syminf = search_func_params(tok);
 				if (syminf == nullptr) {
 					//if null, then search in global symbol table
-					syminf = SymbolTable::search_symbol_node(Compiler::symtab, tok.string);
+					syminf = SymbolTable::search_symbol_node(comp->symtab, tok.name);
 				}
 			}
 		}
 		else
 			//if function symbol table null, then search in global symbol table
-			syminf = SymbolTable::search_symbol_node(Compiler::symtab, tok.string);
+			syminf = SymbolTable::search_symbol_node(comp->symtab, tok.name);
 		return syminf;
 	}
 
@@ -77,16 +77,16 @@ namespace xlang {
 		//if fact_1 is id & fact_2 is not and fact_1 id is pointer
 		if (fact_1->is_id && !fact_2->is_id && fact_1->id_info != nullptr && fact_1->id_info->is_ptr) {
 
-			std::string msg = "invalid Operand to binary " + opr->tok.string;
+			std::string msg = "invalid Operand to binary " + std::string(opr->tok.string);
 			if (opr->tok.number == ARTHM_ADD || opr->tok.number == ARTHM_SUB) {
 				if (fact_2->tok.number == LIT_FLOAT || fact_2->tok.number == LIT_STRING) {
-					msg += " (have " + fact_2->tok.string + ")";
+					msg += " (have " + std::string(fact_2->tok.string) + ")";
 					Log::error_at(opr->tok.loc, msg);
 					return false;
 				}
 			}
 			else {
-				Log::error_at(opr->tok.loc, msg + " (have " + fact_1->tok.string + ")");
+				Log::error_at(opr->tok.loc, msg + " (have " + std::string(fact_1->tok.string) + ")");
 				return false;
 			}
 		}
@@ -94,12 +94,12 @@ namespace xlang {
 
 			if (opr->tok.number == ARTHM_ADD || opr->tok.number == ARTHM_SUB) {
 				if (fact_1->tok.number == LIT_FLOAT || fact_1->tok.number == LIT_STRING) {
-					Log::error_at(opr->tok.loc, "invalid Operand to binary " + opr->tok.string + " (have " + fact_2->tok.string + ")");
+					Log::error_at(opr->tok.loc, "invalid Operand to binary " + std::string(opr->tok.string) + " (have " + std::string(fact_2->tok.string) + ")");
 					return false;
 				}
 			}
 			else {
-				Log::error_at(opr->tok.loc, "invalid Operand to binary " + opr->tok.string + " (have " + fact_2->tok.string + ")");
+				Log::error_at(opr->tok.loc, "invalid Operand to binary " + std::string(opr->tok.string) + " (have " + std::string(fact_2->tok.string) + ")");
 				return false;
 			}
 
@@ -108,14 +108,14 @@ namespace xlang {
 
 			//if both are pointers
 			if (fact_1->id_info->is_ptr && fact_2->id_info->is_ptr) {
-				Log::error_at(opr->tok.loc, "invalid Operand to binary " + opr->tok.string);
+				Log::error_at(opr->tok.loc, "invalid Operand to binary " + std::string(opr->tok.string));
 				return false;
 			}
 			else if (fact_1->id_info->is_ptr && !fact_2->id_info->is_ptr) {
 				if (opr->tok.number == ARTHM_ADD || opr->tok.number == ARTHM_SUB) {
 				}
 				else {
-					Log::error_at(opr->tok.loc, "invalid Operand to binary " + opr->tok.string);
+					Log::error_at(opr->tok.loc, "invalid Operand to binary " + std::string(opr->tok.string));
 					return false;
 				}
 			}
@@ -123,7 +123,7 @@ namespace xlang {
 				if (opr->tok.number == ARTHM_ADD || opr->tok.number == ARTHM_SUB) {
 				}
 				else {
-					Log::error_at(opr->tok.loc, "invalid Operand to binary " + opr->tok.string);
+					Log::error_at(opr->tok.loc, "invalid Operand to binary " + std::string(opr->tok.string));
 					return false;
 				}
 			}
@@ -158,13 +158,13 @@ namespace xlang {
 
 				//if fact_1 is pointer id then error
 				if (fact_1 != nullptr && fact_1->is_id && fact_1->id_info != nullptr && fact_1->id_info->is_ptr) {
-					Log::error_at(opr->tok.loc, "invalid Operand to binary " + opr->tok.string + " (have " + fact_1->tok.string + ")");
+					Log::error_at(opr->tok.loc, "invalid Operand to binary " + std::string(opr->tok.string) + " (have " + std::string(fact_1->tok.string) + ")");
 					return false;
 				}
 
 				//if fact_2 is pointer id then error
 				if (fact_2 != nullptr && fact_2->is_id && fact_2->id_info != nullptr && fact_2->id_info->is_ptr) {
-					Log::error_at(opr->tok.loc, "invalid Operand to binary " + opr->tok.string + " (have " + fact_1->tok.string + ")");
+					Log::error_at(opr->tok.loc, "invalid Operand to binary " + std::string(opr->tok.string) + " (have " + std::string(fact_1->tok.string) + ")");
 					return false;
 				}
 
@@ -174,7 +174,7 @@ namespace xlang {
 						if (fact_1->id_info->type_info->type_specifier.simple_type[0].number == KEY_DOUBLE
 							|| fact_1->id_info->type_info->type_specifier.simple_type[0].number == KEY_FLOAT) {
 
-							Log::error_at(opr->tok.loc, "invalid Operand to binary " + opr->tok.string + " (have " + fact_1->tok.string + ")");
+							Log::error_at(opr->tok.loc, "invalid Operand to binary " + std::string(opr->tok.string) + " (have " + std::string(fact_1->tok.string) + ")");
 							return false;
 						}
 					}
@@ -185,7 +185,7 @@ namespace xlang {
 					if (fact_2->id_info->type_info->type == NodeType::SIMPLE) {
 						if (fact_2->id_info->type_info->type_specifier.simple_type[0].number == KEY_DOUBLE
 							|| fact_2->id_info->type_info->type_specifier.simple_type[0].number == KEY_FLOAT) {
-							Log::error_at(opr->tok.loc, "invalid Operand to binary " + opr->tok.string + " (have " + fact_2->tok.string + ")");
+							Log::error_at(opr->tok.loc, "invalid Operand to binary " + std::string(opr->tok.string) + " (have " + std::string(fact_2->tok.string) + ")");
 							return false;
 						}
 					}
@@ -193,13 +193,13 @@ namespace xlang {
 
 				//if fact_1 is not id and Token is float literal then error
 				if (fact_1 != nullptr && !fact_1->is_id && fact_1->tok.number == LIT_FLOAT) {
-					Log::error_at(opr->tok.loc, "invalid Operand to binary " + opr->tok.string + " (have " + fact_1->tok.string + ")");
+					Log::error_at(opr->tok.loc, "invalid Operand to binary " + std::string(opr->tok.string) + " (have " + std::string(fact_1->tok.string) + ")");
 					return false;
 				}
 
 				//if fact_2 is not id and Token is float literal then error
 				if (fact_2 != nullptr && !fact_2->is_id && fact_2->tok.number == LIT_FLOAT) {
-					Log::error_at(opr->tok.loc, "invalid Operand to binary " + opr->tok.string + " (have " + fact_2->tok.string + ")");
+					Log::error_at(opr->tok.loc, "invalid Operand to binary " + std::string(opr->tok.string) + " (have " + std::string(fact_2->tok.string) + ")");
 					return false;
 				}
 			}
@@ -221,7 +221,7 @@ namespace xlang {
 		if (pexpr->is_id) {
 			syminf = search_id(pexpr->tok);
 			if (syminf == nullptr) {
-				Log::error_at(pexpr->tok.loc, "undeclared '" + pexpr->tok.string + "'");
+				Log::error_at(pexpr->tok.loc, "undeclared '" + std::string(pexpr->tok.string) + "'");
 				return false;
 			}
 			else {
@@ -246,8 +246,8 @@ namespace xlang {
 			result = false;
 
 		return (result &&
-				check_unary_primexp_type_argument(pexpr->left) &&
-				check_unary_primexp_type_argument(pexpr->right));
+				check_unary_primexp_type_argument(Tree::primary_expr(pexpr->left)) &&
+				check_unary_primexp_type_argument(Tree::primary_expr(pexpr->right)));
 	}
 
 	bool Analyzer::check_unary_idexp_type_argument(IdentifierExpression *idexpr) {
@@ -261,7 +261,7 @@ namespace xlang {
 		if (idexpr->is_id) {
 			syminf = search_id(idexpr->tok);
 			if (syminf == nullptr) {
-				Log::error_at(idexpr->tok.loc, "undeclared '" + idexpr->tok.string + "'");
+				Log::error_at(idexpr->tok.loc, "undeclared '" + std::string(idexpr->tok.string) + "'");
 				return false;
 			}
 
@@ -281,8 +281,8 @@ namespace xlang {
 		if (!idexpr->is_id && !idexpr->is_oprtr && idexpr->tok.number == LIT_FLOAT)
 			result = false;
 
-		return (result && check_unary_idexp_type_argument(idexpr->left)
-				&& check_unary_idexp_type_argument(idexpr->right));
+		return (result && check_unary_idexp_type_argument(Tree::id_expr(idexpr->left))
+				&& check_unary_idexp_type_argument(Tree::id_expr(idexpr->right)));
 	}
 
 	bool Analyzer::check_array_subscript(IdentifierExpression *idexpr) {
@@ -296,7 +296,7 @@ namespace xlang {
 		if (idexpr->is_id) {
 			syminf = search_id(idexpr->tok);
 			if (syminf == nullptr) {
-				Log::error_at(idexpr->tok.loc, "undeclared '" + idexpr->tok.string + "'");
+				Log::error_at(idexpr->tok.loc, "undeclared '" + std::string(idexpr->tok.string) + "'");
 				return false;
 			}
 
@@ -324,30 +324,30 @@ namespace xlang {
 			}
 
 			if (!result) {
-				Log::error_at(idexpr->tok.loc, "subscript is neither array nor pointer '" + idexpr->tok.string + "'");
-				Log::error_at(idexpr->tok.loc, "array dimension is different at declaration '" + idexpr->tok.string + "'");
+				Log::error_at(idexpr->tok.loc, "subscript is neither array nor pointer '" + std::string(idexpr->tok.string) + "'");
+				Log::error_at(idexpr->tok.loc, "array dimension is different at declaration '" + std::string(idexpr->tok.string) + "'");
 			}
 		}
 
 		return (result &&
-				check_array_subscript(idexpr->left) &&
-				check_array_subscript(idexpr->right));
+				check_array_subscript(Tree::id_expr(idexpr->left)) &&
+				check_array_subscript(Tree::id_expr(idexpr->right)));
 	}
 
-	void Analyzer::analyze_primary_expr(PrimaryExpression **_pexpr) {
+	void Analyzer::analyze_primary_expr(PrimaryExpression *_pexpr) {
 
 		std::stack<PrimaryExpression *> pexp_stack;
 		std::stack<PrimaryExpression *> pexp_out_stack;
-		PrimaryExpression *pexp_root = *_pexpr;
+		PrimaryExpression *pexp_root = _pexpr;
 		PrimaryExpression *pexp = nullptr;
 		SymbolInfo *syminf = nullptr;
 
 		if (pexp_root == nullptr)
 			return;
 
-		if (pexp_root->unary_node != nullptr) {
+		if (pexp_root->unary_node != NO_NODE) {
 			if (pexp_root->is_oprtr && pexp_root->tok.number == BIT_COMPL) {
-				if (!check_unary_primexp_type_argument(pexp_root->unary_node)) {
+				if (!check_unary_primexp_type_argument(Tree::primary_expr(pexp_root->unary_node))) {
 					Log::error_at(pexp_root->tok.loc, "wrong type argument to bit-complement ");
 					return;
 				}
@@ -364,11 +364,11 @@ namespace xlang {
 			pexp_stack.pop();
 			pexp_out_stack.push(pexp);
 
-			if (pexp->left != nullptr)
-				pexp_stack.push(pexp->left);
+			if (pexp->left != NO_NODE)
+				pexp_stack.push(Tree::primary_expr(pexp->left));
 
-			if (pexp->right != nullptr)
-				pexp_stack.push(pexp->right);
+			if (pexp->right != NO_NODE)
+				pexp_stack.push(Tree::primary_expr(pexp->right));
 		}
 
 		clear_stack(pexp_stack);
@@ -399,7 +399,7 @@ namespace xlang {
 				if (pexp->is_id) {
 					syminf = search_id(pexp->tok); //search symbol
 					if (syminf == nullptr) {
-						Log::error_at(pexp->tok.loc, "undeclared '" + pexp->tok.string + "'");
+						Log::error_at(pexp->tok.loc, "undeclared '" + std::string(pexp->tok.string) + "'");
 						pexp_out_stack.pop();
 						continue;
 					}
@@ -421,25 +421,25 @@ namespace xlang {
 		}
 	}
 
-	void Analyzer::analyze_id_expr(IdentifierExpression **_idexpr) {
+	void Analyzer::analyze_id_expr(IdentifierExpression *_idexpr) {
 
 		std::stack<IdentifierExpression *> idexp_stack;
 		std::vector<IdentifierExpression *> idexp_vec;
-		IdentifierExpression *idexp_root = *_idexpr;
+		IdentifierExpression *idexp_root = _idexpr;
 		IdentifierExpression *idexp = nullptr;
 		IdentifierExpression *idobj = nullptr, *idmember = nullptr;
 		SymbolInfo *syminf = nullptr;
 		RecordNode *record = nullptr;
-		std::string recordname;
+		NameId recordname = NO_NAME;
 		size_t i;
 
 		if (idexp_root == nullptr)
 			return;
 
-		if (idexp_root->unary != nullptr) {
+		if (idexp_root->unary != NO_NODE) {
 			//if first operator is bit compl(~), then check rest of the expression
 			if (idexp_root->is_oprtr && idexp_root->tok.number == BIT_COMPL) {
-				if (!check_unary_idexp_type_argument(idexp_root->unary)) {
+				if (!check_unary_idexp_type_argument(Tree::id_expr(idexp_root->unary))) {
 					Log::error_at(idexp_root->tok.loc, "wrong type argument to bit-complement ");
 					return;
 				}
@@ -447,11 +447,11 @@ namespace xlang {
 		}
 
 		//if ++, --, &(addressof)
-		if (idexp != nullptr && idexp_root->unary != nullptr) {
+		if (idexp != nullptr && idexp_root->unary != NO_NODE) {
 			if (idexp_root->is_oprtr &&
 				(idexp_root->tok.number == INCR_OP || idexp->tok.number == DECR_OP
 				 || idexp_root->tok.number == ADDROF_OP)) {
-				analyze_id_expr(&idexp_root->unary);
+				analyze_id_expr(Tree::id_expr(idexp_root->unary));
 			}
 		}
 
@@ -463,13 +463,13 @@ namespace xlang {
 
 			if (idexp != nullptr) {
 				idexp_stack.push(idexp);
-				idexp = idexp->left;
+				idexp = Tree::id_expr(idexp->left);
 			}
 			else {
 				idexp = idexp_stack.top();
 				idexp_vec.push_back(idexp);
 				idexp_stack.pop();
-				idexp = idexp->right;
+				idexp = Tree::id_expr(idexp->right);
 			}
 		}
 
@@ -480,14 +480,14 @@ namespace xlang {
 		if (idobj == nullptr)
 			return;
 
-		if (idobj->unary != nullptr)
-			idobj = idobj->unary;
+		if (idobj->unary != NO_NODE)
+			idobj = Tree::id_expr(idobj->unary);
 
 		if (idobj->is_id) {
 			//search symbol
 			syminf = search_id(idobj->tok);
 			if (syminf == nullptr) {
-				Log::error_at(idobj->tok.loc, "undeclared '" + idobj->tok.string + "'");
+				Log::error_at(idobj->tok.loc, "undeclared '" + std::string(idobj->tok.string) + "'");
 				return;
 			}
 			else {
@@ -501,7 +501,7 @@ namespace xlang {
 					else
 						return;
 				}
-				recordname = idobj->id_info->type_info->type_specifier.record_type.string;
+				recordname = idobj->id_info->type_info->type_specifier.record_type.name;
 			}
 		}
 
@@ -519,12 +519,12 @@ namespace xlang {
 				idmember = idexp_vec[i + 2];
 
 				if (idobj->is_id) {
-					record = SymbolTable::search_record_node(Compiler::record_table, recordname);
+					record = SymbolTable::search_record_node(comp->record_table, recordname);
 					if (record != nullptr) {
-						syminf = SymbolTable::search_symbol_node(record->symtab, idobj->tok.string);
+						syminf = SymbolTable::search_symbol_node(record->symtab, idobj->tok.name);
 						if (syminf != nullptr) {
 							idobj->id_info = syminf;
-							recordname = idobj->id_info->type_info->type_specifier.record_type.string;
+							recordname = idobj->id_info->type_info->type_specifier.record_type.name;
 						}
 					}
 				}
@@ -545,16 +545,16 @@ namespace xlang {
 				if (idobj->id_info != nullptr) {
 					switch (idobj->id_info->type_info->type) {
 						case NodeType::RECORD :
-							record = SymbolTable::search_record_node(Compiler::record_table, recordname);
+							record = SymbolTable::search_record_node(comp->record_table, recordname);
 							if (record != nullptr && idmember != nullptr) {
-								if (!SymbolTable::search_symbol(record->symtab, idmember->tok.string)) {
-									Log::error_at(idmember->tok.loc, "record '" + record->recordname + "' has no member '" + idmember->tok.string + "'");
+								if (!SymbolTable::search_symbol(record->symtab, idmember->tok.name)) {
+									Log::error_at(idmember->tok.loc, "record '" + record->recordname + "' has no member '" + std::string(idmember->tok.string) + "'");
 								}
 							}
 
 							break;
 						case NodeType::SIMPLE :
-							Log::error_at(idobj->tok.loc, "'" + idobj->tok.string + "' is not a record type");
+							Log::error_at(idobj->tok.loc, "'" + std::string(idobj->tok.string) + "' is not a record type");
 							break;
 						default:
 							break;
@@ -577,11 +577,11 @@ namespace xlang {
 			return;
 
 		if (!sizeexpr->is_simple_type) {
-			record = SymbolTable::search_record_node(Compiler::record_table, sizeexpr->identifier.string);
+			record = SymbolTable::search_record_node(comp->record_table, sizeexpr->identifier.name);
 			if (record == nullptr) {
 				sminf = search_id(sizeexpr->identifier);
 				if (sminf == nullptr)
-					Log::error_at(sizeexpr->identifier.loc, "undeclared '" + sizeexpr->identifier.string + "'");
+					Log::error_at(sizeexpr->identifier.loc, "undeclared '" + std::string(sizeexpr->identifier.string) + "'");
 			}
 		}
 	}
@@ -592,17 +592,17 @@ namespace xlang {
 		if (cast_expr == nullptr)
 			return;
 
-		analyze_id_expr(&cast_expr->target);
+		analyze_id_expr(Tree::id_expr(cast_expr->target));
 	}
 
 	void Analyzer::get_idexpr_idinfo(IdentifierExpression *idexpr, SymbolInfo **idinfo) {
 		if (idexpr == nullptr)
 			return;
 
-		if (idexpr->left == nullptr && idexpr->right == nullptr)
+		if (idexpr->left == NO_NODE && idexpr->right == NO_NODE)
 			*idinfo = idexpr->id_info;
 
-		get_idexpr_idinfo(idexpr->right, &(*idinfo));
+		get_idexpr_idinfo(Tree::id_expr(idexpr->right), &(*idinfo));
 	}
 
 	IdentifierExpression *Analyzer::get_idexpr_attrbute_node(IdentifierExpression **_idexpr) {
@@ -614,14 +614,14 @@ namespace xlang {
 		IdentifierExpression *idobj = nullptr, *idmember = nullptr;
 		SymbolInfo *syminf = nullptr;
 		RecordNode *record = nullptr;
-		std::string recordname;
+		NameId recordname = NO_NAME;
 		size_t i;
 		IdentifierExpression *result = nullptr;
 
 		if (idexp_root == nullptr)
 			return nullptr;
 
-		if (idexp_root->unary != nullptr) {
+		if (idexp_root->unary != NO_NODE) {
 			Log::error_at(idexp_root->tok.loc, "unary operator to assignement ");
 			return nullptr;
 		}
@@ -633,13 +633,13 @@ namespace xlang {
 
 			if (idexp != nullptr) {
 				idexp_stack.push(idexp);
-				idexp = idexp->left;
+				idexp = Tree::id_expr(idexp->left);
 			}
 			else {
 				idexp = idexp_stack.top();
 				idexp_vec.push_back(idexp);
 				idexp_stack.pop();
-				idexp = idexp->right;
+				idexp = Tree::id_expr(idexp->right);
 			}
 		}
 
@@ -652,7 +652,7 @@ namespace xlang {
 		if (idobj->is_id) {
 			syminf = search_id(idobj->tok);
 			if (syminf == nullptr) {
-				Log::error_at(idobj->tok.loc, "undeclared '" + idobj->tok.string + "'");
+				Log::error_at(idobj->tok.loc, "undeclared '" + std::string(idobj->tok.string) + "'");
 				return nullptr;
 			}
 			else {
@@ -665,7 +665,7 @@ namespace xlang {
 					else
 						return idobj;
 				}
-				recordname = idobj->id_info->type_info->type_specifier.record_type.string;
+				recordname = idobj->id_info->type_info->type_specifier.record_type.name;
 			}
 		}
 
@@ -681,12 +681,12 @@ namespace xlang {
 
 				//search id in record table and assign to node
 				if (idobj->is_id) {
-					record = SymbolTable::search_record_node(Compiler::record_table, recordname);
+					record = SymbolTable::search_record_node(comp->record_table, recordname);
 					if (record != nullptr) {
-						syminf = SymbolTable::search_symbol_node(record->symtab, idmember->tok.string);
+						syminf = SymbolTable::search_symbol_node(record->symtab, idmember->tok.name);
 						if (syminf != nullptr) {
 							idmember->id_info = syminf;
-							recordname = idmember->id_info->type_info->type_specifier.record_type.string;
+							recordname = idmember->id_info->type_info->type_specifier.record_type.name;
 						}
 					}
 				}
@@ -707,8 +707,8 @@ namespace xlang {
 				if (pexpr == nullptr)
 					return 0;
 				else {
-					left = tree_height(exprtype, pexpr->left, idexpr);
-					right = tree_height(exprtype, pexpr->right, idexpr);
+					left = tree_height(exprtype, Tree::primary_expr(pexpr->left), idexpr);
+					right = tree_height(exprtype, Tree::primary_expr(pexpr->right), idexpr);
 					if (left > right)
 						return left + 1;
 					else
@@ -720,8 +720,8 @@ namespace xlang {
 				if (idexpr == nullptr)
 					return 0;
 				else {
-					left = tree_height(exprtype, pexpr, idexpr->left);
-					right = tree_height(exprtype, pexpr, idexpr->right);
+					left = tree_height(exprtype, pexpr, Tree::id_expr(idexpr->left));
+					right = tree_height(exprtype, pexpr, Tree::id_expr(idexpr->right));
 					if (left > right)
 						return left + 1;
 					else
@@ -746,7 +746,7 @@ namespace xlang {
 			if (_idexp->is_id) {
 				syminf = search_id(_idexp->tok);
 				if (syminf == nullptr) {
-					Log::error_at(_idexp->tok.loc, "undeclared '" + _idexp->tok.string + "'");
+					Log::error_at(_idexp->tok.loc, "undeclared '" + std::string(_idexp->tok.string) + "'");
 					return nullptr;
 				}
 				else {
@@ -778,7 +778,7 @@ namespace xlang {
 			switch (type) {
 				case ExpressionType::PRIMARY_EXPR :
 					if (!check_unary_primexp_type_argument(pexpr)) {
-						Log::error_at(assgnexpr->tok.loc, "expected only simple type argument to '" + assgnexpr->tok.string + "'");
+						Log::error_at(assgnexpr->tok.loc, "expected only simple type argument to '" + std::string(assgnexpr->tok.string) + "'");
 						return false;
 					}
 					break;
@@ -788,12 +788,12 @@ namespace xlang {
 						if (idexpr->id_info->type_info->type == NodeType::SIMPLE) {
 							if (idexpr->id_info->type_info->type_specifier.simple_type[0].number == KEY_FLOAT ||
 								idexpr->id_info->type_info->type_specifier.simple_type[0].number == KEY_FLOAT) {
-								Log::error_at(assgnexpr->tok.loc, "wrong type argument to '" + assgnexpr->tok.string + "'");
+								Log::error_at(assgnexpr->tok.loc, "wrong type argument to '" + std::string(assgnexpr->tok.string) + "'");
 								return false;
 							}
 						}
 						else {
-							Log::error_at(assgnexpr->tok.loc, "expected only simple type argument to '" + assgnexpr->tok.string + "'");
+							Log::error_at(assgnexpr->tok.loc, "expected only simple type argument to '" + std::string(assgnexpr->tok.string) + "'");
 							return false;
 						}
 					}
@@ -810,12 +810,14 @@ namespace xlang {
 
 		AssignmentExpression *assgnexp = *asexpr;
 		Token tok;
-		PrimaryExpression *left = nullptr, *opr = nullptr;
+		NodeIndex left, oprindex;
+		PrimaryExpression *leftexp = nullptr, *opr = nullptr;
 
 		if (*asexpr == nullptr)
 			return;
 
-		if (assgnexp->id_expr->left != nullptr && assgnexp->id_expr->right != nullptr)
+		IdentifierExpression *idexp = Tree::id_expr(assgnexp->id_expr);
+		if (idexp->left != NO_NODE && idexp->right != NO_NODE)
 			return;
 
 		tok = assgnexp->tok;
@@ -824,12 +826,14 @@ namespace xlang {
 		(*asexpr)->tok.string = "=";
 
 		left = Tree::get_primary_expr_mem();
-		left->is_id = true;
-		left->tok = assgnexp->id_expr->tok;
-		left->is_oprtr = false;
-		left->id_info = search_id(left->tok);
-
-		opr = Tree::get_primary_expr_mem();
+		leftexp = Tree::primary_expr(left);
+		leftexp->is_id = true;
+		leftexp->tok = idexp->tok;
+		leftexp->is_oprtr = false;
+		leftexp->id_info = search_id(leftexp->tok);
+
+		oprindex = Tree::get_primary_expr_mem();
+		opr = Tree::primary_expr(oprindex);
 		opr->is_oprtr = true;
 		opr->oprtr_kind = OperatorType::BINARY;
 		opr->left = left;
@@ -880,7 +884,7 @@ namespace xlang {
 		}
 
 		opr->right = (*asexpr)->expression->primary_expr;
-		(*asexpr)->expression->primary_expr = opr;
+		(*asexpr)->expression->primary_expr = oprindex;
 	}
 
 	void Analyzer::analyze_assgn_expr(AssignmentExpression **_assgnexpr) {
@@ -890,17 +894,17 @@ namespace xlang {
 		IdentifierExpression *assgnleft = nullptr;
 		IdentifierExpression *idright = nullptr;
 		FunctionInfo *funcinfo = nullptr;
-		std::map<std::string, FunctionInfo *>::iterator findit;
+		FunctionMap::iterator findit;
 
 		if (assgnexpr == nullptr)
 			return;
 
-		analyze_id_expr(&assgnexpr->id_expr);
+		analyze_id_expr(Tree::id_expr(assgnexpr->id_expr));
 		if (assgnexpr->tok.number != ASSGN)
 			simplify_assgn_primary_expr(&(*_assgnexpr));
 
 		analyze_expr(&assgnexpr->expression);
-		assgnleft = get_assgnexpr_idexpr_attribute(assgnexpr->id_expr);
+		assgnleft = get_assgnexpr_idexpr_attribute(Tree::id_expr(assgnexpr->id_expr));
 		if (assgnleft == nullptr)
 			return;
 
@@ -914,31 +918,31 @@ namespace xlang {
 		switch (assgnexpr->expression->expr_kind) {
 
 			case ExpressionType::PRIMARY_EXPR : {
-				PrimaryExpression *prim_exp = assgnexpr->expression->primary_expr;
+				PrimaryExpression *prim_exp = Tree::primary_expr(assgnexpr->expression->primary_expr);
 
 				if (!check_assignment_type_argument(assgnexpr, ExpressionType::PRIMARY_EXPR, nullptr, prim_exp))
 					return;
 
 				if (assgnleft->id_info->is_ptr && prim_exp->is_id && prim_exp->id_info->is_ptr) {
 					if (typeinf->type != prim_exp->id_info->type_info->type)
-						Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + assgnleft->tok.string + "'");
+						Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + std::string(assgnleft->tok.string) + "'");
 				}
 				else {
 
 					if (assgnleft->id_info->is_ptr && !prim_exp->is_id) {
 						if (!check_unary_primexp_type_argument(prim_exp))
-							Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + assgnleft->tok.string + "'");
+							Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + std::string(assgnleft->tok.string) + "'");
 					}
 
 					if (!assgnleft->id_info->is_ptr && !prim_exp->is_id && assgnleft->id_info->type_info->type == NodeType::RECORD) {
 						if (!check_unary_primexp_type_argument(prim_exp))
-							Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + assgnleft->tok.string + "'");
+							Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + std::string(assgnleft->tok.string) + "'");
 					}
 
 					if (typeinf->type == NodeType::SIMPLE && typeinf->type_specifier.simple_type[0].number == KEY_CHAR) {
 						if (!assgnleft->id_info->is_array && !assgnleft->id_info->is_ptr) {
 							if (prim_exp->tok.number == LIT_STRING) {
-								Log::error_at(assgnexpr->tok.loc, "incompatible types for string assignment to '" + assgnleft->tok.string + "'");
+								Log::error_at(assgnexpr->tok.loc, "incompatible types for string assignment to '" + std::string(assgnleft->tok.string) + "'");
 								return;
 							}
 						}
@@ -954,12 +958,12 @@ namespace xlang {
 									if ((typeinf->type_specifier.simple_type[0].number == KEY_VOID) &&
 										(prim_exp->id_info->type_info->type_specifier.simple_type[0].number == KEY_FLOAT ||
 										 prim_exp->id_info->type_info->type_specifier.simple_type[0].number == KEY_DOUBLE)) {
-										Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + assgnleft->tok.string + "'");
+										Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + std::string(assgnleft->tok.string) + "'");
 									}
 									break;
 								case NodeType::RECORD :
 									if (typeinf->type_specifier.simple_type[0].number != KEY_INT && typeinf->type_specifier.simple_type[0].number != KEY_VOID)
-										Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + assgnleft->tok.string + "'");
+										Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + std::string(assgnleft->tok.string) + "'");
 									break;
 								default:
 									break;
@@ -970,7 +974,7 @@ namespace xlang {
 								case NodeType::SIMPLE :
 									if (prim_exp->id_info->type_info->type_specifier.simple_type[0].number == KEY_INT ||
 										prim_exp->id_info->type_info->type_specifier.simple_type[0].number == KEY_VOID) {
-										Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to45 '" + assgnleft->tok.string + "'");
+										Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to45 '" + std::string(assgnleft->tok.string) + "'");
 										return;
 									}
 									break;
@@ -987,13 +991,13 @@ namespace xlang {
 
 				if (typeinf->type == NodeType::RECORD && prim_exp->is_id) {
 					if (typeinf->type_specifier.record_type.string != prim_exp->id_info->type_info->type_specifier.record_type.string) {
-						Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + assgnleft->tok.string + "'");
+						Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + std::string(assgnleft->tok.string) + "'");
 					}
 
 					if (typeinf->type_specifier.record_type.string == prim_exp->id_info->type_info->type_specifier.record_type.string &&
 						assgnleft->id_info->is_ptr != prim_exp->id_info->is_ptr &&
 						assgnleft->id_info->ptr_oprtr_count != prim_exp->id_info->ptr_oprtr_count) {
-						Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + assgnleft->tok.string + "'");
+						Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment to '" + std::string(assgnleft->tok.string) + "'");
 					}
 				}
 
@@ -1008,20 +1012,20 @@ namespace xlang {
 						(cast_exp->simple_type[0].number == KEY_FLOAT ||
 						 cast_exp->simple_type[0].number == KEY_DOUBLE)) {
 
-						idright = get_assgnexpr_idexpr_attribute(cast_exp->target);
+						idright = get_assgnexpr_idexpr_attribute(Tree::id_expr(cast_exp->target));
 						if (idright == nullptr)
 							return;
 						if (idright->id_info->is_ptr)
-							Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment by casting to '" + assgnleft->tok.string + "'");
+							Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment by casting to '" + std::string(assgnleft->tok.string) + "'");
 					}
 					//record type = record type
 				}
 				else if (typeinf->type == NodeType::RECORD && !cast_exp->is_simple_type) {
 					if (typeinf->type_specifier.record_type.string != cast_exp->identifier.string)
-						Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment by casting to '" + assgnleft->tok.string + "'");
+						Log::error_at(assgnexpr->tok.loc, "incompatible types for assignment by casting to '" + std::string(assgnleft->tok.string) + "'");
 				}
 				else {
-					idright = get_assgnexpr_idexpr_attribute(cast_exp->target);
+					idright = get_assgnexpr_idexpr_attribute(Tree::id_expr(cast_exp->target));
 					if (idright == nullptr)
 						return;
 				}
@@ -1029,15 +1033,16 @@ namespace xlang {
 			}
 
 			case ExpressionType::ID_EXPR :
-				if (assgnexpr->expression->id_expr->tok.number == ADDROF_OP) {
+				if (Tree::id_expr(assgnexpr->expression->id_expr)->tok.number == ADDROF_OP) {
 
-					analyze_id_expr(&assgnexpr->expression->id_expr->unary);
-					idright = get_assgnexpr_idexpr_attribute(assgnexpr->expression->id_expr->unary);
+					IdentifierExpression *unary = Tree::id_expr(Tree::id_expr(assgnexpr->expression->id_expr)->unary);
+					analyze_id_expr(unary);
+					idright = get_assgnexpr_idexpr_attribute(unary);
 					if (idright == nullptr)
 						return;
 
 					if (!assgnleft->id_info->is_ptr) {
-						Log::error_at(assgnexpr->tok.loc, "pointer type expected to the left hand side '" + assgnleft->tok.string + "'");
+						Log::error_at(assgnexpr->tok.loc, "pointer type expected to the left hand side '" + std::string(assgnleft->tok.string) + "'");
 						return;
 					}
 
@@ -1056,7 +1061,7 @@ namespace xlang {
 					}
 				}
 				else {
-					idright = get_assgnexpr_idexpr_attribute(assgnexpr->expression->id_expr);
+					idright = get_assgnexpr_idexpr_attribute(Tree::id_expr(assgnexpr->expression->id_expr));
 					if (idright == nullptr)
 						return;
 					if (!check_assignment_type_argument(assgnexpr, ExpressionType::ID_EXPR, idright, nullptr)) {
@@ -1068,24 +1073,24 @@ namespace xlang {
 					}
 					else if (idright->id_info != nullptr && assgnleft->id_info->is_ptr && !idright->id_info->is_ptr) {
 						if (idright->id_info->type_info->type_specifier.simple_type[0].number != KEY_INT) {
-							Log::error_at(assgnexpr->tok.loc, "invalid type assignment4 '" + idright->id_info->tok.string + "' to '" + assgnleft->id_info->tok.string + "'");
+							Log::error_at(assgnexpr->tok.loc, "invalid type assignment4 '" + std::string(idright->id_info->tok.string) + "' to '" + std::string(assgnleft->id_info->tok.string) + "'");
 							return;
 						}
 					}
 					if (assgnleft && idright->id_info && typeinf->type == NodeType::RECORD && idright->id_info->type_info->type != NodeType::RECORD) {
-						Log::error_at(assgnexpr->tok.loc, "invalid type assignment '" + idright->id_info->tok.string + "' to '" + assgnleft->id_info->tok.string + "'");
+						Log::error_at(assgnexpr->tok.loc, "invalid type assignment '" + std::string(idright->id_info->tok.string) + "' to '" + std::string(assgnleft->id_info->tok.string) + "'");
 						return;
 					}
 					else if (assgnleft && idright->id_info && typeinf->type == NodeType::SIMPLE && idright->id_info->type_info->type != NodeType::SIMPLE) {
 						return;
 					}
 					else if (assgnleft && idright->id_info && assgnleft->id_info->is_ptr && typeinf->type == NodeType::RECORD && idright->id_info->type_info->type != NodeType::RECORD) {
-						Log::error_at(assgnexpr->tok.loc, "invalid type assignment '" + idright->id_info->tok.string + "' to '" + assgnleft->id_info->tok.string + "'");
+						Log::error_at(assgnexpr->tok.loc, "invalid type assignment '" + std::string(idright->id_info->tok.string) + "' to '" + std::string(assgnleft->id_info->tok.string) + "'");
 						return;
 					}
 					else if (assgnleft && idright->id_info && assgnleft->id_info->is_ptr && typeinf->type == NodeType::RECORD && idright->id_info->type_info->type == NodeType::SIMPLE) {
 						if (idright->id_info->type_info->type_specifier.simple_type[0].number != KEY_INT) {
-							Log::error_at(assgnexpr->tok.loc, "invalid type assignment '" + idright->id_info->tok.string + "' to '" + assgnleft->id_info->tok.string + "'");
+							Log::error_at(assgnexpr->tok.loc, "invalid type assignment '" + std::string(idright->id_info->tok.string) + "' to '" + std::string(assgnleft->id_info->tok.string) + "'");
 							return;
 						}
 					}
@@ -1096,15 +1101,15 @@ namespace xlang {
 				if (assgnexpr->expression->call_expr == nullptr)
 					return;
 
-				findit = Compiler::func_table->find(assgnexpr->expression->call_expr->function->tok.string);
-				if (findit == Compiler::func_table->end())
+				findit = comp->func_table->find(Tree::id_expr(assgnexpr->expression->call_expr->function)->tok.name);
+				if (findit == comp->func_table->end())
 					return;
 
 				funcinfo = findit->second;
 
 				if (funcinfo != nullptr) {
 					if (typeinf->type != funcinfo->return_type->type) {
-						Log::error_at(assgnexpr->tok.loc, "mismatched type assignment of function-call '" + funcinfo->func_name + "' to '" + assgnleft->id_info->tok.string + "'");
+						Log::error_at(assgnexpr->tok.loc, "mismatched type assignment of function-call '" + funcinfo->func_name + "' to '" + std::string(assgnleft->id_info->tok.string) + "'");
 						return;
 					}
 
@@ -1118,12 +1123,12 @@ namespace xlang {
 							if (typeinf->type_specifier.simple_type[0].number != funcinfo->return_type->type_specifier.simple_type[0].number) {
 								Log::error_at(assgnexpr->tok.loc,
 											  "mismatched type assignment of function-call '" + funcinfo->func_name + "' to '"
-											  + assgnleft->id_info->tok.string + "'");
+											  + std::string(assgnleft->id_info->tok.string) + "'");
 								return;
 							}
 							if (assgnleft->id_info->ptr_oprtr_count != funcinfo->ptr_oprtr_count) {
 								Log::error_at(assgnexpr->tok.loc,
-											  "mismatched pointer type assignment of function-call '" + funcinfo->func_name + "' to '" + assgnleft->id_info->tok.string + "'");
+											  "mismatched pointer type assignment of function-call '" + funcinfo->func_name + "' to '" + std::string(assgnleft->id_info->tok.string) + "'");
 
 								return;
 							}
@@ -1133,12 +1138,12 @@ namespace xlang {
 							if (typeinf->type_specifier.record_type.string !=
 								funcinfo->return_type->type_specifier.record_type.string) {
 								Log::error_at(assgnexpr->tok.loc,
-											  "mismatched type assignment of function-call '" + funcinfo->func_name + "' to '" + assgnleft->id_info->tok.string + "'");
+											  "mismatched type assignment of function-call '" + funcinfo->func_name + "' to '" + std::string(assgnleft->id_info->tok.string) + "'");
 								return;
 							}
 							if (assgnleft->id_info->ptr_oprtr_count != funcinfo->ptr_oprtr_count) {
 								Log::error_at(assgnexpr->tok.loc,
-											  "mismatched pointer type assignment of function-call '" + funcinfo->func_name + "' to '" + assgnleft->id_info->tok.string + "'");
+											  "mismatched pointer type assignment of function-call '" + funcinfo->func_name + "' to '" + std::string(assgnleft->id_info->tok.string) + "'");
 								return;
 							}
 							break;
@@ -1158,23 +1163,23 @@ namespace xlang {
 
 		CallExpression *funcexpr = *_funcallexpr;
 		FunctionInfo *funcinfo = nullptr;
-		std::map<std::string, FunctionInfo *>::iterator findit;
-		std::list<Expression *>::iterator func_exprit;
+		FunctionMap::iterator findit;
 
 		if (funcexpr == nullptr)
 			return;
 
-		findit = Compiler::func_table->find(funcexpr->function->tok.string);
-		if (findit == Compiler::func_table->end()) {
-			Log::error_at(funcexpr->function->tok.loc, "undeclared function called '" + funcexpr->function->tok.string + "'");
+		IdentifierExpression *function = Tree::id_expr(funcexpr->function);
+		findit = comp->func_table->find(function->tok.name);
+		if (findit == comp->func_table->end()) {
+			Log::error_at(function->tok.loc, "undeclared function called '" + std::string(function->tok.string) + "'");
 			return;
 		}
 
 		funcinfo = findit->second;
 		if (funcinfo != nullptr) {
 			if (funcinfo->param_list.size() != funcexpr->expression_list.size()) {
-				Log::error_at(funcexpr->function->tok.loc,
-							  "In function call '" + funcexpr->function->tok.string + "', require " + std::to_string(funcinfo->param_list.size()) + " arguments");
+				Log::error_at(function->tok.loc,
+							  "In function call '" + std::string(function->tok.string) + "', require " + std::to_string(funcinfo->param_list.size()) + " arguments");
 				return;
 			}
 		}
@@ -1190,7 +1195,7 @@ namespace xlang {
 
 		switch (_expr->expr_kind) {
 			case ExpressionType::PRIMARY_EXPR :
-				analyze_primary_expr(&(_expr->primary_expr));
+				analyze_primary_expr(Tree::primary_expr(_expr->primary_expr));
 				break;
 			case ExpressionType::ASSGN_EXPR :
 				analyze_assgn_expr(&(_expr->assgn_expr));
@@ -1202,7 +1207,7 @@ namespace xlang {
 				analyze_cast_expr(&(_expr->cast_expr));
 				break;
 			case ExpressionType::ID_EXPR :
-				analyze_id_expr(&(_expr->id_expr));
+				analyze_id_expr(Tree::id_expr(_expr->id_expr));
 				break;
 			case ExpressionType::FUNC_CALL_EXPR :
 				analyze_funccall_expr(&(_expr->call_expr));
@@ -1212,17 +1217,17 @@ namespace xlang {
 
 	void Analyzer::analyze_label_statement(LabelStatement **labelstmt) {
 
-		std::map<std::string, Token>::iterator labels_it;
+		std::unordered_map<NameId, Token>::iterator labels_it;
 		if (*labelstmt == nullptr)
 			return;
 
-		labels_it = labels.find((*labelstmt)->label.string);
+		labels_it = labels.find((*labelstmt)->label.name);
 		if (labels_it != labels.end()) {
-			Log::error_at((*labelstmt)->label.loc, "duplicate label '" + (*labelstmt)->label.string + "'");
+			Log::error_at((*labelstmt)->label.loc, "duplicate label '" + std::string((*labelstmt)->label.string) + "'");
 			return;
 		}
 		else
-			labels.insert(std::pair<std::string, Token>((*labelstmt)->label.string, (*labelstmt)->label));
+			labels.insert(std::pair<NameId, Token>((*labelstmt)->label.name, (*labelstmt)->label));
 	}
 
 	void Analyzer::analyze_selection_statement(SelectStatement **selstmt) {
@@ -1326,12 +1331,12 @@ namespace xlang {
 	void Analyzer::analyze_goto_jmpstmt() {
 
 		std::list<Token>::iterator it;
-		std::map<std::string, Token>::iterator labels_it;
+		std::unordered_map<NameId, Token>::iterator labels_it;
 
 		for (it = goto_list.begin(); it != goto_list.end(); it++) {
-			labels_it = labels.find(it->string);
+			labels_it = labels.find(it->name);
 			if (labels_it == labels.end()) {
-				Log::error_at(it->loc, "label '" + it->string + "' does not exists");
+				Log::error_at(it->loc, "label '" + std::string(it->string) + "' does not exists");
 				return;
 			}
 		}
@@ -1363,7 +1368,7 @@ namespace xlang {
 		size_t loc;
 		std::vector<int> v;
 		std::string asmtoken;
-		std::string asmtemplate = tok.string;
+		std::string asmtemplate(tok.string);
 
 		loc = asmtemplate.find_first_of("%");
 		while (loc != std::string::npos) {
@@ -1411,7 +1416,7 @@ namespace xlang {
 			return;
 
 		Token constrainttok = (*Operand)->constraint;
-		std::string constraint = constrainttok.string;
+		std::string constraint(constrainttok.string);
 		size_t len = constraint.length();
 		char ch;
 
@@ -1454,7 +1459,7 @@ namespace xlang {
 			return;
 
 		Token constrainttok = (*Operand)->constraint;
-		std::string constraint = constrainttok.string;
+		std::string constraint(constrainttok.string);
 		size_t len = constraint.length();
 		char ch;
 
@@ -1480,17 +1485,19 @@ namespace xlang {
 			return;
 
 		switch (expr2->expr_kind) {
-			case ExpressionType::PRIMARY_EXPR :
-				if (expr2->primary_expr == nullptr)
+			case ExpressionType::PRIMARY_EXPR : {
+				PrimaryExpression *pexpr = Tree::primary_expr(expr2->primary_expr);
+				if (pexpr == nullptr)
 					return;
 
-				if (expr2->primary_expr->left != nullptr ||
-					expr2->primary_expr->right != nullptr ||
-					expr2->primary_expr->unary_node != nullptr) {
-					Log::error_at(expr2->primary_expr->tok.loc, "only single node primary expression expected in asm Operand");
+				if (pexpr->left != NO_NODE ||
+					pexpr->right != NO_NODE ||
+					pexpr->unary_node != NO_NODE) {
+					Log::error_at(pexpr->tok.loc, "only single node primary expression expected in asm Operand");
 				}
 
 				break;
+			}
 			default:
 				Log::error("only single node primary expression expected in asm Operand");
 				return;
@@ -1591,9 +1598,9 @@ namespace xlang {
 			return true;
 
 		if (pexpr->is_id)
-			return (has_constant_member(pexpr->left) && has_constant_member(pexpr->right));
+			return (has_constant_member(Tree::primary_expr(pexpr->left)) && has_constant_member(Tree::primary_expr(pexpr->right)));
 		else
-			return (has_constant_member(pexpr->left) && has_constant_member(pexpr->right));
+			return (has_constant_member(Tree::primary_expr(pexpr->left)) && has_constant_member(Tree::primary_expr(pexpr->right)));
 
 		return true;
 	}
@@ -1646,18 +1653,18 @@ namespace xlang {
 							case ExpressionType::ASSGN_EXPR :
 								if (_expr->assgn_expr->expression == nullptr)
 									return;
-								if (!has_constant_array_subscript(_expr->assgn_expr->id_expr))
+								if (!has_constant_array_subscript(Tree::id_expr(_expr->assgn_expr->id_expr)))
 									Log::error_at(_expr->assgn_expr->tok.loc, "constant expression expected in array subscript");
 								if (_expr->assgn_expr->expression->expr_kind == ExpressionType::PRIMARY_EXPR) {
-									PrimaryExpression *pexpr = _expr->assgn_expr->expression->primary_expr;
-									if (pexpr->left != nullptr || pexpr->right != nullptr)
+									PrimaryExpression *pexpr = Tree::primary_expr(_expr->assgn_expr->expression->primary_expr);
+									if (pexpr->left != NO_NODE || pexpr->right != NO_NODE)
 										Log::error_at(_expr->assgn_expr->tok.loc, "constant expression expected ");
 								}
 								else
 									Log::error_at(_expr->assgn_expr->tok.loc, "expected constant primary expression ");
 								break;
 							case ExpressionType::PRIMARY_EXPR :
-								Log::error_at(_expr->primary_expr->tok.loc, "expected assignment expression ");
+								Log::error_at(Tree::primary_expr(_expr->primary_expr)->tok.loc, "expected assignment expression ");
 								break;
 							case ExpressionType::SIZEOF_EXPR :
 								Log::error_at(_expr->sizeof_expr->identifier.loc, "expected assignment expression ");
@@ -1666,7 +1673,7 @@ namespace xlang {
 								Log::error_at(_expr->cast_expr->identifier.loc, "expected assignment expression ");
 								break;
 							case ExpressionType::ID_EXPR :
-								Log::error_at(_expr->id_expr->tok.loc, "expected assignment expression ");
+								Log::error_at(Tree::id_expr(_expr->id_expr)->tok.loc, "expected assignment expression ");
 								break;
 							case ExpressionType::FUNC_CALL_EXPR :
 								Log::error("unexpected function call expression ");
@@ -1708,22 +1715,27 @@ namespace xlang {
 			return;
 
 		while (trhead != nullptr) {
-			if (trhead->symtab != nullptr) {
-				func_symtab = trhead->symtab;
-				func_info = trhead->symtab->func_info;
+			analyze_func_locals(trhead);
+			trhead = trhead->p_next;
+		}
+	}
 
-				if (func_symtab != nullptr && func_info != nullptr)
-					analyze_func_params(func_info);
+	void Analyzer::analyze_func_locals(TreeNode *trnode) {
+		if (trnode->symtab == nullptr)
+			return;
 
-				for (FuncParamInfo *param: func_info->param_list) {
-					if (param != nullptr && param->symbol_info != nullptr) {
-						if (SymbolTable::search_symbol(func_symtab, param->symbol_info->symbol)) {
-							Log::error_at(param->symbol_info->tok.loc, "redeclaration of '" + param->symbol_info->symbol + "', same name used for function parameter");
-						}
-					}
+		func_symtab = trnode->symtab;
+		func_info = trnode->symtab->func_info;
+
+		if (func_symtab != nullptr && func_info != nullptr)
+			analyze_func_params(func_info);
+
+		for (FuncParamInfo *param: func_info->param_list) {
+			if (param != nullptr && param->symbol_info != nullptr) {
+				if (SymbolTable::search_symbol(func_symtab, param->symbol_info->tok.name)) {
+					Log::error_at(param->symbol_info->tok.loc, "redeclaration of '" + param->symbol_info->symbol + "', same name used for function parameter");
 				}
 			}
-			trhead = trhead->p_next;
 		}
 	}
 
@@ -1734,18 +1746,9 @@ namespace xlang {
 		if (trhead == nullptr)
 			return;
 
-		check_invalid_type_declaration(Compiler::symtab);
+		check_invalid_type_declaration(comp->symtab);
 		while (trhead != nullptr) {
-			if (trhead->symtab != nullptr) {
-				analyze_func_param_info(&trhead->symtab->func_info);
-				func_info = trhead->symtab->func_info;
-			}
-
-			func_symtab = trhead->symtab;
-			check_invalid_type_declaration(func_symtab);
-			analyze_statement(&trhead->statement);
-			analyze_goto_jmpstmt();
-			labels.clear();
+			analyze_tree_node(trhead);
 			trhead = trhead->p_next;
 		}
 
@@ -1755,4 +1758,32 @@ namespace xlang {
 		//one pass for globally declared expressions
 		analyze_global_assignment(&(*trnode));
 	}
+
+	void Analyzer::analyze_tree_node(TreeNode *trhead) {
+		TraceScope span(comp->trace, Compiler::node_name(trhead), "analyze");
+		if (trhead->symtab != nullptr) {
+			analyze_func_param_info(&trhead->symtab->func_info);
+			func_info = trhead->symtab->func_info;
+		}
+
+		func_symtab = trhead->symtab;
+		check_invalid_type_declaration(func_symtab);
+		analyze_statement(&trhead->statement);
+		analyze_goto_jmpstmt();
+		labels.clear();
+	}
+
+	void Analyzer::analyze_declarations(TreeNode **trnode) {
+		parse_tree = *trnode;
+		if (parse_tree == nullptr)
+			return;
+
+		check_invalid_type_declaration(comp->symtab);
+		analyze_global_assignment(trnode);
+	}
+
+	void Analyzer::analyze_node(TreeNode *trnode) {
+		analyze_tree_node(trnode);
+		analyze_func_locals(trnode);
+	}
 }
\ No newline at end of file
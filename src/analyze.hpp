@@ -18,18 +18,30 @@
 
 namespace xlang {
 	
+	class Compiler;
+	
 	class Analyzer {
     public:
+		explicit Analyzer(Compiler *c) : comp(c) {}
+		
 		void analyze(TreeNode **);
+
+		// --stream: the declarations and global assignments first, then
+		// every top level node in order, a function once its body is parsed
+		void analyze_declarations(TreeNode **);
+
+		void analyze_node(TreeNode *);
 		
     private:
+		Compiler *comp;
+		
 		TreeNode *parse_tree = nullptr;
 
 		Node *func_symtab = nullptr;
 
 		FunctionInfo *func_info = nullptr;
 		std::stack<PrimaryExpression *> prim_expr_stack;
-		std::map<std::string, Token> labels;
+		std::unordered_map<NameId, Token> labels;
 		int break_inloop = 0, continue_inloop = 0;
 		std::list<Token> goto_list; // for forward reference of labels
 		PrimaryExpression *factor_1 = nullptr, *factor_2 = nullptr, *primoprtr = nullptr;
@@ -48,9 +60,9 @@ namespace xlang {
 		
 		void analyze_expr(Expression **);
 		
-		void analyze_primary_expr(PrimaryExpression **);
+		void analyze_primary_expr(PrimaryExpression *);
 		
-		void analyze_id_expr(IdentifierExpression **);
+		void analyze_id_expr(IdentifierExpression *);
 		
 		void analyze_sizeof_expr(SizeOfExpression **);
 		
@@ -89,6 +101,10 @@ namespace xlang {
 		void analyze_func_params(FunctionInfo *);
 		
 		void analyze_local_declaration(TreeNode **);
+
+		void analyze_func_locals(TreeNode *);
+
+		void analyze_tree_node(TreeNode *);
 		
 		void check_invalid_type_declaration(Node *);
 		
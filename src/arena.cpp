@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include <cstdint>
+#include "arena.hpp"
+
+namespace xlang {
+
+	Arena &Arena::current() {
+		if (active != nullptr)
+			return *active;
+		static thread_local Arena own;
+		return own;
+	}
+
+	void *Arena::allocate(size_t size, size_t align) {
+		uintptr_t at = (reinterpret_cast<uintptr_t>(next) + align - 1) & ~(uintptr_t) (align - 1);
+		if (next == nullptr || at + size > reinterpret_cast<uintptr_t>(end)) {
+
+			// a large object gets a block of its own, the current one
+			// goes on being filled
+			if (size + align > BLOCK_SIZE / 4) {
+				blocks.emplace_back(new char[size + align]);
+				used_bytes += size;
+				uintptr_t start = reinterpret_cast<uintptr_t>(blocks.back().get());
+				return reinterpret_cast<void *>((start + align - 1) & ~(uintptr_t) (align - 1));
+			}
+			blocks.emplace_back(new char[BLOCK_SIZE]);
+			next = blocks.back().get();
+			end = next + BLOCK_SIZE;
+			at = (reinterpret_cast<uintptr_t>(next) + align - 1) & ~(uintptr_t) (align - 1);
+		}
+		next = reinterpret_cast<char *>(at + size);
+		used_bytes += size;
+		return reinterpret_cast<void *>(at);
+	}
+
+	void Arena::reset() {
+		for (Finalizer *fin = finalizers; fin != nullptr; fin = fin->prev)
+			fin->destroy(fin->object);
+		finalizers = nullptr;
+		blocks.clear();
+		next = end = nullptr;
+		used_bytes = 0;
+	}
+
+	void Arena::adopt(Arena &other) {
+
+		// the block being filled here stays the one being filled. the
+		// objects of other are destroyed before the ones made here
+
+		if (other.finalizers != nullptr) {
+			Finalizer *oldest = other.finalizers;
+			while (oldest->prev != nullptr)
+				oldest = oldest->prev;
+			oldest->prev = finalizers;
+			finalizers = other.finalizers;
+		}
+		for (auto &block: other.blocks)
+			blocks.push_back(std::move(block));
+		used_bytes += other.used_bytes;
+
+		other.finalizers = nullptr;
+		other.blocks.clear();
+		other.next = other.end = nullptr;
+		other.used_bytes = 0;
+	}
+}
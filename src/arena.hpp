@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace xlang {
+
+	// memory of the tree and symbol tables of one compilation
+	//
+	// objects are bumped out of large blocks and never freed one at a
+	// time, they all go when the arena is reset or destroyed. the ones
+	// with a destructor (most have a list or a vector) get it run then,
+	// newest first
+	//
+	// Tree::get_*_mem() and SymbolTable::get_*_mem() take from the arena
+	// of the thread, Compiler::run() makes its own the one of the thread
+	// it runs on. it isn't locked, one thread uses an arena at a time
+
+	class Arena {
+	public:
+
+		static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+		Arena() = default;
+
+		~Arena() {
+			reset();
+		}
+
+		Arena(const Arena &) = delete;
+
+		Arena &operator=(const Arena &) = delete;
+
+		// the arena of the compilation running on this thread. a thread
+		// without one uses one of its own that lasts as long as the thread
+		static inline thread_local Arena *active = nullptr;
+
+		static Arena &current();
+
+		// a value initialized T, like new T()
+		template<typename T>
+		T *make() {
+			T *obj = new(allocate(sizeof(T), alignof(T))) T();
+			if constexpr (!std::is_trivially_destructible_v<T>) {
+				auto *fin = new(allocate(sizeof(Finalizer), alignof(Finalizer))) Finalizer;
+				fin->object = obj;
+				fin->destroy = [](void *p) { static_cast<T *>(p)->~T(); };
+				fin->prev = finalizers;
+				finalizers = fin;
+			}
+			return obj;
+		}
+
+		void *allocate(size_t size, size_t align);
+
+		// destroys everything made so far and frees the blocks
+		void reset();
+
+		// takes over everything made in other, it goes when this one
+		// does. other is left empty
+		void adopt(Arena &other);
+
+		// bytes handed out and blocks they came from, for --mem-stats
+		size_t used() const {
+			return used_bytes;
+		}
+
+		size_t block_count() const {
+			return blocks.size();
+		}
+
+	private:
+
+		struct Finalizer {
+			void *object;
+			void (*destroy)(void *);
+			Finalizer *prev;
+		};
+
+		std::vector<std::unique_ptr<char[]>> blocks;
+		char *next{nullptr};
+		char *end{nullptr};
+		size_t used_bytes{0};
+		Finalizer *finalizers{nullptr};
+	};
+}
@@ -0,0 +1,1142 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include <cstring>
+#include <fstream>
+#include "ast.hpp"
+#include "compiler.hpp"
+#include "murmurhash3.hpp"
+#include "arena.hpp"
+#include "log.hpp"
+
+namespace xlang {
+
+	// bits of the byte before a token, the rest of it is written only
+	// when it is set. the text is TOKEN_TEXT_* in the two top bits
+	#define TOKEN_NAME   0x01
+	#define TOKEN_WIDTH  0x02
+	#define TOKEN_VALUE  0x04
+	#define TOKEN_NO_LOC 0x08
+
+	#define TOKEN_TEXT_NONE    0
+	#define TOKEN_TEXT_AT_LOC  1   // where the token is
+	#define TOKEN_TEXT_SOURCE  2   // somewhere else in the source
+	#define TOKEN_TEXT_POOL    3
+
+	#define TOKEN_TEXT_SHIFT   6
+
+	// the source and the compiler that read it
+	static void source_hash(std::string_view source, uint64_t hash[2]) {
+		std::string bytes(source);
+		bytes += '\0';
+		bytes += "xlang " + VERSION;
+		MurmurHash3_x64_128(bytes.data(), bytes.size(), 0, hash);
+	}
+
+	static uint8_t flags(bool a, bool b = false, bool c = false, bool d = false,
+						 bool e = false, bool f = false, bool g = false, bool h = false) {
+		return a | b << 1 | c << 2 | d << 3 | e << 4 | f << 5 | g << 6 | h << 7;
+	}
+
+	void AstWriter::number(uint64_t v) {
+		while (v >= 0x80) {
+			out.push_back(static_cast<char>(v | 0x80));
+			v >>= 7;
+		}
+		out.push_back(static_cast<char>(v));
+	}
+
+	void AstWriter::signed_number(int64_t v) {
+		number((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+	}
+
+	void AstWriter::text(std::string_view s) {
+		number(s.size());
+		if (s.empty())
+			return;
+
+		auto it = pooled.find(std::string(s));
+		if (it == pooled.end()) {
+			it = pooled.emplace(std::string(s), pool.size()).first;
+			pool += s;
+		}
+		number(it->second);
+	}
+
+	void AstWriter::token(const Token &tok) {
+		uintptr_t start = reinterpret_cast<uintptr_t>(source.data());
+		uintptr_t s = reinterpret_cast<uintptr_t>(tok.string.data());
+		uint8_t where = TOKEN_TEXT_NONE;
+		if (!tok.string.empty()) {
+			if (s >= start && s + tok.string.size() <= start + source.size())
+				where = s - start == tok.loc.offset ? TOKEN_TEXT_AT_LOC : TOKEN_TEXT_SOURCE;
+			else
+				where = TOKEN_TEXT_POOL;
+		}
+
+		bool no_loc = tok.loc.offset == TokenLocation::NO_OFFSET;
+		byte(tok.number);
+		byte((tok.name != NO_NAME ? TOKEN_NAME : 0) | (tok.width != 0 ? TOKEN_WIDTH : 0)
+			 | (tok.value.i != 0 ? TOKEN_VALUE : 0) | (no_loc ? TOKEN_NO_LOC : 0) | where << TOKEN_TEXT_SHIFT);
+
+		// from the token before, they are mostly close
+		if (!no_loc) {
+			signed_number(static_cast<int64_t>(tok.loc.offset) - last_offset);
+			last_offset = tok.loc.offset;
+		}
+		if (tok.name != NO_NAME)
+			number(tok.name);
+		if (tok.width != 0)
+			byte(tok.width);
+		if (tok.value.i != 0)
+			signed_number(tok.value.i);
+
+		switch (where) {
+			case TOKEN_TEXT_AT_LOC :
+				number(tok.string.size());
+				break;
+			case TOKEN_TEXT_SOURCE :
+				number(tok.string.size());
+				number(s - start);
+				break;
+			case TOKEN_TEXT_POOL :
+				text(tok.string);
+				break;
+			default:
+				break;
+		}
+	}
+
+	template<typename C>
+	void AstWriter::tokens(const C &toks) {
+		number(toks.size());
+		for (const Token &tok: toks)
+			token(tok);
+	}
+
+	bool AstWriter::ref(const void *p) {
+
+		// 0 is nullptr, 1 an object that follows, the others the index
+		// of one written before plus 2
+
+		if (p == nullptr) {
+			number(0);
+			return false;
+		}
+
+		auto it = decl_refs.find(p);
+		if (it != decl_refs.end()) {
+			number(it->second + 2);
+			return false;
+		}
+		if (in_body) {
+			it = body_refs.find(p);
+			if (it != body_refs.end()) {
+				number(it->second + 2);
+				return false;
+			}
+			body_refs.emplace(p, decl_refs.size() + body_refs.size());
+		}
+		else
+			decl_refs.emplace(p, decl_refs.size());
+
+		number(1);
+		return true;
+	}
+
+	void AstWriter::type_specifier(const TypeSpecifier &ts) {
+		tokens(ts.simple_type);
+		token(ts.record_type);
+	}
+
+	void AstWriter::type_info(TypeInfo *t) {
+		if (!ref(t))
+			return;
+		byte(static_cast<uint8_t>(t->type));
+		byte(flags(t->is_const, t->is_global, t->is_extern, t->is_static));
+		type_specifier(t->type_specifier);
+	}
+
+	void AstWriter::record_type_info(RecordTypeInfo *t) {
+		if (!ref(t))
+			return;
+		byte(static_cast<uint8_t>(t->type));
+		byte(flags(t->is_const, t->is_ptr));
+		signed_number(t->ptr_oprtr_count);
+		type_specifier(t->type_specifier);
+	}
+
+	void AstWriter::symbol_info(SymbolInfo *s) {
+
+		// the symbols after it in its bucket follow it, a chain is as
+		// deep as the bucket is long
+
+		if (!ref(s))
+			return;
+		text(s->symbol);
+		token(s->tok);
+		type_info(s->type_info);
+		byte(flags(s->is_ptr, s->is_array, s->is_func_ptr));
+		signed_number(s->ptr_oprtr_count);
+		signed_number(s->ret_ptr_count);
+		tokens(s->arr_dimension_list);
+		number(s->arr_init_list.size());
+		for (auto &init: s->arr_init_list)
+			tokens(init);
+		number(s->func_ptr_params_list.size());
+		for (RecordTypeInfo *param: s->func_ptr_params_list)
+			record_type_info(param);
+		symbol_info(s->p_next);
+	}
+
+	void AstWriter::func_param_info(FuncParamInfo *p) {
+		if (!ref(p))
+			return;
+		type_info(p->type_info);
+		symbol_info(p->symbol_info);
+	}
+
+	void AstWriter::function_info(FunctionInfo *f) {
+		if (!ref(f))
+			return;
+		text(f->func_name);
+		token(f->tok);
+		byte(flags(f->is_global, f->is_extern));
+		signed_number(f->ptr_oprtr_count);
+		type_info(f->return_type);
+		number(f->param_list.size());
+		for (FuncParamInfo *param: f->param_list)
+			func_param_info(param);
+	}
+
+	void AstWriter::node(Node *n, bool with_locals) {
+		if (!ref(n))
+			return;
+		signed_number(n->node_type);
+		function_info(n->func_info);
+		byte(with_locals);
+		if (with_locals)
+			locals(n);
+	}
+
+	void AstWriter::locals(Node *n) {
+
+		// the buckets keep the order symbols were declared in, the ids
+		// are written as they are since a removed symbol can be in one
+		// and not the other
+
+		for (SymbolInfo *s: n->symbol_info)
+			symbol_info(s);
+		number(n->ids.size());
+		for (auto &id: n->ids) {
+			number(id.first);
+			symbol_info(id.second);
+		}
+	}
+
+	void AstWriter::record_node(RecordNode *r) {
+		if (!ref(r))
+			return;
+		text(r->recordname);
+		token(r->recordtok);
+		byte(flags(r->is_global, r->is_extern));
+		node(r->symtab, true);
+		record_node(r->p_next);
+	}
+
+	// the tree is written where it is met, nothing in it is pointed
+	// to twice. a byte before each says if it is there
+
+	// these two are most of a tree, the byte saying one is there has its
+	// flags too and which of its children follow
+
+	void AstWriter::primary_expr(NodeIndex i) {
+		PrimaryExpression *e = Tree::primary_expr(i);
+		if (e == nullptr) {
+			byte(0);
+			return;
+		}
+		byte(flags(true, e->is_oprtr, e->is_id, e->oprtr_kind == OperatorType::BINARY,
+				   e->left != NO_NODE, e->right != NO_NODE, e->unary_node != NO_NODE));
+		token(e->tok);
+		symbol_info(e->id_info);
+		if (e->left != NO_NODE)
+			primary_expr(e->left);
+		if (e->right != NO_NODE)
+			primary_expr(e->right);
+		if (e->unary_node != NO_NODE)
+			primary_expr(e->unary_node);
+	}
+
+	void AstWriter::id_expr(NodeIndex i) {
+		IdentifierExpression *e = Tree::id_expr(i);
+		if (e == nullptr) {
+			byte(0);
+			return;
+		}
+		byte(flags(true, e->is_oprtr, e->is_id, e->is_subscript, e->is_ptr,
+				   e->left != NO_NODE, e->right != NO_NODE, e->unary != NO_NODE));
+		token(e->tok);
+		symbol_info(e->id_info);
+		tokens(e->subscript);
+		signed_number(e->ptr_oprtr_count);
+		if (e->left != NO_NODE)
+			id_expr(e->left);
+		if (e->right != NO_NODE)
+			id_expr(e->right);
+		if (e->unary != NO_NODE)
+			id_expr(e->unary);
+	}
+
+	void AstWriter::sizeof_expr(SizeOfExpression *e) {
+		byte(e != nullptr);
+		if (e == nullptr)
+			return;
+		byte(flags(e->is_simple_type, e->is_ptr));
+		tokens(e->simple_type);
+		token(e->identifier);
+		signed_number(e->ptr_oprtr_count);
+	}
+
+	void AstWriter::cast_expr(CastExpression *e) {
+		byte(e != nullptr);
+		if (e == nullptr)
+			return;
+		byte(e->is_simple_type);
+		tokens(e->simple_type);
+		token(e->identifier);
+		signed_number(e->ptr_oprtr_count);
+		id_expr(e->target);
+	}
+
+	void AstWriter::assgn_expr(AssignmentExpression *e) {
+		byte(e != nullptr);
+		if (e == nullptr)
+			return;
+		token(e->tok);
+		id_expr(e->id_expr);
+		expression(e->expression);
+	}
+
+	void AstWriter::call_expr(CallExpression *e) {
+		byte(e != nullptr);
+		if (e == nullptr)
+			return;
+		id_expr(e->function);
+		number(e->expression_list.size());
+		for (Expression *arg: e->expression_list)
+			expression(arg);
+	}
+
+	void AstWriter::expression(Expression *e) {
+
+		// the kind plus 1, 0 if there is none
+		byte(e != nullptr ? static_cast<uint8_t>(e->expr_kind) + 1 : 0);
+		if (e == nullptr)
+			return;
+		switch (e->expr_kind) {
+			case ExpressionType::PRIMARY_EXPR :
+				primary_expr(e->primary_expr);
+				break;
+			case ExpressionType::ASSGN_EXPR :
+				assgn_expr(e->assgn_expr);
+				break;
+			case ExpressionType::SIZEOF_EXPR :
+				sizeof_expr(e->sizeof_expr);
+				break;
+			case ExpressionType::CAST_EXPR :
+				cast_expr(e->cast_expr);
+				break;
+			case ExpressionType::ID_EXPR :
+				id_expr(e->id_expr);
+				break;
+			case ExpressionType::FUNC_CALL_EXPR :
+				call_expr(e->call_expr);
+				break;
+		}
+	}
+
+	void AstWriter::asm_operand(AsmOperand *op) {
+		byte(op != nullptr);
+		if (op == nullptr)
+			return;
+		token(op->constraint);
+		expression(op->expression);
+	}
+
+	void AstWriter::asm_statement(AsmStatement *asmstmt) {
+		size_t count = 0;
+		for (AsmStatement *a = asmstmt; a != nullptr; a = a->p_next)
+			count++;
+		number(count);
+		for (AsmStatement *a = asmstmt; a != nullptr; a = a->p_next) {
+			token(a->asm_template);
+			number(a->output_operand.size());
+			for (AsmOperand *op: a->output_operand)
+				asm_operand(op);
+			number(a->input_operand.size());
+			for (AsmOperand *op: a->input_operand)
+				asm_operand(op);
+		}
+	}
+
+	void AstWriter::statement(Statement *stmt) {
+		byte(static_cast<uint8_t>(stmt->type));
+		switch (stmt->type) {
+			case StatementType::LABEL :
+				byte(stmt->labled_statement != nullptr);
+				if (stmt->labled_statement != nullptr)
+					token(stmt->labled_statement->label);
+				break;
+
+			case StatementType::EXPR :
+				byte(stmt->expression_statement != nullptr);
+				if (stmt->expression_statement != nullptr)
+					expression(stmt->expression_statement->expression);
+				break;
+
+			case StatementType::SELECT : {
+				SelectStatement *sel = stmt->selection_statement;
+				byte(sel != nullptr);
+				if (sel == nullptr)
+					break;
+				token(sel->iftok);
+				token(sel->elsetok);
+				expression(sel->condition);
+				statements(sel->if_statement);
+				statements(sel->else_statement);
+				break;
+			}
+
+			case StatementType::ITER : {
+				IterationStatement *iter = stmt->iteration_statement;
+				byte(iter != nullptr);
+				if (iter == nullptr)
+					break;
+				byte(static_cast<uint8_t>(iter->type));
+				token(iter->_while.whiletok);
+				expression(iter->_while.condition);
+				statements(iter->_while.statement);
+				token(iter->_dowhile.dotok);
+				token(iter->_dowhile.whiletok);
+				expression(iter->_dowhile.condition);
+				statements(iter->_dowhile.statement);
+				token(iter->_for.fortok);
+				expression(iter->_for.init_expr);
+				expression(iter->_for.condition);
+				expression(iter->_for.update_expr);
+				statements(iter->_for.statement);
+				break;
+			}
+
+			case StatementType::JUMP : {
+				JumpStatement *jmp = stmt->jump_statement;
+				byte(jmp != nullptr);
+				if (jmp == nullptr)
+					break;
+				byte(static_cast<uint8_t>(jmp->type));
+				token(jmp->tok);
+				expression(jmp->expression);
+				token(jmp->goto_id);
+				break;
+			}
+
+			case StatementType::ASM :
+				asm_statement(stmt->asm_statement);
+				break;
+
+			case StatementType::DECL :
+				break;
+		}
+	}
+
+	void AstWriter::statements(Statement *head) {
+
+		// a list goes as its length and the statements, p_prev and p_next
+		// are made again when it is read
+
+		size_t count = 0;
+		for (Statement *s = head; s != nullptr; s = s->p_next)
+			count++;
+		number(count);
+		for (Statement *s = head; s != nullptr; s = s->p_next)
+			statement(s);
+	}
+
+	void AstWriter::declarations() {
+		// NO_NAME isn't written
+		number(comp->names.size());
+		for (NameId id = 1; id < comp->names.size(); id++)
+			text(comp->names.name(id));
+
+		node(comp->symtab, true);
+
+		for (RecordNode *r: comp->record_table->recordinfo)
+			record_node(r);
+		number(comp->record_table->ids.size());
+		for (auto &id: comp->record_table->ids) {
+			number(id.first);
+			record_node(id.second);
+		}
+
+		number(comp->func_table->size());
+		for (auto &f: *comp->func_table) {
+			number(f.first);
+			function_info(f.second);
+		}
+
+		size_t count = 0;
+		for (TreeNode *n = comp->ast; n != nullptr; n = n->p_next)
+			count++;
+		number(count);
+		for (TreeNode *n = comp->ast; n != nullptr; n = n->p_next) {
+			byte(n->symtab != nullptr);
+			if (n->symtab != nullptr)
+				node(n->symtab, false);
+			else
+				statements(n->statement);
+		}
+	}
+
+	bool AstWriter::write(const std::string &path) {
+		source = comp->global.file.buffer->text();
+
+		AstHeader header{};
+		std::memcpy(header.magic, AstHeader::MAGIC, sizeof(header.magic));
+		header.version = AstHeader::VERSION;
+		header.source_size = source.size();
+		source_hash(source, header.source_hash);
+
+		out.assign(sizeof(AstHeader), '\0');
+		declarations();
+
+		std::vector<uint64_t> index;
+		in_body = true;
+		for (TreeNode *n = comp->ast; n != nullptr; n = n->p_next) {
+			if (n->symtab == nullptr)
+				continue;
+			index.push_back(out.size());
+			last_offset = 0;
+			locals(n->symtab);
+			statements(n->statement);
+			body_refs.clear();
+		}
+		in_body = false;
+		index.push_back(out.size());
+
+		// the declarations, each body and the pool
+		std::vector<uint32_t> checks;
+		checks.push_back(MurmurHash3_x86_32(out.data() + sizeof(header), index[0] - sizeof(header), 0));
+		for (size_t i = 0; i + 1 < index.size(); i++)
+			checks.push_back(MurmurHash3_x86_32(out.data() + index[i], index[i + 1] - index[i], 0));
+		checks.push_back(MurmurHash3_x86_32(pool.data(), pool.size(), 0));
+
+		header.body_count = index.size() - 1;
+		header.index = out.size();
+		out.append(reinterpret_cast<const char *>(index.data()), index.size() * sizeof(uint64_t));
+		out.append(reinterpret_cast<const char *>(checks.data()), checks.size() * sizeof(uint32_t));
+		header.pool = out.size();
+		header.pool_size = pool.size();
+		out += pool;
+		std::memcpy(out.data(), &header, sizeof(header));
+
+		std::ofstream outfile(path, std::ios::out | std::ios::binary);
+		if (!outfile.is_open())
+			return false;
+		outfile.write(out.data(), out.size());
+		return outfile.good();
+	}
+
+	void AstReader::damaged() {
+		Log::error(path, ": damaged, compile without --load-ast");
+
+		// not reached, Log::error() throws it
+		throw CompileError();
+	}
+
+	bool AstReader::open(const std::string &p) {
+		path = p;
+		file = SourceBuffer::map(path);
+		if (!file)
+			return false;
+
+		std::string_view bytes = file->text();
+		AstHeader header;
+		if (bytes.size() < sizeof(header))
+			return false;
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		if (std::memcmp(header.magic, AstHeader::MAGIC, sizeof(header.magic)) != 0 || header.version != AstHeader::VERSION)
+			return false;
+
+		source = comp->global.file.buffer->text();
+		uint64_t hash[2];
+		source_hash(source, hash);
+		if (header.source_size != source.size() || hash[0] != header.source_hash[0] || hash[1] != header.source_hash[1])
+			return false;
+
+		// the sections have to be in the file and in order
+		uint64_t entry = sizeof(uint64_t) + sizeof(uint32_t);
+		if (header.index > bytes.size() || (bytes.size() - header.index) / entry <= header.body_count + 1)
+			return false;
+		index.resize(header.body_count + 1);
+		checks.resize(header.body_count + 2);
+		std::memcpy(index.data(), bytes.data() + header.index, index.size() * sizeof(uint64_t));
+		std::memcpy(checks.data(), bytes.data() + header.index + index.size() * sizeof(uint64_t), checks.size() * sizeof(uint32_t));
+		uint64_t prev = sizeof(header);
+		for (uint64_t at: index) {
+			if (at < prev)
+				return false;
+			prev = at;
+		}
+		if (index.back() > header.index || header.pool < header.index + index.size() * entry
+			|| header.pool > bytes.size() || header.pool_size > bytes.size() - header.pool)
+			return false;
+
+		pool = bytes.substr(header.pool, header.pool_size);
+		return MurmurHash3_x86_32(pool.data(), pool.size(), 0) == checks.back();
+	}
+
+	void AstReader::section(uint64_t from, uint64_t to, uint32_t check) {
+		const uint8_t *start = reinterpret_cast<const uint8_t *>(file->text().data());
+		at = start + from;
+		end = start + to;
+		last_offset = 0;
+		if (MurmurHash3_x86_32(at, to - from, 0) != check)
+			damaged();
+	}
+
+	uint8_t AstReader::byte() {
+		if (at == end)
+			damaged();
+		return *at++;
+	}
+
+	uint64_t AstReader::number() {
+		uint64_t v = 0;
+		for (unsigned shift = 0; shift < 64; shift += 7) {
+			uint8_t b = byte();
+			v |= static_cast<uint64_t>(b & 0x7f) << shift;
+			if ((b & 0x80) == 0)
+				return v;
+		}
+		damaged();
+	}
+
+	int64_t AstReader::signed_number() {
+		uint64_t v = number();
+		return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+	}
+
+	std::string_view AstReader::text() {
+		uint64_t size = number();
+		if (size == 0)
+			return {};
+		uint64_t offset = number();
+		if (offset > pool.size() || size > pool.size() - offset)
+			damaged();
+		return pool.substr(offset, size);
+	}
+
+	void AstReader::token(Token &tok) {
+		tok = Token();
+		tok.number = byte();
+		uint8_t mask = byte();
+		if (!(mask & TOKEN_NO_LOC)) {
+			int64_t offset = last_offset + signed_number();
+			if (offset < 0 || offset >= TokenLocation::NO_OFFSET)
+				damaged();
+			tok.loc.offset = last_offset = offset;
+		}
+		if (mask & TOKEN_NAME)
+			tok.name = number();
+		if (mask & TOKEN_WIDTH)
+			tok.width = byte();
+		if (mask & TOKEN_VALUE)
+			tok.value.i = signed_number();
+
+		uint64_t size, offset;
+		switch (mask >> TOKEN_TEXT_SHIFT) {
+			case TOKEN_TEXT_AT_LOC :
+			case TOKEN_TEXT_SOURCE :
+				size = number();
+				offset = (mask >> TOKEN_TEXT_SHIFT) == TOKEN_TEXT_AT_LOC ? tok.loc.offset : number();
+				if (offset > source.size() || size > source.size() - offset)
+					damaged();
+				tok.string = source.substr(offset, size);
+				break;
+			case TOKEN_TEXT_POOL :
+				tok.string = text();
+				break;
+			default:
+				break;
+		}
+	}
+
+	template<typename C>
+	void AstReader::tokens(C &toks) {
+		uint64_t count = number();
+		toks.clear();
+		for (uint64_t i = 0; i < count; i++)
+			token(toks.emplace_back());
+	}
+
+	template<typename T>
+	T *AstReader::ref(Kind kind, bool &fresh) {
+		fresh = false;
+		uint64_t r = number();
+		if (r == 0)
+			return nullptr;
+
+		std::vector<Object> &objects = in_body ? body_objects : decl_objects;
+		if (r == 1) {
+			T *obj = Arena::current().make<T>();
+			objects.push_back({obj, kind});
+			fresh = true;
+			return obj;
+		}
+
+		uint64_t i = r - 2;
+		const Object *obj = nullptr;
+		if (i < decl_objects.size())
+			obj = &decl_objects[i];
+		else if (in_body && i - decl_objects.size() < body_objects.size())
+			obj = &body_objects[i - decl_objects.size()];
+		if (obj == nullptr || obj->kind != kind)
+			damaged();
+		return static_cast<T *>(obj->ptr);
+	}
+
+	void AstReader::type_specifier(TypeSpecifier &ts) {
+		tokens(ts.simple_type);
+		token(ts.record_type);
+	}
+
+	TypeInfo *AstReader::type_info() {
+		bool fresh;
+		TypeInfo *t = ref<TypeInfo>(Kind::TYPE_INFO, fresh);
+		if (!fresh)
+			return t;
+		t->type = static_cast<NodeType>(byte());
+		uint8_t f = byte();
+		t->is_const = f & 1;
+		t->is_global = f & 2;
+		t->is_extern = f & 4;
+		t->is_static = f & 8;
+		type_specifier(t->type_specifier);
+		return t;
+	}
+
+	RecordTypeInfo *AstReader::record_type_info() {
+		bool fresh;
+		RecordTypeInfo *t = ref<RecordTypeInfo>(Kind::RECORD_TYPE_INFO, fresh);
+		if (!fresh)
+			return t;
+		t->type = static_cast<NodeType>(byte());
+		uint8_t f = byte();
+		t->is_const = f & 1;
+		t->is_ptr = f & 2;
+		t->ptr_oprtr_count = signed_number();
+		type_specifier(t->type_specifier);
+		return t;
+	}
+
+	SymbolInfo *AstReader::symbol_info() {
+		bool fresh;
+		SymbolInfo *s = ref<SymbolInfo>(Kind::SYMBOL_INFO, fresh);
+		if (!fresh)
+			return s;
+		s->symbol = text();
+		token(s->tok);
+		s->type_info = type_info();
+		uint8_t f = byte();
+		s->is_ptr = f & 1;
+		s->is_array = f & 2;
+		s->is_func_ptr = f & 4;
+		s->ptr_oprtr_count = signed_number();
+		s->ret_ptr_count = signed_number();
+		tokens(s->arr_dimension_list);
+		s->arr_init_list.resize(number());
+		for (auto &init: s->arr_init_list)
+			tokens(init);
+		uint64_t params = number();
+		for (uint64_t i = 0; i < params; i++)
+			s->func_ptr_params_list.push_back(record_type_info());
+		s->p_next = symbol_info();
+		return s;
+	}
+
+	FuncParamInfo *AstReader::func_param_info() {
+		bool fresh;
+		FuncParamInfo *p = ref<FuncParamInfo>(Kind::FUNC_PARAM_INFO, fresh);
+		if (!fresh)
+			return p;
+		p->type_info = type_info();
+		p->symbol_info = symbol_info();
+		return p;
+	}
+
+	FunctionInfo *AstReader::function_info() {
+		bool fresh;
+		FunctionInfo *f = ref<FunctionInfo>(Kind::FUNCTION_INFO, fresh);
+		if (!fresh)
+			return f;
+		f->func_name = text();
+		token(f->tok);
+		uint8_t fl = byte();
+		f->is_global = fl & 1;
+		f->is_extern = fl & 2;
+		f->ptr_oprtr_count = signed_number();
+		f->return_type = type_info();
+		uint64_t params = number();
+		for (uint64_t i = 0; i < params; i++)
+			f->param_list.push_back(func_param_info());
+		return f;
+	}
+
+	Node *AstReader::node() {
+		bool fresh;
+		Node *n = ref<Node>(Kind::NODE, fresh);
+		if (!fresh)
+			return n;
+		n->node_type = signed_number();
+		n->func_info = function_info();
+		if (byte())
+			locals(n);
+		return n;
+	}
+
+	void AstReader::locals(Node *n) {
+		for (SymbolInfo *&s: n->symbol_info)
+			s = symbol_info();
+		uint64_t count = number();
+		for (uint64_t i = 0; i < count; i++) {
+			NameId name = number();
+			n->ids[name] = symbol_info();
+		}
+	}
+
+	RecordNode *AstReader::record_node() {
+		bool fresh;
+		RecordNode *r = ref<RecordNode>(Kind::RECORD_NODE, fresh);
+		if (!fresh)
+			return r;
+		r->recordname = text();
+		token(r->recordtok);
+		uint8_t f = byte();
+		r->is_global = f & 1;
+		r->is_extern = f & 2;
+		r->symtab = node();
+		r->p_next = record_node();
+		return r;
+	}
+
+	NodeIndex AstReader::primary_expr() {
+		uint8_t f = byte();
+		if (f == 0)
+			return NO_NODE;
+		NodeIndex i = Tree::get_primary_expr_mem();
+		PrimaryExpression *e = Tree::primary_expr(i);
+		e->is_oprtr = f & 2;
+		e->is_id = f & 4;
+		e->oprtr_kind = f & 8 ? OperatorType::BINARY : OperatorType::UNARY;
+		token(e->tok);
+		e->id_info = symbol_info();
+		if (f & 16)
+			e->left = primary_expr();
+		if (f & 32)
+			e->right = primary_expr();
+		if (f & 64)
+			e->unary_node = primary_expr();
+		return i;
+	}
+
+	NodeIndex AstReader::id_expr() {
+		uint8_t f = byte();
+		if (f == 0)
+			return NO_NODE;
+		NodeIndex i = Tree::get_id_expr_mem();
+		IdentifierExpression *e = Tree::id_expr(i);
+		e->is_oprtr = f & 2;
+		e->is_id = f & 4;
+		e->is_subscript = f & 8;
+		e->is_ptr = f & 16;
+		token(e->tok);
+		e->id_info = symbol_info();
+		tokens(e->subscript);
+		e->ptr_oprtr_count = signed_number();
+		if (f & 32)
+			e->left = id_expr();
+		if (f & 64)
+			e->right = id_expr();
+		if (f & 128)
+			e->unary = id_expr();
+		return i;
+	}
+
+	SizeOfExpression *AstReader::sizeof_expr() {
+		if (!byte())
+			return nullptr;
+		SizeOfExpression *e = Tree::get_sizeof_expr_mem();
+		uint8_t f = byte();
+		e->is_simple_type = f & 1;
+		e->is_ptr = f & 2;
+		tokens(e->simple_type);
+		token(e->identifier);
+		e->ptr_oprtr_count = signed_number();
+		return e;
+	}
+
+	CastExpression *AstReader::cast_expr() {
+		if (!byte())
+			return nullptr;
+		CastExpression *e = Tree::get_cast_expr_mem();
+		e->is_simple_type = byte();
+		tokens(e->simple_type);
+		token(e->identifier);
+		e->ptr_oprtr_count = signed_number();
+		e->target = id_expr();
+		return e;
+	}
+
+	AssignmentExpression *AstReader::assgn_expr() {
+		if (!byte())
+			return nullptr;
+		AssignmentExpression *e = Tree::get_assgn_expr_mem();
+		token(e->tok);
+		e->id_expr = id_expr();
+		e->expression = expression();
+		return e;
+	}
+
+	CallExpression *AstReader::call_expr() {
+		if (!byte())
+			return nullptr;
+		CallExpression *e = Tree::get_func_call_expr_mem();
+		e->function = id_expr();
+		uint64_t count = number();
+		for (uint64_t i = 0; i < count; i++)
+			e->expression_list.push_back(expression());
+		return e;
+	}
+
+	Expression *AstReader::expression() {
+		uint8_t kind = byte();
+		if (kind == 0)
+			return nullptr;
+		Expression *e = Tree::get_expr_mem();
+		e->expr_kind = static_cast<ExpressionType>(kind - 1);
+		switch (e->expr_kind) {
+			case ExpressionType::PRIMARY_EXPR :
+				e->primary_expr = primary_expr();
+				break;
+			case ExpressionType::ASSGN_EXPR :
+				e->assgn_expr = assgn_expr();
+				break;
+			case ExpressionType::SIZEOF_EXPR :
+				e->sizeof_expr = sizeof_expr();
+				break;
+			case ExpressionType::CAST_EXPR :
+				e->cast_expr = cast_expr();
+				break;
+			case ExpressionType::ID_EXPR :
+				e->id_expr = id_expr();
+				break;
+			case ExpressionType::FUNC_CALL_EXPR :
+				e->call_expr = call_expr();
+				break;
+			default:
+				damaged();
+		}
+		return e;
+	}
+
+	AsmOperand *AstReader::asm_operand() {
+		if (!byte())
+			return nullptr;
+		AsmOperand *op = Tree::get_asm_operand_mem();
+		token(op->constraint);
+		op->expression = expression();
+		return op;
+	}
+
+	AsmStatement *AstReader::asm_statement() {
+		AsmStatement *head = nullptr;
+		uint64_t count = number();
+		for (uint64_t i = 0; i < count; i++) {
+			AsmStatement *a = Tree::get_asm_stmt_mem();
+			token(a->asm_template);
+			uint64_t ops = number();
+			for (uint64_t j = 0; j < ops; j++)
+				a->output_operand.push_back(asm_operand());
+			ops = number();
+			for (uint64_t j = 0; j < ops; j++)
+				a->input_operand.push_back(asm_operand());
+			Tree::add_asm_statement(&head, &a);
+		}
+		return head;
+	}
+
+	Statement *AstReader::statement() {
+		Statement *stmt = Tree::get_stmt_mem();
+		stmt->type = static_cast<StatementType>(byte());
+		switch (stmt->type) {
+			case StatementType::LABEL :
+				if (byte()) {
+					stmt->labled_statement = Tree::get_label_stmt_mem();
+					token(stmt->labled_statement->label);
+				}
+				break;
+
+			case StatementType::EXPR :
+				if (byte()) {
+					stmt->expression_statement = Tree::get_expr_stmt_mem();
+					stmt->expression_statement->expression = expression();
+				}
+				break;
+
+			case StatementType::SELECT :
+				if (byte()) {
+					SelectStatement *sel = Tree::get_select_stmt_mem();
+					token(sel->iftok);
+					token(sel->elsetok);
+					sel->condition = expression();
+					sel->if_statement = statements();
+					sel->else_statement = statements();
+					stmt->selection_statement = sel;
+				}
+				break;
+
+			case StatementType::ITER :
+				if (byte()) {
+					IterationStatement *iter = Tree::get_iter_stmt_mem();
+					iter->type = static_cast<IterationType>(byte());
+					token(iter->_while.whiletok);
+					iter->_while.condition = expression();
+					iter->_while.statement = statements();
+					token(iter->_dowhile.dotok);
+					token(iter->_dowhile.whiletok);
+					iter->_dowhile.condition = expression();
+					iter->_dowhile.statement = statements();
+					token(iter->_for.fortok);
+					iter->_for.init_expr = expression();
+					iter->_for.condition = expression();
+					iter->_for.update_expr = expression();
+					iter->_for.statement = statements();
+					stmt->iteration_statement = iter;
+				}
+				break;
+
+			case StatementType::JUMP :
+				if (byte()) {
+					JumpStatement *jmp = Tree::get_jump_stmt_mem();
+					jmp->type = static_cast<JumpType>(byte());
+					token(jmp->tok);
+					jmp->expression = expression();
+					token(jmp->goto_id);
+					stmt->jump_statement = jmp;
+				}
+				break;
+
+			case StatementType::ASM :
+				stmt->asm_statement = asm_statement();
+				break;
+
+			case StatementType::DECL :
+				break;
+
+			default:
+				damaged();
+		}
+		return stmt;
+	}
+
+	Statement *AstReader::statements() {
+		Statement *head = nullptr;
+		Statement *last = nullptr;
+		uint64_t count = number();
+		for (uint64_t i = 0; i < count; i++) {
+			Statement *stmt = statement();
+			stmt->p_prev = last;
+			if (last != nullptr)
+				last->p_next = stmt;
+			else
+				head = stmt;
+			last = stmt;
+		}
+		return head;
+	}
+
+	void AstReader::load_declarations() {
+		section(sizeof(AstHeader), index[0], checks[0]);
+		decl_objects.clear();
+		in_body = false;
+
+		// the names get the ids they had, the lexer of this compilation
+		// hasn't handed out any
+		uint64_t count = number();
+		for (uint64_t i = 1; i < count; i++) {
+			if (comp->names.intern(text()) != i)
+				damaged();
+		}
+
+		comp->symtab = node();
+		if (comp->symtab == nullptr)
+			damaged();
+
+		comp->record_table = SymbolTable::get_record_symtab_mem();
+		for (RecordNode *&r: comp->record_table->recordinfo)
+			r = record_node();
+		count = number();
+		for (uint64_t i = 0; i < count; i++) {
+			NameId name = number();
+			comp->record_table->ids[name] = record_node();
+		}
+
+		comp->func_table = SymbolTable::get_func_table_mem();
+		count = number();
+		for (uint64_t i = 0; i < count; i++) {
+			NameId name = number();
+			(*comp->func_table)[name] = function_info();
+		}
+
+		comp->ast = nullptr;
+		bodies.clear();
+		TreeNode *last = nullptr;
+		count = number();
+		for (uint64_t i = 0; i < count; i++) {
+			TreeNode *n = Arena::current().make<TreeNode>();
+			if (byte()) {
+				n->symtab = node();
+				if (n->symtab == nullptr)
+					damaged();
+				bodies.push_back(n);
+			}
+			else {
+				n->statement = statements();
+			}
+			n->p_prev = last;
+			if (last != nullptr)
+				last->p_next = n;
+			else
+				comp->ast = n;
+			last = n;
+		}
+
+		if (at != end || bodies.size() != index.size() - 1)
+			damaged();
+	}
+
+	void AstReader::load_body(size_t i) {
+		section(index[i], index[i + 1], checks[i + 1]);
+		body_objects.clear();
+		in_body = true;
+		locals(bodies[i]->symtab);
+		bodies[i]->statement = statements();
+		in_body = false;
+		if (at != end)
+			damaged();
+	}
+}
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "tree.hpp"
+#include "source.hpp"
+
+namespace xlang {
+
+	class Compiler;
+
+	// the analyzed tree and symbol tables of a file (--emit-ast), so a
+	// later compilation of the same source with other code generation
+	// options can start at the optimizer (--load-ast)
+	//
+	// the file is:
+	//
+	//   AstHeader
+	//   declarations: the names, globals, records, functions and the
+	//                 tree nodes, with the bodies of functions left out
+	//   bodies:       the locals and statements of each function
+	//   index:        where each body starts and where the last ends,
+	//                 then a MurmurHash3 of the declarations, each body
+	//                 and the pool, a section is checked when it is read
+	//   pool:         text that isn't in the source
+	//
+	// numbers are LEB128, a pointer is written the first time it is met
+	// and as the index of it after that so shared symbols stay shared.
+	// token text is a place in the source or in the pool, the source is
+	// mapped and the file too, the tokens point into them
+	//
+	// it is only read back with the same source and the same version of
+	// the compiler, any other one is out of date
+
+	struct AstHeader {
+		static constexpr char MAGIC[8] = {'x', 'l', 'a', 'n', 'g', 'a', 's', 't'};
+		static constexpr uint32_t VERSION = 1;
+
+		char magic[8];
+		uint32_t version;
+		uint32_t body_count;
+		uint64_t source_hash[2];   // of the source and the compiler version
+		uint64_t source_size;
+		uint64_t index;            // body_count + 1 offsets, body_count + 2 checks
+		uint64_t pool;
+		uint64_t pool_size;
+	};
+
+	class AstWriter {
+	public:
+
+		explicit AstWriter(Compiler *c) : comp(c) {}
+
+		// the tree of comp, after analysis and before it is optimized.
+		// false if the file can't be written
+		bool write(const std::string &path);
+
+	private:
+
+		Compiler *comp;
+		std::string_view source;
+		std::string out;
+		std::string pool;
+		std::unordered_map<std::string, uint32_t> pooled;
+
+		// index of each pointer written, bodies add to the ones of the
+		// declarations and forget theirs when they are done
+		std::unordered_map<const void *, uint32_t> decl_refs;
+		std::unordered_map<const void *, uint32_t> body_refs;
+		bool in_body{false};
+
+		// tokens are written where they are from the one before, each
+		// body starts again at 0 so it can be read alone
+		int64_t last_offset{0};
+
+		void number(uint64_t);
+
+		void signed_number(int64_t);
+
+		void byte(uint8_t v) {
+			out.push_back(static_cast<char>(v));
+		}
+
+		void text(std::string_view);
+
+		void token(const Token &);
+
+		template<typename C>
+		void tokens(const C &);
+
+		// true if p still has to be written after it
+		bool ref(const void *p);
+
+		void type_specifier(const TypeSpecifier &);
+
+		void type_info(TypeInfo *);
+
+		void record_type_info(RecordTypeInfo *);
+
+		void symbol_info(SymbolInfo *);
+
+		void func_param_info(FuncParamInfo *);
+
+		void function_info(FunctionInfo *);
+
+		void node(Node *, bool locals);
+
+		void locals(Node *);
+
+		void record_node(RecordNode *);
+
+		void primary_expr(NodeIndex);
+
+		void id_expr(NodeIndex);
+
+		void sizeof_expr(SizeOfExpression *);
+
+		void cast_expr(CastExpression *);
+
+		void assgn_expr(AssignmentExpression *);
+
+		void call_expr(CallExpression *);
+
+		void expression(Expression *);
+
+		void asm_operand(AsmOperand *);
+
+		void asm_statement(AsmStatement *);
+
+		void statement(Statement *);
+
+		void statements(Statement *);
+
+		void declarations();
+	};
+
+	class AstReader {
+	public:
+
+		explicit AstReader(Compiler *c) : comp(c) {}
+
+		// maps the file, false if there is none or it was written for
+		// another source or compiler
+		bool open(const std::string &path);
+
+		// the names, tables and tree nodes of comp, the bodies of
+		// functions are left empty. it can be done again, the tree made
+		// before stays in the arena unused
+		void load_declarations();
+
+		size_t body_count() const {
+			return bodies.size();
+		}
+
+		TreeNode *body(size_t i) const {
+			return bodies[i];
+		}
+
+		// the locals and statements of a function, in the arena of
+		// the thread
+		void load_body(size_t);
+
+	private:
+
+		// kinds of objects a pointer can be to, a reference to an index
+		// of another kind is a damaged file
+		enum class Kind : uint8_t {
+			TYPE_INFO,
+			RECORD_TYPE_INFO,
+			SYMBOL_INFO,
+			FUNC_PARAM_INFO,
+			FUNCTION_INFO,
+			NODE,
+			RECORD_NODE
+		};
+
+		struct Object {
+			void *ptr;
+			Kind kind;
+		};
+
+		Compiler *comp;
+		std::string path;
+		std::shared_ptr<SourceBuffer> file;
+		std::string_view source;
+		std::string_view pool;
+		std::vector<uint64_t> index;
+		std::vector<uint32_t> checks;
+		std::vector<TreeNode *> bodies;
+
+		// decoding, at is where the next byte is read, end where the
+		// section being read ends
+		const uint8_t *at{nullptr};
+		const uint8_t *end{nullptr};
+		std::vector<Object> decl_objects;
+		std::vector<Object> body_objects;
+		bool in_body{false};
+		int64_t last_offset{0};
+
+		[[noreturn]] void damaged();
+
+		void section(uint64_t from, uint64_t to, uint32_t check);
+
+		uint64_t number();
+
+		int64_t signed_number();
+
+		uint8_t byte();
+
+		std::string_view text();
+
+		void token(Token &);
+
+		template<typename C>
+		void tokens(C &);
+
+		// the object an index is to or nullptr, made and kept if new
+		template<typename T>
+		T *ref(Kind, bool &fresh);
+
+		void type_specifier(TypeSpecifier &);
+
+		TypeInfo *type_info();
+
+		RecordTypeInfo *record_type_info();
+
+		SymbolInfo *symbol_info();
+
+		FuncParamInfo *func_param_info();
+
+		FunctionInfo *function_info();
+
+		Node *node();
+
+		void locals(Node *);
+
+		RecordNode *record_node();
+
+		NodeIndex primary_expr();
+
+		NodeIndex id_expr();
+
+		SizeOfExpression *sizeof_expr();
+
+		CastExpression *cast_expr();
+
+		AssignmentExpression *assgn_expr();
+
+		CallExpression *call_expr();
+
+		Expression *expression();
+
+		AsmOperand *asm_operand();
+
+		AsmStatement *asm_statement();
+
+		Statement *statement();
+
+		Statement *statements();
+	};
+}
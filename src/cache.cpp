@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+#include "cache.hpp"
+#include "murmurhash3.hpp"
+#include "log.hpp"
+
+namespace xlang {
+
+	namespace fs = std::filesystem;
+
+	std::string Cache::key(const GlobalConfig &global) {
+
+		// source bytes as they are on disk, followed by whatever
+		// changes the generated code
+
+		std::ifstream input(global.file.path, std::ios::in | std::ios::binary);
+		if (!input.is_open())
+			return "";
+
+		std::ostringstream buf;
+		buf << input.rdbuf();
+		buf << '\0' << "xlang " << VERSION
+			<< " x64=" << global.x64
+			<< " optimize=" << global.optimize
+			<< " omit_frame_pointer=" << global.omit_frame_pointer
+			<< " use_cstdlib=" << global.use_cstdlib
+			<< " use_nasm=" << global.use_nasm
+			<< " stream=" << global.stream;
+
+		std::string bytes = buf.str();
+		uint64_t hash[2];
+		MurmurHash3_x64_128(bytes.data(), bytes.size(), 0, hash);
+
+		std::ostringstream name;
+		name << std::hex << std::setfill('0') << std::setw(16) << hash[0] << std::setw(16) << hash[1];
+		return name.str();
+	}
+
+	bool Cache::copy(const std::string &from, const std::string &to) {
+
+		// copy next to the destination and rename, readers never see
+		// a half written file
+
+		std::ostringstream tmp;
+		tmp << to << ".tmp." << getpid() << "." << std::this_thread::get_id();
+
+		std::error_code ec;
+		fs::copy_file(from, tmp.str(), fs::copy_options::overwrite_existing, ec);
+		if (!ec)
+			fs::rename(tmp.str(), to, ec);
+		if (ec) {
+			fs::remove(tmp.str(), ec);
+			return false;
+		}
+		return true;
+	}
+
+	bool Cache::fetch(GlobalConfig &global, const std::string &key) {
+		fs::path entry = fs::path(global.cache_dir) / key;
+		std::string source = global.file.name;
+		bool need_obj = global.assemble;
+		bool need_asm = !global.assemble || !global.remove_asmfile;
+		std::error_code ec;
+
+		if ((need_obj && !fs::exists(entry.string() + ".o", ec)) || (need_asm && !fs::exists(entry.string() + ".asm", ec))) {
+			misses++;
+			if (global.log_level >= LOG_VERBOSE)
+				Log::line("cache miss: ", source, " ", key);
+			return false;
+		}
+
+		if ((need_obj && !copy(entry.string() + ".o", global.file.object_name()))
+			|| (need_asm && !copy(entry.string() + ".asm", global.file.asm_name()))) {
+			misses++;
+			return false;
+		}
+
+		hits++;
+		if (global.log_level >= LOG_VERBOSE)
+			Log::line("cache hit: ", source, " ", key);
+		return true;
+	}
+
+	void Cache::store(GlobalConfig &global, const std::string &key) {
+		fs::path entry = fs::path(global.cache_dir) / key;
+		std::error_code ec;
+
+		fs::create_directories(global.cache_dir, ec);
+		if (ec) {
+			if (global.log_level >= LOG_VERBOSE)
+				Log::line("cache: can't create ", global.cache_dir, ": ", ec.message());
+			return;
+		}
+
+		bool stored = false;
+		if (global.assemble && fs::exists(global.file.object_name(), ec))
+			stored |= copy(global.file.object_name(), entry.string() + ".o");
+		if ((!global.assemble || !global.remove_asmfile) && fs::exists(global.file.asm_name(), ec))
+			stored |= copy(global.file.asm_name(), entry.string() + ".asm");
+
+		if (stored)
+			stores++;
+	}
+
+	void Cache::print_stats() {
+		unsigned h = hits, m = misses;
+		Log::line("cache: ", h, " hits, ", m, " misses, ", stores.load(), " stored",
+				  (h + m > 0 ? " (" + std::to_string(100 * h / (h + m)) + "% hit rate)" : ""));
+	}
+
+	void Cache::reset_stats() {
+		hits = 0;
+		misses = 0;
+		stores = 0;
+	}
+}
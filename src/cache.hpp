@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <string>
+#include <atomic>
+#include "global.hpp"
+
+namespace xlang {
+
+	// on disk cache of compiler output (--cache-dir)
+	//
+	// an entry is named by the hash of everything that decides the output:
+	// source bytes, code generation options and the compiler version.
+	// entries are written to a temporary file and renamed into place so
+	// parallel jobs and other xlang processes can share one directory
+
+	class Cache {
+	public:
+		static std::string key(const GlobalConfig &);
+
+		static bool fetch(GlobalConfig &, const std::string &);
+
+		static void store(GlobalConfig &, const std::string &);
+
+		static void print_stats();
+
+		static void reset_stats();
+
+	private:
+		static inline std::atomic<unsigned> hits{0};
+		static inline std::atomic<unsigned> misses{0};
+		static inline std::atomic<unsigned> stores{0};
+
+		static bool copy(const std::string &, const std::string &);
+	};
+}
@@ -7,69 +7,170 @@
 
 #include "compiler.hpp"
 #include "log.hpp"
+#include "cache.hpp"
+#include "process.hpp"
 
-#include <sys/wait.h>
+#include <cerrno>
 #include <cstring>
 #include <cstdio>
-#include <iostream>
-#include <memory>
-#include <stdexcept>
-#include <unistd.h>
-#include <array>
+#include <sstream>
+#include <algorithm>
+#include <iterator>
+#include <filesystem>
 
 namespace xlang {
 	
-	Lexer *Compiler::lex{nullptr};
-	Parser *Compiler::parser{nullptr};
-	Analyzer *Compiler::an{nullptr};
-	CodeGen *Compiler::generator{nullptr};
-	TreeNode *Compiler::ast{nullptr};
-	Node *Compiler::symtab{nullptr};
-	RecordSymtab *Compiler::record_table{nullptr};
-	FunctionMap *Compiler::func_table{nullptr};
-    RecordNode *Compiler::last_rec_node{nullptr};
-	SymbolInfo *Compiler::last_symbol{nullptr};
-
-	int Compiler::run() {
-
-        bool res = false;
-		if (global.compile)
-			res = compile();
-		
-		if (res && global.assemble)
-			res = assemble();
-		
-        if (res && global.link)
-		    res =link();
-		
-        if(!res)
-            return 1;
+	Compiler::~Compiler() {
+		delete generator;
+		delete an;
+		delete parser;
+		delete lex;
+		delete ast_reader;
+	}
 
-		if(global.remove_asmfile)
-			remove(global.file.asm_name().c_str());
-		
-		if(global.remove_objfile)
-		    remove(global.file.object_name().c_str());
-		
-		Tree::delete_tree(&ast);
-		SymbolTable::delete_node(&symtab);
-		SymbolTable::delete_record_symtab(&record_table);
-		return 0;
+	std::string Compiler::node_name(TreeNode *node) {
+		if (node->symtab != nullptr && node->symtab->func_info != nullptr)
+			return node->symtab->func_info->func_name;
+		return "global";
+	}
+
+	int Compiler::run(std::ostream &out) {
+
+		// everything logged while this compilation runs on this thread
+		// ends up in out, errors unwind back to here
+
+		std::ostream *prev_out = Log::out;
+		int prev_level = Log::level;
+		const SourceBuffer *prev_source = Log::source;
+		Arena *prev_arena = Arena::active;
+		TreePools *prev_pools = TreePools::active;
+		Log::out = &out;
+		Arena::active = &arena;
+		TreePools::active = &pools;
+		Log::level = global.log_level;
+
+		std::string source = global.file.name;
+		stats.enabled = global.time_passes || global.mem_stats || !global.stats_file.empty();
+		trace.enabled = !global.trace_file.empty();
+
+		int status = 0;
+		try {
+			bool res = false;
+			bool cached = false;
+			if (!global.in_memory && !check_outputs())
+				throw CompileError();
+
+			std::string key;
+			if (global.compile && !global.cache_dir.empty() && !global.in_memory) {
+				StatsScope scope(stats, "cache");
+				TraceScope span(trace, "cache", "pass");
+				key = Cache::key(global);
+				cached = !key.empty() && Cache::fetch(global, key);
+			}
+
+			if (cached) {
+				res = true;
+				object_written = global.assemble;
+			}
+			else {
+				if (global.compile)
+					res = compile();
+
+				if (res && global.assemble) {
+					StatsScope scope(stats, "assemble", true);
+					TraceScope span(trace, "assemble", "pass");
+					res = assemble();
+				}
+
+				if (res && !key.empty()) {
+					StatsScope scope(stats, "cache");
+					TraceScope span(trace, "cache", "pass");
+					Cache::store(global, key);
+				}
+			}
+			
+			if (res && global.link && !global.in_memory && global.compile && !object_written) {
+				Log::line(global.file.name, ": no code to link");
+				res = false;
+			}
+
+			if (res && global.link && !global.in_memory) {
+				StatsScope scope(stats, "link", true);
+				TraceScope span(trace, "link", "pass");
+				res = link();
+			}
+			
+			if (!res) {
+				status = 1;
+			}
+			else if (!global.in_memory) {
+				if (global.remove_asmfile)
+					remove(global.file.asm_name().c_str());
+				
+				if (global.remove_objfile)
+					remove(global.file.object_name().c_str());
+			}
+		}
+		catch (const CompileError &) {
+			status = -1;
+		}
+
+		if (global.time_passes)
+			stats.print_times(out, source);
+		if (global.mem_stats) {
+			stats.print_memory(out, source);
+			out << "  tree and symbol tables: " << arena.used() << " bytes in " << arena.block_count() << " arena blocks\n";
+			out << "  expression node pools: " << pools.primary.used() + pools.id.used() << " bytes for "
+				<< pools.primary.size() - 1 << " primary and " << pools.id.size() - 1 << " identifier expressions\n";
+		}
+
+		Log::out = prev_out;
+		Log::level = prev_level;
+		Log::source = prev_source;
+		Arena::active = prev_arena;
+		TreePools::active = prev_pools;
+		return status;
 	}
 	
+	bool Compiler::check_outputs() {
+
+		// a source without an extension, or named like an output, would
+		// be written over or linked over
+
+		std::vector<std::string> outputs = {global.file.asm_name(), global.file.object_name()};
+		if (global.link)
+			outputs.push_back(global.file.exe_name());
+		if (global.emit_ast)
+			outputs.push_back(std::filesystem::path(global.file.path).replace_extension(".ast"));
+
+		for (auto &output: outputs) {
+			std::error_code ec;
+			if (std::filesystem::equivalent(output, global.file.path, ec)) {
+				Log::line(global.file.name, ": output ", output, " is the source file");
+				return false;
+			}
+		}
+		return true;
+	}
+
 	bool Compiler::assemble() {
-		
-		std::string asm_cmd = "nasm ";
-        
-        if(global.x64)
-            asm_cmd += "-f elf64 ";
-        else 
-            asm_cmd += "-f elf32 ";
 
-        asm_cmd += global.file.asm_name();
+		// the object file is already written unless code generation
+		// needed nasm for it
+
+		if (!global.use_nasm)
+			return true;
+
+		if (global.in_memory) {
+			Log::line(global.file.name, ": can't be assembled in memory, the built-in encoder doesn't support it");
+			return false;
+		}
+		
+		std::vector<std::string> args = {"nasm", "-f", global.x64 ? "elf64" : "elf32", global.file.asm_name()};
 
-        //std::cout << "asm: " << assembler <<"\n";
-        return execute(asm_cmd);
+		TraceScope span(trace, "nasm", "subprocess");
+		object_written = execute(args);
+		return object_written;
 	}
 	
 	
@@ -77,28 +178,23 @@ namespace xlang {
 		
         //	link the compiled and assembled object file with GCC.
 
-        std::vector<std::string> opts;
-		std::string outputfile = global.file.name;
+		std::string outputfile = global.file.exe_name();
 
-        size_t fnd = global.file.object_name().find_last_of('/');
-		if (fnd != std::string::npos) 
-			outputfile = global.file.object_name().substr(0, fnd) + "/" + outputfile;
+		std::vector<std::string> args = {"gcc"};
 
-        std::string link_cmd = "gcc ";
+		if (!global.x64 && X64_HOST)
+			args.emplace_back("-m32");
 
-        if(!global.x64 && X64_HOST)
-            link_cmd+= "-m32 ";
+		if (!global.use_cstdlib) 
+			args.emplace_back("-nostdlib");
 
-        if (!global.use_cstdlib) 
-            link_cmd += "-nostdlib ";
+		args.emplace_back("-no-pie");
+		args.push_back(global.file.object_name());
+		args.emplace_back("-o");
+		args.push_back(outputfile);
 
-        link_cmd += "-no-pie ";
-        link_cmd += global.file.object_name(); 
-        link_cmd += " -o ";
-        link_cmd += outputfile.c_str();
-
-        //std::cout << "link: " << link_cmd <<"\n";
-        return execute(link_cmd);
+		TraceScope span(trace, "gcc", "subprocess");
+		return execute(args);
 	}
 
 	bool Compiler::compile() {
@@ -111,40 +207,85 @@ namespace xlang {
         //          optimizer  -> 
         //              code generation!
 
-		lex = new Lexer(global.file);
-		lex->init();
+		if (global.load_ast) {
+			StatsScope scope(stats, "load-ast");
+			TraceScope span(trace, "load-ast", "pass");
+			open_ast();
+		}
 
-		parser = new Parser();	
-		ast = parser->parse();
-		
-		if (global.error_count > 0) 
-			return false;
-		
-		an = new Analyzer();
-		an->analyze(&ast); 
-		
-		if (!error_count()) {
-			delete an;
-			delete parser;
-			delete lex;
-			return false;
+		// --stream doesn't keep the tree, printing it or writing it out
+		// takes the usual way
+		bool print = global.print_tree || global.print_symtab || global.print_record_symtab;
+		bool emit = global.emit_ast && ast_reader == nullptr;
+		if (global.stream && !print && !emit && compile_stream())
+			return true;
+
+		if (ast_reader != nullptr) {
+			StatsScope scope(stats, "load-ast");
+			TraceScope span(trace, "load-ast", "pass");
+			ast_reader->load_declarations();
+			for (size_t i = 0; i < ast_reader->body_count(); i++)
+				ast_reader->load_body(i);
+		}
+		else {
+			lex = new Lexer(global.file);
+			lex->stats = &stats;
+			lex->names = &names;
+			{
+				StatsScope scope(stats, "lex");
+				TraceScope span(trace, "lex", "pass");
+				lex->init();
+				if (global.lex_threads > 0)
+					lex->run_ahead(global.lex_threads);
+			}
+
+			parser = new Parser(this);
+			{
+				StatsScope scope(stats, "parse");
+				TraceScope span(trace, "parse", "pass");
+				ast = parser->parse();
+			}
+
+			if (global.error_count > 0)
+				return false;
+
+			an = new Analyzer(this);
+			{
+				StatsScope scope(stats, "analyze");
+				TraceScope span(trace, "analyze", "pass");
+				an->analyze(&ast);
+			}
+
+			if (!error_count())
+				return false;
+
+			// before the optimizer changes it
+			if (emit) {
+				StatsScope scope(stats, "emit-ast");
+				TraceScope span(trace, "emit-ast", "pass");
+				std::string path = std::filesystem::path(global.file.path).replace_extension(".ast");
+				AstWriter writer(this);
+				if (!writer.write(path))
+					Log::line("can't write ", path);
+			}
 		}
 		
-		generator = new CodeGen();
+		generator = new CodeGen(this);
 		generator->get_code(&ast);
 		delete generator;
+		generator = nullptr;
 		
 		if (error_count() != 0) {
 			if (global.print_tree) {
-				std::cout << "file: " << global.file.name << std::endl;
+				Log::line("file: ", global.file.name);
 				ast->print();
 			}
 			if (global.print_symtab) {
-				std::cout << "file: " << global.file.name << std::endl;
+				Log::line("file: ", global.file.name);
 				symtab->print();
 			}
 			if (global.print_record_symtab) {
-				std::cout << "file: " << global.file.name << std::endl;
+				Log::line("file: ", global.file.name);
 				record_table->print();
 			}
 		}
@@ -152,43 +293,221 @@ namespace xlang {
 		return true;
 	}
 	
-	bool Compiler::error_count() {
-		if (global.error_count > 0) {
-			Tree::delete_tree(&ast);
-			SymbolTable::delete_node(&symtab);
-			SymbolTable::delete_record_symtab(&record_table);
+	bool Compiler::compile_stream() {
+
+		// the declarations and the heads of functions are parsed first,
+		// the bodies are skipped. then each function is parsed, analyzed,
+		// optimized and generated in an arena of its own, written out, and
+		// dropped when the next one starts. what stays is the declarations
+		// and the data section
+		//
+		// with --load-ast the declarations and each body are read from
+		// the file instead, they are analyzed already
+		//
+		// nothing is printed until the file is done. after an error, or a
+		// body that didn't end where it was skipped to, it is all dropped
+		// and the file is compiled again the usual way, so the messages
+		// are the ones without --stream
+
+		std::ostringstream messages;
+		std::ostream *out = Log::out;
+		Log::out = &messages;
+		Arena function_arena;
+		bool done = false;
+
+		// tree nodes of the bodies, in the order of the tree
+		auto body_count = [this]() {
+			return ast_reader != nullptr ? ast_reader->body_count() : parser->body_count();
+		};
+		auto body_node = [this](size_t i) {
+			return ast_reader != nullptr ? ast_reader->body(i) : parser->body(i);
+		};
+
+		try {
+			Optimizer optmz(this);
+			if (ast_reader != nullptr) {
+				StatsScope scope(stats, "load-ast");
+				TraceScope span(trace, "load-ast", "pass");
+				ast_reader->load_declarations();
+			}
+			else {
+				lex = new Lexer(global.file);
+				lex->stats = &stats;
+				lex->names = &names;
+				{
+					StatsScope scope(stats, "lex");
+					TraceScope span(trace, "lex", "pass");
+					lex->init();
+					if (global.lex_threads > 0)
+						lex->run_ahead(global.lex_threads);
+				}
+
+				parser = new Parser(this);
+				{
+					StatsScope scope(stats, "parse");
+					TraceScope span(trace, "parse", "pass");
+					ast = parser->parse_declarations();
+				}
+
+				// the bodies are left for the loop below, the rest is all
+				// there before the global declarations are generated
+
+				an = new Analyzer(this);
+				StatsScope scope(stats, "analyze");
+				TraceScope span(trace, "analyze", "pass");
+				an->analyze_declarations(&ast);
+				size_t body = 0;
+				for (TreeNode *node = ast; node != nullptr; node = node->p_next) {
+					if (body < body_count() && node == body_node(body))
+						body++;
+					else
+						an->analyze_node(node);
+				}
+			}
+			if (global.optimize) {
+				StatsScope scope(stats, "optimize");
+				size_t body = 0;
+				for (TreeNode *node = ast; node != nullptr; node = node->p_next) {
+					if (body < body_count() && node == body_node(body))
+						body++;
+					else
+						optmz.optimize_function(node);
+				}
+			}
+
+			generator = new CodeGen(this);
+			{
+				StatsScope scope(stats, "codegen");
+				generator->begin_stream(&ast);
+			}
+
+			done = true;
+			size_t body = 0;
+			TreeNode *last = nullptr;
+			TreePools::Mark body_mark = pools.mark();
+			for (TreeNode *node = ast; node != nullptr && done; node = node->p_next) {
+				if (body < body_count() && node == body_node(body)) {
+					if (last != nullptr) {
+						// its statements and locals go with the arena
+						last->statement = nullptr;
+						std::fill(std::begin(last->symtab->symbol_info), std::end(last->symtab->symbol_info), nullptr);
+						std::unordered_map<NameId, SymbolInfo *>().swap(last->symtab->ids);
+					}
+					last = node;
+					Arena::active = &arena;
+					function_arena.reset();
+					pools.truncate(body_mark);
+					Arena::active = &function_arena;
+
+					if (ast_reader != nullptr) {
+						StatsScope scope(stats, "load-ast");
+						TraceScope span(trace, Compiler::node_name(node), "load-ast");
+						ast_reader->load_body(body++);
+					}
+					else {
+						{
+							StatsScope scope(stats, "parse");
+							TraceScope span(trace, Compiler::node_name(node), "parse");
+							done = parser->parse_body(body++);
+						}
+						if (!done)
+							break;
+						StatsScope scope(stats, "analyze");
+						an->analyze_node(node);
+					}
+					if (global.optimize) {
+						StatsScope scope(stats, "optimize");
+						optmz.optimize_function(node);
+					}
+				}
+				StatsScope scope(stats, "codegen");
+				generator->stream_node(node);
+			}
+
+			if (done) {
+				StatsScope scope(stats, "codegen");
+				generator->end_stream();
+			}
+		}
+		catch (const CompileError &) {
+			done = false;
+		}
+
+		Arena::active = &arena;
+		Log::out = out;
+		bool wrote_asm = generator != nullptr && !global.in_memory;
+		delete generator;
+		delete an;
+		delete parser;
+		delete lex;
+		generator = nullptr;
+		an = nullptr;
+		parser = nullptr;
+		lex = nullptr;
+
+		if (done) {
+			*Log::out << messages.str();
+			return true;
+		}
+
+		// what was made so far stays in the arena, unused
+		if (wrote_asm)
+			remove(global.file.asm_name().c_str());
+		ast = nullptr;
+		return false;
+	}
+	
+	bool Compiler::open_ast() {
+
+		// the source is mapped here to check it is the one the tree is
+		// of, the lexer reports it if it can't be
+		if (!global.file.buffer)
+			global.file.buffer = SourceBuffer::map(global.file.path);
+		if (!global.file.buffer)
 			return false;
+		Log::source = global.file.buffer.get();
+
+		std::string path = std::filesystem::path(global.file.path).replace_extension(".ast");
+		ast_reader = new AstReader(this);
+		if (ast_reader->open(path)) {
+			if (global.log_level >= LOG_VERBOSE)
+				Log::line("loading ", path);
+			return true;
 		}
+
+		if (global.log_level >= LOG_VERBOSE)
+			Log::line(path, " is missing or out of date");
+		delete ast_reader;
+		ast_reader = nullptr;
+		return false;
+	}
+	
+	bool Compiler::error_count() {
+		if (global.error_count > 0)
+			return false;
 		
 		return true;
 	}
 
-    bool Compiler::execute(std::string cmd)
-    {
-        int status = 0;
-        auto pp = ::popen(cmd.c_str(), "r");
-
-        if(pp == nullptr) {
-           std::cerr << "couldn't execute, failed to open pipe\n";
-           return false;
-        }
+	bool Compiler::execute(const std::vector<std::string> &args) {
 
-        std::array<char, 256> buffer;
-        std::string result;
+		// messages of the tool go to the output of this compilation,
+		// stdout first, then stderr
 
-        while(not std::feof(pp)) {
-            auto bytes = std::fread(buffer.data(), 1, buffer.size(), pp);
-            result.append(buffer.data(), bytes);
-        }
+		if (global.log_level >= LOG_VERBOSE)
+			Log::line(Process::command_line(args));
 
-        if(!result.empty())
-            std::cout << result;
+		ProcessResult result;
+		if (!Process::run(args, result)) {
+			Log::line("couldn't run ", args[0], ": ", std::strerror(errno));
+			return false;
+		}
 
-        auto rc = ::pclose(pp);
-        if(WIFEXITED(rc))
-            status = WEXITSTATUS(rc);
+		*Log::out << result.out << result.err;
 
-        return (status == 0 ? true:false);
-    }
+		if (result.signal != 0)
+			Log::line(args[0], " killed by signal ", result.signal);
 
+		return result.status == 0;
+	}
 }
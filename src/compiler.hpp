@@ -13,42 +13,94 @@
 #include "analyze.hpp"
 #include "gen.hpp"
 #include "types.hpp"
+#include "stats.hpp"
+#include "trace.hpp"
+#include "arena.hpp"
+#include "ast.hpp"
 
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
 
 namespace xlang {
 
 	// this class tries to hold everything to keep a somewhat organized mess
+	//
+	// one instance is one compilation of one source file, nothing in here
+	// is shared so several of them can run on different threads
 	
 	class Compiler {
 	public:
 		
-		~Compiler() = default;
+		explicit Compiler(GlobalConfig cfg) : global(std::move(cfg)) {}
 		
-		static GlobalConfig global;
+		~Compiler();
 		
-		static Lexer *lex;
-		static Parser *parser;
-		static Analyzer *an;
-		static CodeGen *generator;
-		static TreeNode *ast;
-		static Node *symtab;
-		static RecordSymtab *record_table;
-		static FunctionMap *func_table;
-        static RecordNode *last_rec_node;
-	    static SymbolInfo *last_symbol;
+		Compiler(const Compiler &) = delete;
+		
+		Compiler &operator=(const Compiler &) = delete;
+		
+		GlobalConfig global;
+
+		// the tree and symbol tables below are made in it and go with it
+		Arena arena;
+
+		// and the expression nodes in these
+		TreePools pools;
+		
+		Lexer *lex{nullptr};
+		Parser *parser{nullptr};
+		Analyzer *an{nullptr};
+		CodeGen *generator{nullptr};
+		AstReader *ast_reader{nullptr};    // --load-ast, when the file is up to date
+		TreeNode *ast{nullptr};
+		Node *symtab{nullptr};
+		RecordSymtab *record_table{nullptr};
+		FunctionMap *func_table{nullptr};
+		Interner names;
+		Stats stats;
+		Trace trace;
+
+		// output of an in memory compilation (GlobalConfig::in_memory)
+		std::string assembly;
+		std::vector<uint8_t> object;
 
-		static int run();
+		// an object file was written by this run, link() has nothing
+		// to do without one unless only linking was asked for
+		bool object_written{false};
+
+		// text for tokens made after lexing (folded constants), it
+		// lives as long as the source buffer the other tokens point into
+		std::string_view keep(std::string text) { return global.file.buffer->keep(std::move(text)); }
+
+		// trace span name of a top level tree node
+		static std::string node_name(TreeNode *);
+
+		// diagnostics and tool output of this compilation go to out
+		int run(std::ostream &out);
 		
-		static bool assemble();
+		// false if an output would be written over the source
+		bool check_outputs();
+
+		bool assemble();
 		
-		static bool link();
+		bool link();
 		
-		static bool compile();
+		bool compile();
+
+		// compile() with --stream, false if the file has to be compiled
+		// the usual way instead
+		bool compile_stream();
+
+		// --load-ast: sets ast_reader if the file of --emit-ast is there
+		// and was written for this source
+		bool open_ast();
 		
-		static bool error_count();
+		bool error_count();
 
-		static bool execute(std::string cmd);
+		// runs a tool, false unless it exits with 0
+		bool execute(const std::vector<std::string> &);
 		
 	};
 }
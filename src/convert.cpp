@@ -12,95 +12,41 @@
 
 namespace xlang {
 	
-	int Convert::octal_to_decimal(std::string& lx) {
-		size_t sz = lx.size();
-		int power = 0, num = 0, index = 0;
-		if (!lx.empty()) {
-			if (sz == 1) {
-				return 0;
-			} else if (sz > 1) {
-				index = sz - 1;
-				while (index > 0) {
-					num += (lx.at(index) - '0') * (1 << power);
-					index--;
-					power += 3;
-				}
-				return num;
-			}
-			
-		}
-		return 0;
-	}
-	
-	int Convert::hex_to_decimal(std::string& lx) {
-		size_t sz = lx.size();
-		int power = 0, num = 0, index = 0, hexval = 0;
-		char ch;
-		if (!lx.empty()) {
-			if (sz > 2) {
-				index = sz - 1;
-				while (index > 1) {
-					
-                    ch = lx.at(index);
-                    if (ch >= '0' && ch <= '9') 
-						hexval = ch - '0';
-					else if (ch >= 'a' && ch <= 'f') 
-						hexval = ((ch - '0' - 1) - '0') + 10;
-					else if (ch >= 'A' && ch <= 'F') 
-						hexval = ch - '0' - 7;
-					
-					num += hexval * (1 << power);
-					index--;
-					power += 4;
-				}
-				return num;
-			}
-		}
-		return 0;
-	}
-	
-	int Convert::bin_to_decimal(std::string& lx) {
-		size_t sz = lx.size();
-		int power = 0, num = 0, index = 0;
-		if (!lx.empty()) {
-			if (sz > 2) {
-				index = sz - 1;
-				while (index > 1) {
-					num += (lx.at(index) - '0') * (1 << power);
-					index--;
-					power++;
-				}
-				return num;
-			}
-		}
-		return 0;
-	}
-	
-	int Convert::char_to_decimal(std::string& lx) {
-		if (!lx.empty())
-			return lx.at(0);
-		return 0;
-	}
-	
-	int Convert::tok_to_decimal(Token& tok) {
+	int Convert::tok_to_decimal(const Token &tok) {
 
-		std::string lx = tok.string;
+		// the lexer decoded the value, this is the int the
+		// 32 bit code works with
 		switch (tok.number) {
 			case LIT_CHAR :
-				return Convert::char_to_decimal(lx);
 			case LIT_DECIMAL :
-				return std::stoi(lx);
 			case LIT_OCTAL :
-				return Convert::octal_to_decimal(lx);
 			case LIT_HEX :
-				return Convert::hex_to_decimal(lx);
 			case LIT_BIN :
-				return Convert::bin_to_decimal(lx);
+				return static_cast<int>(tok.value.i);
 			default:
 				return 0;
 		}
 	}
 	
+	std::string Convert::tok_to_string(const Token &tok) {
+
+		// literals folded by the optimizer have a value and no text,
+		// a negative one that fits 32 bits is written in hex
+		if (!tok.string.empty())
+			return std::string(tok.string);
+		switch (tok.number) {
+			case LIT_FLOAT :
+				return std::to_string(tok.value.f);
+			case LIT_DECIMAL :
+			case LIT_HEX :
+				if (tok.value.i < 0 && tok.width <= 4)
+					return "0x" + dec_to_hex(static_cast<uint32_t>(tok.value.i));
+				return std::to_string(tok.value.i);
+			default:
+				return std::string();
+		}
+	}
+	
 	std::string Convert::dec_to_hex(unsigned int num) {
 		int temp;
 		std::string hex;
@@ -124,4 +70,4 @@ namespace xlang {
 		std::reverse(hex.begin(), hex.end());
 		return hex;
 	}
-}
\ No newline at end of file
+}
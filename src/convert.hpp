@@ -16,11 +16,8 @@ namespace xlang {
 
     class Convert {
     public:
-	    static int tok_to_decimal(Token&);
-	    static int octal_to_decimal(std::string&);
-	    static int hex_to_decimal(std::string&);
-	    static int bin_to_decimal(std::string&);
-	    static int char_to_decimal(std::string&);
+	    static int tok_to_decimal(const Token &);
+	    static std::string tok_to_string(const Token &);
 	    static std::string dec_to_hex(unsigned int);
     };
 }
\ No newline at end of file
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// ELF relocatable object writer
+//
+// sections are always laid out as
+//    null, .text, .data, .bss, .shstrtab, .symtab, .strtab, [.rel.text], [.rel.data]
+// symbol table starts with the file and section symbols, then locals, then globals.
+// elf32 uses REL relocations so addends are stored in the patched field,
+// elf64 uses RELA like nasm does.
+
+#include <elf.h>
+#include <map>
+#include <fstream>
+#include <cstring>
+#include "elf.hpp"
+
+namespace xlang {
+
+	struct Elf32Types {
+		typedef Elf32_Ehdr Ehdr;
+		typedef Elf32_Shdr Shdr;
+		typedef Elf32_Sym Sym;
+		typedef Elf32_Rel Rel;
+		static const unsigned char elfclass = ELFCLASS32;
+		static const Elf32_Half machine = EM_386;
+		static const bool rela = false;
+		static const unsigned align = 4;
+
+		static uint32_t rel_type(ElfRelocationType t) {
+			return (t == ELF_PC32 ? R_386_PC32 : R_386_32);
+		}
+
+		static Rel relocation(uint64_t offset, uint32_t sym, uint32_t type, int64_t) {
+			Rel r{};
+			r.r_offset = offset;
+			r.r_info = ELF32_R_INFO(sym, type);
+			return r;
+		}
+	};
+
+	struct Elf64Types {
+		typedef Elf64_Ehdr Ehdr;
+		typedef Elf64_Shdr Shdr;
+		typedef Elf64_Sym Sym;
+		typedef Elf64_Rela Rel;
+		static const unsigned char elfclass = ELFCLASS64;
+		static const Elf64_Half machine = EM_X86_64;
+		static const bool rela = true;
+		static const unsigned align = 8;
+
+		static uint32_t rel_type(ElfRelocationType t) {
+			switch (t) {
+				case ELF_ABS32:
+					return R_X86_64_32;
+				case ELF_ABS32S:
+					return R_X86_64_32S;
+				case ELF_ABS64:
+					return R_X86_64_64;
+				default:
+					return R_X86_64_PC32;
+			}
+		}
+
+		static Rel relocation(uint64_t offset, uint32_t sym, uint32_t type, int64_t addend) {
+			Rel r{};
+			r.r_offset = offset;
+			r.r_info = ELF64_R_INFO(sym, type);
+			r.r_addend = addend;
+			return r;
+		}
+	};
+
+	struct StringTable {
+		std::vector<uint8_t> bytes{0};
+		std::map<std::string, uint32_t> offsets;
+
+		uint32_t add(const std::string &s) {
+			if (s.empty())
+				return 0;
+			auto it = offsets.find(s);
+			if (it != offsets.end())
+				return it->second;
+			uint32_t pos = bytes.size();
+			bytes.insert(bytes.end(), s.begin(), s.end());
+			bytes.push_back(0);
+			offsets[s] = pos;
+			return pos;
+		}
+	};
+
+	template<typename T>
+	static void append(std::vector<uint8_t> &out, const T &v) {
+		const uint8_t *p = reinterpret_cast<const uint8_t *>(&v);
+		out.insert(out.end(), p, p + sizeof(T));
+	}
+
+	static void align_to(std::vector<uint8_t> &out, unsigned align) {
+		while (out.size() % align != 0)
+			out.push_back(0);
+	}
+
+	template<typename E>
+	static std::vector<uint8_t> build_image(const ElfObject &obj) {
+		std::vector<uint8_t> text = obj.text;
+		std::vector<uint8_t> data = obj.data;
+		std::vector<typename E::Sym> syms;
+		std::map<std::string, uint32_t> sym_index;
+		StringTable strtab, shstrtab;
+
+		auto section_index = [](ElfSectionId s) -> uint16_t {
+			switch (s) {
+				case ELF_TEXT:
+					return 1;
+				case ELF_DATA:
+					return 2;
+				case ELF_BSS:
+					return 3;
+				case ELF_ABS:
+					return SHN_ABS;
+				default:
+					return SHN_UNDEF;
+			}
+		};
+
+		auto add_symbol = [&](const std::string &name, uint16_t shndx, uint64_t value, int bind, int type) {
+			typename E::Sym s{};
+			s.st_name = strtab.add(name);
+			s.st_value = value;
+			s.st_shndx = shndx;
+			s.st_info = ELF32_ST_INFO(bind, type);
+			sym_index[name] = syms.size();
+			syms.push_back(s);
+		};
+
+		// file and section symbols first, relocations against locals use the sections
+
+		syms.push_back(typename E::Sym{});
+		add_symbol(obj.source_name, SHN_ABS, 0, STB_LOCAL, STT_FILE);
+		uint32_t section_sym[4] = {0, 0, 0, 0};
+		for (ElfSectionId s: {ELF_TEXT, ELF_DATA, ELF_BSS}) {
+			typename E::Sym sec{};
+			sec.st_shndx = section_index(s);
+			sec.st_info = ELF32_ST_INFO(STB_LOCAL, STT_SECTION);
+			section_sym[s] = syms.size();
+			syms.push_back(sec);
+		}
+
+		for (const auto &s: obj.symbols) {
+			if (!s.global)
+				add_symbol(s.name, section_index(s.section), s.value, STB_LOCAL, STT_NOTYPE);
+		}
+
+		uint32_t first_global = syms.size();
+		for (const auto &s: obj.symbols) {
+			if (s.global)
+				add_symbol(s.name, section_index(s.section), s.value, STB_GLOBAL, STT_NOTYPE);
+		}
+
+		// externs only seen in relocations become undefined globals
+
+		for (const auto &r: obj.relocations) {
+			if (!r.symbol.empty() && sym_index.find(r.symbol) == sym_index.end())
+				add_symbol(r.symbol, SHN_UNDEF, 0, STB_GLOBAL, STT_NOTYPE);
+		}
+
+		std::vector<uint8_t> rel_text, rel_data;
+		for (const auto &r: obj.relocations) {
+			uint32_t sym = r.symbol.empty() ? section_sym[r.target] : sym_index[r.symbol];
+			auto rel = E::relocation(r.offset, sym, E::rel_type(r.type), r.addend);
+			std::vector<uint8_t> &bytes = (r.section == ELF_TEXT ? text : data);
+
+			if (!E::rela) {
+				// REL keeps the addend in the field being relocated
+				int32_t field;
+				std::memcpy(&field, &bytes[r.offset], sizeof(field));
+				field += static_cast<int32_t>(r.addend);
+				std::memcpy(&bytes[r.offset], &field, sizeof(field));
+			}
+			append(r.section == ELF_TEXT ? rel_text : rel_data, rel);
+		}
+
+		std::vector<uint8_t> symtab;
+		for (const auto &s: syms)
+			append(symtab, s);
+
+		// section contents follow the file header, headers go last
+
+		std::vector<uint8_t> out(sizeof(typename E::Ehdr), 0);
+		std::vector<typename E::Shdr> shdrs(1, typename E::Shdr{});
+		const char *rel_prefix = E::rela ? ".rela" : ".rel";
+
+		auto add_section = [&](const std::string &name, uint32_t type, uint64_t flags, const std::vector<uint8_t> *bytes,
+							   uint64_t size, uint64_t align, uint32_t link, uint32_t info, uint64_t entsize) {
+			typename E::Shdr sh{};
+			sh.sh_name = shstrtab.add(name);
+			sh.sh_type = type;
+			sh.sh_flags = flags;
+			sh.sh_addralign = align;
+			sh.sh_link = link;
+			sh.sh_info = info;
+			sh.sh_entsize = entsize;
+			sh.sh_size = size;
+			align_to(out, align);
+			sh.sh_offset = out.size();
+			if (bytes != nullptr)
+				out.insert(out.end(), bytes->begin(), bytes->end());
+			shdrs.push_back(sh);
+		};
+
+		// section names have to be known before .shstrtab is written out
+
+		std::string rel_text_name = std::string(rel_prefix) + ".text";
+		std::string rel_data_name = std::string(rel_prefix) + ".data";
+		for (const char *name: {".text", ".data", ".bss", ".shstrtab", ".symtab", ".strtab"})
+			shstrtab.add(name);
+		if (!rel_text.empty())
+			shstrtab.add(rel_text_name);
+		if (!rel_data.empty())
+			shstrtab.add(rel_data_name);
+
+		add_section(".text", SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, &text, text.size(), 16, 0, 0, 0);
+		add_section(".data", SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, &data, data.size(), 4, 0, 0, 0);
+		add_section(".bss", SHT_NOBITS, SHF_ALLOC | SHF_WRITE, nullptr, obj.bss_size, 4, 0, 0, 0);
+
+		uint32_t shstrtab_index = shdrs.size();
+		std::vector<uint8_t> shstr_bytes = shstrtab.bytes;
+		add_section(".shstrtab", SHT_STRTAB, 0, &shstr_bytes, shstr_bytes.size(), 1, 0, 0, 0);
+		uint32_t symtab_index = shdrs.size();
+		add_section(".symtab", SHT_SYMTAB, 0, &symtab, symtab.size(), E::align, symtab_index + 1, first_global, sizeof(typename E::Sym));
+		add_section(".strtab", SHT_STRTAB, 0, &strtab.bytes, strtab.bytes.size(), 1, 0, 0, 0);
+		if (!rel_text.empty())
+			add_section(rel_text_name, E::rela ? SHT_RELA : SHT_REL, 0, &rel_text, rel_text.size(), E::align, symtab_index, 1, sizeof(typename E::Rel));
+		if (!rel_data.empty())
+			add_section(rel_data_name, E::rela ? SHT_RELA : SHT_REL, 0, &rel_data, rel_data.size(), E::align, symtab_index, 2, sizeof(typename E::Rel));
+
+		align_to(out, E::align);
+
+		typename E::Ehdr eh{};
+		std::memcpy(eh.e_ident, ELFMAG, SELFMAG);
+		eh.e_ident[EI_CLASS] = E::elfclass;
+		eh.e_ident[EI_DATA] = ELFDATA2LSB;
+		eh.e_ident[EI_VERSION] = EV_CURRENT;
+		eh.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+		eh.e_type = ET_REL;
+		eh.e_machine = E::machine;
+		eh.e_version = EV_CURRENT;
+		eh.e_shoff = out.size();
+		eh.e_ehsize = sizeof(typename E::Ehdr);
+		eh.e_shentsize = sizeof(typename E::Shdr);
+		eh.e_shnum = shdrs.size();
+		eh.e_shstrndx = shstrtab_index;
+		std::memcpy(out.data(), &eh, sizeof(eh));
+
+		for (const auto &sh: shdrs)
+			append(out, sh);
+
+		return out;
+	}
+
+	std::vector<uint8_t> ElfObject::image() const {
+		if (elf64)
+			return build_image<Elf64Types>(*this);
+		return build_image<Elf32Types>(*this);
+	}
+
+	bool ElfObject::write(const std::string &path) const {
+		std::vector<uint8_t> bytes = image();
+		std::ofstream outfile(path, std::ios::out | std::ios::binary);
+		if (!outfile.is_open())
+			return false;
+		outfile.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+		return outfile.good();
+	}
+}
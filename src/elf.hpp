@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace xlang {
+
+	enum ElfSectionId {
+		ELF_UNDEF,
+		ELF_TEXT,
+		ELF_DATA,
+		ELF_BSS,
+		ELF_ABS
+	};
+
+	enum ElfRelocationType {
+		ELF_ABS32,    // 32 bit absolute address
+		ELF_ABS32S,   // 32 bit absolute address, sign extended on x86_64
+		ELF_ABS64,    // 64 bit absolute address
+		ELF_PC32      // 32 bit pc relative address
+	};
+
+	struct ElfSymbol {
+		std::string name;
+		ElfSectionId section;
+		uint64_t value;
+		bool global;
+	};
+
+	struct ElfRelocation {
+		ElfSectionId section;      // section that gets patched
+		uint64_t offset;
+		ElfRelocationType type;
+		std::string symbol;        // if empty, relative to section target
+		ElfSectionId target;
+		int64_t addend;
+	};
+
+	// relocatable ELF object with .text, .data and .bss sections,
+	// same layout nasm gives us with -f elf32/elf64
+
+	class ElfObject {
+	public:
+		explicit ElfObject(bool is64) : elf64(is64) {}
+
+		std::string source_name;
+		std::vector<uint8_t> text;
+		std::vector<uint8_t> data;
+		uint64_t bss_size{0};
+		std::vector<ElfSymbol> symbols;
+		std::vector<ElfRelocation> relocations;
+
+		std::vector<uint8_t> image() const;
+
+		bool write(const std::string &path) const;
+
+	private:
+		bool elf64;
+	};
+}
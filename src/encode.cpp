@@ -0,0 +1,1558 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// x86 machine code encoder
+//
+// input is what CodeGen::write_asm_file() would print, output is an ElfObject.
+// encoding follows nasm with its default optimization so objects from
+// both paths disassemble the same:
+//    - sign extended imm8 forms and accumulator forms where shorter
+//    - jumps start short and are made near until every target is in range
+//    - [reg*1 + x] and [reg*2 + x] use reg as base register
+//    - '.label' is local to the previous non local label
+//    - struc members are absolute symbols 'record.member'
+
+#include <cctype>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include "encode.hpp"
+
+namespace xlang {
+
+	// hardware register numbers of RegisterType, in enum order
+
+	static const int reg_numbers[] = {
+		0, 4, 3, 7, 1, 5, 2, 6,
+		0, 3, 1, 2, 4, 5, 6, 7,
+		0, 3, 1, 2, 4, 5, 6, 7,
+		0, 3, 1, 2, 4, 5, 6, 7
+	};
+
+	static const int REG_ACC = 0;
+	static const int REG_CL = 1;
+	static const int REG_SP = 4;
+	static const int REG_BP = 5;
+
+	// condition codes of JE ... JNLE, in enum order
+
+	static const uint8_t condition_codes[] = {
+		0x4, 0x5, 0x7, 0x6, 0x3, 0x2, 0x2, 0x3, 0x6,
+		0x7, 0xF, 0xD, 0xE, 0xC, 0xC, 0xE, 0xD, 0xF
+	};
+
+	static bool fits8(int64_t v) {
+		return v >= -128 && v <= 127;
+	}
+
+	static bool fits32(int64_t v) {
+		return v >= INT32_MIN && v <= INT32_MAX;
+	}
+
+	// immediate as the cpu sees it after truncating to the operand size
+	static int64_t sign_extend(int64_t v, int size) {
+		switch (size) {
+			case 1:
+				return static_cast<int8_t>(v);
+			case 2:
+				return static_cast<int16_t>(v);
+			case 4:
+				return static_cast<int32_t>(v);
+			default:
+				return v;
+		}
+	}
+
+	static std::string trim(const std::string &s) {
+		size_t b = s.find_first_not_of(" \t\r\n");
+		if (b == std::string::npos)
+			return "";
+		size_t e = s.find_last_not_of(" \t\r\n");
+		return s.substr(b, e - b + 1);
+	}
+
+	static std::string lower(std::string s) {
+		std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+		return s;
+	}
+
+	static bool is_quote(char c) {
+		return c == '\'' || c == '"' || c == '`';
+	}
+
+	static bool is_symbol(const std::string &s) {
+		if (s.empty() || std::isdigit(static_cast<unsigned char>(s[0])))
+			return false;
+		for (char c: s) {
+			if (!std::isalnum(static_cast<unsigned char>(c)) && std::strchr("_.$?@#~", c) == nullptr)
+				return false;
+		}
+		return true;
+	}
+
+	// split at top level commas, not inside quotes or brackets
+	static std::vector<std::string> split_list(const std::string &s) {
+		std::vector<std::string> items;
+		std::string cur;
+		char quote = 0;
+		int depth = 0;
+		for (char c: s) {
+			if (quote) {
+				if (c == quote)
+					quote = 0;
+			}
+			else if (is_quote(c))
+				quote = c;
+			else if (c == '[')
+				depth++;
+			else if (c == ']')
+				depth--;
+			else if (c == ',' && depth == 0) {
+				items.push_back(trim(cur));
+				cur.clear();
+				continue;
+			}
+			cur += c;
+		}
+		items.push_back(trim(cur));
+		return items;
+	}
+
+	static int size_of_insn_size(int sz) {
+		return (sz == 1 || sz == 2 || sz == 4 || sz == 8) ? sz : 0;
+	}
+
+	bool Encoder::fail(const std::string &msg) {
+		if (err.empty())
+			err = msg;
+		return false;
+	}
+
+	std::string Encoder::scoped(const std::string &name) {
+		if (name.size() > 1 && name[0] == '.' && name[1] != '.')
+			return scope + name;
+		return name;
+	}
+
+	bool Encoder::define_label(const std::string &name, ElfSectionId section, uint64_t value) {
+		if (labels.find(name) != labels.end())
+			return fail("symbol '" + name + "' redefined");
+		labels[name] = LabelInfo{section, value};
+		return true;
+	}
+
+	bool Encoder::parse_number(const std::string &str, int64_t &value) {
+
+		// nasm numeric constants: 10, 0x0A, 0Ah, 0b1010, 1010b, 0o12, 12q, 'a'
+
+		std::string s = trim(str);
+		if (s.empty())
+			return false;
+
+		if (s.size() >= 2 && is_quote(s[0]) && s.back() == s[0]) {
+			std::string chars = s.substr(1, s.size() - 2);
+			if (chars.size() > 8)
+				return false;
+			uint64_t v = 0;
+			for (size_t i = chars.size(); i > 0; i--)
+				v = (v << 8) | static_cast<unsigned char>(chars[i - 1]);
+			value = static_cast<int64_t>(v);
+			return true;
+		}
+
+		if (!std::isdigit(static_cast<unsigned char>(s[0])))
+			return false;
+
+		s = lower(s);
+		s.erase(std::remove(s.begin(), s.end(), '_'), s.end());
+		int base = 10;
+		if (s.size() > 2 && s[0] == '0' && std::strchr("xhbyoqdt", s[1]) != nullptr
+			&& s.find_first_not_of("0123456789abcdef", 2) == std::string::npos && s.back() != 'h') {
+			switch (s[1]) {
+				case 'x':
+				case 'h':
+					base = 16;
+					break;
+				case 'b':
+				case 'y':
+					base = 2;
+					break;
+				case 'o':
+				case 'q':
+					base = 8;
+					break;
+				default:
+					base = 10;
+					break;
+			}
+			s = s.substr(2);
+		}
+		else if (s.size() > 1 && std::strchr("hbyoqdt", s.back()) != nullptr) {
+			switch (s.back()) {
+				case 'h':
+					base = 16;
+					break;
+				case 'b':
+				case 'y':
+					base = 2;
+					break;
+				case 'o':
+				case 'q':
+					base = 8;
+					break;
+				default:
+					base = 10;
+					break;
+			}
+			s.pop_back();
+		}
+
+		uint64_t v = 0;
+		for (char c: s) {
+			int d;
+			if (std::isdigit(static_cast<unsigned char>(c)))
+				d = c - '0';
+			else if (c >= 'a' && c <= 'f')
+				d = c - 'a' + 10;
+			else
+				return false;
+			if (d >= base)
+				return false;
+			v = v * base + d;
+		}
+		value = static_cast<int64_t>(v);
+		return true;
+	}
+
+	bool Encoder::parse_register(const std::string &str, MachineOperand &mop) {
+		std::string s = lower(trim(str));
+		for (int r = AL; r <= RDI; r++) {
+			RegisterType rt = static_cast<RegisterType>(r);
+			if (regs.reg_name(rt) == s) {
+				mop.type = MOPREG;
+				mop.reg = reg_numbers[r];
+				mop.size = regs.regsize(rt);
+				return true;
+			}
+		}
+		for (int r = ST0; r <= ST7; r++) {
+			std::string paren = "st(" + std::to_string(r) + ")";
+			if (regs.freg_name(static_cast<FloatRegisterType>(r)) == s || paren == s) {
+				mop.type = MOPFREG;
+				mop.reg = r;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool Encoder::address_registers(MachineOperand &mop, const std::vector<std::pair<MachineOperand, int>> &addr) {
+
+		// pick base and index out of the registers of an effective address,
+		// a scale of 0 means the register was not scaled
+
+		int scaled = 0;
+		for (const auto &a: addr) {
+			if (a.second != 0)
+				scaled++;
+			if (mop.addr_size != 0 && mop.addr_size != a.first.size)
+				return fail("invalid effective address");
+			if (a.first.size != 4 && a.first.size != 8)
+				return fail("16 bit addressing is not supported");
+			mop.addr_size = a.first.size;
+		}
+		if (addr.size() > 2 || scaled > 1)
+			return fail("invalid effective address");
+
+		mop.type = MOPMEM;
+		mop.reg = mop.index = -1;
+		mop.scale = 1;
+		for (const auto &a: addr) {
+			if (a.second != 0) {
+				mop.index = a.first.reg;
+				mop.scale = a.second;
+			}
+		}
+		for (const auto &a: addr) {
+			if (a.second == 0) {
+				if (mop.reg == -1)
+					mop.reg = a.first.reg;
+				else
+					mop.index = a.first.reg;
+			}
+		}
+
+		if (mop.index != -1 && mop.reg == -1) {
+			// [r*1] is [r], [r*2] is [r + r], [r*3] is [r + r*2] ...
+			if (mop.scale == 1) {
+				mop.reg = mop.index;
+				mop.index = -1;
+			}
+			else if (mop.scale == 2 || mop.scale == 3 || mop.scale == 5 || mop.scale == 9) {
+				mop.reg = mop.index;
+				mop.scale = (mop.scale == 2 ? 1 : mop.scale - 1);
+			}
+		}
+		if (mop.index != -1 && mop.scale != 1 && mop.scale != 2 && mop.scale != 4 && mop.scale != 8)
+			return fail("invalid scale in effective address");
+		if (mop.index == REG_SP) {
+			if (mop.scale != 1 || mop.reg == REG_SP)
+				return fail("esp can't be an index register");
+			std::swap(mop.reg, mop.index);
+		}
+		return true;
+	}
+
+	bool Encoder::parse_expression(const std::string &expr, MachineOperand &mop, bool memory) {
+
+		// terms joined by + and -, a term is a number, a symbol, a register
+		// or register*scale. registers are only allowed inside [ ]
+
+		std::vector<std::pair<int, std::string>> terms;
+		std::vector<std::pair<MachineOperand, int>> addr;
+		std::string cur;
+		int sign = 1;
+		char quote = 0;
+
+		for (char c: expr) {
+			if (quote) {
+				cur += c;
+				if (c == quote)
+					quote = 0;
+				continue;
+			}
+			if (is_quote(c))
+				quote = c;
+			else if (c == '+' || c == '-') {
+				if (trim(cur).empty()) {
+					if (c == '-')
+						sign = -sign;
+					continue;
+				}
+				terms.push_back({sign, trim(cur)});
+				cur.clear();
+				sign = (c == '-' ? -1 : 1);
+				continue;
+			}
+			cur += c;
+		}
+		if (trim(cur).empty())
+			return fail("invalid expression '" + expr + "'");
+		terms.push_back({sign, trim(cur)});
+
+		for (const auto &t: terms) {
+			MachineOperand r;
+			int64_t n, m;
+			size_t star = t.second.find('*');
+			if (star != std::string::npos) {
+				std::string a = trim(t.second.substr(0, star));
+				std::string b = trim(t.second.substr(star + 1));
+				if (parse_number(a, n) && parse_number(b, m)) {
+					mop.value += t.first * n * m;
+					continue;
+				}
+				if (!(parse_register(a, r) && parse_number(b, n)) && !(parse_register(b, r) && parse_number(a, n)))
+					return fail("invalid expression '" + expr + "'");
+				if (!memory || r.type != MOPREG || t.first < 0)
+					return fail("invalid effective address '" + expr + "'");
+				addr.push_back({r, static_cast<int>(n)});
+			}
+			else if (parse_register(t.second, r)) {
+				if (!memory || r.type != MOPREG || t.first < 0)
+					return fail("invalid effective address '" + expr + "'");
+				addr.push_back({r, 0});
+			}
+			else if (parse_number(t.second, n)) {
+				mop.value += t.first * n;
+			}
+			else if (is_symbol(t.second)) {
+				std::string name = scoped(t.second);
+				auto it = labels.find(name);
+				if (it != labels.end() && it->second.section == ELF_ABS)
+					mop.value += t.first * static_cast<int64_t>(it->second.value);
+				else if (t.first > 0 && mop.symbol.empty())
+					mop.symbol = name;
+				else
+					return fail("expression '" + expr + "' is not relocatable");
+			}
+			else
+				return fail("invalid expression '" + expr + "'");
+		}
+
+		if (memory)
+			return address_registers(mop, addr);
+
+		mop.type = MOPIMM;
+		return true;
+	}
+
+	bool Encoder::parse_operand(std::string text, MachineOperand &mop) {
+		text = trim(text);
+
+		// size and jump distance keywords in front of the operand
+
+		while (true) {
+			size_t e = 0;
+			while (e < text.size() && std::isalpha(static_cast<unsigned char>(text[e])))
+				e++;
+			std::string word = lower(text.substr(0, e));
+			int size = -1;
+			if (word == "byte")
+				size = 1;
+			else if (word == "word")
+				size = 2;
+			else if (word == "dword")
+				size = 4;
+			else if (word == "qword")
+				size = 8;
+			else if (word == "tword")
+				size = 10;
+			else if (word == "short" || word == "near" || word == "strict")
+				size = 0;
+			if (size < 0 || e == text.size())
+				break;
+			if (size > 0)
+				mop.size = size;
+			text = trim(text.substr(e));
+		}
+
+		if (!text.empty() && text[0] == '[') {
+			if (text.back() != ']')
+				return fail("invalid memory operand '" + text + "'");
+			int size = mop.size;
+			if (!parse_expression(text.substr(1, text.size() - 2), mop, true))
+				return false;
+			mop.size = size;
+			return true;
+		}
+
+		int size = mop.size;
+		if (parse_register(text, mop)) {
+			if (size != 0 && size != mop.size)
+				return fail("mismatch in operand sizes");
+			return true;
+		}
+		if (!parse_expression(text, mop, false))
+			return false;
+		mop.size = size;
+		return true;
+	}
+
+	bool Encoder::parse_inline_asm(const std::string &asmtext) {
+
+		// inline assembly is nasm source, only plain instructions and labels
+		// are understood here, anything else goes to nasm
+
+		size_t start = 0;
+		while (start <= asmtext.size()) {
+			size_t end = asmtext.find('\n', start);
+			if (end == std::string::npos)
+				end = asmtext.size();
+			std::string line = asmtext.substr(start, end - start);
+			start = end + 1;
+
+			char quote = 0;
+			for (size_t i = 0; i < line.size(); i++) {
+				if (quote) {
+					if (line[i] == quote)
+						quote = 0;
+				}
+				else if (is_quote(line[i]))
+					quote = line[i];
+				else if (line[i] == ';') {
+					line.erase(i);
+					break;
+				}
+			}
+			line = trim(line);
+			if (line.empty())
+				continue;
+
+			size_t colon = line.find(':');
+			if (colon != std::string::npos && is_symbol(trim(line.substr(0, colon)))) {
+				std::string name = trim(line.substr(0, colon));
+				std::string full = scoped(name);
+				if (name[0] != '.')
+					scope = name;
+				if (!define_label(full, ELF_TEXT, 0))
+					return false;
+				MachineInstruction mi;
+				mi.type = INSLABEL;
+				mi.label = full;
+				text.push_back(mi);
+				line = trim(line.substr(colon + 1));
+				if (line.empty())
+					continue;
+			}
+
+			size_t sp = line.find_first_of(" \t");
+			std::string mnemonic = lower(line.substr(0, sp));
+			std::string rest = (sp == std::string::npos ? "" : trim(line.substr(sp)));
+
+			MachineInstruction mi;
+			for (int t = MOV; t <= FNOP; t++) {
+				if (insncls.insn_name(static_cast<InstructionType>(t)) == mnemonic)
+					mi.type = static_cast<InstructionType>(t);
+			}
+			if (mi.type == INSNONE)
+				return fail("unknown instruction '" + mnemonic + "' in inline assembly");
+
+			if (!rest.empty()) {
+				std::vector<std::string> ops = split_list(rest);
+				if (ops.size() > 2)
+					return fail("too many operands for '" + mnemonic + "'");
+				mi.operand_count = ops.size();
+				for (size_t i = 0; i < ops.size(); i++) {
+					if (!parse_operand(ops[i], mi.op[i]))
+						return false;
+				}
+			}
+			text.push_back(mi);
+		}
+		return true;
+	}
+
+	bool Encoder::get_operand(const Operand *op, int n, int count, MachineOperand &mop) {
+
+		// same operand CodeGen::write_instructions_to_asm_file() prints
+
+		std::vector<std::pair<MachineOperand, int>> addr;
+		MachineOperand r;
+
+		switch (op->type) {
+			case REGISTER :
+				if (op->reg < AL || op->reg > RDI)
+					return fail("invalid register");
+				mop.type = MOPREG;
+				mop.reg = reg_numbers[op->reg];
+				mop.size = regs.regsize(op->reg);
+				return true;
+
+			case FREGISTER :
+				if (op->freg < ST0 || op->freg > ST7 || (n == 2 && !op->literal.empty()))
+					return fail("invalid float register");
+				mop.type = MOPFREG;
+				mop.reg = op->freg;
+				return true;
+
+			case LITERAL :
+				if (trim(op->literal).empty())
+					return fail("missing operand");
+				return parse_expression(op->literal, mop, false);
+
+			case MEMORY :
+				if (op->mem.mem_type == GLOBAL) {
+					if (n == 2 && op->mem.mem_size < 0)
+						return parse_expression(op->mem.name, mop, false);
+
+					if (count == 1 && op->mem.name.empty()) {
+						if (op->reg < AL || op->reg > RDI)
+							return fail("invalid register");
+						r.reg = reg_numbers[op->reg];
+						r.size = regs.regsize(op->reg);
+						addr.push_back({r, 0});
+						if (!address_registers(mop, addr))
+							return false;
+					}
+					else {
+						if (!parse_expression(op->mem.name, mop, true))
+							return false;
+						if (count == 2 && op->is_array && op->reg != RNONE) {
+							if (op->reg < AL || op->reg > RDI || mop.reg != -1 || mop.index != -1)
+								return fail("invalid effective address");
+							r.reg = reg_numbers[op->reg];
+							r.size = regs.regsize(op->reg);
+							addr.push_back({r, op->arr_disp});
+							if (!address_registers(mop, addr))
+								return false;
+						}
+					}
+					if (op->mem.fp_disp > 0)
+						mop.value += op->mem.fp_disp;
+				}
+				else {
+					r.reg = REG_BP;
+					r.size = 4;
+					addr.push_back({r, 0});
+					if (!address_registers(mop, addr))
+						return false;
+					mop.value = op->mem.fp_disp;
+					if (n == 2 && op->mem.mem_size <= 0) {
+						mop.size = 0;
+						return true;
+					}
+				}
+				mop.size = size_of_insn_size(op->mem.mem_size);
+				if (mop.size == 0)
+					return fail("invalid memory operand size");
+				return true;
+
+			default:
+				break;
+		}
+		return fail("invalid operand");
+	}
+
+	bool Encoder::get_instruction(const Instruction *in) {
+		MachineInstruction mi;
+
+		switch (in->insn_type) {
+			case INSLABEL : {
+				std::string full = scoped(in->label);
+				if (in->label.empty() || in->label[0] != '.')
+					scope = in->label;
+				if (!define_label(full, ELF_TEXT, 0))
+					return false;
+				mi.type = INSLABEL;
+				mi.label = full;
+				text.push_back(mi);
+				return true;
+			}
+
+			case INSASM :
+				return parse_inline_asm(in->inline_asm);
+
+			case INSNONE :
+				// comment only
+				if (in->operand_count != 0)
+					return fail("operands without instruction");
+				return true;
+
+			default:
+				break;
+		}
+
+		if (in->insn_type < MOV || in->insn_type > FNOP || in->operand_count < 0 || in->operand_count > 2)
+			return fail("invalid instruction");
+
+		mi.type = in->insn_type;
+		mi.operand_count = in->operand_count;
+		if (mi.operand_count >= 1 && !get_operand(in->operand_1, 1, mi.operand_count, mi.op[0]))
+			return false;
+		if (mi.operand_count == 2 && !get_operand(in->operand_2, 2, mi.operand_count, mi.op[1]))
+			return false;
+		text.push_back(mi);
+		return true;
+	}
+
+	void Encoder::layout_records(const std::vector<ReserveSection *> &resv_section) {
+
+		// struc/endstruc only defines absolute symbols, members are
+		// written grouped by size, same as write_record_data_to_asm_file()
+
+		for (ReserveSection *r: resv_section) {
+			if (!r->is_record)
+				continue;
+			uint64_t offset = 0;
+			define_label(r->record_name, ELF_ABS, 0);
+			for (int type = RESB; type <= RESQ; type++) {
+				for (const auto &m: r->record_members) {
+					if (m.resvsp_type != type)
+						continue;
+					define_label(r->record_name + "." + m.symbol, ELF_ABS, offset);
+					offset += static_cast<uint64_t>(1 << type) * m.resv_size;
+				}
+			}
+			define_label(r->record_name + "_size", ELF_ABS, offset);
+		}
+	}
+
+	bool Encoder::layout_data(const std::vector<Member *> &data_section, ElfObject &obj) {
+		for (Member *d: data_section) {
+			if (d->type < DB || d->type > DQ)
+				return fail("invalid data declaration '" + d->symbol + "'");
+			if (!define_label(d->symbol, ELF_DATA, obj.data.size()))
+				return false;
+
+			int unit = 1 << d->type;
+			std::vector<std::string> items = d->is_array ? d->array_data : split_list(d->value);
+			for (std::string item: items) {
+				item = trim(item);
+				if (item.empty())
+					return fail("missing value of '" + d->symbol + "'");
+
+				if (item.size() >= 2 && is_quote(item[0]) && item.back() == item[0]) {
+					std::string chars = item.substr(1, item.size() - 2);
+					obj.data.insert(obj.data.end(), chars.begin(), chars.end());
+					while (chars.size() % unit != 0) {
+						obj.data.push_back(0);
+						chars.push_back(0);
+					}
+					continue;
+				}
+
+				std::string num = (item[0] == '-' || item[0] == '+') ? item.substr(1) : item;
+				bool is_float = !num.empty() && (std::isdigit(static_cast<unsigned char>(num[0])) || num[0] == '.')
+								&& lower(num).find('x') == std::string::npos
+								&& (num.find('.') != std::string::npos || lower(num).find('e') != std::string::npos);
+				if (is_float) {
+					char *end = nullptr;
+					uint8_t bytes[8];
+					if (unit == 4) {
+						float f = std::strtof(item.c_str(), &end);
+						std::memcpy(bytes, &f, 4);
+					}
+					else if (unit == 8) {
+						double f = std::strtod(item.c_str(), &end);
+						std::memcpy(bytes, &f, 8);
+					}
+					if ((unit != 4 && unit != 8) || end == nullptr || *end != '\0')
+						return fail("invalid floating point value '" + item + "'");
+					obj.data.insert(obj.data.end(), bytes, bytes + unit);
+					continue;
+				}
+
+				MachineOperand v;
+				if (!parse_expression(item, v, false))
+					return false;
+				if (!v.symbol.empty()) {
+					if (unit != 4 && unit != 8)
+						return fail("address of '" + v.symbol + "' does not fit in '" + d->symbol + "'");
+					fixups.push_back(Fixup{ELF_DATA, obj.data.size(), unit == 8 ? ELF_ABS64 : ELF_ABS32, v.symbol, v.value});
+					v.value = 0;
+				}
+				for (int i = 0; i < unit; i++)
+					obj.data.push_back(static_cast<uint8_t>(static_cast<uint64_t>(v.value) >> (8 * i)));
+			}
+		}
+		return true;
+	}
+
+	void Encoder::layout_bss(const std::vector<ReserveSection *> &resv_section, ElfObject &obj) {
+		for (ReserveSection *r: resv_section) {
+			if (r->is_record || r->type < RESB || r->type > RESQ)
+				continue;
+			define_label(r->symbol, ELF_BSS, obj.bss_size);
+			obj.bss_size += static_cast<uint64_t>(1 << r->type) * r->res_size;
+		}
+	}
+
+	void Encoder::put(MachineInstruction &mi, uint64_t value, int size) {
+		for (int i = 0; i < size; i++)
+			mi.code.push_back(static_cast<uint8_t>(value >> (8 * i)));
+	}
+
+	void Encoder::put_imm(MachineInstruction &mi, const MachineOperand &op, int size, ElfRelocationType type) {
+		if (!op.symbol.empty()) {
+			mi.fixups.push_back(Fixup{ELF_TEXT, mi.code.size(), size == 8 ? ELF_ABS64 : type, op.symbol, op.value});
+			put(mi, 0, size);
+			return;
+		}
+		put(mi, static_cast<uint64_t>(op.value), size);
+	}
+
+	bool Encoder::prefixes(MachineInstruction &mi, int opsize, const MachineOperand *mem) {
+		if (opsize == 2)
+			mi.code.push_back(0x66);
+		if (mem != nullptr && mem->type == MOPMEM) {
+			if (x64 && mem->addr_size == 4)
+				mi.code.push_back(0x67);
+			else if (!x64 && mem->addr_size == 8)
+				return fail("64 bit address in 32 bit code");
+		}
+		if (opsize == 8) {
+			if (!x64)
+				return fail("64 bit operand in 32 bit code");
+			mi.code.push_back(0x48);
+		}
+		return true;
+	}
+
+	bool Encoder::modrm(MachineInstruction &mi, int regfield, const MachineOperand &rm) {
+		if (rm.type == MOPREG || rm.type == MOPFREG) {
+			mi.code.push_back(0xC0 | (regfield << 3) | rm.reg);
+			return true;
+		}
+		if (rm.type != MOPMEM)
+			return fail("invalid operand");
+
+		bool sym = !rm.symbol.empty();
+		int64_t disp = rm.value;
+		if (!sym && (disp < INT32_MIN || disp > UINT32_MAX))
+			return fail("displacement out of range");
+
+		auto disp32 = [&]() {
+			MachineOperand d = rm;
+			put_imm(mi, d, 4, x64 ? ELF_ABS32S : ELF_ABS32);
+		};
+		auto sib = [&](int scale, int index, int base) {
+			int ss = (scale == 8 ? 3 : scale == 4 ? 2 : scale == 2 ? 1 : 0);
+			mi.code.push_back((ss << 6) | (index << 3) | base);
+		};
+
+		if (rm.reg == -1 && rm.index == -1) {
+			// absolute address, x86_64 needs a sib byte so it is not rip relative
+			if (x64) {
+				mi.code.push_back(0x04 | (regfield << 3));
+				mi.code.push_back(0x25);
+			}
+			else
+				mi.code.push_back(0x05 | (regfield << 3));
+			disp32();
+			return true;
+		}
+
+		if (rm.reg == -1) {
+			mi.code.push_back(0x04 | (regfield << 3));
+			sib(rm.scale, rm.index, REG_BP);
+			disp32();
+			return true;
+		}
+
+		int mod;
+		if (sym)
+			mod = 2;
+		else if (disp == 0 && rm.reg != REG_BP)
+			mod = 0;
+		else if (fits8(disp))
+			mod = 1;
+		else
+			mod = 2;
+
+		if (rm.index != -1 || rm.reg == REG_SP) {
+			mi.code.push_back((mod << 6) | (regfield << 3) | 4);
+			sib(rm.scale, rm.index == -1 ? REG_SP : rm.index, rm.reg);
+		}
+		else
+			mi.code.push_back((mod << 6) | (regfield << 3) | rm.reg);
+
+		if (mod == 1)
+			put(mi, static_cast<uint64_t>(disp), 1);
+		else if (mod == 2)
+			disp32();
+		return true;
+	}
+
+	int Encoder::operand_size(MachineInstruction &mi) {
+
+		// register size wins, then memory size, 0 if nothing says it,
+		// -1 if operands don't agree
+
+		int size = 0;
+		for (int i = 0; i < mi.operand_count; i++) {
+			if (mi.op[i].type == MOPREG) {
+				if (size != 0 && size != mi.op[i].size)
+					return -1;
+				size = mi.op[i].size;
+			}
+		}
+		for (int i = 0; i < mi.operand_count; i++) {
+			if (mi.op[i].type != MOPREG && mi.op[i].size != 0) {
+				if (size != 0 && size != mi.op[i].size && mi.op[i].type != MOPIMM)
+					return -1;
+				if (size == 0)
+					size = mi.op[i].size;
+			}
+		}
+		return size;
+	}
+
+	bool Encoder::encode_alu(MachineInstruction &mi, int digit) {
+
+		// add, or, and, sub, xor, cmp
+
+		MachineOperand &d = mi.op[0], &s = mi.op[1];
+		int size = operand_size(mi);
+		if (mi.operand_count != 2 || size <= 0)
+			return fail(size < 0 ? "mismatch in operand sizes" : "operation size not specified");
+
+		if (s.type == MOPREG && (d.type == MOPREG || d.type == MOPMEM)) {
+			if (!prefixes(mi, size, &d))
+				return false;
+			mi.code.push_back(digit * 8 + (size == 1 ? 0 : 1));
+			return modrm(mi, s.reg, d);
+		}
+		if (d.type == MOPREG && s.type == MOPMEM) {
+			if (!prefixes(mi, size, &s))
+				return false;
+			mi.code.push_back(digit * 8 + (size == 1 ? 2 : 3));
+			return modrm(mi, d.reg, s);
+		}
+		if (s.type == MOPIMM && (d.type == MOPREG || d.type == MOPMEM)) {
+			if (!prefixes(mi, size, &d))
+				return false;
+			bool acc = (d.type == MOPREG && d.reg == REG_ACC);
+			if (size == 1) {
+				if (acc)
+					mi.code.push_back(digit * 8 + 4);
+				else {
+					mi.code.push_back(0x80);
+					if (!modrm(mi, digit, d))
+						return false;
+				}
+				put_imm(mi, s, 1);
+				return true;
+			}
+			int64_t v = sign_extend(s.value, size);
+			if (s.symbol.empty() && fits8(v)) {
+				mi.code.push_back(0x83);
+				if (!modrm(mi, digit, d))
+					return false;
+				put(mi, static_cast<uint64_t>(v), 1);
+				return true;
+			}
+			if (acc)
+				mi.code.push_back(digit * 8 + 5);
+			else {
+				mi.code.push_back(0x81);
+				if (!modrm(mi, digit, d))
+					return false;
+			}
+			put_imm(mi, s, size == 8 ? 4 : size, ELF_ABS32S);
+			return true;
+		}
+		return fail("invalid combination of operands");
+	}
+
+	bool Encoder::encode_unary(MachineInstruction &mi, int digit) {
+
+		// not, neg, mul, imul, div, idiv with one operand
+
+		MachineOperand &o = mi.op[0];
+		if (mi.operand_count != 1 || (o.type != MOPREG && o.type != MOPMEM))
+			return fail("invalid combination of operands");
+		if (o.size == 0)
+			return fail("operation size not specified");
+		if (!prefixes(mi, o.size, &o))
+			return false;
+		mi.code.push_back(o.size == 1 ? 0xF6 : 0xF7);
+		return modrm(mi, digit, o);
+	}
+
+	bool Encoder::encode_shift(MachineInstruction &mi, int digit) {
+		MachineOperand &d = mi.op[0], &s = mi.op[1];
+		if (mi.operand_count != 2 || (d.type != MOPREG && d.type != MOPMEM))
+			return fail("invalid combination of operands");
+		int size = d.size;
+		if (size == 0)
+			return fail("operation size not specified");
+		if (!prefixes(mi, size, &d))
+			return false;
+
+		if (s.type == MOPREG && s.reg == REG_CL && s.size == 1) {
+			mi.code.push_back(size == 1 ? 0xD2 : 0xD3);
+			return modrm(mi, digit, d);
+		}
+		if (s.type != MOPIMM || !s.symbol.empty())
+			return fail("invalid combination of operands");
+		if (s.value == 1) {
+			mi.code.push_back(size == 1 ? 0xD0 : 0xD1);
+			return modrm(mi, digit, d);
+		}
+		mi.code.push_back(size == 1 ? 0xC0 : 0xC1);
+		if (!modrm(mi, digit, d))
+			return false;
+		put(mi, static_cast<uint64_t>(s.value), 1);
+		return true;
+	}
+
+	bool Encoder::encode_fpu(MachineInstruction &mi) {
+		MachineOperand &a = mi.op[0], &b = mi.op[1];
+		int n = mi.operand_count;
+
+		auto mem = [&](uint8_t opcode, int digit) {
+			if (a.type != MOPMEM)
+				return fail("invalid combination of operands");
+			if (!prefixes(mi, 0, &a))
+				return false;
+			mi.code.push_back(opcode);
+			return modrm(mi, digit, a);
+		};
+		auto st = [&](uint8_t opcode, uint8_t base, int i) {
+			mi.code.push_back(opcode);
+			mi.code.push_back(base + i);
+			return true;
+		};
+		auto sized = [&](int size2, uint8_t op2, int d2, int size4, uint8_t op4, int d4, int size8, uint8_t op8, int d8) {
+			if (a.type != MOPMEM)
+				return fail("invalid combination of operands");
+			if (a.size == size2 && size2 != 0)
+				return mem(op2, d2);
+			if (a.size == size4 && size4 != 0)
+				return mem(op4, d4);
+			if (a.size == size8 && size8 != 0)
+				return mem(op8, d8);
+			return fail(a.size == 0 ? "operation size not specified" : "invalid operand size");
+		};
+		bool one_freg = (n == 1 && a.type == MOPFREG);
+
+		switch (mi.type) {
+			case FLD :
+				if (one_freg)
+					return st(0xD9, 0xC0, a.reg);
+				return sized(4, 0xD9, 0, 8, 0xDD, 0, 10, 0xDB, 5);
+			case FILD :
+				return sized(2, 0xDF, 0, 4, 0xDB, 0, 8, 0xDF, 5);
+			case FST :
+				if (one_freg)
+					return st(0xDD, 0xD0, a.reg);
+				return sized(0, 0, 0, 4, 0xD9, 2, 8, 0xDD, 2);
+			case FSTP :
+				if (one_freg)
+					return st(0xDD, 0xD8, a.reg);
+				return sized(4, 0xD9, 3, 8, 0xDD, 3, 10, 0xDB, 7);
+			case FIST :
+				return sized(2, 0xDF, 2, 4, 0xDB, 2, 0, 0, 0);
+			case FISTP :
+				return sized(2, 0xDF, 3, 4, 0xDB, 3, 8, 0xDF, 7);
+			case FXCH :
+				if (n == 0)
+					return st(0xD9, 0xC8, 1);
+				if (one_freg)
+					return st(0xD9, 0xC8, a.reg);
+				if (n == 2 && a.type == MOPFREG && b.type == MOPFREG && (a.reg == 0 || b.reg == 0))
+					return st(0xD9, 0xC8, a.reg == 0 ? b.reg : a.reg);
+				break;
+			case FFREE :
+				if (one_freg)
+					return st(0xDD, 0xC0, a.reg);
+				break;
+
+			case FADD :
+			case FMUL :
+			case FSUB :
+			case FSUBR :
+			case FDIV :
+			case FDIVR : {
+				int digit = (mi.type == FADD ? 0 : mi.type == FMUL ? 1 : mi.type == FSUB ? 4 :
+							 mi.type == FSUBR ? 5 : mi.type == FDIV ? 6 : 7);
+				if (one_freg)
+					return st(0xD8, 0xC0 + digit * 8, a.reg);
+				if (n == 2 && a.type == MOPFREG && b.type == MOPFREG) {
+					if (a.reg == 0)
+						return st(0xD8, 0xC0 + digit * 8, b.reg);
+					if (b.reg == 0)
+						return st(0xDC, 0xC0 + (digit >= 4 ? digit ^ 1 : digit) * 8, a.reg);
+				}
+				if (n == 1)
+					return sized(0, 0, 0, 4, 0xD8, digit, 8, 0xDC, digit);
+				break;
+			}
+
+			case FIADD :
+			case FIMUL :
+			case FISUB :
+			case FISUBR :
+			case FIDIV :
+			case FIDIVR : {
+				int digit = (mi.type == FIADD ? 0 : mi.type == FIMUL ? 1 : mi.type == FISUB ? 4 :
+							 mi.type == FISUBR ? 5 : mi.type == FIDIV ? 6 : 7);
+				return sized(2, 0xDE, digit, 4, 0xDA, digit, 0, 0, 0);
+			}
+
+			case FCOM :
+			case FCOMP : {
+				int digit = (mi.type == FCOM ? 2 : 3);
+				if (n == 0)
+					return st(0xD8, 0xC0 + digit * 8, 1);
+				if (one_freg)
+					return st(0xD8, 0xC0 + digit * 8, a.reg);
+				return sized(0, 0, 0, 4, 0xD8, digit, 8, 0xDC, digit);
+			}
+			case FCOMPP :
+				return st(0xDE, 0xD9, 0);
+			case FICOM :
+				return sized(2, 0xDE, 2, 4, 0xDA, 2, 0, 0, 0);
+			case FICOMP :
+				return sized(2, 0xDE, 3, 4, 0xDA, 3, 0, 0, 0);
+			case FCOMI :
+			case FCOMIP : {
+				uint8_t opcode = (mi.type == FCOMI ? 0xDB : 0xDF);
+				if (one_freg)
+					return st(opcode, 0xF0, a.reg);
+				if (n == 2 && a.type == MOPFREG && b.type == MOPFREG && a.reg == 0)
+					return st(opcode, 0xF0, b.reg);
+				break;
+			}
+			case FTST :
+				return st(0xD9, 0xE4, 0);
+			case FINIT :
+				mi.code.push_back(0x9B);
+				return st(0xDB, 0xE3, 0);
+			case FNINIT :
+				return st(0xDB, 0xE3, 0);
+			case FSAVE :
+				mi.code.push_back(0x9B);
+				return mem(0xDD, 6);
+			case FNSAVE :
+				return mem(0xDD, 6);
+			case FRSTOR :
+				return mem(0xDD, 4);
+			case FSTSW :
+			case FNSTSW :
+				if (mi.type == FSTSW)
+					mi.code.push_back(0x9B);
+				if (n == 1 && a.type == MOPREG && a.reg == REG_ACC && a.size == 2)
+					return st(0xDF, 0xE0, 0);
+				if (n == 1 && a.type == MOPMEM && (a.size == 0 || a.size == 2))
+					return mem(0xDD, 7);
+				break;
+			case FNOP :
+				return st(0xD9, 0xD0, 0);
+			default:
+				break;
+		}
+		return fail("invalid combination of operands");
+	}
+
+	bool Encoder::encode_insn(MachineInstruction &mi) {
+		MachineOperand &d = mi.op[0], &s = mi.op[1];
+		int n = mi.operand_count;
+		int size;
+
+		switch (mi.type) {
+			case MOV :
+				size = operand_size(mi);
+				if (n != 2 || size <= 0)
+					return fail(size < 0 ? "mismatch in operand sizes" : "operation size not specified");
+
+				if (d.type == MOPREG && s.type == MOPREG) {
+					if (!prefixes(mi, size, nullptr))
+						return false;
+					mi.code.push_back(size == 1 ? 0x88 : 0x89);
+					return modrm(mi, s.reg, d);
+				}
+				if ((d.type == MOPREG && s.type == MOPMEM) || (d.type == MOPMEM && s.type == MOPREG)) {
+					MachineOperand &r = (d.type == MOPREG ? d : s);
+					MachineOperand &m = (d.type == MOPREG ? s : d);
+					bool load = (d.type == MOPREG);
+					if (!prefixes(mi, size, &m))
+						return false;
+					if (!x64 && r.reg == REG_ACC && m.reg == -1 && m.index == -1) {
+						// moffs form of the accumulator
+						mi.code.push_back((load ? 0xA0 : 0xA2) + (size == 1 ? 0 : 1));
+						put_imm(mi, m, 4);
+						return true;
+					}
+					mi.code.push_back((load ? 0x8A : 0x88) + (size == 1 ? 0 : 1));
+					return modrm(mi, r.reg, m);
+				}
+				if (d.type == MOPREG && s.type == MOPIMM) {
+					if (size == 8) {
+						if (s.symbol.empty() && s.value >= 0 && s.value <= UINT32_MAX) {
+							mi.code.push_back(0xB8 + d.reg);
+							put(mi, static_cast<uint64_t>(s.value), 4);
+							return true;
+						}
+						if (s.symbol.empty() && fits32(s.value)) {
+							mi.code.push_back(0x48);
+							mi.code.push_back(0xC7);
+							modrm(mi, 0, d);
+							put(mi, static_cast<uint64_t>(s.value), 4);
+							return true;
+						}
+						mi.code.push_back(0x48);
+						mi.code.push_back(0xB8 + d.reg);
+						put_imm(mi, s, 8);
+						return true;
+					}
+					if (!prefixes(mi, size, nullptr))
+						return false;
+					mi.code.push_back((size == 1 ? 0xB0 : 0xB8) + d.reg);
+					put_imm(mi, s, size);
+					return true;
+				}
+				if (d.type == MOPMEM && s.type == MOPIMM) {
+					if (!prefixes(mi, size, &d))
+						return false;
+					mi.code.push_back(size == 1 ? 0xC6 : 0xC7);
+					if (!modrm(mi, 0, d))
+						return false;
+					put_imm(mi, s, size == 8 ? 4 : size, ELF_ABS32S);
+					return true;
+				}
+				break;
+
+			case ADD :
+				return encode_alu(mi, 0);
+			case OR :
+				return encode_alu(mi, 1);
+			case AND :
+				return encode_alu(mi, 4);
+			case SUB :
+				return encode_alu(mi, 5);
+			case XOR :
+				return encode_alu(mi, 6);
+			case CMP :
+				return encode_alu(mi, 7);
+
+			case TEST :
+				size = operand_size(mi);
+				if (n != 2 || size <= 0)
+					return fail(size < 0 ? "mismatch in operand sizes" : "operation size not specified");
+				if (s.type == MOPREG || (d.type == MOPREG && s.type == MOPMEM)) {
+					MachineOperand &r = (s.type == MOPREG ? s : d);
+					MachineOperand &m = (s.type == MOPREG ? d : s);
+					if (!prefixes(mi, size, &m))
+						return false;
+					mi.code.push_back(size == 1 ? 0x84 : 0x85);
+					return modrm(mi, r.reg, m);
+				}
+				if (s.type == MOPIMM) {
+					if (!prefixes(mi, size, &d))
+						return false;
+					if (d.type == MOPREG && d.reg == REG_ACC)
+						mi.code.push_back(size == 1 ? 0xA8 : 0xA9);
+					else {
+						mi.code.push_back(size == 1 ? 0xF6 : 0xF7);
+						if (!modrm(mi, 0, d))
+							return false;
+					}
+					put_imm(mi, s, size == 8 ? 4 : size, ELF_ABS32S);
+					return true;
+				}
+				break;
+
+			case NOT :
+				return encode_unary(mi, 2);
+			case NEG :
+				return encode_unary(mi, 3);
+			case MUL :
+				return encode_unary(mi, 4);
+			case DIV :
+				return encode_unary(mi, 6);
+			case IDIV :
+				return encode_unary(mi, 7);
+			case IMUL :
+				if (n == 1)
+					return encode_unary(mi, 5);
+				size = operand_size(mi);
+				if (n != 2 || d.type != MOPREG || size <= 1)
+					break;
+				if (s.type == MOPREG || s.type == MOPMEM) {
+					if (!prefixes(mi, size, &s))
+						return false;
+					mi.code.push_back(0x0F);
+					mi.code.push_back(0xAF);
+					return modrm(mi, d.reg, s);
+				}
+				if (s.type == MOPIMM) {
+					if (!prefixes(mi, size, nullptr))
+						return false;
+					int64_t v = sign_extend(s.value, size);
+					bool short_imm = s.symbol.empty() && fits8(v);
+					mi.code.push_back(short_imm ? 0x6B : 0x69);
+					modrm(mi, d.reg, d);
+					if (short_imm)
+						put(mi, static_cast<uint64_t>(v), 1);
+					else
+						put_imm(mi, s, size == 8 ? 4 : size, ELF_ABS32S);
+					return true;
+				}
+				break;
+
+			case INC :
+			case DEC :
+				if (n != 1 || (d.type != MOPREG && d.type != MOPMEM))
+					break;
+				if (d.size == 0)
+					return fail("operation size not specified");
+				if (!prefixes(mi, d.size, &d))
+					return false;
+				if (!x64 && d.type == MOPREG && d.size != 1) {
+					mi.code.push_back((mi.type == INC ? 0x40 : 0x48) + d.reg);
+					return true;
+				}
+				mi.code.push_back(d.size == 1 ? 0xFE : 0xFF);
+				return modrm(mi, mi.type == INC ? 0 : 1, d);
+
+			case SHL :
+				return encode_shift(mi, 4);
+			case SHR :
+				return encode_shift(mi, 5);
+
+			case PUSH :
+			case POP :
+				if (n != 1)
+					break;
+				if (d.type == MOPREG) {
+					if (d.size != 2 && d.size != (x64 ? 8 : 4))
+						break;
+					if (d.size == 2)
+						mi.code.push_back(0x66);
+					mi.code.push_back((mi.type == PUSH ? 0x50 : 0x58) + d.reg);
+					return true;
+				}
+				if (d.type == MOPMEM) {
+					if (d.size == 0)
+						return fail("operation size not specified");
+					if (d.size != 2 && d.size != (x64 ? 8 : 4))
+						break;
+					if (!prefixes(mi, d.size == 2 ? 2 : 0, &d))
+						return false;
+					mi.code.push_back(mi.type == PUSH ? 0xFF : 0x8F);
+					return modrm(mi, mi.type == PUSH ? 6 : 0, d);
+				}
+				if (d.type == MOPIMM && mi.type == PUSH) {
+					if (d.symbol.empty() && fits8(d.value)) {
+						mi.code.push_back(0x6A);
+						put(mi, static_cast<uint64_t>(d.value), 1);
+					}
+					else {
+						mi.code.push_back(0x68);
+						put_imm(mi, d, 4, ELF_ABS32S);
+					}
+					return true;
+				}
+				break;
+
+			case PUSHA :
+			case POPA :
+				if (x64 || n != 0)
+					break;
+				mi.code.push_back(mi.type == PUSHA ? 0x60 : 0x61);
+				return true;
+
+			case CALL :
+			case JMP :
+				if (n != 1)
+					break;
+				if (d.type == MOPIMM) {
+					if (d.symbol.empty())
+						return fail("absolute jump target");
+					mi.code.push_back(mi.type == CALL ? 0xE8 : 0xE9);
+					mi.fixups.push_back(Fixup{ELF_TEXT, mi.code.size(), ELF_PC32, d.symbol, d.value - 4});
+					put(mi, 0, 4);
+					return true;
+				}
+				if (d.type == MOPREG || d.type == MOPMEM) {
+					if (!prefixes(mi, 0, &d))
+						return false;
+					mi.code.push_back(0xFF);
+					return modrm(mi, mi.type == CALL ? 2 : 4, d);
+				}
+				break;
+
+			case RET :
+				if (n == 0) {
+					mi.code.push_back(0xC3);
+					return true;
+				}
+				if (n == 1 && d.type == MOPIMM && d.symbol.empty()) {
+					mi.code.push_back(0xC2);
+					put(mi, static_cast<uint64_t>(d.value), 2);
+					return true;
+				}
+				break;
+
+			case LEA :
+				if (n != 2 || d.type != MOPREG || s.type != MOPMEM || d.size == 1)
+					break;
+				if (!prefixes(mi, d.size, &s))
+					return false;
+				mi.code.push_back(0x8D);
+				return modrm(mi, d.reg, s);
+
+			case NOP :
+				mi.code.push_back(0x90);
+				return true;
+
+			case SAHF :
+				mi.code.push_back(0x9E);
+				return true;
+
+			case LOOP :
+				return fail("loop target out of range");
+
+			default:
+				if (mi.type >= JE && mi.type <= JNLE) {
+					// conditional jump to something outside of .text
+					if (n != 1 || d.type != MOPIMM || d.symbol.empty())
+						break;
+					mi.code.push_back(0x0F);
+					mi.code.push_back(0x80 + condition_codes[mi.type - JE]);
+					mi.fixups.push_back(Fixup{ELF_TEXT, mi.code.size(), ELF_PC32, d.symbol, d.value - 4});
+					put(mi, 0, 4);
+					return true;
+				}
+				if (mi.type >= FLD && mi.type <= FNOP)
+					return encode_fpu(mi);
+				break;
+		}
+		return fail("invalid combination of operands");
+	}
+
+	bool Encoder::is_branch(const MachineInstruction &mi) {
+
+		// jumps to labels in .text are resolved here, with short
+		// forms where the target is close enough
+
+		if (!((mi.type >= JMP && mi.type <= JNLE) || mi.type == LOOP))
+			return false;
+		if (mi.operand_count != 1 || mi.op[0].type != MOPIMM || mi.op[0].symbol.empty())
+			return false;
+		auto it = labels.find(mi.op[0].symbol);
+		return it != labels.end() && it->second.section == ELF_TEXT;
+	}
+
+	bool Encoder::layout_text(ElfObject &obj) {
+
+		for (auto &mi: text) {
+			if (mi.type == INSLABEL || is_branch(mi))
+				continue;
+			if (!encode_insn(mi)) {
+				err = insncls.insn_name(mi.type) + ": " + err;
+				return false;
+			}
+		}
+
+		auto branch_size = [](const MachineInstruction &mi) -> uint64_t {
+			if (!mi.near || mi.type == LOOP)
+				return 2;
+			return (mi.type == JMP ? 5 : 6);
+		};
+
+		// every branch starts short, the ones that can't reach are made near
+		// until nothing changes, sizes only ever grow so this ends. the
+		// text goes after what earlier calls put in obj
+
+		bool changed = true;
+		while (changed) {
+			changed = false;
+			uint64_t offset = obj.text.size();
+			for (auto &mi: text) {
+				mi.offset = offset;
+				if (mi.type == INSLABEL)
+					labels[mi.label].value = offset;
+				else if (is_branch(mi))
+					offset += branch_size(mi);
+				else
+					offset += mi.code.size();
+			}
+			for (auto &mi: text) {
+				if (!is_branch(mi) || mi.near || mi.type == LOOP)
+					continue;
+				int64_t target = labels[mi.op[0].symbol].value + mi.op[0].value;
+				if (!fits8(target - static_cast<int64_t>(mi.offset + 2))) {
+					mi.near = true;
+					changed = true;
+				}
+			}
+		}
+
+		for (auto &mi: text) {
+			if (mi.type != INSLABEL && is_branch(mi)) {
+				int64_t target = labels[mi.op[0].symbol].value + mi.op[0].value;
+				int64_t rel = target - static_cast<int64_t>(mi.offset + branch_size(mi));
+				if (mi.type == LOOP) {
+					if (!fits8(rel))
+						return fail("loop: target out of range");
+					mi.code = {0xE2};
+					put(mi, static_cast<uint64_t>(rel), 1);
+				}
+				else if (!mi.near) {
+					mi.code = {static_cast<uint8_t>(mi.type == JMP ? 0xEB : 0x70 + condition_codes[mi.type - JE])};
+					put(mi, static_cast<uint64_t>(rel), 1);
+				}
+				else {
+					if (mi.type == JMP)
+						mi.code = {0xE9};
+					else
+						mi.code = {0x0F, static_cast<uint8_t>(0x80 + condition_codes[mi.type - JE])};
+					put(mi, static_cast<uint64_t>(rel), 4);
+				}
+			}
+			for (auto f: mi.fixups) {
+				f.offset += mi.offset;
+				fixups.push_back(f);
+			}
+			obj.text.insert(obj.text.end(), mi.code.begin(), mi.code.end());
+		}
+		return true;
+	}
+
+	bool Encoder::resolve(const Fixup &f, ElfObject &obj) {
+		std::vector<uint8_t> &bytes = (f.section == ELF_TEXT ? obj.text : obj.data);
+		auto it = labels.find(f.symbol);
+
+		if (it == labels.end()) {
+			if (externs.find(f.symbol) == externs.end() && globals.find(f.symbol) == globals.end())
+				return fail("symbol '" + f.symbol + "' not defined");
+			obj.relocations.push_back(ElfRelocation{f.section, f.offset, f.type, f.symbol, ELF_UNDEF, f.addend});
+			return true;
+		}
+
+		const LabelInfo &l = it->second;
+		if (f.type == ELF_PC32 && l.section == f.section) {
+			int32_t rel = static_cast<int32_t>(l.value + f.addend - f.offset);
+			std::memcpy(&bytes[f.offset], &rel, sizeof(rel));
+			return true;
+		}
+		if (l.section == ELF_ABS)
+			return fail("relative reference to absolute symbol '" + f.symbol + "'");
+
+		// locals are relocated against their section, globals by name
+		if (globals.find(f.symbol) != globals.end())
+			obj.relocations.push_back(ElfRelocation{f.section, f.offset, f.type, f.symbol, l.section, f.addend});
+		else
+			obj.relocations.push_back(ElfRelocation{f.section, f.offset, f.type, "", l.section,
+													static_cast<int64_t>(l.value) + f.addend});
+		return true;
+	}
+
+	bool Encoder::encode(const std::vector<TextSection *> &text_section, const std::vector<Instruction *> &instructions,
+						 const std::vector<Member *> &data_section, const std::vector<ReserveSection *> &resv_section,
+						 ElfObject &obj) {
+		return begin(text_section, resv_section) && add(instructions, obj) && finish(data_section, resv_section, obj);
+	}
+
+	bool Encoder::begin(const std::vector<TextSection *> &text_section, const std::vector<ReserveSection *> &resv_section) {
+		for (TextSection *t: text_section) {
+			if (t->type == TXTGLOBAL)
+				globals.insert(t->symbol);
+			else if (t->type == TXTEXTERN)
+				externs.insert(t->symbol);
+		}
+
+		layout_records(resv_section);
+		return err.empty();
+	}
+
+	bool Encoder::add(const std::vector<Instruction *> &instructions, ElfObject &obj) {
+		for (Instruction *in: instructions) {
+			if (!get_instruction(in))
+				return false;
+		}
+
+		if (!layout_text(obj))
+			return false;
+		text.clear();
+		return true;
+	}
+
+	bool Encoder::finish(const std::vector<Member *> &data_section, const std::vector<ReserveSection *> &resv_section,
+						 ElfObject &obj) {
+
+		// .data is only laid out now, its fixups go first all the same so
+		// the relocations are in the order they always were
+
+		size_t text_fixups = fixups.size();
+		if (!layout_data(data_section, obj))
+			return false;
+		layout_bss(resv_section, obj);
+		if (!err.empty())
+			return false;
+		std::rotate(fixups.begin(), fixups.begin() + static_cast<std::ptrdiff_t>(text_fixups), fixups.end());
+
+		for (const auto &f: fixups) {
+			if (!resolve(f, obj))
+				return false;
+		}
+
+		for (const auto &l: labels)
+			obj.symbols.push_back(ElfSymbol{l.first, l.second.section, l.second.value, globals.count(l.first) > 0});
+
+		for (const auto &e: externs) {
+			if (labels.find(e) == labels.end())
+				obj.symbols.push_back(ElfSymbol{e, ELF_UNDEF, 0, true});
+		}
+		for (const auto &g: globals) {
+			if (labels.find(g) == labels.end() && externs.find(g) == externs.end())
+				obj.symbols.push_back(ElfSymbol{g, ELF_UNDEF, 0, true});
+		}
+		return true;
+	}
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <utility>
+#include <cstdint>
+#include "insn.hpp"
+#include "regs.hpp"
+#include "elf.hpp"
+
+namespace xlang {
+
+	enum MachineOperandType {
+		MOPNONE,
+		MOPREG,
+		MOPFREG,
+		MOPIMM,
+		MOPMEM
+	};
+
+	// an operand the way the cpu sees it, registers are hardware numbers
+
+	struct MachineOperand {
+		MachineOperandType type{MOPNONE};
+		int size{0};            // operand size in bytes, 0 if not given
+		int reg{-1};            // register, or base register of memory
+		int index{-1};          // index register of memory
+		int scale{1};
+		int addr_size{0};       // size of base/index registers
+		int64_t value{0};       // immediate or displacement
+		std::string symbol;     // symbol added to value
+	};
+
+	struct Fixup {
+		ElfSectionId section;
+		uint64_t offset;
+		ElfRelocationType type;
+		std::string symbol;
+		int64_t addend;
+	};
+
+	struct MachineInstruction {
+		InstructionType type{INSNONE};
+		std::string label;      // defined label if type is INSLABEL
+		int operand_count{0};
+		MachineOperand op[2];
+		uint64_t offset{0};
+		bool near{false};       // branch needs rel32
+		std::vector<uint8_t> code;
+		std::vector<Fixup> fixups;
+	};
+
+	struct LabelInfo {
+		ElfSectionId section;
+		uint64_t value;
+	};
+
+	// x86 encoder
+	//
+	// turns the sections and instructions built by CodeGen into machine code
+	// and fills an ElfObject with it, so nasm does not have to run.
+	// it follows nasm's choices (shortest immediates and jumps, local labels
+	// scoped to the previous label, struc offsets) so both give the same code.
+	// anything it does not understand is left in error() and the caller
+	// falls back to nasm
+
+	class Encoder {
+	public:
+		explicit Encoder(bool is64) : x64(is64) {}
+
+		bool encode(const std::vector<TextSection *> &, const std::vector<Instruction *> &,
+					const std::vector<Member *> &, const std::vector<ReserveSection *> &, ElfObject &);
+
+		// encode() in pieces for --stream: begin() with the text and record
+		// sections, add() with the instructions of one function at a time
+		// and finish() with the data and bss sections. a branch to a label
+		// of a later add() can't be made short, it is encoded like a jump
+		// to another file
+		bool begin(const std::vector<TextSection *> &, const std::vector<ReserveSection *> &);
+
+		bool add(const std::vector<Instruction *> &, ElfObject &);
+
+		bool finish(const std::vector<Member *> &, const std::vector<ReserveSection *> &, ElfObject &);
+
+		const std::string &error() const {
+			return err;
+		}
+
+	private:
+		bool x64;
+		std::string err;
+		std::string scope;
+		Registers regs;
+		InstructionClass insncls;
+
+		std::vector<MachineInstruction> text;
+		std::map<std::string, LabelInfo> labels;
+		std::vector<Fixup> fixups;
+		std::set<std::string> globals;
+		std::set<std::string> externs;
+
+		bool fail(const std::string &);
+
+		std::string scoped(const std::string &);
+
+		bool define_label(const std::string &, ElfSectionId, uint64_t);
+
+		bool parse_number(const std::string &, int64_t &);
+
+		bool parse_register(const std::string &, MachineOperand &);
+
+		bool address_registers(MachineOperand &, const std::vector<std::pair<MachineOperand, int>> &);
+
+		bool parse_expression(const std::string &, MachineOperand &, bool);
+
+		bool parse_operand(std::string, MachineOperand &);
+
+		bool parse_inline_asm(const std::string &);
+
+		bool get_operand(const Operand *, int, int, MachineOperand &);
+
+		bool get_instruction(const Instruction *);
+
+		void layout_records(const std::vector<ReserveSection *> &);
+
+		bool layout_data(const std::vector<Member *> &, ElfObject &);
+
+		void layout_bss(const std::vector<ReserveSection *> &, ElfObject &);
+
+		bool is_branch(const MachineInstruction &);
+
+		bool layout_text(ElfObject &);
+
+		bool resolve(const Fixup &, ElfObject &);
+
+		void put(MachineInstruction &, uint64_t, int);
+
+		void put_imm(MachineInstruction &, const MachineOperand &, int, ElfRelocationType = ELF_ABS32);
+
+		bool prefixes(MachineInstruction &, int, const MachineOperand *);
+
+		bool modrm(MachineInstruction &, int, const MachineOperand &);
+
+		int operand_size(MachineInstruction &);
+
+		bool encode_insn(MachineInstruction &);
+
+		bool encode_alu(MachineInstruction &, int);
+
+		bool encode_unary(MachineInstruction &, int);
+
+		bool encode_shift(MachineInstruction &, int);
+
+		bool encode_fpu(MachineInstruction &);
+	};
+}
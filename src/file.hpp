@@ -8,6 +8,9 @@
 #pragma once
 
 #include <string>
+#include <memory>
+#include <filesystem>
+#include "source.hpp"
 
 namespace xlang {
 	
@@ -17,29 +20,25 @@ namespace xlang {
 		std::string path;
 		std::string name;
 		std::string extension;
-		std::string content;
-		bool loaded = false;
+		std::shared_ptr<SourceBuffer> buffer;   // null until the lexer loads the file
 		
-		std::string asm_name() {
+		// outputs are written to the current directory and named after
+		// the source, nothing here changes name so messages keep it
 
-		    // remove .x from end of filename and attach .asm as suffix
-
-			size_t fnd = name.find_last_of('.');
-			if (fnd != std::string::npos) 
-				name = name.substr(0, fnd);
+		std::string stem() const {
+			return std::filesystem::path(path.empty() ? name : path).stem();
+		}
 
-			return name + ".asm";
+		std::string asm_name() const {
+			return stem() + ".asm";
 		}
 		
-		std::string object_name() {
-
-		    // remove .x from end of filename and attach .asm as suffix
+		std::string object_name() const {
+			return stem() + ".o";
+		}
 
-			size_t fnd = name.find_last_of('.');
-            if (fnd != std::string::npos) 
-				name = name.substr(0, fnd);
-			
-			return name + ".o";
+		std::string exe_name() const {
+			return stem();
 		}
 	};
 }
\ No newline at end of file
@@ -11,8 +11,13 @@
 #include "parser.hpp"
 #include "convert.hpp"
 #include "gen.hpp"
+#include "encode.hpp"
 #include "compiler.hpp"
 
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
 namespace xlang {
 
 	int CodeGen::data_type_size(Token tok) {
@@ -114,18 +119,18 @@ namespace xlang {
 				if (type.number == KEY_FLOAT || type.number == KEY_DOUBLE)
 					return true;
 				else
-					return (has_float(pexpr->left) || has_float(pexpr->right));
+					return (has_float(Tree::primary_expr(pexpr->left)) || has_float(Tree::primary_expr(pexpr->right)));
 			}
 			else
-				return (has_float(pexpr->left) || has_float(pexpr->right));
+				return (has_float(Tree::primary_expr(pexpr->left)) || has_float(Tree::primary_expr(pexpr->right)));
 		}
 		else if (pexpr->is_oprtr)
-			return (has_float(pexpr->left) || has_float(pexpr->right));
+			return (has_float(Tree::primary_expr(pexpr->left)) || has_float(Tree::primary_expr(pexpr->right)));
 		else {
 			if (pexpr->tok.number == LIT_FLOAT)
 				return true;
 			else
-				return (has_float(pexpr->left) || has_float(pexpr->right));
+				return (has_float(Tree::primary_expr(pexpr->left)) || has_float(Tree::primary_expr(pexpr->right)));
 		}
 		return false;
 	}
@@ -152,13 +157,13 @@ namespace xlang {
 				}
 			}
 			else {
-				max_datatype_size(pexpr->left, &(*dsize));
-				max_datatype_size(pexpr->right, &(*dsize));
+				max_datatype_size(Tree::primary_expr(pexpr->left), &(*dsize));
+				max_datatype_size(Tree::primary_expr(pexpr->right), &(*dsize));
 			}
 		}
 		else if (pexpr->is_oprtr) {
-			max_datatype_size(pexpr->left, &(*dsize));
-			max_datatype_size(pexpr->right, &(*dsize));
+			max_datatype_size(Tree::primary_expr(pexpr->left), &(*dsize));
+			max_datatype_size(Tree::primary_expr(pexpr->right), &(*dsize));
 		}
 		else {
 			switch (pexpr->tok.number) {
@@ -176,8 +181,8 @@ namespace xlang {
 						*dsize = 4;
 					break;
 				default:
-					max_datatype_size(pexpr->left, &(*dsize));
-					max_datatype_size(pexpr->right, &(*dsize));
+					max_datatype_size(Tree::primary_expr(pexpr->left), &(*dsize));
+					max_datatype_size(Tree::primary_expr(pexpr->right), &(*dsize));
 					break;
 			}
 		}
@@ -218,14 +223,14 @@ namespace xlang {
 							fm.fp_disp = fp;
 							total += fm.insize;
 						}
-						flm.members.insert(std::pair<std::string, FunctionMember>(syminf->symbol, fm));
+						flm.add(syminf->tok.name, fm);
 						break;
 					case NodeType::RECORD :
 						fm.insize = 4;
 						fp = fp - 4;
 						fm.fp_disp = fp;
 						total += 4;
-						flm.members.insert(std::pair<std::string, FunctionMember>(syminf->symbol, fm));
+						flm.add(syminf->tok.name, fm);
 						break;
 					default:
 						break;
@@ -260,14 +265,14 @@ namespace xlang {
 						fm.fp_disp = fp;
 					}
 
-					flm.members.insert(std::pair<std::string, FunctionMember>(fparam->symbol_info->symbol, fm));
+					flm.add(fparam->symbol_info->tok.name, fm);
 					break;
 
 				case NodeType::RECORD :
 					fm.insize = 4;
 					fp = fp + 4;
 					fm.fp_disp = fp;
-					flm.members.insert(std::pair<std::string, FunctionMember>(fparam->symbol_info->symbol, fm));
+					flm.add(fparam->symbol_info->tok.name, fm);
 					break;
 
 				default:
@@ -275,20 +280,20 @@ namespace xlang {
 			}
 		}
 
-		func_members.insert(std::pair<std::string, LocalMembers>(func_symtab->func_info->func_name, flm));
+		func_members.insert(std::pair<NameId, LocalMembers>(func_symtab->func_info->tok.name, flm));
 	}
 
-	SymbolInfo *CodeGen::search_func_params(const std::string &str) {
+	SymbolInfo *CodeGen::search_func_params(NameId name) {
 
 		//search symbol in function parameters
 
-		if (func_params == nullptr)
+		if (func_params == nullptr || name == NO_NAME)
 			return nullptr;
 
 		if (func_params->param_list.size() > 0) {
 			for (auto syminf: func_params->param_list) {
 				if (syminf->symbol_info != nullptr) {
-					if (syminf->symbol_info->symbol == str)
+					if (syminf->symbol_info->tok.name == name)
 						return syminf->symbol_info;
 				}
 			}
@@ -296,26 +301,26 @@ namespace xlang {
 		return nullptr;
 	}
 
-	SymbolInfo *CodeGen::search_id(const std::string &str) {
+	SymbolInfo *CodeGen::search_id(NameId name) {
 
 		//search in symbol tables, same as in analyze.cpp
 
 		SymbolInfo *syminf = nullptr;
 		if (func_symtab != nullptr) {
 			//search in function symbol table
-			syminf = SymbolTable::search_symbol_node(func_symtab, str);
+			syminf = SymbolTable::search_symbol_node(func_symtab, name);
 			if (syminf == nullptr) {
 				//if null, then search in function parameters
-				syminf = search_func_params(str);
+				syminf = search_func_params(name);
 				if (syminf == nullptr) {
 					//if null, then search in global symbol table
-					syminf = SymbolTable::search_symbol_node(Compiler::symtab, str);
+					syminf = SymbolTable::search_symbol_node(comp->symtab, name);
 				}
 			}
 		}
 		else
 			//if function symbol table null, then search in global symbol table
-			syminf = SymbolTable::search_symbol_node(Compiler::symtab, str);
+			syminf = SymbolTable::search_symbol_node(comp->symtab, name);
 
 		return syminf;
 	}
@@ -352,11 +357,11 @@ namespace xlang {
 			pexp_stack.pop();
 			pexp_out_stack.push(pexp);
 
-			if (pexp->left != nullptr)
-				pexp_stack.push(pexp->left);
+			if (pexp->left != NO_NODE)
+				pexp_stack.push(Tree::primary_expr(pexp->left));
 
-			if (pexp->right != nullptr)
-				pexp_stack.push(pexp->right);
+			if (pexp->right != NO_NODE)
+				pexp_stack.push(Tree::primary_expr(pexp->right));
 		}
 
 		clear_stack(pexp_stack);
@@ -375,6 +380,10 @@ namespace xlang {
 		return in;
 	}
 
+	std::string CodeGen::line_number(TokenLocation loc) {
+		return std::to_string(comp->global.file.buffer->position(loc).line);
+	}
+
 	void CodeGen::insert_comment(const std::string &cmnt) {
 
 		//add new instruction with only comment
@@ -386,7 +395,7 @@ namespace xlang {
 		instructions.push_back(in);
 	}
 
-	Member *CodeGen::search_data(const std::string &dt) {
+	Member *CodeGen::search_data(std::string_view dt) {
 
 		//search given data in data section vector
 
@@ -397,7 +406,7 @@ namespace xlang {
 		return nullptr;
 	}
 
-	Member *CodeGen::search_string_data(const std::string &dt) {
+	Member *CodeGen::search_string_data(std::string_view dt) {
 
 		//search given data in data section vector
 
@@ -441,7 +450,7 @@ namespace xlang {
 		}
 	}
 
-	std::string CodeGen::get_hex_string(const std::string &str) {
+	std::string CodeGen::get_hex_string(std::string_view str) {
 
 		//convert string into its hex representation, 1 byte each
 
@@ -498,11 +507,11 @@ namespace xlang {
 			return false;
 		}
 
-		fmemit = func_members.find(func_symtab->func_info->func_name);
+		fmemit = func_members.find(func_symtab->func_info->tok.name);
 
 		if (fmemit != func_members.end()) {
 
-			memit = (fmemit->second.members).find(tok.string);
+			memit = (fmemit->second.members).find(tok.name);
 
 			if (memit != (fmemit->second.members).end()) {
 				fmemb->insize = memit->second.insize;
@@ -516,7 +525,7 @@ namespace xlang {
 		return false;
 	}
 
-	InstructionType CodeGen::get_arthm_op(const std::string &symbol) {
+	InstructionType CodeGen::get_arthm_op(std::string_view symbol) {
 		//get arithmetic instruction type
 
 		if (symbol == "+")
@@ -563,7 +572,7 @@ namespace xlang {
 		else
 			rs = EAX;
 
-		if (pexpr->left == nullptr && pexpr->right == nullptr) {
+		if (pexpr->left == NO_NODE && pexpr->right == NO_NODE) {
 
 			if (pexpr->id_info != nullptr) {
 
@@ -574,10 +583,10 @@ namespace xlang {
 					in->operand_2->type = MEMORY;
 					in->operand_2->mem.mem_type = LOCAL;
 
-					syminf = search_id(pexpr->id_info->symbol);
+					syminf = search_id(pexpr->id_info->tok.name);
 					if (syminf != nullptr && syminf->is_ptr) {
 
-						if (Compiler::global.x64) {
+						if (comp->global.x64) {
 							in->operand_1->reg = RAX;
 							in->operand_2->mem.mem_size = 8;
 						}
@@ -603,9 +612,9 @@ namespace xlang {
 					in->operand_2->type = MEMORY;
 					in->operand_2->mem.mem_type = GLOBAL;
 
-					syminf = search_id(pexpr->id_info->symbol);
+					syminf = search_id(pexpr->id_info->tok.name);
 					if (syminf != nullptr && syminf->is_ptr) {
-						if (Compiler::global.x64) {
+						if (comp->global.x64) {
 							in->operand_1->reg = RAX;
 							in->operand_2->mem.mem_size = 8;
 						}
@@ -646,10 +655,10 @@ namespace xlang {
 		if (pexpr == nullptr)
 			return false;
 
-		pexpr = pexpr->unary_node;
-		insert_comment("; line " + std::to_string(pexpr->tok.loc.line));
+		pexpr = Tree::primary_expr(pexpr->unary_node);
+		insert_comment("; line " + line_number(pexpr->tok.loc));
 
-		if (pexpr->left == nullptr && pexpr->right == nullptr) {
+		if (pexpr->left == NO_NODE && pexpr->right == NO_NODE) {
 			if (pexpr->id_info != nullptr) {
 
 				in = get_insn(NEG, 1);
@@ -676,7 +685,7 @@ namespace xlang {
 		return false;
 	}
 
-	Member *CodeGen::create_string_data(const std::string &value) {
+	Member *CodeGen::create_string_data(std::string_view value) {
 
 		//create new data in data section with string
 
@@ -685,7 +694,7 @@ namespace xlang {
 		dt->type = DB;
 		dt->value = get_hex_string(value);
 		dt->is_array = false;
-		dt->comment = "    ; '" + value + "'";
+		dt->comment = "    ; '" + std::string(value) + "'";
 		string_data_count++;
 		return dt;
 	}
@@ -697,7 +706,7 @@ namespace xlang {
 
 		if (pexpr == nullptr)
 			return RNONE;
-		if (pexpr->left == nullptr && pexpr->right == nullptr) {
+		if (pexpr->left == NO_NODE && pexpr->right == NO_NODE) {
 			if (pexpr->tok.number == LIT_STRING) {
 				Member *dt = search_string_data(pexpr->tok.string);
 				if (dt == nullptr) {
@@ -708,7 +717,7 @@ namespace xlang {
 				Instruction *in = get_insn(MOV, 2);
 				in->operand_1->type = REGISTER;
 
-				if (Compiler::global.x64)
+				if (comp->global.x64)
 					in->operand_1->reg = RAX;
 				else
 					in->operand_1->reg = EAX;
@@ -719,7 +728,7 @@ namespace xlang {
 				in->operand_2->mem.name = dt->symbol;
 				instructions.push_back(in);
 
-				if (Compiler::global.x64)
+				if (comp->global.x64)
 					return RAX;
 				else
 					return EAX;
@@ -751,10 +760,10 @@ namespace xlang {
 		//get maximum data type size
 		max_datatype_size(pexpr, &dtsize);
 
-		if (pexpr->unary_node != nullptr) {
+		if (pexpr->unary_node != NO_NODE) {
 			// check for bit complement operator
 			if (pexpr->tok.number == BIT_COMPL) {
-				max_datatype_size(pexpr->unary_node, &dtsize);
+				max_datatype_size(Tree::primary_expr(pexpr->unary_node), &dtsize);
 				if (gen_int_primexp_compl(pexpr, dtsize))
 					return RNONE;
 			}
@@ -768,7 +777,7 @@ namespace xlang {
 		if (dtsize <= 0)
 			return RNONE;
 
-		insert_comment("; line " + std::to_string(pexpr->tok.loc.line));
+		insert_comment("; line " + line_number(pexpr->tok.loc));
 
 		//if only one node in primary Expression
 		r1 = gen_int_primexp_single_assgn(pexpr, dtsize);
@@ -782,20 +791,20 @@ namespace xlang {
 		in = get_insn(XOR, 2);
 
 		in->operand_1->type = REGISTER;
-		Compiler::global.x64 ? in->operand_1->reg = RAX : in->operand_1->reg = EAX;
+		comp->global.x64 ? in->operand_1->reg = RAX : in->operand_1->reg = EAX;
 
 		in->operand_2->type = REGISTER;
-		Compiler::global.x64 ? in->operand_2->reg = RAX : in->operand_2->reg = EAX;
+		comp->global.x64 ? in->operand_2->reg = RAX : in->operand_2->reg = EAX;
 
 		instructions.push_back(in);
 
 		in = get_insn(XOR, 2);
 		in->operand_1->type = REGISTER;
 
-		Compiler::global.x64 ? in->operand_1->reg = RDX : in->operand_1->reg = EDX;
+		comp->global.x64 ? in->operand_1->reg = RDX : in->operand_1->reg = EDX;
 		in->operand_2->type = REGISTER;
 
-		Compiler::global.x64 ? in->operand_2->reg = RDX : in->operand_2->reg = EDX;
+		comp->global.x64 ? in->operand_2->reg = RDX : in->operand_2->reg = EDX;
 		instructions.push_back(in);
 
 		while (!pexp_out_stack.empty()) {
@@ -847,7 +856,7 @@ namespace xlang {
 						in->operand_1->type = REGISTER;
 						in->operand_1->reg = r1;
 						in->operand_2->type = LITERAL;
-						in->operand_2->literal = fact1->tok.string;
+						in->operand_2->literal = Convert::tok_to_string(fact1->tok);
 						instructions.push_back(in);
 						in = nullptr;
 						result.push(r1);
@@ -893,7 +902,7 @@ namespace xlang {
 							if (fact1->id_info != nullptr && fact1->id_info->is_ptr)
 								in->operand_2->literal = std::to_string(Convert::tok_to_decimal(fact2->tok) * 4);
 							else
-								in->operand_2->literal = fact2->tok.string;
+								in->operand_2->literal = Convert::tok_to_string(fact2->tok);
 
 							instructions.push_back(in);
 							in = nullptr;
@@ -965,7 +974,7 @@ namespace xlang {
 						in->operand_1->type = REGISTER;
 						in->operand_1->reg = r1;
 						in->operand_2->type = LITERAL;
-						in->operand_2->literal = fact2->tok.string;
+						in->operand_2->literal = Convert::tok_to_string(fact2->tok);
 						instructions.push_back(in);
 						in = nullptr;
 					}
@@ -988,7 +997,7 @@ namespace xlang {
 						in->operand_1->type = REGISTER;
 						in->operand_1->reg = r2;
 						in->operand_2->type = LITERAL;
-						in->operand_2->literal = fact1->tok.string;
+						in->operand_2->literal = Convert::tok_to_string(fact1->tok);
 					}
 					else {
 
@@ -1159,7 +1168,7 @@ namespace xlang {
 		return r1;
 	}
 
-	InstructionType CodeGen::get_farthm_op(const std::string &symbol, bool reverse_ins) {
+	InstructionType CodeGen::get_farthm_op(std::string_view symbol, bool reverse_ins) {
 
 		//return float arithmetic instruction types
 
@@ -1174,7 +1183,7 @@ namespace xlang {
 		return INSNONE;
 	}
 
-	Member *CodeGen::create_float_data(DeclarationType ds, const std::string &value) {
+	Member *CodeGen::create_float_data(DeclarationType ds, std::string_view value) {
 
 		//create float data in data section
 
@@ -1200,15 +1209,15 @@ namespace xlang {
 		if (pexpr == nullptr)
 			return FRNONE;
 
-		if (pexpr->left == nullptr && pexpr->right == nullptr) {
+		if (pexpr->left == NO_NODE && pexpr->right == NO_NODE) {
 			if (!pexpr->is_id) {
-				dt = create_float_data(decsp, pexpr->tok.string);
+				dt = create_float_data(decsp, Convert::tok_to_string(pexpr->tok));
 				in = get_insn(FLD, 1);
 				in->operand_1->type = MEMORY;
 				in->operand_1->mem.mem_type = GLOBAL;
 				in->operand_1->mem.mem_size = data_decl_size(decsp);
 				in->operand_1->mem.name = dt->symbol;
-				in->comment = "  ; " + pexpr->tok.string;
+				in->comment = "  ; " + Convert::tok_to_string(pexpr->tok);
 			}
 			else {
 
@@ -1266,7 +1275,7 @@ namespace xlang {
 		else if (dtsize == 8)
 			decsp = DQ;
 
-		insert_comment("; line " + std::to_string(pexpr->tok.loc.line));
+		insert_comment("; line " + line_number(pexpr->tok.loc));
 
 		r1 = gen_float_primexp_single_assgn(pexpr, decsp);
 		if (r1 != FRNONE)
@@ -1287,13 +1296,13 @@ namespace xlang {
 					pexp_stack.pop();
 
 					if (!fact1->is_id) {
-						dt = create_float_data(decsp, fact1->tok.string);
+						dt = create_float_data(decsp, Convert::tok_to_string(fact1->tok));
 						in = get_insn(FLD, 1);
 						in->operand_1->type = MEMORY;
 						in->operand_1->mem.mem_type = GLOBAL;
 						in->operand_1->mem.mem_size = dtsize;
 						in->operand_1->mem.name = dt->symbol;
-						in->comment = "  ; " + fact1->tok.string;
+						in->comment = "  ; " + Convert::tok_to_string(fact1->tok);
 						insncls->delete_operand(&(in->operand_2));
 						instructions.push_back(in);
 						in = nullptr;
@@ -1325,13 +1334,13 @@ namespace xlang {
 					}
 
 					if (!fact2->is_id) {
-						dt = create_float_data(decsp, fact2->tok.string);
+						dt = create_float_data(decsp, Convert::tok_to_string(fact2->tok));
 						in = get_insn(FLD, 1);
 						in->operand_1->type = MEMORY;
 						in->operand_1->mem.mem_type = GLOBAL;
 						in->operand_1->mem.mem_size = dtsize;
 						in->operand_1->mem.name = dt->symbol;
-						in->comment = "  ; " + fact2->tok.string;
+						in->comment = "  ; " + Convert::tok_to_string(fact2->tok);
 						insncls->delete_operand(&(in->operand_2));
 						instructions.push_back(in);
 						in = nullptr;
@@ -1377,13 +1386,13 @@ namespace xlang {
 					pexp_stack.pop();
 
 					if (!fact1->is_id) {
-						dt = create_float_data(decsp, fact1->tok.string);
+						dt = create_float_data(decsp, Convert::tok_to_string(fact1->tok));
 						in = get_insn(FLD, 1);
 						in->operand_1->type = MEMORY;
 						in->operand_1->mem.mem_type = GLOBAL;
 						in->operand_1->mem.mem_size = dtsize;
 						in->operand_1->mem.name = dt->symbol;
-						in->comment = "  ; " + fact1->tok.string;
+						in->comment = "  ; " + Convert::tok_to_string(fact1->tok);
 						insncls->delete_operand(&(in->operand_2));
 						instructions.push_back(in);
 						in = nullptr;
@@ -1436,7 +1445,7 @@ namespace xlang {
 		reg->free_float_register(r1);
 	}
 
-	std::pair<int, int> CodeGen::gen_primary_expr(PrimaryExpression **pexpr) {
+	std::pair<int, int> CodeGen::gen_primary_expr(PrimaryExpression *pexpr2) {
 
 		// return pair as result of an primary expression
 		// pair(type: int,float, register: simple, float)
@@ -1445,7 +1454,6 @@ namespace xlang {
 
 		RegisterType result;
 		std::pair<int, int> pr(-1, -1);
-		PrimaryExpression *pexpr2 = *pexpr;
 
 		if (pexpr2 == nullptr)
 			return pr;
@@ -1480,15 +1488,15 @@ namespace xlang {
 		if (assgnexp == nullptr)
 			return;
 
-		if (assgnexp->id_expr == nullptr)
+		if (assgnexp->id_expr == NO_NODE)
 			return;
 
-		left = assgnexp->id_expr;
-		if (left->unary != nullptr)
-			left = left->unary;
+		left = Tree::id_expr(assgnexp->id_expr);
+		if (left->unary != NO_NODE)
+			left = Tree::id_expr(left->unary);
 
 		//generate primary expression & get its result
-		pexp_result = gen_primary_expr(&(assgnexp->expression->primary_expr));
+		pexp_result = gen_primary_expr(Tree::primary_expr(assgnexp->expression->primary_expr));
 
 		if (pexp_result.first == -1)
 			return;
@@ -1566,10 +1574,10 @@ namespace xlang {
 					in2 = get_insn(XOR, 2);
 
 					in2->operand_1->type = REGISTER;
-					Compiler::global.x64 ? in2->operand_1->reg = RCX : in2->operand_1->reg = ECX;
+					comp->global.x64 ? in2->operand_1->reg = RCX : in2->operand_1->reg = ECX;
 
 					in2->operand_2->type = REGISTER;
-					Compiler::global.x64 ? in2->operand_2->reg = RCX : in2->operand_2->reg = ECX;
+					comp->global.x64 ? in2->operand_2->reg = RCX : in2->operand_2->reg = ECX;
 
 					instructions.push_back(in2);
 					in2 = nullptr;
@@ -1592,7 +1600,7 @@ namespace xlang {
 						instructions.push_back(in2);
 					}
 
-					Compiler::global.x64 ? in->operand_1->reg = RCX : in->operand_1->reg = ECX;
+					comp->global.x64 ? in->operand_1->reg = RCX : in->operand_1->reg = ECX;
 					in->operand_1->arr_disp = dtsize;
 				}
 			}
@@ -1634,17 +1642,17 @@ namespace xlang {
 			return;
 
 		if (szofnexp->is_simple_type) {
-			insert_comment("; line " + std::to_string(szofnexp->simple_type[0].loc.line));
+			insert_comment("; line " + line_number(szofnexp->simple_type[0].loc));
 			in = get_insn(MOV, 2);
 
 			in->operand_1->type = REGISTER;
-			Compiler::global.x64 ? in->operand_1->reg = RAX : in->operand_1->reg = EAX;
+			comp->global.x64 ? in->operand_1->reg = RAX : in->operand_1->reg = EAX;
 
 			in->operand_2->type = LITERAL;
-			in->comment = "    ;  sizeof " + szofnexp->simple_type[0].string;
+			in->comment = "    ;  sizeof " + std::string(szofnexp->simple_type[0].string);
 
 			if (szofnexp->is_ptr) {
-				Compiler::global.x64 ? in->operand_2->literal = "8" : in->operand_2->literal = "4";
+				comp->global.x64 ? in->operand_2->literal = "8" : in->operand_2->literal = "4";
 				in->comment += " pointer";
 			}
 			else
@@ -1653,21 +1661,21 @@ namespace xlang {
 			instructions.push_back(in);
 		}
 		else {
-			insert_comment("; line " + std::to_string(szofnexp->identifier.loc.line));
+			insert_comment("; line " + line_number(szofnexp->identifier.loc));
 			in = get_insn(MOV, 2);
 			in->operand_1->type = REGISTER;
 
-			Compiler::global.x64 ? in->operand_1->reg = RAX : in->operand_1->reg = EAX;
+			comp->global.x64 ? in->operand_1->reg = RAX : in->operand_1->reg = EAX;
 			in->operand_2->type = LITERAL;
-			in->comment = "    ;  sizeof " + szofnexp->identifier.string;
+			in->comment = "    ;  sizeof " + std::string(szofnexp->identifier.string);
 
 			if (szofnexp->is_ptr) {
-				Compiler::global.x64 ? in->operand_2->literal = "8" : in->operand_2->literal = "4";
+				comp->global.x64 ? in->operand_2->literal = "8" : in->operand_2->literal = "4";
 				in->comment += " pointer";
 			}
 			else {
-				std::unordered_map<std::string, int>::iterator it;
-				it = record_sizes.find(szofnexp->identifier.string);
+				std::unordered_map<NameId, int>::iterator it;
+				it = record_sizes.find(szofnexp->identifier.name);
 				if (it != record_sizes.end())
 					in->operand_2->literal = std::to_string(it->second);
 			}
@@ -1686,12 +1694,12 @@ namespace xlang {
 
 		if (assgnexp == nullptr)
 			return;
-		if (assgnexp->id_expr == nullptr)
+		if (assgnexp->id_expr == NO_NODE)
 			return;
 
-		left = assgnexp->id_expr;
-		if (left->unary != nullptr)
-			left = left->unary;
+		left = Tree::id_expr(assgnexp->id_expr);
+		if (left->unary != NO_NODE)
+			left = Tree::id_expr(left->unary);
 
 		gen_sizeof_expr(&assgnexp->expression->sizeof_expr);
 
@@ -1706,27 +1714,27 @@ namespace xlang {
 		if (get_function_local_member(&fmem, left->id_info->tok)) {
 			in->operand_1->mem.mem_type = LOCAL;
 			in->operand_1->mem.fp_disp = fmem.fp_disp;
-			Compiler::global.x64 ? in->operand_1->mem.mem_size = 8 : in->operand_1->mem.mem_size = 4;
+			comp->global.x64 ? in->operand_1->mem.mem_size = 8 : in->operand_1->mem.mem_size = 4;
 			in->operand_2->type = REGISTER;
-			Compiler::global.x64 ? in->operand_2->reg = RAX : in->operand_2->reg = EAX;
-			in->comment = "    ; line: " + std::to_string(assgnexp->tok.loc.line);
+			comp->global.x64 ? in->operand_2->reg = RAX : in->operand_2->reg = EAX;
+			in->comment = "    ; line: " + line_number(assgnexp->tok.loc);
 			instructions.push_back(in);
 		}
 		else {
 			in->operand_1->mem.mem_type = GLOBAL;
 
-			Compiler::global.x64 ? in->operand_1->mem.mem_size = 8 : in->operand_1->mem.mem_size = 4;
+			comp->global.x64 ? in->operand_1->mem.mem_size = 8 : in->operand_1->mem.mem_size = 4;
 			in->operand_1->mem.name = left->id_info->symbol;
 			in->operand_2->type = REGISTER;
 
-			Compiler::global.x64 ? in->operand_2->reg = RAX : in->operand_2->reg = EAX;
+			comp->global.x64 ? in->operand_2->reg = RAX : in->operand_2->reg = EAX;
 
 			if (left->is_subscript) {
 				Token sb = *(left->subscript.begin());
-				in->operand_1->mem.fp_disp = std::stoi(sb.string) * dtsize;
+				in->operand_1->mem.fp_disp = Convert::tok_to_decimal(sb) * dtsize;
 			}
 
-			in->comment = "    ; line: " + std::to_string(assgnexp->tok.loc.line);
+			in->comment = "    ; line: " + line_number(assgnexp->tok.loc);
 			instructions.push_back(in);
 		}
 	}
@@ -1742,7 +1750,7 @@ namespace xlang {
 
 		if (assgnexp == nullptr)
 			return;
-		if (assgnexp->id_expr == nullptr)
+		if (assgnexp->id_expr == NO_NODE)
 			return;
 
 		auto resreg = [=](int sz) {
@@ -1756,9 +1764,9 @@ namespace xlang {
 				return RAX;
 		};
 
-		left = assgnexp->id_expr;
-		if (left->unary != nullptr)
-			left = left->unary;
+		left = Tree::id_expr(assgnexp->id_expr);
+		if (left->unary != NO_NODE)
+			left = Tree::id_expr(left->unary);
 
 		gen_cast_expr(&assgnexp->expression->cast_expr);
 
@@ -1790,22 +1798,21 @@ namespace xlang {
 
 			if (left->is_subscript) {
 				Token sb = *(left->subscript.begin());
-				in->operand_1->mem.fp_disp = std::stoi(sb.string) * dtsize;
+				in->operand_1->mem.fp_disp = Convert::tok_to_decimal(sb) * dtsize;
 			}
 		}
 
-		in->comment = "    ; line: " + std::to_string(assgnexp->tok.loc.line);
+		in->comment = "    ; line: " + line_number(assgnexp->tok.loc);
 		instructions.push_back(in);
 	}
 
-	void CodeGen::gen_id_expr(IdentifierExpression **idexpr) {
+	void CodeGen::gen_id_expr(IdentifierExpression *idexp) {
 
 		// generate id expresion
 		// RECORD tyeps are not considered while code generation
 		// only simple types are used
 		// id expression, checking for addressof, ++, --
 
-		IdentifierExpression *idexp = *idexpr;
 		Instruction *in = nullptr;
 		int dtsize = 0;
 		Token type;
@@ -1815,20 +1822,20 @@ namespace xlang {
 		if (idexp == nullptr)
 			return;
 
-		insert_comment("; line " + std::to_string(idexp->tok.loc.line));
+		insert_comment("; line " + line_number(idexp->tok.loc));
 
-		if (idexp->unary != nullptr) {
+		if (idexp->unary != NO_NODE) {
 			op = idexp->tok.number;
 			if (idexp->is_oprtr) {
 				in = get_insn(INSNONE, 2);
 				in->operand_1->type = REGISTER;
 
-				if (Compiler::global.x64)
+				if (comp->global.x64)
 					in->operand_1->reg = RAX;
 				else
 					in->operand_1->reg = EAX;
 
-				idexp = idexp->unary;
+				idexp = Tree::id_expr(idexp->unary);
 				if (idexp->id_info == nullptr)
 					return;
 
@@ -1934,13 +1941,13 @@ namespace xlang {
 
 						in2 = get_insn(XOR, 2);
 						in2->operand_1->type = REGISTER;
-						if (Compiler::global.x64)
+						if (comp->global.x64)
 							in2->operand_1->reg = RCX;
 						else
 							in2->operand_1->reg = ECX;
 
 						in2->operand_2->type = REGISTER;
-						if (Compiler::global.x64)
+						if (comp->global.x64)
 							in2->operand_2->reg = RCX;
 						else
 							in2->operand_2->reg = ECX;
@@ -1963,7 +1970,7 @@ namespace xlang {
 
 						in2->operand_2->mem.mem_size = dtsize;
 						instructions.push_back(in2);
-						Compiler::global.x64 ? in->operand_2->reg = RCX : in->operand_2->reg = ECX;
+						comp->global.x64 ? in->operand_2->reg = RCX : in->operand_2->reg = ECX;
 						in->operand_2->arr_disp = dtsize;
 					}
 				}
@@ -1982,7 +1989,7 @@ namespace xlang {
 					in = get_insn(MOV, 2);
 					in->operand_1->type = REGISTER;
 
-					if (Compiler::global.x64)
+					if (comp->global.x64)
 						in->operand_1->reg = RAX;
 					else
 						in->operand_1->reg = EAX;
@@ -1990,7 +1997,7 @@ namespace xlang {
 					in->operand_2->type = MEMORY;
 					in->operand_2->mem.mem_type = GLOBAL;
 
-					if (Compiler::global.x64) {
+					if (comp->global.x64) {
 						in->operand_2->mem.mem_size = 8;
 						in->operand_2->mem.name = "rax";
 					}
@@ -2017,14 +2024,14 @@ namespace xlang {
 		if (assgnexp == nullptr)
 			return;
 
-		if (assgnexp->id_expr == nullptr)
+		if (assgnexp->id_expr == NO_NODE)
 			return;
 
-		left = assgnexp->id_expr;
-		if (left->unary != nullptr)
-			left = left->unary;
+		left = Tree::id_expr(assgnexp->id_expr);
+		if (left->unary != NO_NODE)
+			left = Tree::id_expr(left->unary);
 
-		gen_id_expr(&assgnexp->expression->id_expr);
+		gen_id_expr(Tree::id_expr(assgnexp->expression->id_expr));
 
 		auto resultreg = [=](int sz) {
 			if (sz == 1)
@@ -2056,14 +2063,14 @@ namespace xlang {
 
 			if (left->is_subscript) {
 				Token sb = *(left->subscript.begin());
-				in->operand_1->mem.fp_disp = std::stoi(sb.string) * dtsize;
+				in->operand_1->mem.fp_disp = Convert::tok_to_decimal(sb) * dtsize;
 			}
 		}
 
 		in->operand_2->type = REGISTER;
 		in->operand_2->reg = resultreg(dtsize);
 		in->operand_1->mem.mem_size = dtsize;
-		in->comment = "    ; line: " + std::to_string(assgnexp->tok.loc.line);
+		in->comment = "    ; line: " + line_number(assgnexp->tok.loc);
 		instructions.push_back(in);
 	}
 
@@ -2078,12 +2085,12 @@ namespace xlang {
 
 		if (assgnexp == nullptr)
 			return;
-		if (assgnexp->id_expr == nullptr)
+		if (assgnexp->id_expr == NO_NODE)
 			return;
 
-		left = assgnexp->id_expr;
-		if (left->unary != nullptr)
-			left = left->unary;
+		left = Tree::id_expr(assgnexp->id_expr);
+		if (left->unary != NO_NODE)
+			left = Tree::id_expr(left->unary);
 
 		gen_funccall_expr(&assgnexp->expression->call_expr);
 
@@ -2100,12 +2107,12 @@ namespace xlang {
 			in->operand_1->mem.mem_size = 4;
 			in->operand_2->type = REGISTER;
 
-			if (Compiler::global.x64)
+			if (comp->global.x64)
 				in->operand_2->reg = RAX;
 			else
 				in->operand_2->reg = EAX;
 
-			in->comment = "    ; line: " + std::to_string(assgnexp->tok.loc.line) + ", assign";
+			in->comment = "    ; line: " + line_number(assgnexp->tok.loc) + ", assign";
 			instructions.push_back(in);
 		}
 		else {
@@ -2115,17 +2122,17 @@ namespace xlang {
 			in->operand_1->type = MEMORY;
 			in->operand_1->mem.mem_type = GLOBAL;
 
-			Compiler::global.x64 ? in->operand_1->mem.mem_size = 8 : in->operand_1->mem.mem_size = 4;
+			comp->global.x64 ? in->operand_1->mem.mem_size = 8 : in->operand_1->mem.mem_size = 4;
 			in->operand_1->mem.name = left->id_info->symbol;
 			in->operand_2->type = REGISTER;
 
-			Compiler::global.x64 ? in->operand_2->reg = RAX : in->operand_2->reg = EAX;
+			comp->global.x64 ? in->operand_2->reg = RAX : in->operand_2->reg = EAX;
 			if (left->is_subscript) {
 				Token sb = *(left->subscript.begin());
-				in->operand_1->mem.fp_disp = std::stoi(sb.string) * dtsize;
+				in->operand_1->mem.fp_disp = Convert::tok_to_decimal(sb) * dtsize;
 			}
 
-			in->comment = "    ; line: " + std::to_string(assgnexp->tok.loc.line) + " assign to " + left->id_info->symbol;
+			in->comment = "    ; line: " + line_number(assgnexp->tok.loc) + " assign to " + left->id_info->symbol;
 			instructions.push_back(in);
 		}
 	}
@@ -2135,7 +2142,7 @@ namespace xlang {
 
 		if (assgnexp == nullptr)
 			return;
-		if (assgnexp->id_expr == nullptr)
+		if (assgnexp->id_expr == NO_NODE)
 			return;
 
 		switch (assgnexp->expression->expr_kind) {
@@ -2172,15 +2179,16 @@ namespace xlang {
 		int pushed_count = 0;
 		int param_count = 0;
 		CallExpression *fcexpr = *fccallex;
-		std::list<Expression *>::reverse_iterator it;
+		std::vector<Expression *>::reverse_iterator it;
 		std::pair<int, int> pr;
 
 		if (fcexpr == nullptr)
 			return;
-		if (fcexpr->function == nullptr)
+		if (fcexpr->function == NO_NODE)
 			return;
+		IdentifierExpression *callee = Tree::id_expr(fcexpr->function);
 
-		insert_comment("; line: " + std::to_string(fcexpr->function->tok.loc.line) + ", func_call: " + fcexpr->function->tok.string);
+		insert_comment("; line: " + line_number(callee->tok.loc) + ", func_call: " + std::string(callee->tok.string));
 
 		it = fcexpr->expression_list.rbegin();
 		param_count = fcexpr->expression_list.size();
@@ -2189,12 +2197,12 @@ namespace xlang {
 				break;
 			switch ((*it)->expr_kind) {
 				case ExpressionType::PRIMARY_EXPR :
-					pr = gen_primary_expr(&((*it)->primary_expr));
+					pr = gen_primary_expr(Tree::primary_expr((*it)->primary_expr));
 					if (pr.first == 2) {
 						in = get_insn(FSTP, 1);
 						in->operand_1->type = MEMORY;
 
-						if (Compiler::global.x64) {
+						if (comp->global.x64) {
 							in->operand_1->reg = RAX;
 							in->operand_1->mem.mem_size = 8;
 						}
@@ -2212,7 +2220,7 @@ namespace xlang {
 						in = get_insn(PUSH, 1);
 						in->operand_1->type = REGISTER;
 
-						if (Compiler::global.x64)
+						if (comp->global.x64)
 							in->operand_1->reg = RAX;
 						else
 							in->operand_1->reg = EAX;
@@ -2225,7 +2233,7 @@ namespace xlang {
 						in = get_insn(PUSH, 1);
 						in->operand_1->type = REGISTER;
 
-						if (Compiler::global.x64)
+						if (comp->global.x64)
 							in->operand_1->reg = RAX;
 						else
 							in->operand_1->reg = EAX;
@@ -2241,7 +2249,7 @@ namespace xlang {
 					gen_sizeof_expr(&((*it)->sizeof_expr));
 					in = get_insn(PUSH, 1);
 					in->operand_1->type = REGISTER;
-					Compiler::global.x64 ? in->operand_1->reg = RAX : in->operand_1->reg = EAX;
+					comp->global.x64 ? in->operand_1->reg = RAX : in->operand_1->reg = EAX;
 					in->comment = "    ; param " + std::to_string(param_count);
 					insncls->delete_operand(&(in->operand_2));
 					instructions.push_back(in);
@@ -2249,10 +2257,10 @@ namespace xlang {
 					break;
 
 				case ExpressionType::ID_EXPR:
-					gen_id_expr(&((*it)->id_expr));
+					gen_id_expr(Tree::id_expr((*it)->id_expr));
 					in = get_insn(PUSH, 1);
 					in->operand_1->type = REGISTER;
-					Compiler::global.x64 ? in->operand_1->reg = RAX : in->operand_1->reg = EAX;
+					comp->global.x64 ? in->operand_1->reg = RAX : in->operand_1->reg = EAX;
 					in->comment = "    ; param " + std::to_string(param_count);
 					insncls->delete_operand(&(in->operand_2));
 					instructions.push_back(in);
@@ -2271,8 +2279,8 @@ namespace xlang {
 		in = get_insn(CALL, 1);
 		in->operand_1->type = LITERAL;
 
-		if (fcexpr->function->left == nullptr && fcexpr->function->right == nullptr)
-			in->operand_1->literal = fcexpr->function->tok.string;
+		if (callee->left == NO_NODE && callee->right == NO_NODE)
+			in->operand_1->literal = callee->tok.string;
 
 		insncls->delete_operand(&(in->operand_2));
 		instructions.push_back(in);
@@ -2280,7 +2288,7 @@ namespace xlang {
 		if (fcexpr->expression_list.size() > 0) {
 			in = get_insn(ADD, 2);
 			in->operand_1->type = REGISTER;
-			Compiler::global.x64 ? in->operand_1->reg = RAX : in->operand_1->reg = EAX;
+			comp->global.x64 ? in->operand_1->reg = RAX : in->operand_1->reg = EAX;
 			in->operand_2->type = LITERAL;
 			in->operand_2->literal = std::to_string(pushed_count);
 			in->comment = "    ; restore func-call params stack frame";
@@ -2314,18 +2322,19 @@ namespace xlang {
 			return;
 		}
 
-		if (cstexpr->target == nullptr)
+		if (cstexpr->target == NO_NODE)
 			return;
+		IdentifierExpression *target = Tree::id_expr(cstexpr->target);
 
-		if (cstexpr->target->tok.number != IDENTIFIER)
+		if (target->tok.number != IDENTIFIER)
 			return;
 
-		if (cstexpr->target->id_info == nullptr)
+		if (target->id_info == nullptr)
 			return;
 
-		insert_comment("; cast expression, line " + std::to_string(cstexpr->simple_type[0].loc.line));
+		insert_comment("; cast expression, line " + line_number(cstexpr->simple_type[0].loc));
 		dtsize = data_type_size(cstexpr->simple_type[0]);
-		get_function_local_member(&fmem, cstexpr->target->id_info->tok);
+		get_function_local_member(&fmem, target->id_info->tok);
 
 		in = get_insn(MOV, 2);
 		in->operand_1->type = REGISTER;
@@ -2339,7 +2348,7 @@ namespace xlang {
 		}
 		else {
 			in->operand_2->type = MEMORY;
-			in->operand_2->mem.name = cstexpr->target->id_info->symbol;
+			in->operand_2->mem.name = target->id_info->symbol;
 			in->operand_2->mem.mem_type = GLOBAL;
 			in->operand_2->mem.mem_size = dtsize;
 		}
@@ -2357,7 +2366,7 @@ namespace xlang {
 
 		switch (_expr->expr_kind) {
 			case ExpressionType::PRIMARY_EXPR :
-				gen_primary_expr(&(_expr->primary_expr));
+				gen_primary_expr(Tree::primary_expr(_expr->primary_expr));
 				break;
 			case ExpressionType::ASSGN_EXPR :
 				gen_assignment_expr(&(_expr->assgn_expr));
@@ -2369,7 +2378,7 @@ namespace xlang {
 				gen_cast_expr(&(_expr->cast_expr));
 				break;
 			case ExpressionType::ID_EXPR :
-				gen_id_expr(&(_expr->id_expr));
+				gen_id_expr(Tree::id_expr(_expr->id_expr));
 				break;
 			case ExpressionType::FUNC_CALL_EXPR :
 				gen_funccall_expr(&(_expr->call_expr));
@@ -2381,9 +2390,9 @@ namespace xlang {
 		if (*labstmt == nullptr)
 			return;
 
-		insert_comment("; line " + std::to_string((*labstmt)->label.loc.line));
+		insert_comment("; line " + line_number((*labstmt)->label.loc));
 		Instruction *in = get_insn(INSLABEL, 0);
-		in->label = "." + (*labstmt)->label.string;
+		in->label = "." + std::string((*labstmt)->label.string);
 		insncls->delete_operand(&(in->operand_1));
 		insncls->delete_operand(&(in->operand_2));
 		instructions.push_back(in);
@@ -2422,7 +2431,7 @@ namespace xlang {
 						break;
 				}
 
-				in->comment = "    ; break loop, line " + std::to_string(jmpstmt->tok.loc.line);
+				in->comment = "    ; break loop, line " + line_number(jmpstmt->tok.loc);
 				insncls->delete_operand(&(in->operand_2));
 				instructions.push_back(in);
 				break;
@@ -2431,7 +2440,7 @@ namespace xlang {
 				in = get_insn(JMP, 1);
 				in->operand_1->type = LITERAL;
 				in->operand_1->literal = ".exit_loop" + std::to_string(exit_loop_label_count);
-				in->comment = "    ; continue loop, line " + std::to_string(jmpstmt->tok.loc.line);
+				in->comment = "    ; continue loop, line " + line_number(jmpstmt->tok.loc);
 				insncls->delete_operand(&(in->operand_2));
 				switch (current_loop) {
 					case IterationType::WHILE:
@@ -2456,7 +2465,7 @@ namespace xlang {
 				in = get_insn(JMP, 1);
 				in->operand_1->type = LITERAL;
 				in->operand_1->literal = "._exit_" + func_symtab->func_info->func_name;
-				in->comment = "    ; return, line " + std::to_string(jmpstmt->tok.loc.line);
+				in->comment = "    ; return, line " + line_number(jmpstmt->tok.loc);
 				insncls->delete_operand(&(in->operand_2));
 				instructions.push_back(in);
 				break;
@@ -2464,8 +2473,8 @@ namespace xlang {
 			case JumpType::GOTO:
 				in = get_insn(JMP, 1);
 				in->operand_1->type = LITERAL;
-				in->operand_1->literal = "." + jmpstmt->goto_id.string;
-				in->comment = "    ; goto, line " + std::to_string(jmpstmt->tok.loc.line);
+				in->operand_1->literal = "." + std::string(jmpstmt->goto_id.string);
+				in->comment = "    ; goto, line " + line_number(jmpstmt->tok.loc);
 				insncls->delete_operand(&(in->operand_2));
 				instructions.push_back(in);
 				break;
@@ -2474,7 +2483,7 @@ namespace xlang {
 
 	RegisterType CodeGen::get_reg_type_by_char(char ch) {
 
-		if (Compiler::global.x64) {
+		if (comp->global.x64) {
 			switch (ch) {
 				case 'a':
 					return RAX;
@@ -2524,7 +2533,7 @@ namespace xlang {
 
 		constraint = asmoperand->constraint.string;
 
-		if (Compiler::global.x64) {
+		if (comp->global.x64) {
 			if (constraint == "=a")
 				return "rax";
 			else if (constraint == "=b")
@@ -2562,13 +2571,13 @@ namespace xlang {
 
 		if (constraint == "=m") {
 
-			pexp = asmoperand->expression->primary_expr;
+			pexp = Tree::primary_expr(asmoperand->expression->primary_expr);
 			get_function_local_member(&fmem, pexp->tok);
 
 			if (fmem.insize != -1) {
 				std::string cast = insncls->insnsize_name(get_insn_size_type(fmem.insize));
 				if (fmem.fp_disp < 0) {
-					if (Compiler::global.x64) {
+					if (comp->global.x64) {
 						return cast + "[rbp - " + std::to_string(fmem.fp_disp * (-1)) + "]";
 					}
 					else {
@@ -2576,7 +2585,7 @@ namespace xlang {
 					}
 				}
 				else {
-					if (Compiler::global.x64) {
+					if (comp->global.x64) {
 						return cast + "[rbp + " + std::to_string(fmem.fp_disp) + "]";
 					}
 					else {
@@ -2586,12 +2595,12 @@ namespace xlang {
 			}
 			else {
 				if (pexp->id_info == nullptr) {
-					pexp->id_info = search_id(pexp->tok.string);
+					pexp->id_info = search_id(pexp->tok.name);
 				}
 				if (pexp->id_info != nullptr) {
 					Token type = pexp->id_info->type_info->type_specifier.simple_type[0];
 					std::string cast = insncls->insnsize_name(get_insn_size_type(data_type_size(type)));
-					return cast + "[" + pexp->tok.string + "]";
+					return cast + "[" + std::string(pexp->tok.string) + "]";
 				}
 			}
 		}
@@ -2615,7 +2624,7 @@ namespace xlang {
 		constraint = asmoperand->constraint.string;
 
 		if (asmoperand->expression != nullptr) {
-			pexp = asmoperand->expression->primary_expr;
+			pexp = Tree::primary_expr(asmoperand->expression->primary_expr);
 			tok = pexp->tok;
 			t = tok.number;
 			switch (t) {
@@ -2636,7 +2645,7 @@ namespace xlang {
 				case IDENTIFIER:
 					constraint = 'm';
 					if (pexp->id_info == nullptr)
-						pexp->id_info = search_id(tok.string);
+						pexp->id_info = search_id(tok.name);
 					break;
 				default:
 					break;
@@ -2645,23 +2654,23 @@ namespace xlang {
 
 		switch (constraint[0]) {
 			case 'a':
-				return Compiler::global.x64 ? "rax" : "eax";
+				return comp->global.x64 ? "rax" : "eax";
 			case 'b':
-				return Compiler::global.x64 ? "rbx" : "ebx";
+				return comp->global.x64 ? "rbx" : "ebx";
 			case 'c':
-				return Compiler::global.x64 ? "rcx" : "ecx";
+				return comp->global.x64 ? "rcx" : "ecx";
 			case 'd':
-				return Compiler::global.x64 ? "rdx" : "edx";
+				return comp->global.x64 ? "rdx" : "edx";
 			case 'S':
-				return Compiler::global.x64 ? "rsi" : "esi";
+				return comp->global.x64 ? "rsi" : "esi";
 			case 'D':
-				return Compiler::global.x64 ? "rdi" : "edi";
+				return comp->global.x64 ? "rdi" : "edi";
 			case 'm':
 				get_function_local_member(&fmem, pexp->tok);
 				if (fmem.insize != -1) {
 					std::string cast = insncls->insnsize_name(get_insn_size_type(fmem.insize));
 					if (fmem.fp_disp < 0) {
-						if (Compiler::global.x64) {
+						if (comp->global.x64) {
 							return cast + "[rbp - " + std::to_string(fmem.fp_disp * (-1)) + "]";
 						}
 						else {
@@ -2669,7 +2678,7 @@ namespace xlang {
 						}
 					}
 					else {
-						if (Compiler::global.x64) {
+						if (comp->global.x64) {
 							return cast + "[rbp + " + std::to_string(fmem.fp_disp) + "]";
 						}
 						else {
@@ -2679,12 +2688,12 @@ namespace xlang {
 				}
 				else {
 					if (pexp->id_info == nullptr) {
-						pexp->id_info = search_id(pexp->tok.string);
+						pexp->id_info = search_id(pexp->tok.name);
 					}
 					if (pexp->id_info != nullptr) {
 						Token type = pexp->id_info->type_info->type_specifier.simple_type[0];
 						std::string cast = insncls->insnsize_name(get_insn_size_type(data_type_size(type)));
-						return cast + "[" + pexp->tok.string + "]";
+						return cast + "[" + std::string(pexp->tok.string) + "]";
 					}
 				}
 			case 'i':
@@ -2714,7 +2723,7 @@ namespace xlang {
 
 		if (asmstmt != nullptr) {
 			if (!asmstmt->asm_template.string.empty()) {
-				insert_comment("; inline assembly, line " + std::to_string(asmstmt->asm_template.loc.line));
+				insert_comment("; inline assembly, line " + line_number(asmstmt->asm_template.loc));
 			}
 		}
 
@@ -2769,10 +2778,7 @@ namespace xlang {
 		return false;
 	}
 
-	bool CodeGen::gen_float_type_condition(PrimaryExpression **f1, PrimaryExpression **f2, PrimaryExpression **opr) {
-		PrimaryExpression *fexp1 = *f1;
-		PrimaryExpression *fexp2 = *f2;
-		PrimaryExpression *fexpopr = *opr;
+	bool CodeGen::gen_float_type_condition(PrimaryExpression *fexp1, PrimaryExpression *fexp2, PrimaryExpression *fexpopr) {
 		Token type;
 		Member *dt = nullptr;
 		DeclarationType decsp = DQ;
@@ -2824,30 +2830,30 @@ namespace xlang {
 		}
 
 		if (!fexp1->is_id) {
-			dt = search_data(fexp1->tok.string);
+			dt = search_data(Convert::tok_to_string(fexp1->tok));
 			if (dt == nullptr) {
-				dt = create_float_data(decsp, fexp1->tok.string);
+				dt = create_float_data(decsp, Convert::tok_to_string(fexp1->tok));
 			}
 			in = get_insn(FLD, 1);
 			in->operand_1->type = MEMORY;
 			in->operand_1->mem.mem_type = GLOBAL;
 			in->operand_1->mem.mem_size = 8;
 			in->operand_1->mem.name = dt->symbol;
-			in->comment = "  ; " + fexp1->tok.string;
+			in->comment = "  ; " + Convert::tok_to_string(fexp1->tok);
 			insncls->delete_operand(&(in->operand_2));
 			instructions.push_back(in);
 
 			if (!fexp2->is_id) {
-				dt = search_data(fexp2->tok.string);
+				dt = search_data(Convert::tok_to_string(fexp2->tok));
 				if (dt == nullptr) {
-					dt = create_float_data(decsp, fexp2->tok.string);
+					dt = create_float_data(decsp, Convert::tok_to_string(fexp2->tok));
 				}
 				in = get_insn(FCOM, 1);
 				in->operand_1->type = MEMORY;
 				in->operand_1->mem.mem_type = GLOBAL;
 				in->operand_1->mem.mem_size = 8;
 				in->operand_1->mem.name = dt->symbol;
-				in->comment = "  ; " + fexp2->tok.string;
+				in->comment = "  ; " + Convert::tok_to_string(fexp2->tok);
 				insncls->delete_operand(&(in->operand_2));
 				instructions.push_back(in);
 			}
@@ -2861,7 +2867,7 @@ namespace xlang {
 					in->operand_1->mem.mem_type = LOCAL;
 					in->operand_1->mem.mem_size = dtsize;
 					in->operand_1->mem.fp_disp = fmem.fp_disp;
-					in->comment = "  ; " + fexp2->tok.string;
+					in->comment = "  ; " + std::string(fexp2->tok.string);
 					insncls->delete_operand(&(in->operand_2));
 					instructions.push_back(in);
 				}
@@ -2871,7 +2877,7 @@ namespace xlang {
 					in->operand_1->mem.mem_type = GLOBAL;
 					in->operand_1->mem.mem_size = dtsize;
 					in->operand_1->mem.name = fexp2->tok.string;
-					in->comment = "  ; " + fexp2->tok.string;
+					in->comment = "  ; " + std::string(fexp2->tok.string);
 					insncls->delete_operand(&(in->operand_2));
 					instructions.push_back(in);
 				}
@@ -2887,7 +2893,7 @@ namespace xlang {
 				in->operand_1->mem.mem_type = LOCAL;
 				in->operand_1->mem.mem_size = dtsize;
 				in->operand_1->mem.fp_disp = fmem.fp_disp;
-				in->comment = "  ; " + fexp1->tok.string;
+				in->comment = "  ; " + std::string(fexp1->tok.string);
 				insncls->delete_operand(&(in->operand_2));
 				instructions.push_back(in);
 			}
@@ -2897,22 +2903,22 @@ namespace xlang {
 				in->operand_1->mem.mem_type = GLOBAL;
 				in->operand_1->mem.mem_size = dtsize;
 				in->operand_1->mem.name = fexp1->tok.string;
-				in->comment = "  ; " + fexp1->tok.string;
+				in->comment = "  ; " + std::string(fexp1->tok.string);
 				insncls->delete_operand(&(in->operand_2));
 				instructions.push_back(in);
 			}
 
 			if (!fexp2->is_id) {
-				dt = search_data(fexp2->tok.string);
+				dt = search_data(Convert::tok_to_string(fexp2->tok));
 				if (dt == nullptr) {
-					dt = create_float_data(decsp, fexp2->tok.string);
+					dt = create_float_data(decsp, Convert::tok_to_string(fexp2->tok));
 				}
 				in = get_insn(FCOM, 1);
 				in->operand_1->type = MEMORY;
 				in->operand_1->mem.mem_type = GLOBAL;
 				in->operand_1->mem.mem_size = 8;
 				in->operand_1->mem.name = dt->symbol;
-				in->comment = "  ; " + fexp2->tok.string;
+				in->comment = "  ; " + Convert::tok_to_string(fexp2->tok);
 				insncls->delete_operand(&(in->operand_2));
 				instructions.push_back(in);
 			}
@@ -2926,7 +2932,7 @@ namespace xlang {
 					in->operand_1->mem.mem_type = LOCAL;
 					in->operand_1->mem.mem_size = dtsize;
 					in->operand_1->mem.fp_disp = fmem.fp_disp;
-					in->comment = "  ; " + fexp2->tok.string;
+					in->comment = "  ; " + std::string(fexp2->tok.string);
 					insncls->delete_operand(&(in->operand_2));
 					instructions.push_back(in);
 				}
@@ -2936,7 +2942,7 @@ namespace xlang {
 					in->operand_1->mem.mem_type = GLOBAL;
 					in->operand_1->mem.mem_size = dtsize;
 					in->operand_1->mem.name = fexp2->tok.string;
-					in->comment = "  ; " + fexp2->tok.string;
+					in->comment = "  ; " + std::string(fexp2->tok.string);
 					insncls->delete_operand(&(in->operand_2));
 					instructions.push_back(in);
 				}
@@ -2959,6 +2965,8 @@ namespace xlang {
 
 	TokenId CodeGen::gen_select_stmt_condition(Expression *_expr) {
 		PrimaryExpression *pexpr = nullptr;
+		PrimaryExpression *left = nullptr;
+		PrimaryExpression *right = nullptr;
 		Token tok;
 		TokenId t;
 		FunctionMember fmem;
@@ -2979,24 +2987,26 @@ namespace xlang {
 
 		switch (_expr->expr_kind) {
 			case ExpressionType::PRIMARY_EXPR :
-				pexpr = _expr->primary_expr;
+				pexpr = Tree::primary_expr(_expr->primary_expr);
 				if (pexpr == nullptr)
 					return NONE;
-				insert_comment("; condition checking, line " + std::to_string(pexpr->tok.loc.line));
+				insert_comment("; condition checking, line " + line_number(pexpr->tok.loc));
 				//only 2 primary expressions are used exp1 op exp1
 				//others are discaded
 				if (pexpr->is_oprtr) {
 					tok = pexpr->tok;
 					t = tok.number;
 					if (t == COMP_EQ || t == COMP_GREAT || t == COMP_GREAT_EQ || t == COMP_LESS || t == COMP_LESS_EQ || t == COMP_NOT_EQ) {
+						left = Tree::primary_expr(pexpr->left);
+						right = Tree::primary_expr(pexpr->right);
 						//if any one of them is float type
-						if (gen_float_type_condition(&pexpr->left, &pexpr->right, &pexpr))
+						if (gen_float_type_condition(left, right, pexpr))
 							return t;
 
 						//if both are identifiers id op id
-						if (pexpr->left->tok.number == IDENTIFIER && pexpr->right->tok.number == IDENTIFIER) {
-							get_function_local_member(&fmem, pexpr->right->tok);
-							type = pexpr->left->id_info->type_info->type_specifier.simple_type[0];
+						if (left->tok.number == IDENTIFIER && right->tok.number == IDENTIFIER) {
+							get_function_local_member(&fmem, right->tok);
+							type = left->id_info->type_info->type_specifier.simple_type[0];
 							dtsize = data_type_size(type);
 							in = get_insn(MOV, 2);
 							in->operand_1->type = REGISTER;
@@ -3009,16 +3019,16 @@ namespace xlang {
 							}
 							else {
 								in->operand_2->type = MEMORY;
-								in->operand_2->mem.name = pexpr->right->tok.string;
+								in->operand_2->mem.name = right->tok.string;
 								in->operand_2->mem.mem_type = GLOBAL;
-								in->operand_2->mem.mem_size = data_type_size(pexpr->right->id_info->type_info->type_specifier.simple_type[0]);
+								in->operand_2->mem.mem_size = data_type_size(right->id_info->type_info->type_specifier.simple_type[0]);
 							}
 							instructions.push_back(in);
 							in = nullptr;
 
-							type = pexpr->right->id_info->type_info->type_specifier.simple_type[0];
+							type = right->id_info->type_info->type_specifier.simple_type[0];
 							dtsize = data_type_size(type);
-							get_function_local_member(&fmem, pexpr->left->tok);
+							get_function_local_member(&fmem, left->tok);
 							in = get_insn(CMP, 2);
 							in->operand_2->type = REGISTER;
 							in->operand_2->reg = resreg(dtsize);
@@ -3030,18 +3040,18 @@ namespace xlang {
 							}
 							else {
 								in->operand_1->type = MEMORY;
-								in->operand_1->mem.name = pexpr->left->tok.string;
+								in->operand_1->mem.name = left->tok.string;
 								in->operand_1->mem.mem_type = GLOBAL;
-								in->operand_1->mem.mem_size = data_type_size(pexpr->left->id_info->type_info->type_specifier.simple_type[0]);
+								in->operand_1->mem.mem_size = data_type_size(left->id_info->type_info->type_specifier.simple_type[0]);
 							}
 							instructions.push_back(in);
 							in = nullptr;
 						}
-						else if (pexpr->left->tok.number == IDENTIFIER && is_literal(pexpr->right->tok)) {
-							get_function_local_member(&fmem, pexpr->left->tok);
+						else if (left->tok.number == IDENTIFIER && is_literal(right->tok)) {
+							get_function_local_member(&fmem, left->tok);
 							in = get_insn(CMP, 2);
 							in->operand_2->type = LITERAL;
-							in->operand_2->literal = std::to_string(Convert::tok_to_decimal(pexpr->right->tok));
+							in->operand_2->literal = std::to_string(Convert::tok_to_decimal(right->tok));
 							if (fmem.insize != -1) {
 								in->operand_1->type = MEMORY;
 								in->operand_1->mem.mem_type = LOCAL;
@@ -3050,17 +3060,17 @@ namespace xlang {
 							}
 							else {
 								in->operand_1->type = MEMORY;
-								in->operand_1->mem.name = pexpr->left->tok.string;
+								in->operand_1->mem.name = left->tok.string;
 								in->operand_1->mem.mem_type = GLOBAL;
-								in->operand_1->mem.mem_size = data_type_size(pexpr->left->id_info->type_info->type_specifier.simple_type[0]);
+								in->operand_1->mem.mem_size = data_type_size(left->id_info->type_info->type_specifier.simple_type[0]);
 							}
 							instructions.push_back(in);
 						}
-						else if (is_literal(pexpr->left->tok) && pexpr->right->tok.number == IDENTIFIER) {
-							get_function_local_member(&fmem, pexpr->right->tok);
+						else if (is_literal(left->tok) && right->tok.number == IDENTIFIER) {
+							get_function_local_member(&fmem, right->tok);
 							in = get_insn(CMP, 2);
 							in->operand_2->type = LITERAL;
-							in->operand_2->literal = std::to_string(Convert::tok_to_decimal(pexpr->left->tok));
+							in->operand_2->literal = std::to_string(Convert::tok_to_decimal(left->tok));
 							if (fmem.insize != -1) {
 								in->operand_1->type = MEMORY;
 								in->operand_1->mem.mem_type = LOCAL;
@@ -3069,36 +3079,36 @@ namespace xlang {
 							}
 							else {
 								in->operand_1->type = MEMORY;
-								in->operand_1->mem.name = pexpr->right->tok.string;
+								in->operand_1->mem.name = right->tok.string;
 								in->operand_1->mem.mem_type = GLOBAL;
-								in->operand_1->mem.mem_size = data_type_size(pexpr->right->id_info->type_info->type_specifier.simple_type[0]);
+								in->operand_1->mem.mem_size = data_type_size(right->id_info->type_info->type_specifier.simple_type[0]);
 							}
 							instructions.push_back(in);
 						}
-						else if (is_literal(pexpr->left->tok) && is_literal(pexpr->right->tok)) {
+						else if (is_literal(left->tok) && is_literal(right->tok)) {
 							in = get_insn(MOV, 2);
 							in->operand_1->type = REGISTER;
 
-							if (Compiler::global.x64)
+							if (comp->global.x64)
 								in->operand_1->reg = RAX;
 							else
 								in->operand_1->reg = EAX;
 
 							in->operand_2->type = LITERAL;
-							in->operand_2->literal = std::to_string(Convert::tok_to_decimal(pexpr->left->tok));
+							in->operand_2->literal = std::to_string(Convert::tok_to_decimal(left->tok));
 							instructions.push_back(in);
 							in = nullptr;
 
 							in = get_insn(CMP, 2);
 							in->operand_1->type = REGISTER;
 
-							if (Compiler::global.x64)
+							if (comp->global.x64)
 								in->operand_1->reg = RAX;
 							else
 								in->operand_1->reg = EAX;
 
 							in->operand_2->type = LITERAL;
-							in->operand_2->literal = std::to_string(Convert::tok_to_decimal(pexpr->right->tok));
+							in->operand_2->literal = std::to_string(Convert::tok_to_decimal(right->tok));
 							instructions.push_back(in);
 						}
 						return t;
@@ -3210,21 +3220,21 @@ namespace xlang {
 		//create loop label, while, dowhile, for
 		switch (itstmt->type) {
 			case IterationType::WHILE :
-				insert_comment("; while loop, line " + std::to_string(itstmt->_while.whiletok.loc.line));
+				insert_comment("; while loop, line " + line_number(itstmt->_while.whiletok.loc));
 				in->label = ".while_loop" + std::to_string(while_loop_count);
 				current_loop = IterationType::WHILE;
 				while_loop_stack.push(while_loop_count);
 				while_loop_count++;
 				break;
 			case IterationType::DOWHILE :
-				insert_comment("; do-while loop, line " + std::to_string(itstmt->_dowhile.dotok.loc.line));
+				insert_comment("; do-while loop, line " + line_number(itstmt->_dowhile.dotok.loc));
 				in->label = ".dowhile_loop" + std::to_string(dowhile_loop_count);
 				current_loop = IterationType::DOWHILE;
 				dowhile_loop_stack.push(dowhile_loop_count);
 				dowhile_loop_count++;
 				break;
 			case IterationType::FOR :
-				insert_comment("; for loop, line " + std::to_string(itstmt->_for.fortok.loc.line));
+				insert_comment("; for loop, line " + line_number(itstmt->_for.fortok.loc));
 				current_loop = IterationType::FOR;
 				gen_expr(&(itstmt->_for.init_expr));
 				in->label = ".for_loop" + std::to_string(for_loop_count);
@@ -3417,12 +3427,34 @@ namespace xlang {
 		}
 	}
 
+	// trace span name of a statement
+	static const char *statement_name(StatementType type) {
+		switch (type) {
+			case StatementType::LABEL :
+				return "label";
+			case StatementType::EXPR :
+				return "expression";
+			case StatementType::SELECT :
+				return "if";
+			case StatementType::ITER :
+				return "loop";
+			case StatementType::JUMP :
+				return "jump";
+			case StatementType::ASM :
+				return "asm";
+			default:
+				return "statement";
+		}
+	}
+
 	void CodeGen::gen_statement(Statement **_stmt) {
 		Statement *_stmt2 = *_stmt;
 		if (_stmt2 == nullptr)
 			return;
 
 		while (_stmt2 != nullptr) {
+			// nested statements are spans inside the one of theirs
+			TraceScope span(comp->trace, statement_name(_stmt2->type), "statement");
 			switch (_stmt2->type) {
 				case StatementType::LABEL :
 					gen_label_statement(&(_stmt2->labled_statement));
@@ -3455,11 +3487,11 @@ namespace xlang {
 		// push ebp|rbp
 		// mov ebp|rpb, esp|rsp
 
-		if (!Compiler::global.omit_frame_pointer) {
+		if (!comp->global.omit_frame_pointer) {
 			Instruction *in = get_insn(PUSH, 1);
 			in->operand_1->type = REGISTER;
 
-			if (Compiler::global.x64)
+			if (comp->global.x64)
 				in->operand_1->reg = RBP;
 			else
 				in->operand_1->reg = EBP;
@@ -3473,13 +3505,13 @@ namespace xlang {
 			in->operand_count = 2;
 			in->operand_1->type = REGISTER;
 
-			if (Compiler::global.x64)
+			if (comp->global.x64)
 				in->operand_1->reg = RBP;
 			else
 				in->operand_1->reg = EBP;
 
 			in->operand_2->type = REGISTER;
-			if (Compiler::global.x64)
+			if (comp->global.x64)
 				in->operand_2->reg = RSP;
 			else
 				in->operand_2->reg = ESP;
@@ -3506,19 +3538,19 @@ namespace xlang {
 		instructions.push_back(in);
 		in = nullptr;
 
-		if (!Compiler::global.omit_frame_pointer) {
+		if (!comp->global.omit_frame_pointer) {
 			in = get_insn(MOV, 2);
 			in->insn_type = MOV;
 			in->operand_count = 2;
 
 			in->operand_1->type = REGISTER;
-			if (Compiler::global.x64)
+			if (comp->global.x64)
 				in->operand_1->reg = RSP;
 			else
 				in->operand_1->reg = ESP;
 
 			in->operand_2->type = REGISTER;
-			if (Compiler::global.x64)
+			if (comp->global.x64)
 				in->operand_2->reg = RBP;
 			else
 				in->operand_2->reg = EBP;
@@ -3531,7 +3563,7 @@ namespace xlang {
 			in->operand_count = 1;
 			in->operand_1->type = REGISTER;
 
-			if (Compiler::global.x64)
+			if (comp->global.x64)
 				in->operand_1->reg = RBP;
 			else
 				in->operand_1->reg = EBP;
@@ -3565,11 +3597,11 @@ namespace xlang {
 			comment.push_back('(');
 			for (auto e: func_symtab->func_info->param_list) {
 				if (e->type_info->type == NodeType::SIMPLE) {
-					comment += e->type_info->type_specifier.simple_type[0].string + " ";
+					comment += std::string(e->type_info->type_specifier.simple_type[0].string) + " ";
 					comment += e->symbol_info->symbol + ", ";
 				}
 				else {
-					comment += e->type_info->type_specifier.record_type.string + " ";
+					comment += std::string(e->type_info->type_specifier.record_type.string) + " ";
 					comment += e->symbol_info->symbol + ", ";
 				}
 			}
@@ -3598,7 +3630,7 @@ namespace xlang {
 		save_frame_pointer();
 
 		//allocate memory on stack for local variables
-		fmemit = func_members.find(func_symtab->func_info->func_name);
+		fmemit = func_members.find(func_symtab->func_info->tok.name);
 
 		if (fmemit != func_members.end()) {
 			if (fmemit->second.total_size > 0) {
@@ -3607,7 +3639,7 @@ namespace xlang {
 				in->operand_count = 2;
 				in->operand_1->type = REGISTER;
 
-				if (Compiler::global.x64)
+				if (comp->global.x64)
 					in->operand_1->reg = RSP;
 				else
 					in->operand_1->reg = ESP;
@@ -3618,23 +3650,23 @@ namespace xlang {
 				instructions.push_back(in);
 			}
 
-			//emit local variables location comments
-			memit = fmemit->second.members.begin();
-			while (memit != fmemit->second.members.end()) {
+			//emit local variables location comments, in frame order
+			for (NameId member: fmemit->second.order) {
+				memit = fmemit->second.members.find(member);
+				std::string name(comp->names.name(member));
 				fpdisp = memit->second.fp_disp;
 				if (fpdisp < 0) {
-					if (Compiler::global.x64)
-						insert_comment("    ; " + memit->first + " = [rbp - " + std::to_string(fpdisp * (-1)) + "]" + ", " + insncls->insnsize_name(get_insn_size_type(memit->second.insize)));
+					if (comp->global.x64)
+						insert_comment("    ; " + name + " = [rbp - " + std::to_string(fpdisp * (-1)) + "]" + ", " + insncls->insnsize_name(get_insn_size_type(memit->second.insize)));
 					else
-						insert_comment("    ; " + memit->first + " = [ebp - " + std::to_string(fpdisp * (-1)) + "]" + ", " + insncls->insnsize_name(get_insn_size_type(memit->second.insize)));
+						insert_comment("    ; " + name + " = [ebp - " + std::to_string(fpdisp * (-1)) + "]" + ", " + insncls->insnsize_name(get_insn_size_type(memit->second.insize)));
 				}
 				else {
-					if (Compiler::global.x64)
-						insert_comment("    ; " + memit->first + " = [rbp + " + std::to_string(fpdisp) + "]" + ", " + insncls->insnsize_name(get_insn_size_type(memit->second.insize)));
+					if (comp->global.x64)
+						insert_comment("    ; " + name + " = [rbp + " + std::to_string(fpdisp) + "]" + ", " + insncls->insnsize_name(get_insn_size_type(memit->second.insize)));
 					else
-						insert_comment("    ; " + memit->first + " = [ebp + " + std::to_string(fpdisp) + "]" + ", " + insncls->insnsize_name(get_insn_size_type(memit->second.insize)));
+						insert_comment("    ; " + name + " = [ebp + " + std::to_string(fpdisp) + "]" + ", " + insncls->insnsize_name(get_insn_size_type(memit->second.insize)));
 				}
-				memit++;
 			}
 		}
 	}
@@ -3649,11 +3681,11 @@ namespace xlang {
 		SymbolInfo *temp = nullptr;
 		std::list<Token>::iterator it;
 
-		if (Compiler::symtab == nullptr)
+		if (comp->symtab == nullptr)
 			return;
 
 		for (i = 0; i < ST_SIZE; i++) {
-			temp = Compiler::symtab->symbol_info[i];
+			temp = comp->symtab->symbol_info[i];
 			while (temp != nullptr && temp->type_info != nullptr) {
 				//check if globaly declared variable is global or extern
 				//if global/extern then put them in text section
@@ -3670,7 +3702,7 @@ namespace xlang {
 					text_section.push_back(txt);
 				}
 
-				if (initialized_data.find(temp->symbol) == initialized_data.end()) {
+				if (initialized_data.find(temp->tok.name) == initialized_data.end()) {
 					ReserveSection *rv = insncls->get_resv_mem();
 					TypeInfo *typeinf = temp->type_info;
 					rv->symbol = temp->symbol;
@@ -3681,8 +3713,8 @@ namespace xlang {
 					}
 					else if (typeinf->type == NodeType::RECORD) {
 						rv->type = RESB;
-						std::unordered_map<std::string, int>::iterator it;
-						it = record_sizes.find(typeinf->type_specifier.record_type.string);
+						std::unordered_map<NameId, int>::iterator it;
+						it = record_sizes.find(typeinf->type_specifier.record_type.name);
 						if (it != record_sizes.end()) {
 							rv->res_size = it->second;
 						}
@@ -3728,12 +3760,12 @@ namespace xlang {
 					dt->is_array = true;
 					dt->symbol = syminf->symbol;
 					dt->type = declspace_type_size(syminf->type_info->type_specifier.simple_type[0]);
-					initialized_data[dt->symbol] = syminf;
+					initialized_data[syminf->tok.name] = syminf;
 
 					for (auto e1: syminf->arr_init_list) {
 						for (auto e2: e1) {
 							if (e2.number == LIT_FLOAT) {
-								dt->array_data.push_back(e2.string);
+								dt->array_data.emplace_back(e2.string);
 							}
 							else {
 								dt->array_data.push_back(std::to_string(Convert::tok_to_decimal(e2)));
@@ -3759,10 +3791,10 @@ namespace xlang {
 		TypeInfo *typeinf = nullptr;
 		int record_size = 0;
 
-		if (Compiler::record_table == nullptr)
+		if (comp->record_table == nullptr)
 			return;
 		for (int i = 0; i < ST_RECORD_SIZE; i++) {
-			recnode = Compiler::record_table->recordinfo[i];
+			recnode = comp->record_table->recordinfo[i];
 			//iterate through each record linked list
 			while (recnode != nullptr) {
 				record_size = 0;
@@ -3811,9 +3843,9 @@ namespace xlang {
 							rectype.resvsp_type = RESD;
 
 							if (syminf->is_array)
-								record_size += rectype.resv_size * (Compiler::global.x64 ? 8 : 4);
+								record_size += rectype.resv_size * (comp->global.x64 ? 8 : 4);
 							else
-								record_size += (Compiler::global.x64 ? 8 : 4);
+								record_size += (comp->global.x64 ? 8 : 4);
 						}
 
 						rv->record_members.push_back(rectype);
@@ -3821,7 +3853,7 @@ namespace xlang {
 					}
 				}
 
-				record_sizes.insert(std::pair<std::string, int>(rv->record_name, record_size));
+				record_sizes.insert(std::pair<NameId, int>(recnode->recordtok.name, record_size));
 				resv_section.push_back(rv);
 				rv = nullptr;
 				recnode = recnode->p_next;
@@ -3841,7 +3873,7 @@ namespace xlang {
 		if (trhead == nullptr)
 			return;
 
-		gen_array_init_declaration(Compiler::symtab);
+		gen_array_init_declaration(comp->symtab);
 
 		while (trhead != nullptr) {
 			if (trhead->symtab != nullptr) {
@@ -3865,16 +3897,17 @@ namespace xlang {
 								if (_expr->assgn_expr->expression == nullptr)
 									return;
 
-								PrimaryExpression *pexpr = _expr->assgn_expr->expression->primary_expr;
-								if (initialized_data.find(_expr->assgn_expr->id_expr->id_info->symbol) != initialized_data.end()) {
-									Log::error_at(_expr->assgn_expr->tok.loc, "'" + _expr->assgn_expr->id_expr->id_info->symbol + "' assigned multiple times");
+								PrimaryExpression *pexpr = Tree::primary_expr(_expr->assgn_expr->expression->primary_expr);
+								IdentifierExpression *target = Tree::id_expr(_expr->assgn_expr->id_expr);
+								if (initialized_data.find(target->id_info->tok.name) != initialized_data.end()) {
+									Log::error_at(_expr->assgn_expr->tok.loc, "'" + target->id_info->symbol + "' assigned multiple times");
 									return;
 
 								}
 
-								initialized_data.insert(std::pair<std::string, SymbolInfo *>(_expr->assgn_expr->id_expr->id_info->symbol, _expr->assgn_expr->id_expr->id_info));
+								initialized_data.insert(std::pair<NameId, SymbolInfo *>(target->id_info->tok.name, target->id_info));
 								Member *dt = insncls->get_data_mem();
-								SymbolInfo *sminf = _expr->assgn_expr->id_expr->id_info;
+								SymbolInfo *sminf = target->id_info;
 								dt->symbol = sminf->symbol;
 								dt->type = declspace_type_size(sminf->type_info->type_specifier.simple_type[0]);
 								dt->is_array = false;
@@ -3882,10 +3915,10 @@ namespace xlang {
 								if (pexpr->tok.number == LIT_STRING) {
 									dt->symbol = dt->symbol;
 									dt->value = get_hex_string(pexpr->tok.string);
-									dt->comment = "    ; '" + pexpr->tok.string + "'";
+									dt->comment = "    ; '" + std::string(pexpr->tok.string) + "'";
 								}
 								else
-									dt->value = pexpr->tok.string;
+									dt->value = Convert::tok_to_string(pexpr->tok);
 
 								data_section.push_back(dt);
 							}
@@ -3905,9 +3938,7 @@ namespace xlang {
 		gen_uninitialized_data();
 	}
 
-	void CodeGen::write_text_to_asm_file(std::ofstream &outfile) {
-		if (!outfile.is_open())
-			return;
+	void CodeGen::write_text_to_asm_file(std::ostream &outfile) {
 		if (text_section.empty())
 			return;
 		outfile << "\nsection .text\n";
@@ -3919,11 +3950,11 @@ namespace xlang {
 		outfile << "\n";
 	}
 
-	void CodeGen::write_record_member_to_asm_file(RecordDataType &x, std::ofstream &outfile) {
+	void CodeGen::write_record_member_to_asm_file(RecordDataType &x, std::ostream &outfile) {
 		outfile << "      ." << x.symbol << " " << insncls->resspace_name(x.resvsp_type) << " " << std::to_string(x.resv_size) << "\n";
 	}
 
-	void CodeGen::write_record_data_to_asm_file(ReserveSection **rv, std::ofstream &outfile) {
+	void CodeGen::write_record_data_to_asm_file(ReserveSection **rv, std::ostream &outfile) {
 		ReserveSection *r = *rv;
 		if (r == nullptr)
 			return;
@@ -3961,10 +3992,8 @@ namespace xlang {
 		outfile << "    endstruc" << "\n";
 	}
 
-	void CodeGen::write_data_to_asm_file(std::ofstream &outfile) {
+	void CodeGen::write_data_to_asm_file(std::ostream &outfile) {
 
-		if (!outfile.is_open())
-			return;
 
 		if (data_section.empty())
 			return;
@@ -3991,9 +4020,7 @@ namespace xlang {
 		outfile << "\n";
 	}
 
-	void CodeGen::write_resv_to_asm_file(std::ofstream &outfile) {
-		if (!outfile.is_open())
-			return;
+	void CodeGen::write_resv_to_asm_file(std::ostream &outfile) {
 		if (resv_section.empty())
 			return;
 		outfile << "\nsection .bss\n";
@@ -4007,10 +4034,8 @@ namespace xlang {
 		outfile << "\n";
 	}
 
-	void CodeGen::write_instructions_to_asm_file(std::ofstream &outfile) {
+	void CodeGen::write_instructions_to_asm_file(std::ostream &outfile) {
 		std::string cast;
-		if (!outfile.is_open())
-			return;
 
 		for (Instruction *in: instructions) {
 			if (in->insn_type == INSLABEL) {
@@ -4187,14 +4212,54 @@ namespace xlang {
 	}
 
 	void CodeGen::write_asm_file() {
-		std::ofstream outfile(Compiler::global.file.asm_name(), std::ios::out);
+		StatsScope scope(comp->stats, "write_asm");
+		TraceScope span(comp->trace, "write_asm", "pass");
 
+		if (comp->global.in_memory) {
+			std::ostringstream out;
+			write_asm(out);
+			comp->assembly = out.str();
+			return;
+		}
+
+		std::ofstream outfile(comp->global.file.asm_name(), std::ios::out);
+		if (outfile.is_open())
+			write_asm(outfile);
+	}
+
+	void CodeGen::write_asm(std::ostream &outfile) {
 		write_text_to_asm_file(outfile);
 		write_instructions_to_asm_file(outfile);
 		write_data_to_asm_file(outfile);
 		write_resv_to_asm_file(outfile);
+	}
+
+	bool CodeGen::write_object_file() {
+
+		// encode and write the object file without nasm,
+		// returns false if nasm has to do it instead
+
+		StatsScope scope(comp->stats, "write_object");
+		TraceScope span(comp->trace, "write_object", "pass");
+		ElfObject obj(comp->global.x64);
+		obj.source_name = comp->global.file.asm_name();
+
+		Encoder enc(comp->global.x64);
+		if (!enc.encode(text_section, instructions, data_section, resv_section, obj)) {
+			if (comp->global.log_level >= LOG_VERBOSE)
+				Log::line("using nasm: ", enc.error());
+			return false;
+		}
+		return save_object_file(obj);
+	}
 
-		outfile.close();
+	bool CodeGen::save_object_file(const ElfObject &obj) {
+		if (comp->global.in_memory) {
+			comp->object = obj.image();
+			return true;
+		}
+		comp->object_written = obj.write(comp->global.file.object_name());
+		return comp->object_written;
 	}
 
 	bool CodeGen::search_text(TextSection *tx) {
@@ -4207,6 +4272,65 @@ namespace xlang {
 		return false;
 	}
 
+	void CodeGen::add_text_section(FunctionInfo *func_info) {
+
+		//generate text section types for function(scope: global, extern)
+		TextSection *t = insncls->get_text_mem();
+		t->symbol = func_info->func_name;
+
+		if (func_info->is_global)
+			t->type = TXTGLOBAL;
+		else if (func_info->is_extern)
+			t->type = TXTEXTERN;
+		else
+			t->type = TXTNONE;
+
+		if (t->type != TXTNONE && !search_text(t))
+			text_section.push_back(t);
+		else
+			insncls->delete_text(&t);
+	}
+
+	void CodeGen::gen_tree_node(TreeNode *trhead) {
+
+		if (trhead->symtab != nullptr) {
+			func_symtab = trhead->symtab;
+			func_params = trhead->symtab->func_info;
+		}
+
+		if (trhead->symtab == nullptr) {
+			if (trhead->statement != nullptr && trhead->statement->type == StatementType::ASM) {
+				gen_asm_statement(&trhead->statement->asm_statement);
+				return;
+			}
+		}
+
+		//global expression does not have sumbol table
+		//if symbol table is found, then function definition is also found
+
+		if (func_symtab != nullptr) {
+			add_text_section(func_symtab->func_info);
+
+			if (!func_symtab->func_info->is_extern) {
+				TraceScope function_span(comp->trace, func_symtab->func_info->func_name, "codegen");
+				get_func_local_members();
+				gen_function();
+
+				if_label_count = 1;
+				else_label_count = 1;
+				exit_if_count = 1;
+				while_loop_count = 1;
+				dowhile_loop_count = 1;
+				for_loop_count = 1;
+				exit_loop_label_count = 1;
+
+				gen_statement(&trhead->statement);
+				restore_frame_pointer();
+				func_return();
+			}
+		}
+	}
+
 	//generate final assembly code
 
 	void CodeGen::get_code(TreeNode **ast) {
@@ -4215,12 +4339,17 @@ namespace xlang {
 		if (trhead == nullptr)
 			return;
 
-		if (Compiler::global.optimize) {
-			Optimizer *optmz = new Optimizer();
+		StatsScope scope(comp->stats, "codegen");
+		TraceScope span(comp->trace, "codegen", "pass");
+
+		if (comp->global.optimize) {
+			StatsScope optimize_scope(comp->stats, "optimize");
+			TraceScope optimize_span(comp->trace, "optimize", "pass");
+			Optimizer *optmz = new Optimizer(comp);
 			optmz->optimize(&trhead);
 			delete optmz;
 			optmz = nullptr;
-			if (Compiler::global.error_count > 0)
+			if (comp->global.error_count > 0)
 				return;
 		}
 
@@ -4228,64 +4357,95 @@ namespace xlang {
 
 		trhead = *ast;
 		while (trhead != nullptr) {
+			gen_tree_node(trhead);
+			trhead = trhead->p_next;
+		}
 
-			if (trhead->symtab != nullptr) {
-				func_symtab = trhead->symtab;
-				func_params = trhead->symtab->func_info;
-			}
+		if (comp->global.assemble && !comp->global.use_nasm && !write_object_file())
+			comp->global.use_nasm = true;
 
-			if (trhead->symtab == nullptr) {
-				if (trhead->statement != nullptr && trhead->statement->type == StatementType::ASM) {
-					gen_asm_statement(&trhead->statement->asm_statement);
-					trhead = trhead->p_next;
-					continue;
-				}
-			}
+		if (!comp->global.assemble || comp->global.use_nasm || !comp->global.remove_asmfile || comp->global.in_memory)
+			write_asm_file();
+	}
 
-			//global expression does not have sumbol table
-			//if symbol table is found, then function definition is also found
+	void CodeGen::begin_stream(TreeNode **ast) {
 
-			if (func_symtab != nullptr) {
+		// the text section is known from the heads of the functions before
+		// any of them is generated, so the asm text can be written in order
 
-				//generate text section types for function(scope: global, extern)
-				TextSection *t = insncls->get_text_mem();
-				t->symbol = func_symtab->func_info->func_name;
+		if (*ast == nullptr)
+			return;
 
-				if (func_symtab->func_info->is_global)
-					t->type = TXTGLOBAL;
-				else if (func_symtab->func_info->is_extern)
-					t->type = TXTEXTERN;
-				else
-					t->type = TXTNONE;
+		gen_global_declarations(ast);
+		for (TreeNode *trhead = *ast; trhead != nullptr; trhead = trhead->p_next) {
+			if (trhead->symtab != nullptr)
+				add_text_section(trhead->symtab->func_info);
+		}
 
-				if (t->type != TXTNONE) {
-					if (search_text(t))
-						insncls->delete_text(&t);
-					else
-						text_section.push_back(t);
-				}
+		if (comp->global.in_memory)
+			stream_out = std::make_unique<std::ostringstream>();
+		else
+			stream_out = std::make_unique<std::ofstream>(comp->global.file.asm_name(), std::ios::out);
+		write_text_to_asm_file(*stream_out);
+
+		if (comp->global.assemble && !comp->global.use_nasm) {
+			stream_encoder = std::make_unique<Encoder>(comp->global.x64);
+			stream_object = std::make_unique<ElfObject>(comp->global.x64);
+			stream_object->source_name = comp->global.file.asm_name();
+			if (!stream_encoder->begin(text_section, resv_section))
+				drop_encoder();
+		}
+	}
 
-				if (!func_symtab->func_info->is_extern) {
-					get_func_local_members();
-					gen_function();
-
-					if_label_count = 1;
-					else_label_count = 1;
-					exit_if_count = 1;
-					while_loop_count = 1;
-					dowhile_loop_count = 1;
-					for_loop_count = 1;
-					exit_loop_label_count = 1;
-
-					gen_statement(&trhead->statement);
-					restore_frame_pointer();
-					func_return();
-				}
-			}
+	void CodeGen::stream_node(TreeNode *trhead) {
 
-			trhead = trhead->p_next;
-		}
+		// the members of the function before aren't looked at again
+		// once another one starts
+
+		if (trhead->symtab != nullptr && func_symtab != nullptr && func_symtab != trhead->symtab)
+			func_members.erase(func_symtab->func_info->tok.name);
+
+		gen_tree_node(trhead);
+
+		write_instructions_to_asm_file(*stream_out);
+		if (stream_encoder && !stream_encoder->add(instructions, *stream_object))
+			drop_encoder();
+
+		for (auto x: instructions)
+			insncls->delete_insn(&x);
+		instructions.clear();
+	}
+
+	void CodeGen::drop_encoder() {
+		if (comp->global.log_level >= LOG_VERBOSE)
+			Log::line("using nasm: ", stream_encoder->error());
+		stream_encoder.reset();
+		stream_object.reset();
+	}
+
+	void CodeGen::end_stream() {
+
+		// the asm file is always written, nasm needs it if the encoder
+		// gave up. it goes again if the object file was made without it
+
+		if (!stream_out)
+			return;
+
+		write_data_to_asm_file(*stream_out);
+		write_resv_to_asm_file(*stream_out);
+		if (comp->global.in_memory)
+			comp->assembly = static_cast<std::ostringstream &>(*stream_out).str();
+		stream_out.reset();
+
+		if (!comp->global.assemble || comp->global.use_nasm)
+			return;
+
+		if (stream_encoder && !stream_encoder->finish(data_section, resv_section, *stream_object))
+			drop_encoder();
 
-		write_asm_file();
+		if (!stream_encoder || !save_object_file(*stream_object))
+			comp->global.use_nasm = true;
+		else if (comp->global.remove_asmfile && !comp->global.in_memory)
+			remove(comp->global.file.asm_name().c_str());
 	}
 }
\ No newline at end of file
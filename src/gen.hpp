@@ -13,6 +13,7 @@
 #include <map>
 #include <unordered_map>
 #include <memory>
+#include <ostream>
 #include "token.hpp"
 #include "lex.hpp"
 #include "tree.hpp"
@@ -20,13 +21,16 @@
 #include "regs.hpp"
 #include "insn.hpp"
 #include "optimize.hpp"
+#include "encode.hpp"
 
 namespace xlang {
 
+	class Compiler;
+
 	class CodeGen {
 	public:
 
-		CodeGen() : reg{new Registers}, insncls{new InstructionClass} {}
+		explicit CodeGen(Compiler *c) : comp(c), reg{new Registers}, insncls{new InstructionClass} {}
 
 		~CodeGen() {
 
@@ -48,8 +52,19 @@ namespace xlang {
 
 		void get_code(TreeNode **);
 
+		// --stream: begin_stream() once the declarations are analyzed,
+		// stream_node() for every top level node in order and end_stream()
+		// after the last. the instructions of a node are written out and
+		// freed after it, the data and bss sections at the end
+		void begin_stream(TreeNode **);
+
+		void stream_node(TreeNode *);
+
+		void end_stream();
+
 	private:
 
+		Compiler *comp;
 		Registers *reg;
 		InstructionClass *insncls;
 
@@ -63,7 +78,7 @@ namespace xlang {
 
 		IterationType current_loop = IterationType::WHILE;
 		std::stack<int> for_loop_stack, while_loop_stack, dowhile_loop_stack;
-		std::unordered_map<std::string, SymbolInfo *> initialized_data;
+		std::unordered_map<NameId, SymbolInfo *> initialized_data;
 
 		//vectors for data, bss, text sections and instructions
 		std::vector<Member *> data_section;
@@ -78,14 +93,26 @@ namespace xlang {
 
 		struct LocalMembers {
 			size_t total_size;
-			std::unordered_map<std::string, FunctionMember> members;
+			std::unordered_map<NameId, FunctionMember> members;
+			std::vector<NameId> order;  // members in the order they were laid out
+
+			void add(NameId name, FunctionMember fm) {
+				if (members.emplace(name, fm).second)
+					order.push_back(name);
+			}
 		};
 
 
-		std::unordered_map<std::string, LocalMembers> func_members;
+		std::unordered_map<NameId, LocalMembers> func_members;
+
+		// where --stream writes to, the encoder gets the same instructions
+		// unless it is not used or has given up
+		std::unique_ptr<std::ostream> stream_out;
+		std::unique_ptr<Encoder> stream_encoder;
+		std::unique_ptr<ElfObject> stream_object;
 
-		using funcmem_iterator = std::unordered_map<std::string, LocalMembers>::iterator;
-		using memb_iterator = std::unordered_map<std::string, FunctionMember>::iterator;
+		using funcmem_iterator = std::unordered_map<NameId, LocalMembers>::iterator;
+		using memb_iterator = std::unordered_map<NameId, FunctionMember>::iterator;
 
 		template<typename type>
 		void clear_stack(std::stack<type> &stk) {
@@ -109,29 +136,32 @@ namespace xlang {
 
 		void get_func_local_members();
 
-		SymbolInfo *search_func_params(const std::string &);
+		SymbolInfo *search_func_params(NameId);
 
-		SymbolInfo *search_id(const std::string &);
+		SymbolInfo *search_id(NameId);
 
 		InstructionSize get_insn_size_type(int);
 
 		std::stack<PrimaryExpression *> get_post_order_prim_expr(PrimaryExpression *);
 
-		InstructionType get_arthm_op(const std::string &);
+		InstructionType get_arthm_op(std::string_view);
 
-		InstructionType get_farthm_op(const std::string &, bool);
+		InstructionType get_farthm_op(std::string_view, bool);
 
 		Instruction *get_insn(InstructionType instype, int oprcount);
 
 		void insert_comment(const std::string &);
 
-		Member *search_data(const std::string &);
+		// line of a token for the comments, found in the source only then
+		std::string line_number(TokenLocation);
+
+		Member *search_data(std::string_view);
 
-		Member *search_string_data(const std::string &);
+		Member *search_string_data(std::string_view);
 
 		std::string hex_escape_sequence(char);
 
-		std::string get_hex_string(const std::string &);
+		std::string get_hex_string(std::string_view);
 
 		bool get_function_local_member(FunctionMember *, Token);
 
@@ -139,7 +169,7 @@ namespace xlang {
 
 		bool gen_int_primexp_compl(PrimaryExpression *, int);
 
-		Member *create_string_data(const std::string &);
+		Member *create_string_data(std::string_view);
 
 		RegisterType gen_string_literal_primary_expr(PrimaryExpression *);
 
@@ -147,11 +177,11 @@ namespace xlang {
 
 		RegisterType gen_int_primary_expr(PrimaryExpression *);
 
-		Member *create_float_data(DeclarationType, const std::string &);
+		Member *create_float_data(DeclarationType, std::string_view);
 
 		void gen_float_primary_expr(PrimaryExpression *);
 
-		std::pair<int, int> gen_primary_expr(PrimaryExpression **);
+		std::pair<int, int> gen_primary_expr(PrimaryExpression *);
 
 		void gen_assgn_primary_expr(AssignmentExpression **);
 
@@ -161,7 +191,7 @@ namespace xlang {
 
 		void gen_assgn_cast_expr(AssignmentExpression **);
 
-		void gen_id_expr(IdentifierExpression **);
+		void gen_id_expr(IdentifierExpression *);
 
 		void gen_assgn_id_expr(AssignmentExpression **);
 
@@ -205,7 +235,7 @@ namespace xlang {
 
 		bool is_literal(Token);
 
-		bool gen_float_type_condition(PrimaryExpression **, PrimaryExpression **, PrimaryExpression **opr);
+		bool gen_float_type_condition(PrimaryExpression *, PrimaryExpression *, PrimaryExpression *opr);
 
 		TokenId gen_select_stmt_condition(Expression *);
 
@@ -215,24 +245,36 @@ namespace xlang {
 
 		void gen_statement(Statement **);
 
-		void write_record_member_to_asm_file(RecordDataType &, std::ofstream &);
+		void write_record_member_to_asm_file(RecordDataType &, std::ostream &);
 
-		void write_record_data_to_asm_file(ReserveSection **, std::ofstream &);
+		void write_record_data_to_asm_file(ReserveSection **, std::ostream &);
 
-		void write_data_to_asm_file(std::ofstream &);
+		void write_data_to_asm_file(std::ostream &);
 
-		void write_resv_to_asm_file(std::ofstream &);
+		void write_resv_to_asm_file(std::ostream &);
 
-		void write_text_to_asm_file(std::ofstream &);
+		void write_text_to_asm_file(std::ostream &);
 
-		void write_instructions_to_asm_file(std::ofstream &);
+		void write_instructions_to_asm_file(std::ostream &);
 
 		void write_asm_file();
 
+		void write_asm(std::ostream &);
+
+		bool write_object_file();
+
+		bool save_object_file(const ElfObject &);
+
+		void drop_encoder();
+
+		void add_text_section(FunctionInfo *);
+
+		void gen_tree_node(TreeNode *);
+
 		bool search_text(TextSection *);
 
 		void gen_record();
 
-		std::unordered_map<std::string, int> record_sizes;
+		std::unordered_map<NameId, int> record_sizes;
 	};
 }
\ No newline at end of file
@@ -22,6 +22,8 @@ namespace xlang {
     #error "Host not supported."
 #endif
 
+	inline const std::string VERSION = "0.0.1";
+
 	struct GlobalConfig {
 		SourceFile file;
 		int log_level{1};
@@ -38,5 +40,17 @@ namespace xlang {
 		bool remove_asmfile{true};
 		bool remove_objfile{true};
         bool x64{false};
+		bool use_nasm{false};
+		std::string cache_dir;
+		bool time_passes{false};
+		bool mem_stats{false};
+		std::string stats_file;
+		std::string trace_file;
+		bool in_memory{false};
+		unsigned lex_threads{0};   // 0 lexes while parsing
+		unsigned parse_threads{0}; // function bodies parsed at the same time
+		bool stream{false};        // one function at a time from parsing to output
+		bool emit_ast{false};      // write the analyzed tree next to the source, as .ast
+		bool load_ast{false};      // start from that file if it is up to date
 	};
 }
\ No newline at end of file
@@ -10,7 +10,7 @@
 namespace xlang {
 	
 	Operand *InstructionClass::get_operand_mem() {
-		return new struct Operand;
+		return new Operand();
 	}
 	
 	TextSection *InstructionClass::get_text_mem() {
@@ -42,6 +42,8 @@ namespace xlang {
 	}
 	
 	void InstructionClass::delete_insn(Instruction **in) {
+		delete (*in)->operand_1;
+		delete (*in)->operand_2;
 		delete *in;
 		*in = nullptr;
 	}
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "intern.hpp"
+
+namespace xlang {
+
+	NameId Interner::intern(std::string_view str) {
+		auto it = ids.find(str);
+		if (it != ids.end())
+			return it->second;
+
+		// a deque doesn't move its strings, the keys stay valid
+		NameId id = static_cast<NameId>(names.size());
+		names.emplace_back(str);
+		ids.emplace(names.back(), id);
+		return id;
+	}
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "token.hpp"
+
+namespace xlang {
+
+	// every identifier of a compilation gets a small number, the same
+	// one each time it appears. the symbol, function, record and label
+	// tables are keyed on it so later phases compare integers instead
+	// of hashing and comparing strings
+	//
+	// it isn't locked, the lexer interns on the thread that reads the
+	// tokens
+
+	class Interner {
+	public:
+
+		// the id of a name, given a new one the first time it is seen
+		NameId intern(std::string_view);
+
+		// the text of an id, empty for NO_NAME
+		std::string_view name(NameId id) const {
+			return id < names.size() ? std::string_view(names[id]) : std::string_view();
+		}
+
+		// ids handed out so far, NO_NAME included
+		size_t size() const {
+			return names.size();
+		}
+
+	private:
+
+		std::deque<std::string> names{""};
+		std::unordered_map<std::string_view, NameId> ids;
+	};
+}
@@ -11,96 +11,69 @@
 
 #include <iostream>
 
-#include <stack>
 #include <algorithm>
+#include <charconv>
 #include "token.hpp"
 #include "log.hpp"
 #include "lex.hpp"
 
 namespace xlang {
 
-	void Lexer::init() {
-
-		if (!file_exists(file.path)) {
+	static_assert(Lexer::keyword("asm") == KEY_ASM && Lexer::keyword("break") == KEY_BREAK &&
+				  Lexer::keyword("char") == KEY_CHAR && Lexer::keyword("const") == KEY_CONST &&
+				  Lexer::keyword("continue") == KEY_CONTINUE && Lexer::keyword("do") == KEY_DO &&
+				  Lexer::keyword("double") == KEY_DOUBLE && Lexer::keyword("else") == KEY_ELSE &&
+				  Lexer::keyword("extern") == KEY_EXTERN && Lexer::keyword("float") == KEY_FLOAT &&
+				  Lexer::keyword("for") == KEY_FOR && Lexer::keyword("global") == KEY_GLOBAL &&
+				  Lexer::keyword("goto") == KEY_GOTO && Lexer::keyword("if") == KEY_IF &&
+				  Lexer::keyword("int") == KEY_INT && Lexer::keyword("long") == KEY_LONG &&
+				  Lexer::keyword("record") == KEY_RECORD && Lexer::keyword("return") == KEY_RETURN &&
+				  Lexer::keyword("short") == KEY_SHORT && Lexer::keyword("sizeof") == KEY_SIZEOF &&
+				  Lexer::keyword("static") == KEY_STATIC && Lexer::keyword("void") == KEY_VOID &&
+				  Lexer::keyword("while") == KEY_WHILE, "every keyword in token.hpp");
+
+	static_assert(Lexer::keyword("") == IDENTIFIER && Lexer::keyword("i") == IDENTIFIER &&
+				  Lexer::keyword("iff") == IDENTIFIER && Lexer::keyword("rec0rd") == IDENTIFIER &&
+				  Lexer::keyword("retain") == IDENTIFIER && Lexer::keyword("sizes") == IDENTIFIER, "not keywords");
+
+	void Lexer::init(size_t from) {
+
+		// the whole file is mapped once, tokens point into it
+		if (!file.buffer)
+			file.buffer = SourceBuffer::map(file.path);
+		if (!file.buffer)
 			Log::error(file.name, "No such file of directory");
-			std::exit(EXIT_FAILURE);
-		}
-
-		key_tokens = {{"asm",      KEY_ASM},
-					  {"break",    KEY_BREAK},
-					  {"char",     KEY_CHAR},
-					  {"const",    KEY_CONST},
-					  {"continue", KEY_CONTINUE},
-					  {"do",       KEY_DO},
-					  {"double",   KEY_DOUBLE},
-					  {"else",     KEY_ELSE},
-					  {"extern",   KEY_EXTERN},
-					  {"float",    KEY_FLOAT},
-					  {"for",      KEY_FOR},
-					  {"global",   KEY_GLOBAL},
-					  {"goto",     KEY_GOTO},
-					  {"if",       KEY_IF},
-					  {"int",      KEY_INT},
-					  {"long",     KEY_LONG},
-					  {"record",   KEY_RECORD},
-					  {"return",   KEY_RETURN},
-					  {"short",    KEY_SHORT},
-					  {"sizeof",   KEY_SIZEOF},
-					  {"static",   KEY_STATIC},
-					  {"void",     KEY_VOID},
-					  {"while",    KEY_WHILE}};
-
-		std::sort(symbols.begin(), symbols.end());
-	}
 
-	std::string Lexer::get_filename() {
-		return file.name;
+		text = file.buffer->text();
+		buffer_index = from;
+		Log::source = file.buffer.get();
 	}
 
-	bool Lexer::is_eof(char ch) {
-		return (ch <= 0);
+	void Lexer::run_ahead(unsigned jobs) {
+		stream = std::make_unique<TokenStream>(file, jobs);
 	}
 
-	bool Lexer::file_read(SourceFile &src) {
-		std::ifstream input(src.path);
-
-		if (input.is_open()) {
-			std::string ln;
-			while (std::getline(input, ln)) {
-				src.content += ln;
-			}
-			input.close();
-			src.loaded = true;
-			buffer_index = 0;
-			return true;
-		}
-
-		return false;
+	void Lexer::replay(const Token *tokens, size_t count, std::string_view error) {
+		replaying = true;
+		replayed = tokens;
+		replay_count = count;
+		replay_error = error;
+		next = 0;
+		scanned = 0;
 	}
 
-	bool Lexer::file_exists(const std::string &path) {
-
-		if (path.empty())
-			return false;
-
-		std::ifstream test(path);
-		if (test.is_open()) {
-			test.close();
-			return true;
-		}
+	std::string Lexer::get_filename() {
+		return file.name;
+	}
 
-		return false;
+	bool Lexer::is_eof(char ch) {
+		return (ch <= 0);
 	}
 
 	char Lexer::get_next_char() {
 
-		if (!file.loaded) {
-			file_read(file);
-			eof_flag = false;
-		}
-
-		if (buffer_index < file.content.size())
-			return file.content[buffer_index++];
+		if (buffer_index < text.size())
+			return text[buffer_index++];
 
 		eof_flag = true;
 		unget_flag = false;
@@ -129,9 +102,6 @@ namespace xlang {
 				return;
 			}
 			lexeme.push_back(ch);
-			col++;
-			if (ch == '\n')
-				line++;
 		}
 	}
 
@@ -143,9 +113,6 @@ namespace xlang {
 			}
 			else {
 				lexeme.push_back(ch);
-				col++;
-				if (ch == '\n')
-					line++;
 			}
 		}
 	}
@@ -159,9 +126,6 @@ namespace xlang {
 			}
 			else {
 				lexeme.push_back(ch);
-				col++;
-				if (ch == '\n')
-					line++;
 			}
 		}
 		unget_char();
@@ -172,7 +136,7 @@ namespace xlang {
 	  ! % ^ ~ & * ( ) - + = [ ] { } | : ; < > , . / \ ' " @ # ` ?
 	*/
 	bool Lexer::symbol(char ch) {
-		return std::binary_search(symbols.begin(), symbols.end(), ch);
+		return Scan::is(ch, CHAR_SYMBOL);
 	}
 
 	/*
@@ -180,7 +144,7 @@ namespace xlang {
 	    0 1 2 3 4 5 6 7 8 9
 	*/
 	bool Lexer::digit(char ch) {
-		return ((ch - '0' >= 0) && (ch - '0' <= 9));
+		return Scan::is(ch, CHAR_DIGIT);
 	}
 
 	/*
@@ -188,7 +152,7 @@ namespace xlang {
 		1 2 3 4 5 6 7 8 9
 	*/
 	bool Lexer::nonzero_digit(char ch) {
-		return ((ch - '0' >= 1) && (ch - '0' <= 9));
+		return ch != '0' && Scan::is(ch, CHAR_DIGIT);
 	}
 
 	/*
@@ -196,7 +160,7 @@ namespace xlang {
 	  0 1 2 3 4 5 6 7
 	*/
 	bool Lexer::octal_digit(char ch) {
-		return ((ch - '0' >= 0) && (ch - '0' <= 7));
+		return Scan::is(ch, CHAR_OCTAL);
 	}
 
 	/*
@@ -206,7 +170,7 @@ namespace xlang {
 		A B C D E F
 	*/
 	bool Lexer::hexadecimal_digit(char ch) {
-		return (((ch - '0' >= 0) && (ch - '0' <= 9)) || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F'));
+		return Scan::is(ch, CHAR_HEX);
 	}
 
 	/*
@@ -215,7 +179,7 @@ namespace xlang {
 	  A B C D E F G H I J K L M N O P Q R S T U V W X Y Z
 	*/
 	bool Lexer::non_digit(char ch) {
-		return (ch == '_' || ch == '$' || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z'));
+		return Scan::is(ch, CHAR_NONDIGIT);
 	}
 
 	/*
@@ -226,7 +190,6 @@ namespace xlang {
 	bool Lexer::comment() {
 		char ch = get_next_char();
 		char peek;
-		int multicomment_line = 0, mulcmnt_col = 0;
 		bool is_comment_complete = false;
 
 		if (is_eof(ch)) {
@@ -234,45 +197,28 @@ namespace xlang {
 			return false;
 		}
 
-		// single line comment '//'
+		// single line comment '//', up to and with the newline
 		if (ch == '/') {
-			col++;
-			do {
-				ch = get_next_char();
-				col++;
-				if (is_eof(ch)) {
-					unget_char();
-					break;
-				}
-			} while (ch != '\n');
-
+			size_t end = buffer_index + Scan::find(text.data() + buffer_index, text.size() - buffer_index, '\n', '\n', '\n');
+			buffer_index = std::min(end + 1, text.size());
 		}
 		else if (ch == '*') {    //multi line comment / *  * /
-			multicomment_line = line;
-			mulcmnt_col = col;
-			col++;
-
-			// any character
-			while (!is_eof(ch = get_next_char())) {
-				col++;
-				if (ch == '\n') {
-					line++;
-					col = 1;
-				}
-				else if (ch == '*') {
+
+			// any character, the ones that aren't '*' are skipped at once
+			while (true) {
+				size_t run = Scan::find(text.data() + buffer_index, text.size() - buffer_index, '*', '*', '*');
+				buffer_index += run;
+				if (is_eof(ch = get_next_char()))
+					break;
+				if (ch == '*') {
 					peek = get_next_char();
 					if (peek == '/') {
-						col++;
 						is_comment_complete = true;
 						break;
 					}
-					else if (peek == '\n') {
-						line++;
-						col = 1;
-					}
 					else {
 						if (is_eof(peek)) {
-							Log::error(get_filename(), "incomplete comment", multicomment_line, mulcmnt_col);
+							Log::error(get_filename(), "incomplete comment", position().line, position().col);
 
 							return false;
 						}
@@ -284,7 +230,7 @@ namespace xlang {
 			}
 			else {
 				unget_char();
-				Log::error(get_filename(), "incomplete comment", multicomment_line, mulcmnt_col);
+				Log::error(get_filename(), "incomplete comment", position().line, position().col);
 
 				return false;
 			}
@@ -294,38 +240,42 @@ namespace xlang {
 			return false;
 		}
 
-		line++;
 		return true;
 	}
 
+	std::string_view Lexer::view(const std::string &lexm) {
+
+		// a lexeme is the source text where its token starts, or right
+		// after the quote of a string or character. text that isn't (made
+		// up while recovering from errors) is kept by the buffer
+
+		for (size_t at: {token_start, token_start + 1}) {
+			if (at <= text.size() && text.substr(at, lexm.size()) == lexm)
+				return text.substr(at, lexm.size());
+		}
+		return file.buffer->keep(lexm);
+	}
+
+	SourcePosition Lexer::position() {
+		return file.buffer->position({static_cast<uint32_t>(token_start)});
+	}
+
 	Token Lexer::make_token(TokenId tok1) {
 
 		// assign lexeme, location and return that Token
 
 		Token tok;
 		tok.number = tok1;
-		tok.string = lexeme;
-
-		if (col == (unsigned) lexeme.size())
-			tok.loc.col = 1;
-		else
-			tok.loc.col = col - lexeme.size();
-
-		tok.loc.line = line;
+		tok.string = view(lexeme);
+		tok.loc.offset = token_start;
 		return tok;
 	}
 
-	Token Lexer::make_token(std::string lexm, TokenId tok1) {
+	Token Lexer::make_token(std::string_view lexm, TokenId tok1) {
 		Token tok;
 		tok.number = tok1;
 		tok.string = lexm;
-
-		if (col == (unsigned) lexm.size())
-			tok.loc.col = 1;
-		else
-			tok.loc.col = col - lexm.size();
-
-		tok.loc.line = line;
+		tok.loc.offset = token_start;
 		return tok;
 	}
 
@@ -360,6 +310,52 @@ namespace xlang {
 		return tok;
 	}
 
+	void Lexer::decode(Token &tok) {
+
+		// the value of a number or character literal, from its text.
+		// the text was checked while lexing, a bad literal decodes as
+		// far as it is valid. an integer that doesn't fit its 64 bits
+		// is an error
+
+		std::string_view str = tok.string;
+		const char *first = str.data();
+		const char *last = str.data() + str.size();
+		LiteralValue &value = tok.value;
+		std::errc ec{};
+		switch (tok.number) {
+			case LIT_CHAR :
+				value.i = str.empty() ? 0 : str[0];
+				tok.width = 1;
+				return;
+			case LIT_FLOAT :
+				std::from_chars(first, last, value.f);
+				tok.width = 8;
+				return;
+			case LIT_DECIMAL :
+				ec = std::from_chars(first, last, value.i, 10).ec;
+				break;
+			case LIT_OCTAL :
+				ec = std::from_chars(first, last, value.i, 8).ec;
+				break;
+			case LIT_HEX :
+			case LIT_BIN :
+				if (str.size() > 2) {
+					uint64_t bits = 0;
+					ec = std::from_chars(first + 2, last, bits, tok.number == LIT_HEX ? 16 : 2).ec;
+					value.i = static_cast<int64_t>(bits);
+				}
+				break;
+			default:
+				return;
+		}
+		if (ec == std::errc::result_out_of_range)
+			Log::error_at(tok.loc, "integer literal too large ", tok.string);
+
+		// a literal has no sign, 0xFFFFFFFFFFFFFFFF is all 64 bits and
+		// not -1
+		tok.width = static_cast<uint64_t>(value.i) <= UINT32_MAX ? 4 : 8;
+	}
+	
 	Token Lexer::character_literal() {
 
 		char ch = get_next_char();
@@ -372,7 +368,6 @@ namespace xlang {
 
 			if (ch == '"') {
 				lexeme.clear();
-				col++;
 				tok = make_token(LIT_CHAR);
 			}
 			else {
@@ -430,7 +425,6 @@ namespace xlang {
 			else {
 				lexeme.push_back(ch);
 				lexeme.push_back(peek);
-				col += 2;
 			}
 		}
 		else if (ch == '\n') {
@@ -443,7 +437,6 @@ namespace xlang {
 		}
 		else {
 			lexeme.push_back(ch);
-			col++;
 		}
 
 		peek = get_next_char();
@@ -454,7 +447,6 @@ namespace xlang {
 		}
 
 		if (ch == '\'') {
-			col++;
 			return;
 		}
 		else {
@@ -476,7 +468,6 @@ namespace xlang {
 
 			if (ch == '"') {
 				lexeme.clear();
-				col++;
 				tok = make_token(LIT_STRING);
 			}
 			else {
@@ -514,6 +505,11 @@ namespace xlang {
 
 	void Lexer::s_char_sequence() {
 
+		// characters that need no checks are taken at once
+		size_t run = Scan::find(text.data() + buffer_index, text.size() - buffer_index, '"', '\\', '\n');
+		lexeme.append(text.data() + buffer_index, run);
+		buffer_index += run;
+
 		char ch = get_next_char();
 		char peek;
 
@@ -537,7 +533,6 @@ namespace xlang {
 			else {
 				lexeme.push_back(ch);
 				lexeme.push_back(peek);
-				col += 2;
 			}
 		}
 		else if (ch == '\n') {
@@ -549,7 +544,6 @@ namespace xlang {
 			return;
 		else {
 			lexeme.push_back(ch);
-			col++;
 		}
 
 
@@ -561,7 +555,6 @@ namespace xlang {
 		}
 
 		if (ch == '"') {
-			col++;
 			return;
 		}
 		else {
@@ -585,16 +578,14 @@ namespace xlang {
 
 					lexeme.push_back(ch);
 					lexeme.push_back(peek);
-					col += 2;
 					tok = hexadecimal_literal();
 
 					if (tok.string.size() == 2)
-						tok.string = tok.string + "0";
+						tok.string = file.buffer->keep(std::string(tok.string) + "0");
 				}
 				else if (peek == 'b' || peek == 'B') {
 					lexeme.push_back('0');
 					lexeme.push_back(peek);
-					col += 2;
 					tok = binary_literal();
 				}
 				else if (digit(peek)) {
@@ -604,8 +595,7 @@ namespace xlang {
 					tok = octal_literal();
 				}
 				else if (peek == '.') {
-					tok = float_literal();
-					tok.string.insert(0, "0.");
+					tok = float_literal("0.");
 				}
 				else {
 					if (symbol(peek)) {
@@ -636,27 +626,24 @@ namespace xlang {
 		else {
 			if (nonzero_digit(ch)) {
 				lexeme.push_back(ch);
-				col++;
 
 				sub_decimal_literal();
 				if (error_flag) {
 					consume_chars_till_symbol();
-					Log::error(get_filename(), "invalid decimal ", lexeme, line, col - lexeme.size());
+					Log::error(get_filename(), "invalid decimal ", lexeme, position().line, position().col);
 				}
 
 				peek = get_next_char();
 
 				if (peek == '.') {
-					tok = float_literal();
 					lexeme.push_back('.');
-					tok.string.insert(0, lexeme);
+					tok = float_literal(lexeme);
 				}
 				else if (symbol(peek)) {
 					unget_char();
 					if (eof_flag) {
 						if (lexeme.size() > 0) {
 							tok = make_token(LIT_DECIMAL);
-							col++;
 						}
 						else
 							tok.number = END;
@@ -664,7 +651,6 @@ namespace xlang {
 					else {
 						if (lexeme.size() > 0) {
 							tok = make_token(LIT_DECIMAL);
-							col++;
 						}
 					}
 				}
@@ -685,7 +671,6 @@ namespace xlang {
 
 		if (digit(ch)) {
 			lexeme.push_back(ch);
-			col++;
 		}
 		else {
 			if (symbol(ch)) {
@@ -732,18 +717,16 @@ namespace xlang {
 		else {
 			if (ch == '0') {
 				lexeme.push_back(ch);
-				col++;
 
 				sub_octal_literal();
 				if (error_flag) {
 					consume_chars_till_symbol();
-					Log::error(get_filename(), "invalid octal ", lexeme, line, col - lexeme.size());
+					Log::error(get_filename(), "invalid octal ", lexeme, position().line, position().col);
 				}
 
 				if (eof_flag) {
 					if (lexeme.size() > 0) {
 						tok = make_token(LIT_OCTAL);
-						col++;
 					}
 					else
 						tok.number = END;
@@ -751,7 +734,6 @@ namespace xlang {
 				else {
 					if (lexeme.size() > 0) {
 						tok = make_token(LIT_OCTAL);
-						col++;
 					}
 				}
 			}
@@ -771,7 +753,6 @@ namespace xlang {
 
 		if (octal_digit(ch)) {
 			lexeme.push_back(ch);
-			col++;
 		}
 		else {
 			if (symbol(ch)) {
@@ -820,12 +801,11 @@ namespace xlang {
 			sub_hexadecimal_literal();
 			if (error_flag) {
 				consume_chars_till_symbol();
-				Log::error(get_filename(), "invalid hexadecimal ", lexeme, line, col - lexeme.size());
+				Log::error(get_filename(), "invalid hexadecimal ", lexeme, position().line, position().col);
 			}
 			if (eof_flag) {
 				if (lexeme.size() > 0) {
 					tok = make_token(LIT_HEX);
-					col++;
 				}
 				else
 					tok.number = END;
@@ -833,7 +813,6 @@ namespace xlang {
 			else {
 				if (lexeme.size() > 0) {
 					tok = make_token(LIT_HEX);
-					col++;
 				}
 			}
 		}
@@ -852,7 +831,6 @@ namespace xlang {
 
 		if (hexadecimal_digit(ch)) {
 			lexeme.push_back(ch);
-			col++;
 		}
 		else {
 			if (symbol(ch)) {
@@ -900,12 +878,11 @@ namespace xlang {
 
 			if (error_flag) {
 				consume_chars_till_symbol();
-				Log::error(get_filename(), "invalid binary ", lexeme, line, col - lexeme.size());
+				Log::error(get_filename(), "invalid binary ", lexeme, position().line, position().col);
 			}
 			if (eof_flag) {
 				if (lexeme.size() > 0) {
 					tok = make_token(LIT_BIN);
-					col++;
 				}
 				else
 					tok.number = END;
@@ -913,7 +890,6 @@ namespace xlang {
 			else {
 				if (lexeme.size() > 0) {
 					tok = make_token(LIT_BIN);
-					col++;
 				}
 			}
 		}
@@ -933,7 +909,6 @@ namespace xlang {
 
 		if (ch == '0' || ch == '1') {
 			lexeme.push_back(ch);
-			col++;
 		}
 		else {
 			if (symbol(ch)) {
@@ -969,17 +944,18 @@ namespace xlang {
 		}
 	}
 
-	Token Lexer::float_literal() {
+	Token Lexer::float_literal(const std::string &integer) {
 		Token tok;
 		std::string lexm;
 		digit_sequence(lexm);
 
 		if (error_flag) {
 			consume_chars_till_symbol();
-			Log::error(get_filename(), "invalid float ", lexm, line, col - lexm.size());
+			Log::error(get_filename(), "invalid float ", lexm, position().line, position().col);
 		}
 
-		tok = make_token(lexm, LIT_FLOAT);;
+		tok = make_token(lexm, LIT_FLOAT);
+		tok.string = view(integer + lexm);
 		return tok;
 	}
 
@@ -995,7 +971,6 @@ namespace xlang {
 
 		if (digit(ch)) {
 			lexm.push_back(ch);
-			col++;
 		}
 		else {
 			error_flag = true;
@@ -1036,9 +1011,7 @@ namespace xlang {
 		else {
 			if (non_digit(ch)) {
 				lexeme.push_back(ch);
-				tok.loc.col = col;
-				tok.loc.line = line;
-				col++;
+				tok.loc.offset = token_start;
 			}
 		}
 
@@ -1053,14 +1026,14 @@ namespace xlang {
 				if (eof_flag) {
 					if (lexeme.size() > 0) {
 						tok.number = IDENTIFIER;
-						tok.string = lexeme;
+						tok.string = view(lexeme);
 					}
 					else
 						tok.number = END;
 				}
 				else if (lexeme.size() > 0) {
 					tok.number = IDENTIFIER;
-					tok.string = lexeme;
+					tok.string = view(lexeme);
 				}
 			}
 			else {
@@ -1068,16 +1041,15 @@ namespace xlang {
 					unget_char();
 					if (lexeme.size() > 0) {
 						tok.number = IDENTIFIER;
-						tok.string = lexeme;
-						col++;
+						tok.string = view(lexeme);
 					}
 				}
 			}
 		}
 
-		std::unordered_map<std::string, TokenId>::iterator find_it = key_tokens.find(lexeme);
-		if (find_it != key_tokens.end())
-			tok.number = find_it->second;
+		TokenId key = keyword(lexeme);
+		if (key != IDENTIFIER)
+			tok.number = key;
 
 		lexeme.clear();
 		return tok;
@@ -1085,33 +1057,13 @@ namespace xlang {
 
 	void Lexer::sub_identifier() {
 
-		char ch = get_next_char();
-		char peek;
-
-		if (is_eof(ch)) {
-			eof_flag = true;
-			return;
-		}
-
-		if (non_digit(ch) || digit(ch)) {
-			lexeme.push_back(ch);
-			col++;
-		}
+		// the rest of the identifier
+		size_t run = Scan::identifier(text.data() + buffer_index, text.size() - buffer_index);
+		lexeme.append(text.data() + buffer_index, run);
+		buffer_index += run;
 
-		peek = get_next_char();
-		if (is_eof(peek)) {
+		if (buffer_index == text.size())
 			eof_flag = true;
-			return;
-		}
-
-		if (non_digit(peek) || digit(peek)) {
-			unget_char();
-			sub_identifier();
-		}
-		else {
-			unget_char();
-			return;
-		}
 	}
 
 	Token Lexer::operator_token() {
@@ -1124,15 +1076,12 @@ namespace xlang {
 			case '+' : {
 				peek = get_next_char();
 				if (peek == '=') {
-					col += 2;
 					return make_token("+=", ASSGN_ADD);
 				}
 				else if (peek == '+') {
-					col += 2;
 					return make_token("++", INCR_OP);
 				}
 				else {
-					col++;
 					unget_char();
 					return make_token("+", ARTHM_ADD);
 				}
@@ -1142,19 +1091,15 @@ namespace xlang {
 			case '-' : {
 				peek = get_next_char();
 				if (peek == '=') {
-					col += 2;
 					return make_token("-=", ASSGN_SUB);
 				}
 				else if (peek == '-') {
-					col += 2;
 					return make_token("--", DECR_OP);
 				}
 				else if (peek == '>') {
-					col += 2;
 					return make_token("->", ARROW_OP);
 				}
 				else {
-					col++;
 					unget_char();
 					return make_token("-", ARTHM_SUB);
 				}
@@ -1164,11 +1109,9 @@ namespace xlang {
 			case '*' : {
 				peek = get_next_char();
 				if (peek == '=') {
-					col += 2;
 					return make_token("*=", ASSGN_MUL);
 				}
 				else {
-					col++;
 					unget_char();
 					return make_token("*", ARTHM_MUL);
 				}
@@ -1178,11 +1121,9 @@ namespace xlang {
 			case '/' : {
 				peek = get_next_char();
 				if (peek == '=') {
-					col += 2;
 					return make_token("/=", ASSGN_DIV);
 				}
 				else {
-					col++;
 					unget_char();
 					return make_token("/", ARTHM_DIV);
 				}
@@ -1192,11 +1133,9 @@ namespace xlang {
 			case '%' : {
 				peek = get_next_char();
 				if (peek == '=') {
-					col += 2;
 					return make_token("%=", ASSGN_MOD);
 				}
 				else {
-					col++;
 					unget_char();
 					return make_token("%", ARTHM_MOD);
 				}
@@ -1206,15 +1145,12 @@ namespace xlang {
 			case '&' : {
 				peek = get_next_char();
 				if (peek == '=') {
-					col += 2;
 					return make_token("&=", ASSGN_BIT_AND);
 				}
 				if (peek == '&') {
-					col += 2;
 					return make_token("&&", LOG_AND);
 				}
 				else {
-					col++;
 					unget_char();
 					return make_token("&", BIT_AND);
 				}
@@ -1224,15 +1160,12 @@ namespace xlang {
 			case '|' : {
 				peek = get_next_char();
 				if (peek == '=') {
-					col += 2;
 					return make_token("|=", ASSGN_BIT_OR);
 				}
 				if (peek == '|') {
-					col += 2;
 					return make_token("||", LOG_OR);
 				}
 				else {
-					col++;
 					unget_char();
 					return make_token("|", BIT_OR);
 				}
@@ -1242,11 +1175,9 @@ namespace xlang {
 			case '!' : {
 				peek = get_next_char();
 				if (peek == '=') {
-					col += 2;
 					return make_token("!=", COMP_NOT_EQ);
 				}
 				else {
-					col++;
 					unget_char();
 					return make_token("!", LOG_NOT);
 				}
@@ -1254,7 +1185,6 @@ namespace xlang {
 				break;
 
 			case '~' : {
-				col++;
 				return make_token("~", BIT_COMPL);
 			}
 				break;
@@ -1262,23 +1192,19 @@ namespace xlang {
 			case '<' : {
 				peek = get_next_char();
 				if (peek == '=') {
-					col += 2;
 					return make_token("<=", COMP_LESS_EQ);
 				}
 				else if (peek == '<') {
 					peek = get_next_char();
 					if (peek == '=') {
-						col += 3;
 						return make_token("<<=", ASSGN_LSHIFT);
 					}
 					else {
-						col += 2;
 						unget_char();
 						return make_token("<<", BIT_LSHIFT);
 					}
 				}
 				else {
-					col++;
 					unget_char();
 					return make_token("<", COMP_LESS);
 				}
@@ -1288,23 +1214,19 @@ namespace xlang {
 			case '>' : {
 				peek = get_next_char();
 				if (peek == '=') {
-					col += 2;
 					return make_token(">=", COMP_GREAT_EQ);
 				}
 				else if (peek == '>') {
 					peek = get_next_char();
 					if (peek == '=') {
-						col += 3;
 						return make_token(">>=", ASSGN_RSHIFT);
 					}
 					else {
-						col += 2;
 						unget_char();
 						return make_token(">>", BIT_RSHIFT);
 					}
 				}
 				else {
-					col++;
 					unget_char();
 					return make_token(">", COMP_GREAT);
 				}
@@ -1314,11 +1236,9 @@ namespace xlang {
 			case '^' : {
 				peek = get_next_char();
 				if (peek == '=') {
-					col += 2;
 					return make_token("^=", ASSGN_BIT_EX_OR);
 				}
 				else {
-					col++;
 					unget_char();
 					return make_token("^", BIT_EXOR);
 				}
@@ -1328,11 +1248,9 @@ namespace xlang {
 			case '=' : {
 				peek = get_next_char();
 				if (peek == '=') {
-					col += 2;
 					return make_token("==", COMP_EQ);
 				}
 				else {
-					col++;
 					unget_char();
 					return make_token("=", ASSGN);
 				}
@@ -1351,42 +1269,50 @@ namespace xlang {
 		return tok;
 	}
 
-	void Lexer::print_processed_tokens() {
+	void Lexer::fill() {
 
-		std::stack<Token> temp;
-		Token tok;
+		// tokens are made while the parser asks for them,
+		// lexing time is only known by adding up the calls
 
-		while (!processed_tokens.empty()) {
-			temp.push(processed_tokens.front());
-			processed_tokens.pop();
+		Token &slot = ring[scanned & RING_MASK];
+		if (replaying) {
+			if (scanned < replay_count)
+				slot = replayed[scanned];
+			else if (replay_error.empty()) {
+				slot = Token();
+				slot.number = END;
+			}
+			else {
+				*Log::out << replay_error;
+				throw CompileError();
+			}
+			scanned++;
+			return;
 		}
-
-		while (!temp.empty()) {
-			tok = temp.top();
-			std::cout << "tok = " << tok.number << " lexeme = " << tok.string << std::endl;
-			processed_tokens.push(temp.top());
-			temp.pop();
+		if (stream)
+			slot = stream->get(scanned);
+		else if (stats != nullptr && stats->enabled) {
+			StatsScope scope(*stats, "lex");
+			slot = scan();
 		}
+		else
+			slot = scan();
+		if (names != nullptr && slot.number == IDENTIFIER)
+			slot.name = names->intern(slot.string);
+		scanned++;
 	}
 
-	Token Lexer::get_next() {
+	Token Lexer::scan() {
 
 		Token tok;
 		tok.number = END;
-		tok.loc.line = 0;
-		tok.loc.col = 0;
 
 		char ch;
 		if (this->is_lexing_done)
 			return tok;
 
-		if (!processed_tokens.empty()) {
-			tok = processed_tokens.front();
-			processed_tokens.pop();
-			return tok;
-		}
-
 		loop_label:
+		token_start = buffer_index;
 		switch (ch = get_next_char()) {
 			case '_':
 			case '$':
@@ -1401,13 +1327,16 @@ namespace xlang {
 			case '\'':
 				unget_char();
 				tok = literal();
+				decode(tok);
 				error_flag = false;
 				break;
 
 			case ' ':
-			case '\t':
-				col++;
+			case '\t': {
+				size_t run = Scan::spaces(text.data() + buffer_index, text.size() - buffer_index);
+				buffer_index += run;
 				goto loop_label;
+			}
 
 			case '+':
 			case '-':
@@ -1434,58 +1363,46 @@ namespace xlang {
 				break;
 
 			case '.':
-				col++;
 				tok = make_token(".", DOT_OP);
 				break;
 
 			case ',':
-				col++;
 				tok = make_token(",", COMMA_OP);
 				break;
 
 			case ':':
-				col++;
 				tok = make_token(":", COLON_OP);
 				break;
 
 			case '{':
-				col++;
 				tok = make_token("{", CURLY_OPEN);
 				break;
 
 			case '}':
-				col++;
 				tok = make_token("}", CURLY_CLOSE);
 				break;
 
 			case '(':
-				col++;
 				tok = make_token("(", PARENTH_OPEN);
 				break;
 
 			case ')':
-				col++;
 				tok = make_token(")", PARENTH_CLOSE);
 				break;
 
 			case '[':
-				col++;
 				tok = make_token("[", SQUARE_OPEN);
 				break;
 
 			case ']':
-				col++;
 				tok = make_token("]", SQUARE_CLOSE);
 				break;
 
 			case ';':
-				col++;
 				tok = make_token(";", SEMICOLON);
 				break;
 
 			case '\n':
-				line++;
-				col = 1;
 				goto loop_label;
 
 			default:
@@ -1499,39 +1416,4 @@ namespace xlang {
 		}
 		return tok;
 	}
-
-	void Lexer::put_back(Token &tok) {
-		processed_tokens.push(tok);
-	}
-
-	void Lexer::put_back(Token &tok, bool high_priority) {
-		Token tok2;
-		if (!processed_tokens.empty()) {
-			if (high_priority) {
-				tok2 = processed_tokens.front();
-				processed_tokens.pop();
-				processed_tokens.push(tok);
-				processed_tokens.push(tok2);
-			}
-			else
-				processed_tokens.push(tok);
-		}
-	}
-
-	void Lexer::reverse_tokens_queue() {
-
-		std::stack<Token> temp;
-		Token tok;
-
-		while (!processed_tokens.empty()) {
-			temp.push(processed_tokens.front());
-			processed_tokens.pop();
-		}
-
-		while (!temp.empty()) {
-			tok = temp.top();
-			processed_tokens.push(temp.top());
-			temp.pop();
-		}
-	}
 }
\ No newline at end of file
@@ -10,61 +10,180 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <unordered_map>
-#include <queue>
+#include <string_view>
+#include <array>
+#include <cassert>
 #include "file.hpp"
 #include "token.hpp"
+#include "stats.hpp"
+#include "scan.hpp"
+#include "stream.hpp"
+#include "intern.hpp"
 
 namespace xlang {
 	
 	class Lexer {
 	public:
 
-		Lexer(SourceFile src) : file(src) {};
-		
-		void init();
-		
-		Token get_next();
-		
-		void put_back(Token &);
+		// the file is the compiler's, its buffer is loaded by init()
+		explicit Lexer(SourceFile &src) : file(src) {};
+
+		// tokens peek() can see past the next one
+		static constexpr size_t LOOKAHEAD = 16;
+
+		Stats *stats{nullptr};
+
+		// identifiers get their ids here when it is set
+		Interner *names{nullptr};
 		
-		void put_back(Token &, bool);
+		// lexing starts at from, a token has to start there
+		void init(size_t from = 0);
+
+		// lex the file on a thread of its own, in pieces on up to jobs
+		// threads if it is large. get_next() and peek() then take the
+		// tokens made there. call it before reading any
+		void run_ahead(unsigned jobs);
+
+		// read count tokens lexed before instead of the file, from the
+		// first one again. error is printed and thrown when the parser
+		// gets past them, as it was when they were lexed
+		void replay(const Token *tokens, size_t count, std::string_view error = {});
+
+		// consume n tokens without making them. only while replaying,
+		// the ones skipped can't be rewound over
+		void skip(size_t n) {
+			assert(replaying);
+			next += n;
+			if (scanned < next)
+				scanned = next;
+		}
+		
+		// the next token, consumed
+		Token get_next() {
+			Token tok = peek(0);
+			next++;
+			return tok;
+		}
+
+		// the token k places ahead of the next one, without consuming
+		// anything. it stays valid until the lexer is used again
+		const Token &peek(size_t k = 0) {
+			assert(k < LOOKAHEAD);
+			while (scanned <= next + k)
+				fill();
+			return ring[(next + k) & RING_MASK];
+		}
+
+		// position of the next token, for rewind()
+		size_t mark() const {
+			return next;
+		}
+
+		// go back to a mark, the tokens after it are read again. at most
+		// HISTORY tokens can be gone back over
+		void rewind(size_t pos) {
+			assert(pos <= next && next - pos <= HISTORY);
+			next = pos;
+		}
+
+		// give back the last n tokens get_next() returned
+		void unget(size_t n = 1) {
+			rewind(next - n);
+		}
 		
 		std::string get_filename();
-		
-		void print_processed_tokens();
-		
-		void reverse_tokens_queue();
+
+		// token of a keyword, IDENTIFIER for anything else. the length and
+		// first character leave at most one keyword to compare with
+		static constexpr TokenId keyword(std::string_view str) {
+			auto is = [&str](std::string_view key, TokenId id) -> TokenId {
+				return str == key ? id : IDENTIFIER;
+			};
+			switch (str.size()) {
+				case 2:
+					switch (str[0]) {
+						case 'd': return is("do", KEY_DO);
+						case 'i': return is("if", KEY_IF);
+					}
+					break;
+				case 3:
+					switch (str[0]) {
+						case 'a': return is("asm", KEY_ASM);
+						case 'f': return is("for", KEY_FOR);
+						case 'i': return is("int", KEY_INT);
+					}
+					break;
+				case 4:
+					switch (str[0]) {
+						case 'c': return is("char", KEY_CHAR);
+						case 'e': return is("else", KEY_ELSE);
+						case 'g': return is("goto", KEY_GOTO);
+						case 'l': return is("long", KEY_LONG);
+						case 'v': return is("void", KEY_VOID);
+					}
+					break;
+				case 5:
+					switch (str[0]) {
+						case 'b': return is("break", KEY_BREAK);
+						case 'c': return is("const", KEY_CONST);
+						case 'f': return is("float", KEY_FLOAT);
+						case 's': return is("short", KEY_SHORT);
+						case 'w': return is("while", KEY_WHILE);
+					}
+					break;
+				case 6:
+					switch (str[0]) {
+						case 'd': return is("double", KEY_DOUBLE);
+						case 'e': return is("extern", KEY_EXTERN);
+						case 'g': return is("global", KEY_GLOBAL);
+						case 'r': return str[2] == 'c' ? is("record", KEY_RECORD) : is("return", KEY_RETURN);
+						case 's': return str[1] == 'i' ? is("sizeof", KEY_SIZEOF) : is("static", KEY_STATIC);
+					}
+					break;
+				case 8:
+					return is("continue", KEY_CONTINUE);
+			}
+			return IDENTIFIER;
+		}
 		
     private:
+
+		friend class TokenStream;
 		
-		SourceFile file;
-		std::unordered_map<std::string, TokenId> key_tokens;
-		std::queue<Token> processed_tokens;
+		SourceFile &file;
+		std::unique_ptr<TokenStream> stream;
+
+		// tokens are kept in a ring, LOOKAHEAD of them can be peeked at and
+		// HISTORY of the ones already read can be rewound over
+		static constexpr size_t RING_SIZE = 64;
+		static constexpr size_t RING_MASK = RING_SIZE - 1;
+		static constexpr size_t HISTORY = RING_SIZE - LOOKAHEAD;
+		std::array<Token, RING_SIZE> ring;
+		size_t next = 0;     // tokens read, the index of the next one
+		size_t scanned = 0;  // tokens in the ring so far
 
-		std::vector<char> symbols = {
-            ' ', '\t', '\n', '!', '%', '^', '~', '&', 
-            '*', '(', ')', '-', '+', '=', '[', ']', '{', 
-            '}', '|', ':', ';', '<', '>', ',', '.', '/', 
-            '\\', '\'', '"', '@', '`', '?'
-        };
+		// replaying, tokens may be nullptr when there are none
+		bool replaying{false};
+		const Token *replayed{nullptr};
+		size_t replay_count{0};
+		std::string_view replay_error;
 
+		std::string_view text;
 		std::string lexeme;
 		size_t buffer_index = 0;
-		unsigned line = 1;
-        unsigned col = 1;
+		size_t token_start = 0;
 
 		bool unget_flag = false;
 		bool is_lexing_done = false;
 		bool eof_flag = false;
 		bool error_flag = false;
 		
+		void fill();
+
+		Token scan();
+
 		bool is_eof(char);
 		
-		bool file_read(SourceFile &src);
-		
-		bool file_exists(const std::string &path);
-		
 		char get_next_char();
 		
 		void unget_char();
@@ -77,7 +196,12 @@ namespace xlang {
 		
 		Token make_token(TokenId);
 		
-		Token make_token(std::string, TokenId);
+		Token make_token(std::string_view, TokenId);
+		
+		std::string_view view(const std::string &);
+
+		// where the token being lexed starts, for errors
+		SourcePosition position();
 		
 		Token operator_token();
 		
@@ -98,10 +222,12 @@ namespace xlang {
 		void sub_identifier();
 		
 		Token literal();
+
+		static void decode(Token &);
 		
 		Token integer_literal();
 		
-		Token float_literal();
+		Token float_literal(const std::string &integer);
 		
 		Token character_literal();
 		
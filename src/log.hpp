@@ -9,8 +9,8 @@
 #include <cstdarg>
 #include <iostream>
 #include <vector>
-#include "compiler.hpp"
 #include "token.hpp"
+#include "source.hpp"
 
 namespace xlang {
 	
@@ -19,52 +19,67 @@ namespace xlang {
 	#define    LOG_VERBOSE  2
 	#define    LOG_ANNOYING 3
 	
+	// thrown by Log::error so a failing compilation unwinds to its own
+	// Compiler::run() instead of taking the whole process down
+
+	struct CompileError {};
+	
 	class Log {
 	public:
 		
+		// each thread logs into the output of the compilation it is running,
+		// the driver prints those back in input order
+		static inline thread_local std::ostream *out = &std::cout;
+		static inline thread_local int level = LOG_MINIMAL;
+
+		// the file error_at() finds lines and columns in, the lexer sets
+		// it when it loads one
+		static inline thread_local const SourceBuffer *source = nullptr;
+		
 		template<typename ...Args>
 		static void error(Args &&...args) {
-			(std::cout << ... << args);
-			std::cout << '\n';
-			exit(-1);
+			(*out << ... << args);
+			*out << '\n';
+			throw CompileError();
 		}
 		
 		template<typename ...Args>
 		static void error_at(TokenLocation loc, Args &&...args) {
 			//std::cout << cfg.file.name << ": [" << loc.line << ":" << loc.col << "] ";
 			// TODO: log file path and name here, absolute if possible
-			std::cout << "[" << loc.line << ":" << loc.col << "] ";
-			(std::cout << ... << args);
-            std::cout << "\n";
-			exit(-1);
+			SourcePosition pos = source != nullptr ? source->position(loc) : SourcePosition();
+			*out << "[" << pos.line << ":" << pos.col << "] ";
+			(*out << ... << args);
+            *out << "\n";
+			throw CompileError();
 		}
 		
 		template<typename ...Args>
 		static void info(Args &&...args) {
-			if (Compiler::global.log_level != LOG_DISABLE) {
-				(std::cout << ... << args);
+			if (level != LOG_DISABLE) {
+				(*out << ... << args);
 			}
 		}
 		
 		template<typename ...Args>
 		static void warn(Args &&...args) {
-			if (Compiler::global.log_level != LOG_DISABLE) {
-				(std::cout << ... << args);
+			if (level != LOG_DISABLE) {
+				(*out << ... << args);
 			}
 		}
 		
 		template<typename ...Args>
 		static void debug(Args &&...args) {
-			if (Compiler::global.log_level != LOG_DISABLE) {
-				(std::cout << ... << args);
+			if (level != LOG_DISABLE) {
+				(*out << ... << args);
 			}
 		}
 		
 		template<typename ...Args>
 		static void line(Args &&...args) {
-			if (Compiler::global.log_level != LOG_DISABLE) {
-				(std::cout << ... << args);
-				std::cout << '\n';
+			if (level != LOG_DISABLE) {
+				(*out << ... << args);
+				*out << '\n';
 			}
 		}
 		
@@ -76,7 +91,7 @@ namespace xlang {
 		
 		static void print_lines(std::vector<std::string> lines) {
 			for (const auto &l: lines) {
-				std::cout << l << "\n";
+				*out << l << "\n";
 			}
 		}
 	};
@@ -6,23 +6,28 @@
  */
 
 #include <iostream>
+#include <sstream>
 #include <filesystem>
+#include <thread>
+#include <future>
+#include <atomic>
+#include <algorithm>
+#include <fstream>
 #include "compiler.hpp"
+#include "cache.hpp"
+#include "server.hpp"
 #include "log.hpp"
 
 using namespace xlang;
 
-const std::string VERSION = "0.0.1";
-
 static void Version() {
 	Log::line("xlang ", VERSION);
-	exit(0);
 }
 
 static void Help() {
 	
 	std::vector<std::string> lines = {
-			"  usage: ./xlang [options] <file>",
+			"  usage: ./xlang [options] <file>...",
 			"    -h  or --help (this message)",
 			"    -t  or --print-tree (print symbol table)",
 			"    -r  or --print-record-symtab (print record symnol table)",
@@ -34,17 +39,45 @@ static void Help() {
 			"    -no-stdlib (don't incude stdsib)",
 			"    -no-frameptr (omits frame pointer)",
 			"    -m32 (only applies for x86_64 hosts to output 32 bit code)",
+			"    -j N (compile up to N files at the same time)",
+			"    --use-nasm (assemble with nasm instead of the built-in encoder)",
+			"    --lex-thread (lex on a thread of its own while parsing)",
+			"    --lex-jobs N (lex large files in pieces on up to N threads)",
+			"    --parse-jobs N (parse function bodies on up to N threads)",
+			"    --stream (compile one function at a time to keep memory down, keeps unused globals)",
+			"    --emit-ast (write the analyzed tree to <file>.ast)",
+			"    --load-ast (start from <file>.ast if it was written for the same source)",
+			"    --cache-dir DIR (reuse output of unchanged files from DIR)",
+			"    --verbose (print more about what is done)",
+			"    --time-passes (print wall and cpu time of each compiler pass)",
+			"    --mem-stats (print allocations and peak heap growth of each compiler pass)",
+			"    --stats-json FILE (write time and memory of each pass as JSON)",
+			"    --trace FILE (write a chrome trace of passes, functions and tools run)",
+			"    --server SOCKET (stay running and compile requests sent to SOCKET)",
+			"    --connect SOCKET (send this command to a server, compile here if there is none)",
 			"    -v  or --version (show version)"
 	};
 	
 	Log::print_lines(lines);
-	exit(0);
 }
 
-static void process_args(GlobalConfig &global, int argc, char **argv) {
+// value of an option given as "--opt VALUE" or "--opt=VALUE"
+static std::string option_value(const std::vector<std::string> &args, size_t &i, size_t len) {
+	std::string value = args[i].substr(len);
+	if (value.empty() && i + 1 < args.size())
+		value = args[++i];
+	else if (!value.empty() && value[0] == '=')
+		value = value.substr(1);
+	return value;
+}
+
+// 1 to compile, 0 if there is nothing to compile (--help, --version),
+// -1 for a bad argument
+static int process_args(GlobalConfig &global, std::vector<SourceFile> &files, unsigned &jobs,
+						 const std::vector<std::string> &args) {
 	
-	for (int i = 1; i < argc; ++i) {
-		std::string str = argv[i];
+	for (size_t i = 0; i < args.size(); ++i) {
+		const std::string &str = args[i];
 		if (str == "--print-tree" || str == "-t") 
 			global.print_tree = true;
 		else if (str == "--print-symtab" || str == "-s") 
@@ -67,39 +100,224 @@ static void process_args(GlobalConfig &global, int argc, char **argv) {
 			global.remove_asmfile = false;
 		else if (str == "ok" || str == "--keep-obj-file") 
 			global.remove_objfile = false;
-		else if (str == "-v" || str == "--version") 
+		else if (str == "--use-nasm") 
+			global.use_nasm = true;
+		else if (str == "--lex-thread") 
+			global.lex_threads = std::max(1u, global.lex_threads);
+		else if (str.rfind("--lex-jobs", 0) == 0) 
+			global.lex_threads = std::max(1, atoi(option_value(args, i, 10).c_str()));
+		else if (str.rfind("--parse-jobs", 0) == 0) 
+			global.parse_threads = std::max(1, atoi(option_value(args, i, 12).c_str()));
+		else if (str == "--stream") 
+			global.stream = true;
+		else if (str == "--emit-ast") 
+			global.emit_ast = true;
+		else if (str == "--load-ast") 
+			global.load_ast = true;
+		else if (str == "--verbose") 
+			global.log_level = LOG_VERBOSE;
+		else if (str == "--time-passes") 
+			global.time_passes = true;
+		else if (str == "--mem-stats") 
+			global.mem_stats = true;
+		else if (str.rfind("--stats-json", 0) == 0) 
+			global.stats_file = option_value(args, i, 12);
+		else if (str.rfind("--trace", 0) == 0) 
+			global.trace_file = option_value(args, i, 7);
+		else if (str.rfind("--cache-dir", 0) == 0) {
+			std::string dir = option_value(args, i, 11);
+			if (dir.empty()) {
+				Log::line("--cache-dir needs a directory");
+				return -1;
+			}
+			std::error_code ec;
+			global.cache_dir = std::filesystem::absolute(dir, ec);
+			if (ec) {
+				Log::line("bad --cache-dir ", dir, ": ", ec.message());
+				return -1;
+			}
+		}
+		else if (str == "-v" || str == "--version") {
 			Version();
+			return 0;
+		}
 		else if (str == "-m32") {
             global.x64 = false;
 			// TODO
 		}
-		else if (str == "-h" || str == "--help") 
+		else if (str == "-h" || str == "--help") {
 			Help();
+			return 0;
+		}
+		else if (str.rfind("-j", 0) == 0) {
+			std::string n = str.substr(2);
+			if (n.empty() && i + 1 < args.size())
+				n = args[++i];
+			jobs = std::max(1, atoi(n.c_str()));
+		}
 		else {
+			SourceFile file;
 			std::filesystem::path path(str);
-			global.file.name = path.filename();
-			global.file.path = absolute(path);
+			file.id = files.size();
+			file.name = path.filename();
+			file.path = absolute(path);
 			
 			if (path.has_extension())
-				global.file.extension = path.extension();
+				file.extension = path.extension();
+			files.push_back(file);
 		}
 	}
+	return 1;
 }
 
-GlobalConfig Compiler::global;
+struct FileReport {
+	std::string stats;
+	std::string trace;
+};
 
-int main(int argc, char **argv) {
+static int compile_file(const GlobalConfig &global, const SourceFile &file, std::ostream &out, FileReport &report) {
+	GlobalConfig cfg = global;
+	cfg.file = file;
+	Compiler comp(cfg);
+	int status = comp.run(out);
+	if (!global.stats_file.empty())
+		report.stats = comp.stats.json(file.name, status);
+	if (!global.trace_file.empty()) {
+		std::ostringstream trace;
+		comp.trace.write_events(trace, file.id + 1, file.name);
+		report.trace = trace.str();
+	}
+	return status;
+}
+
+static void write_stats(const GlobalConfig &global, const std::vector<FileReport> &reports) {
+	std::ofstream outfile(global.stats_file, std::ios::out);
+	if (!outfile.is_open()) {
+		Log::line("can't write ", global.stats_file);
+		return;
+	}
+	outfile << "{\"version\": " << json_string(VERSION) << ", \"files\": [";
+	for (size_t i = 0; i < reports.size(); i++)
+		outfile << (i > 0 ? ",\n  " : "\n  ") << reports[i].stats;
+	outfile << "\n]}\n";
+}
+
+static void write_trace(const GlobalConfig &global, const std::vector<FileReport> &reports) {
+	std::ofstream outfile(global.trace_file, std::ios::out);
+	if (!outfile.is_open()) {
+		Log::line("can't write ", global.trace_file);
+		return;
+	}
+	outfile << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+	for (size_t i = 0; i < reports.size(); i++)
+		outfile << (i > 0 ? ",\n  " : "\n  ") << reports[i].trace;
+	outfile << "\n]}\n";
+}
+
+static int build(const GlobalConfig &global, const std::vector<SourceFile> &files, unsigned jobs, std::ostream &out) {
 	
-	if (argc < 2) {
-		Log::error("No input file provided");
-		Help();
-		return 0;
+	// every file gets its own Compiler, the output of each one is printed
+	// in input order and the first failure decides the exit status, so
+	// the result is the same no matter how many jobs run
+
+	std::vector<int> status(files.size(), 0);
+	std::vector<FileReport> reports(files.size());
+	
+	if (jobs <= 1 || files.size() == 1) {
+		for (size_t i = 0; i < files.size(); i++)
+			status[i] = compile_file(global, files[i], out, reports[i]);
+	}
+	else {
+		std::vector<std::string> outputs(files.size());
+		std::vector<std::promise<void>> done(files.size());
+		std::vector<std::future<void>> ready;
+		std::atomic<size_t> next{0};
+		
+		for (auto &d: done)
+			ready.push_back(d.get_future());
+		
+		auto worker = [&]() {
+			size_t i;
+			while ((i = next++) < files.size()) {
+				std::ostringstream file_out;
+				status[i] = compile_file(global, files[i], file_out, reports[i]);
+				outputs[i] = file_out.str();
+				done[i].set_value();
+			}
+		};
+		
+		std::vector<std::thread> pool;
+		for (size_t j = 0; j < std::min<size_t>(jobs, files.size()); j++)
+			pool.emplace_back(worker);
+		
+		for (size_t i = 0; i < files.size(); i++) {
+			ready[i].wait();
+			out << outputs[i] << std::flush;
+		}
+		
+		for (auto &t: pool)
+			t.join();
 	}
 	
-	process_args(Compiler::global, argc, argv);
-	if (Compiler::global.file.name.empty())
-		Log::error("No files provided");
+	if (!global.stats_file.empty())
+		write_stats(global, reports);
+
+	if (!global.trace_file.empty())
+		write_trace(global, reports);
 
-	Compiler comp;
-	return comp.run();
-}
\ No newline at end of file
+	if (!global.cache_dir.empty() && global.log_level >= LOG_VERBOSE)
+		Cache::print_stats();
+
+	for (int s: status) {
+		if (s != 0)
+			return s;
+	}
+	return 0;
+}
+
+// one command line, run either directly or by the server for a client
+static int run_command(const std::vector<std::string> &args, std::ostream &out) {
+
+	if (args.empty()) {
+		Log::line("No input file provided");
+		return -1;
+	}
+	
+	GlobalConfig global;
+	std::vector<SourceFile> files;
+	unsigned jobs = 1;
+	
+	int status = process_args(global, files, jobs, args);
+	if (status <= 0)
+		return status;
+	if (files.empty()) {
+		Log::line("No files provided");
+		return -1;
+	}
+
+	return build(global, files, jobs, out);
+}
+
+int main(int argc, char **argv) {
+	
+	std::vector<std::string> args(argv + 1, argv + argc);
+
+	if (!args.empty() && args[0].rfind("--server", 0) == 0) {
+		size_t i = 0;
+		return Server::serve(option_value(args, i, 8), run_command);
+	}
+
+	if (!args.empty() && args[0].rfind("--connect", 0) == 0) {
+		size_t i = 0;
+		std::string socket = option_value(args, i, 9);
+		args.erase(args.begin(), args.begin() + i + 1);
+
+		// without a server the command is compiled here, so
+		// build scripts work whether one is running or not
+		int status;
+		if (Server::connect(socket, args, status))
+			return status;
+	}
+
+	return run_command(args, std::cout);
+}
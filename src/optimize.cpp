@@ -21,66 +21,99 @@
 namespace xlang {
 	
 
-	bool Optimizer::evaluate(Token &f1, Token &f2, Token &op, std::string &stresult, bool has_float) {
+	// a literal made by the optimizer, it has no text until codegen
+	// writes it out
+	static Token made_literal(TokenId number, TokenLocation loc, LiteralValue value, uint8_t width) {
+		Token tok;
+		tok.number = number;
+		tok.width = width;
+		tok.loc = loc;
+		tok.value = value;
+		return tok;
+	}
+
+	bool Optimizer::evaluate(const Token &f1, const Token &f2, const Token &op, LiteralValue &result, uint8_t &width, bool has_float) {
 	    
-        // evaluate an expression with two factors(f1,f2) and operator op
-	    // evaluation result is always a double, depends on has_float parameter
+        // evaluate an expression with two factors(f1,f2) and operator op.
+	    // with has_float both are doubles, otherwise integers that wrap
+	    // around like 32 bit code would unless a literal needs 64 bits
 
-		double d1 = 0.0; 
-        double d2 = 0.0; 
-        double result = 0.0;
-		bool bres = false;
-		
 		if (has_float) {
-			d1 = std::stod(f1.string);
-			d2 = std::stod(f2.string);
-		} else {
-			d1 = static_cast<double>(Convert::tok_to_decimal(f1));
-			d2 = static_cast<double>(Convert::tok_to_decimal(f2));
+			double d1 = f1.number == LIT_FLOAT ? f1.value.f : static_cast<double>(f1.value.i);
+			double d2 = f2.number == LIT_FLOAT ? f2.value.f : static_cast<double>(f2.value.i);
+			switch (op.number) {
+				case ARTHM_ADD :
+					result.f = d1 + d2;
+					break;
+				case ARTHM_SUB :
+					result.f = d1 - d2;
+					break;
+				case ARTHM_MUL :
+					result.f = d1 * d2;
+					break;
+				case ARTHM_DIV :
+					if (d2 == 0) {
+						Log::error("divide by zero found in optimization");
+						return false;
+					}
+					result.f = d1 / d2;
+					break;
+				case ARTHM_MOD :
+					if (static_cast<int>(d2) == 0) {
+						Log::error("divide by zero found in optimization");
+						return false;
+					}
+					result.f = static_cast<int>(d1) % static_cast<int>(d2);
+					break;
+				default:
+					Log::error("invalid operator found in optimization '" + std::string(op.string) + "'");
+					return false;
+			}
+			width = 8;
+			return true;
 		}
 
+		// unsigned so overflow wraps instead of being undefined
+		uint64_t u1 = static_cast<uint64_t>(f1.value.i);
+		uint64_t u2 = static_cast<uint64_t>(f2.value.i);
+		int64_t i1 = f1.value.i;
+		int64_t i2 = f2.value.i;
+		int64_t value = 0;
 		switch (op.number) {
 			case ARTHM_ADD :
-				result = d1 + d2;
-				bres = true;
+				value = static_cast<int64_t>(u1 + u2);
 				break;
-
 			case ARTHM_SUB :
-				result = d1 - d2;
-				bres = true;
+				value = static_cast<int64_t>(u1 - u2);
 				break;
-
 			case ARTHM_MUL :
-				result = d1 * d2;
-				bres = true;
+				value = static_cast<int64_t>(u1 * u2);
 				break;
-
 			case ARTHM_DIV :
-				if (d2 == 0) {
+			case ARTHM_MOD :
+				if (i2 == 0) {
 					Log::error("divide by zero found in optimization");
-					bres = false;
-				} else {
-					result = d1 / d2;
-					bres = true;
+					return false;
 				}
+				if (i2 == -1)
+					value = op.number == ARTHM_DIV ? static_cast<int64_t>(0 - u1) : 0;
+				else
+					value = op.number == ARTHM_DIV ? i1 / i2 : i1 % i2;
 				break;
-
-			case ARTHM_MOD :
-				result = static_cast<int>(d1) % static_cast<int>(d2);
-				bres = true;
-				break;
-
 			default:
-				Log::error("invalid operator found in optimization '" + op.string + "'");
-				bres = false;
-				break;
+				Log::error("invalid operator found in optimization '" + std::string(op.string) + "'");
+				return false;
 		}
-		
-		stresult = std::to_string(result);
-		if (bres)
-			return true;
-		else
-			return false;
+
+		if (f1.width <= 4 && f2.width <= 4) {
+			result.i = static_cast<int32_t>(value);
+			width = 4;
+		}
+		else {
+			result.i = value;
+			width = value >= INT32_MIN && value <= UINT32_MAX ? 4 : 8;
+		}
+		return true;
 	}
 	
 	void Optimizer::clear_primary_expr_stack() {
@@ -101,18 +134,18 @@ namespace xlang {
 				if (type.number == KEY_FLOAT || type.number == KEY_DOUBLE) {
 					return true;
 				} else {
-					return (has_float_type(pexpr->left) || has_float_type(pexpr->right));
+					return (has_float_type(Tree::primary_expr(pexpr->left)) || has_float_type(Tree::primary_expr(pexpr->right)));
 				}
 			} else {
-				return (has_float_type(pexpr->left) || has_float_type(pexpr->right));
+				return (has_float_type(Tree::primary_expr(pexpr->left)) || has_float_type(Tree::primary_expr(pexpr->right)));
 			}
 		} else if (pexpr->is_oprtr) {
-			return (has_float_type(pexpr->left) || has_float_type(pexpr->right));
+			return (has_float_type(Tree::primary_expr(pexpr->left)) || has_float_type(Tree::primary_expr(pexpr->right)));
 		} else {
 			if (pexpr->tok.number == LIT_FLOAT) {
 				return true;
 			} else {
-				return (has_float_type(pexpr->left) || has_float_type(pexpr->right));
+				return (has_float_type(Tree::primary_expr(pexpr->left)) || has_float_type(Tree::primary_expr(pexpr->right)));
 			}
 		}
 		return false;
@@ -128,59 +161,58 @@ namespace xlang {
 		if (pexpr->is_id) 
 			return true;
 		else if (pexpr->is_oprtr) 
-			return (has_id(pexpr->left) || has_id(pexpr->right));
+			return (has_id(Tree::primary_expr(pexpr->left)) || has_id(Tree::primary_expr(pexpr->right)));
 		else 
-			return (has_id(pexpr->left) || has_id(pexpr->right));
+			return (has_id(Tree::primary_expr(pexpr->left)) || has_id(Tree::primary_expr(pexpr->right)));
 		
 		return false;
 	}
 	
-	void Optimizer::get_inorder_primary_expr(PrimaryExpression **pexpr) {
-		PrimaryExpression *pexp = *pexpr;
+	void Optimizer::get_inorder_primary_expr(PrimaryExpression *pexp) {
 		if (pexp == nullptr)
 			return;
 		
 		pexpr_stack.push(pexp);
-		get_inorder_primary_expr(&pexp->left);
-		get_inorder_primary_expr(&pexp->right);
+		get_inorder_primary_expr(Tree::primary_expr(pexp->left));
+		get_inorder_primary_expr(Tree::primary_expr(pexp->right));
 	}
 	
-	void Optimizer::id_constant_folding(PrimaryExpression **pexpr) {
+	void Optimizer::id_constant_folding(NodeIndex *pexpr) {
 
         // traverse primary Expression tree for constant expressions,
         // if found any then fold it
 
-		if (*pexpr == nullptr)
+		if (*pexpr == NO_NODE)
 			return;
 
-		if (!has_id(*pexpr)) 
-			constant_folding(&(*pexpr));
+		if (!has_id(Tree::primary_expr(*pexpr))) 
+			constant_folding(pexpr);
 
-		id_constant_folding(&((*pexpr)->left));
-		id_constant_folding(&((*pexpr)->right));
+		id_constant_folding(&Tree::primary_expr(*pexpr)->left);
+		id_constant_folding(&Tree::primary_expr(*pexpr)->right);
 	}
 	
-	void Optimizer::constant_folding(PrimaryExpression **pexpr) {
+	void Optimizer::constant_folding(NodeIndex *pexpr) {
 	    
         // constant folding optimization on primary expression
 
-		PrimaryExpression *pexp = *pexpr;
+		PrimaryExpression *pexp = Tree::primary_expr(*pexpr);
 		Token fact1, fact2, opr, restok;
 		PrimaryExpression *temp = nullptr;
-		std::string stresult;
-		int result = 0;
+		LiteralValue result;
+		uint8_t width = 0;
 		std::stack<Token> pexp_eval;
 		bool has_float = has_float_type(pexp);
 		if (pexp == nullptr)
 			return;
 		
 		if (has_id(pexp)) {
-			id_constant_folding(&(*pexpr));
+			id_constant_folding(pexpr);
 			return;
 		}
 		
 		// get inorder primary Expression into pexpr_stack
-		get_inorder_primary_expr(&pexp);
+		get_inorder_primary_expr(pexp);
 		
 		while (!pexpr_stack.empty()) {
 			temp = pexpr_stack.top();
@@ -192,22 +224,11 @@ namespace xlang {
 					fact2 = pexp_eval.top();
 					pexp_eval.pop();
 					
-					if (evaluate(fact1, fact2, opr, stresult, has_float)) {
-						restok.loc = opr.loc;
-						if (has_float) {
-							restok.number = LIT_FLOAT;
-							restok.string = stresult;
-						} else {
-							result = std::stoi(stresult);
-							if (result < 0) {
-								stresult = Convert::dec_to_hex(result);
-								restok.number = LIT_HEX;
-								restok.string = "0x" + stresult;
-							} else {
-								restok.number = LIT_DECIMAL;
-								restok.string = std::to_string(result);
-							}
-						}
+					if (evaluate(fact1, fact2, opr, result, width, has_float)) {
+						if (has_float)
+							restok = made_literal(LIT_FLOAT, opr.loc, result, width);
+						else
+							restok = made_literal(result.i < 0 ? LIT_HEX : LIT_DECIMAL, opr.loc, result, width);
 						pexp_eval.push(restok);
 					}
 				}
@@ -218,17 +239,16 @@ namespace xlang {
 			pexpr_stack.pop();
 		}
 		
-		// delete whole sub-expression tree 
-        // and add new node with evaluated result
+		// replace the whole sub-expression tree with a node of the
+		// evaluated result, the old nodes stay in the pool
 
 		if (pexp_eval.size() > 0) {
 			restok = pexp_eval.top();
-			Tree::delete_primary_expr(&(*pexpr));
-			*pexpr = nullptr;
 			*pexpr = Tree::get_primary_expr_mem();
-			(*pexpr)->is_id = false;
-			(*pexpr)->is_oprtr = false;
-			(*pexpr)->tok = restok;
+			PrimaryExpression *folded = Tree::primary_expr(*pexpr);
+			folded->is_id = false;
+			folded->is_oprtr = false;
+			folded->tok = restok;
 			pexp_eval.pop();
 		}
 		
@@ -244,7 +264,7 @@ namespace xlang {
 		if (st1.size() != st2.size())
 			return false;
 		while (!st1.empty()) {
-			if (st1.top()->tok.string == st2.top()->tok.string)
+			if (Convert::tok_to_string(st1.top()->tok) == Convert::tok_to_string(st2.top()->tok))
 				result &= 1;
 			else
 				result &= 0;
@@ -263,60 +283,59 @@ namespace xlang {
 			return false;
 	}
 	
-	PrimaryExpression *Optimizer::get_cmnexpr1_node(PrimaryExpression **root, PrimaryExpression **cmn1) {
+	NodeIndex Optimizer::get_cmnexpr1_node(PrimaryExpression *root, PrimaryExpression **cmn1) {
 
         // search cmn1 Expression node in primary Expression tree
-        // if found then return its address from tree
+        // if found then return its index from tree
 
-		if (*root == nullptr)
-			return nullptr;
+		if (root == nullptr)
+			return NO_NODE;
 
-		if ((*root)->left != nullptr) {
-			if ((*root)->left == *cmn1) 
-				return (*root)->left;
+		if (root->left != NO_NODE) {
+			PrimaryExpression *left = Tree::primary_expr(root->left);
+			if (left == *cmn1) 
+				return root->left;
 			else {
-				get_cmnexpr1_node(&(*root)->left, &(*cmn1));
-				get_cmnexpr1_node(&(*root)->left->right, &(*cmn1));
+				get_cmnexpr1_node(left, &(*cmn1));
+				get_cmnexpr1_node(Tree::primary_expr(left->right), &(*cmn1));
 			}
 		}
 
-		return nullptr;
+		return NO_NODE;
 	}
 
-	void Optimizer::change_subexpr_pointers(PrimaryExpression **root, PrimaryExpression **cmn1, PrimaryExpression **cmn2) {
+	void Optimizer::change_subexpr_pointers(PrimaryExpression *root, PrimaryExpression **cmn1, PrimaryExpression **cmn2) {
 	
         // cmn1 is common subexpression from right side of a tree
         // cmn2 is common subexpression from left side of a tree
         //
         // traverse primary Expression tree, search for common expression
-        // in tree by calling get_cmnexpr1_node(), delete its right subtree,
+        // in tree by calling get_cmnexpr1_node(), drop its right subtree,
         // and set its right side pointer to received common subexpr node
         // by function get_cmnexpr1_node()
         
-		PrimaryExpression *node1 = nullptr;
-		if (*root == nullptr)
+		NodeIndex node1 = NO_NODE;
+		if (root == nullptr)
 			return;
-		if ((*root)->right != nullptr) {
-			node1 = get_cmnexpr1_node(&(*root), &(*cmn2));
-			if ((*root)->right == *cmn1) {
-				Tree::delete_primary_expr(&(*root)->right);
-				(*root)->right = node1;
+		if (root->right != NO_NODE) {
+			node1 = get_cmnexpr1_node(root, &(*cmn2));
+			if (Tree::primary_expr(root->right) == *cmn1) {
+				root->right = node1;
 				return;
 			} else {
-				change_subexpr_pointers(&(*root)->left, &(*cmn1), &(*cmn2));
-				change_subexpr_pointers(&(*root)->right, &(*cmn1), &(*cmn2));
+				change_subexpr_pointers(Tree::primary_expr(root->left), &(*cmn1), &(*cmn2));
+				change_subexpr_pointers(Tree::primary_expr(root->right), &(*cmn1), &(*cmn2));
 			}
 		}
 	}
 	
-	void Optimizer::common_subexpression_elimination(PrimaryExpression **pexpr) {
+	void Optimizer::common_subexpression_elimination(PrimaryExpression *pexp) {
  
         // common subexpression elimination optimization
         // traverse tree, putting each node on stack, and then stack are compared
         // it can only optimize simple two factors expression(e.g: (a+b)*(a+b)
         // more than this are not handled yet(change in loop).
         
-		PrimaryExpression *pexp = *pexpr;
 		PrimaryExpression *cmnexpr1 = nullptr;
 		PrimaryExpression *cmnexpr2 = nullptr;
 		PrimaryExpression *temp = nullptr;
@@ -326,7 +345,7 @@ namespace xlang {
 		if (pexp == nullptr)
 			return;
 		
-		get_inorder_primary_expr(&pexp);
+		get_inorder_primary_expr(pexp);
 		
 		while (!pexpr_stack.empty()) {
 			temp = pexpr_stack.top();
@@ -364,7 +383,7 @@ namespace xlang {
 		clear_primary_expr_stack();
 		
 		if (cmnexpr1 != nullptr && cmnexpr2 != nullptr)
-			change_subexpr_pointers(&(*pexpr), &cmnexpr1, &cmnexpr2);
+			change_subexpr_pointers(pexp, &cmnexpr1, &cmnexpr2);
 	}
 	
 	bool Optimizer::is_powerof_2(int n, int *iter) {
@@ -384,14 +403,13 @@ namespace xlang {
 		return false;
 	}
 	
-	void Optimizer::strength_reduction(PrimaryExpression **pexpr) {
+	void Optimizer::strength_reduction(PrimaryExpression *root) {
 
         // strength reduction optimization
         // converting multiplication by 2^n left-shift operator(<<)
         // division by 2^n right-shift operator(>>)
         // modulus by (2^n)-1 bitwise-and operator(&)
 
-		PrimaryExpression *root = *pexpr;
         PrimaryExpression *left = nullptr;
         PrimaryExpression *right = nullptr;
 
@@ -401,15 +419,15 @@ namespace xlang {
 		if (root == nullptr)
 			return;
 
-        if (root->left == nullptr && root->right == nullptr) 
+        if (root->left == NO_NODE && root->right == NO_NODE) 
             return;
 
-        left = root->left;
-        right = root->right;
+        left = Tree::primary_expr(root->left);
+        right = Tree::primary_expr(root->right);
 
         if (!root->is_oprtr || (left->is_oprtr && right->is_oprtr)) {
-            strength_reduction(&root->left);
-            strength_reduction(&root->right);
+            strength_reduction(left);
+            strength_reduction(right);
             return;
         }
 
@@ -419,23 +437,20 @@ namespace xlang {
                 switch (root->tok.number) {
                     case ARTHM_MUL :
                         if (is_powerof_2(decm, &iter)) {
-                            root->tok.string = BIT_LSHIFT;
                             root->tok.string = "<<";
-                            right->tok.string = std::to_string(iter);
+                            right->tok = made_literal(LIT_DECIMAL, right->tok.loc, {iter}, 4);
                         }
                         break;
                     case ARTHM_DIV :
                         if (is_powerof_2(decm, &iter)) {
-                            root->tok.string = BIT_RSHIFT;
                             root->tok.string = ">>";
-                            right->tok.string = std::to_string(iter);
+                            right->tok = made_literal(LIT_DECIMAL, right->tok.loc, {iter}, 4);
                         }
                         break;
                     case ARTHM_MOD :
                         if (is_powerof_2(decm, &iter)) {
-                            root->tok.string = BIT_AND;
                             root->tok.string = "&";
-                            right->tok.string = std::to_string(decm - 1);
+                            right->tok = made_literal(LIT_DECIMAL, right->tok.loc, {decm - 1}, 4);
                         }
                         break;
                     default:
@@ -444,19 +459,18 @@ namespace xlang {
             }
         }
         
-        strength_reduction(&root->left);
-        strength_reduction(&root->right);
+        strength_reduction(left);
+        strength_reduction(right);
     
 	}
 	
-	void Optimizer::optimize_primary_expr(PrimaryExpression **pexpr) {
-		PrimaryExpression *pexp = *pexpr;
-		if (pexp == nullptr)
+	void Optimizer::optimize_primary_expr(NodeIndex *pexpr) {
+		if (*pexpr == NO_NODE)
 			return;
 		
-		constant_folding(&(*pexpr));
-		common_subexpression_elimination(&(*pexpr));
-		strength_reduction(&(*pexpr));
+		constant_folding(pexpr);
+		common_subexpression_elimination(Tree::primary_expr(*pexpr));
+		strength_reduction(Tree::primary_expr(*pexpr));
 	}
 	
 	void Optimizer::optimize_assignment_expr(AssignmentExpression **assexpr) {
@@ -499,11 +513,11 @@ namespace xlang {
 		}
 	}
 	
-	void Optimizer::update_count(std::string symbol) {
+	void Optimizer::update_count(NameId symbol) {
 		
 	    // search symbol in global_members/local_members and update its count
 
-		std::unordered_map<std::string, int>::iterator it;
+		std::unordered_map<NameId, int>::iterator it;
 		it = local_members.find(symbol);
 		
 		if (it == local_members.end()) {
@@ -525,14 +539,14 @@ namespace xlang {
 		if (pexpr == nullptr)
 			return;
 		
-		if (pexpr->unary_node != nullptr)
-			pexpr = pexpr->unary_node;
+		if (pexpr->unary_node != NO_NODE)
+			pexpr = Tree::primary_expr(pexpr->unary_node);
 		
 		if (pexpr->is_id)
-			update_count(pexpr->tok.string);
+			update_count(pexpr->tok.name);
 		
-		search_id_in_primary_expr(pexpr->left);
-		search_id_in_primary_expr(pexpr->right);
+		search_id_in_primary_expr(Tree::primary_expr(pexpr->left));
+		search_id_in_primary_expr(Tree::primary_expr(pexpr->right));
 	}
 	
 	void Optimizer::search_id_in_id_expr(IdentifierExpression *idexpr) {
@@ -543,10 +557,10 @@ namespace xlang {
 			return;
 		
 		if (idexpr->is_id)
-			update_count(idexpr->tok.string);
+			update_count(idexpr->tok.name);
 		
-		search_id_in_id_expr(idexpr->left);
-		search_id_in_id_expr(idexpr->right);
+		search_id_in_id_expr(Tree::id_expr(idexpr->left));
+		search_id_in_id_expr(Tree::id_expr(idexpr->right));
 	}
 	
 	void Optimizer::search_id_in_expr(Expression **exp) {
@@ -559,27 +573,31 @@ namespace xlang {
 		
 		switch (exp2->expr_kind) {
 			case ExpressionType::PRIMARY_EXPR :
-				search_id_in_primary_expr(exp2->primary_expr);
+				search_id_in_primary_expr(Tree::primary_expr(exp2->primary_expr));
 				break;
-			case ExpressionType::ASSGN_EXPR :
-				if (exp2->assgn_expr->id_expr->unary != nullptr)
-					search_id_in_id_expr(exp2->assgn_expr->id_expr->unary);
+			case ExpressionType::ASSGN_EXPR : {
+				IdentifierExpression *target = Tree::id_expr(exp2->assgn_expr->id_expr);
+				if (target->unary != NO_NODE)
+					search_id_in_id_expr(Tree::id_expr(target->unary));
 				else
-					search_id_in_id_expr(exp2->assgn_expr->id_expr);
+					search_id_in_id_expr(target);
 				
 				search_id_in_expr(&exp2->assgn_expr->expression);
 				break;
+			}
 			case ExpressionType::CAST_EXPR :
-				search_id_in_id_expr(exp2->cast_expr->target);
+				search_id_in_id_expr(Tree::id_expr(exp2->cast_expr->target));
 				break;
-			case ExpressionType::ID_EXPR :
-				if (exp2->id_expr->unary != nullptr)
-					search_id_in_id_expr(exp2->id_expr->unary);
+			case ExpressionType::ID_EXPR : {
+				IdentifierExpression *idexpr = Tree::id_expr(exp2->id_expr);
+				if (idexpr->unary != NO_NODE)
+					search_id_in_id_expr(Tree::id_expr(idexpr->unary));
 				else
-					search_id_in_id_expr(exp2->id_expr);
+					search_id_in_id_expr(idexpr);
 				break;
+			}
 			case ExpressionType::FUNC_CALL_EXPR :
-				search_id_in_id_expr(exp2->call_expr->function);
+				search_id_in_id_expr(Tree::id_expr(exp2->call_expr->function));
 				for (auto e: exp2->call_expr->expression_list)
 					search_id_in_expr(&e);
 				break;
@@ -655,37 +673,20 @@ namespace xlang {
 		TreeNode *trhead = *tr;
 		SymbolInfo *syminfo = nullptr;
 		Statement *stmthead = nullptr;
-		std::unordered_map<std::string, int>::iterator it;
+		std::unordered_map<NameId, int>::iterator it;
 		if (trhead == nullptr)
 			return;
 		
 		//copy each symbol from global symbol table into global_members hashmap
 		for (int i = 0; i < ST_SIZE; i++) {
-			syminfo = Compiler::symtab->symbol_info[i];
+			syminfo = comp->symtab->symbol_info[i];
 			if (syminfo != nullptr)
-				global_members.insert(std::pair<std::string, int>(syminfo->symbol, 0));
+				global_members.insert(std::pair<NameId, int>(syminfo->tok.name, 0));
 		}
 		
 		while (trhead != nullptr) {
 			if (trhead->symtab != nullptr) {
-				func_symtab = trhead->symtab;
-				//copy each symbol from function local symbol table into local_members hashmap
-				for (int i = 0; i < ST_SIZE; i++) {
-					syminfo = func_symtab->symbol_info[i];
-					if (syminfo != nullptr)
-						local_members.insert(std::pair<std::string, int>(syminfo->symbol, 0));
-				}
-				//search symbol in statement list
-				search_id_in_statement(&trhead->statement);
-				it = local_members.begin();
-
-				//if found, remove used symbol count for 0
-				while (it != local_members.end()) {
-					if (it->second == 0)
-						SymbolTable::remove_symbol(&func_symtab, it->first);
-					it++;
-				}
-				local_members.clear();
+				local_dead_code_elimination(trhead);
 			} else {
 				stmthead = trhead->statement;
 				if (stmthead != nullptr) {
@@ -701,11 +702,35 @@ namespace xlang {
 		it = global_members.begin();
 		while (it != global_members.end()) {
 			if (it->second == 0)
-				SymbolTable::remove_symbol(&Compiler::symtab, it->first);
+				SymbolTable::remove_symbol(&comp->symtab, it->first);
 			it++;
 		}
 	}
 	
+	void Optimizer::local_dead_code_elimination(TreeNode *trnode) {
+		SymbolInfo *syminfo = nullptr;
+		std::unordered_map<NameId, int>::iterator it;
+
+		func_symtab = trnode->symtab;
+		//copy each symbol from function local symbol table into local_members hashmap
+		for (int i = 0; i < ST_SIZE; i++) {
+			syminfo = func_symtab->symbol_info[i];
+			if (syminfo != nullptr)
+				local_members.insert(std::pair<NameId, int>(syminfo->tok.name, 0));
+		}
+		//search symbol in statement list
+		search_id_in_statement(&trnode->statement);
+		it = local_members.begin();
+
+		//if found, remove used symbol count for 0
+		while (it != local_members.end()) {
+			if (it->second == 0)
+				SymbolTable::remove_symbol(&func_symtab, it->first);
+			it++;
+		}
+		local_members.clear();
+	}
+
 	void Optimizer::optimize(TreeNode **tr) {
 		struct TreeNode *trhead = *tr;
 		if (trhead == nullptr)
@@ -715,8 +740,17 @@ namespace xlang {
 		trhead = *tr;
 		
 		while (trhead != nullptr) {
+			TraceScope span(comp->trace, Compiler::node_name(trhead), "optimize");
 			optimize_statement(&trhead->statement);
 			trhead = trhead->p_next;
 		}
 	}
+
+	void Optimizer::optimize_function(TreeNode *trnode) {
+		if (trnode->symtab != nullptr)
+			local_dead_code_elimination(trnode);
+
+		TraceScope span(comp->trace, Compiler::node_name(trnode), "optimize");
+		optimize_statement(&trnode->statement);
+	}
 }
\ No newline at end of file
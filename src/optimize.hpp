@@ -9,6 +9,7 @@
 
 #include <stack>
 #include <limits>
+#include <unordered_map>
 #include "token.hpp"
 #include "lex.hpp"
 #include "tree.hpp"
@@ -18,50 +19,60 @@ namespace xlang {
 	
 	constexpr unsigned int maxint = std::numeric_limits<int>::max();
 	
+	class Compiler;
+	
 	class Optimizer {
     public:
+		explicit Optimizer(Compiler *c) : comp(c) {}
+		
 		void optimize(TreeNode **);
+
+		// one function of a --stream compilation. globals are kept, if
+		// they are used is only known after the last function
+		void optimize_function(TreeNode *);
 		
     private:
-		bool evaluate(Token &, Token &, Token &, std::string &, bool);
+		Compiler *comp;
+		
+		bool evaluate(const Token &, const Token &, const Token &, LiteralValue &, uint8_t &, bool);
 		
 		std::stack<PrimaryExpression *> pexpr_stack;
 		
 		void clear_primary_expr_stack();
 		
-		void get_inorder_primary_expr(PrimaryExpression **);
+		void get_inorder_primary_expr(PrimaryExpression *);
 		
 		bool has_float_type(PrimaryExpression *);
 		
 		bool has_id(PrimaryExpression *);
 		
-		void id_constant_folding(PrimaryExpression **);
+		void id_constant_folding(NodeIndex *);
 		
-		void constant_folding(PrimaryExpression **);
+		void constant_folding(NodeIndex *);
 		
 		bool equals(std::stack<PrimaryExpression *>, std::stack<PrimaryExpression *>);
 		
-		PrimaryExpression *get_cmnexpr1_node(PrimaryExpression **, PrimaryExpression **);
+		NodeIndex get_cmnexpr1_node(PrimaryExpression *, PrimaryExpression **);
 		
-		void change_subexpr_pointers(PrimaryExpression **, PrimaryExpression **, PrimaryExpression **);
+		void change_subexpr_pointers(PrimaryExpression *, PrimaryExpression **, PrimaryExpression **);
 		
-		void common_subexpression_elimination(PrimaryExpression **);
+		void common_subexpression_elimination(PrimaryExpression *);
 		
 		bool is_powerof_2(int, int *);
 		
-		void strength_reduction(PrimaryExpression **);
+		void strength_reduction(PrimaryExpression *);
 		
-		void optimize_primary_expr(PrimaryExpression **);
+		void optimize_primary_expr(NodeIndex *);
 		
 		void optimize_assignment_expr(AssignmentExpression **);
 		
 		void optimize_expr(Expression **);
 		
-		std::unordered_map<std::string, int> local_members;
-		std::unordered_map<std::string, int> global_members;
+		std::unordered_map<NameId, int> local_members;
+		std::unordered_map<NameId, int> global_members;
 		Node *func_symtab = nullptr;
 		
-		void update_count(std::string);
+		void update_count(NameId);
 		
 		void search_id_in_primary_expr(PrimaryExpression *);
 		
@@ -72,6 +83,8 @@ namespace xlang {
 		void search_id_in_statement(Statement **);
 		
 		void dead_code_elimination(TreeNode **);
+
+		void local_dead_code_elimination(TreeNode *);
 		
 		void optimize_statement(Statement **);
 		
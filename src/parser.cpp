@@ -11,6 +11,9 @@
 #include <algorithm>
 #include <cstdarg>
 #include <cassert>
+#include <atomic>
+#include <sstream>
+#include <thread>
 #include "token.hpp"
 #include "compiler.hpp"
 #include "log.hpp"
@@ -20,43 +23,38 @@
 
 namespace xlang {
 
-	Parser::Parser() {
-		Compiler::symtab = SymbolTable::get_node_mem();
-		Compiler::record_table = SymbolTable::get_record_symtab_mem();
-		Compiler::func_table = SymbolTable::get_func_table_mem();
+	Parser::Parser(Compiler *c) : comp(c), lex(c->lex) {
+		comp->symtab = SymbolTable::get_node_mem();
+		comp->record_table = SymbolTable::get_record_symtab_mem();
+		comp->func_table = SymbolTable::get_func_table_mem();
 		consumed_terminator.number = NONE;
 		consumed_terminator.string = "";
 		nulltoken.number = NONE;
 		nulltoken.string = "";
 	}
 
-	bool Parser::peek_token(TokenId tk) {
-
-		//get Token from lexer and match it with tk and return Token again to lex
-		Token tok = Compiler::lex->get_next();
-		if (tok.number == tk) {
-			Compiler::lex->put_back(tok);
-			return true;
-		}
+	Parser::Parser(Compiler *c, Lexer *l, uint32_t records) : comp(c), lex(l), records_before(records) {
+		consumed_terminator.number = NONE;
+		consumed_terminator.string = "";
+		nulltoken.number = NONE;
+		nulltoken.string = "";
+	}
 
-		Compiler::lex->put_back(tok);
-		return false;
+	bool Parser::peek_token(TokenId tk) {
+		return lex->peek().number == tk;
 	}
 
 	bool Parser::peek_token(std::vector<TokenId> &tkv) {
 
-		// get Token from lexer and match it with a vector of tokens
+		// match the next token with a vector of tokens
 
-		Token tok = Compiler::lex->get_next();
+		TokenId tk = lex->peek().number;
 		std::vector<TokenId>::iterator it = tkv.begin();
 		while (it != tkv.end()) {
-			if (tok.number == *it) {
-				Compiler::lex->put_back(tok);
+			if (tk == *it)
 				return true;
-			}
 			it++;
 		}
-		Compiler::lex->put_back(tok);
 		return false;
 	}
 
@@ -65,12 +63,12 @@ namespace xlang {
 		// peek Token with variable number of provided tokens
 		va_list args;
 		va_start(args, format);
-		Token tok = Compiler::lex->get_next();
+		TokenId tk = lex->peek().number;
 
 		while (*format != '\0') {
 			if (*format == 'd') {
-				if (va_arg(args, int) == tok.number) {
-					Compiler::lex->put_back(tok);
+				if (va_arg(args, int) == tk) {
+					va_end(args);
 					return true;
 				}
 			}
@@ -78,46 +76,20 @@ namespace xlang {
 		}
 
 		va_end(args);
-		Compiler::lex->put_back(tok);
 		return false;
 	}
 
 	bool Parser::peek_nth_token(TokenId tk, int n) {
-		Token *tok = new Token[n];
-		TokenId tk2;
-		int i;
-		for (i = 0; i < n; i++)
-			tok[i] = Compiler::lex->get_next();
-
-		tk2 = tok[n - 1].number;
-		for (i = n - 1; i >= 0; i--)
-			Compiler::lex->put_back(tok[i]);
-
-		delete[] tok;
-		return (tk == tk2);
+		return get_nth_token(n) == tk;
 	}
 
 	TokenId Parser::get_peek_token() {
-		Token tok = Compiler::lex->get_next();
-		TokenId tk = tok.number;
-		Compiler::lex->put_back(tok);
-		return tk;
+		return lex->peek().number;
 	}
 
 	TokenId Parser::get_nth_token(int n) {
-		Token *tok = new Token[n];
-		TokenId tk;
-		int i;
-
-		for (i = 0; i < n; i++)
-			tok[i] = Compiler::lex->get_next();
-
-		tk = tok[n - 1].number;
-		for (i = n - 1; i >= 0; i--)
-			Compiler::lex->put_back(tok[i]);
-
-		delete[] tok;
-		return tk;
+		// n counts from 1, the next token
+		return lex->peek(n - 1).number;
 	}
 
 	bool Parser::expr_literal(TokenId tkt) {
@@ -130,99 +102,61 @@ namespace xlang {
 	}
 
 	bool Parser::peek_expr_literal() {
-		Token tok = Compiler::lex->get_next();
-		TokenId tkt = tok.number;
-		Compiler::lex->put_back(tok);
-		return (expr_literal(tkt));
-	}
-
-	bool Parser::expect(TokenId tk) {
-
-		Token tok = Compiler::lex->get_next();
-		if (tok.number != tk) {
-			std::map<TokenId, std::string>::iterator find_it = token_lexeme_table.find(tk);
-			if (find_it != token_lexeme_table.end()) {
-				auto it = std::prev(expr_list.end());
-				TokenLocation loc;
-				if (!expr_list.empty())
-					loc = (*it).loc;
-				Log::error_at(loc, "expected ", find_it->second);
-				Log::print_tokens(expr_list);
-				return false;
-			}
-		}
-		Compiler::lex->put_back(tok);
-		return true;
+		return expr_literal(get_peek_token());
 	}
 
 	bool Parser::expect(TokenId tk, bool consume_token) {
 
 		//determine whether to consume Token or return it to lexer
-		Token tok = Compiler::lex->get_next();
+		Token tok = lex->get_next();
 		if (tok.number == END)
 			return false;
 
 		if (tok.number != tk) {
 			std::map<TokenId, std::string>::iterator find_it = token_lexeme_table.find(tk);
 			if (find_it != token_lexeme_table.end()) {
-				auto it = std::prev(expr_list.end());
-				TokenLocation loc;
-
-				if (!expr_list.empty())
-					loc = (*it).loc;
-
-				if (tok.number != END && expr_list.empty())
-					loc = tok.loc;
-				else {
-					loc.line = 0;
-					loc.col = 0;
-				}
-
-				Log::error_at(loc, "expected ", find_it->second, " but found " + s_quotestring(tok.string));
-				Log::print_tokens(expr_list);
+				Log::error_at(tok.loc, "expected ", find_it->second, " but found " + s_quotestring(tok.string));
 				return false;
 			}
 		}
 
 		if (!consume_token)
-			Compiler::lex->put_back(tok);
+			lex->unget();
 		return true;
 	}
 
 	bool Parser::expect(TokenId tk, bool consume_token, std::string str) {
-		Token tok = Compiler::lex->get_next();
+		Token tok = lex->get_next();
 		if (tok.number != tk) {
 			Log::error_at(tok.loc, "expected ", str);
-			Log::print_tokens(expr_list);
 			return false;
 		}
 		if (!consume_token)
-			Compiler::lex->put_back(tok);
+			lex->unget();
 		return true;
 	}
 
 	bool Parser::expect(TokenId tk, bool consume_token, std::string str, std::string arg) {
-		Token tok = Compiler::lex->get_next();
+		Token tok = lex->get_next();
 
 		if (tok.number != tk) {
 			Log::error_at(tok.loc, "expected ", str, arg);
-			Log::print_tokens(expr_list);
 			return false;
 		}
 		if (!consume_token)
-			Compiler::lex->put_back(tok);
+			lex->unget();
 		return true;
 	}
 
 	bool Parser::expect(const char *format...) {
 		va_list args;
 		va_start(args, format);
-		Token tok = Compiler::lex->get_next();
+		Token tok = lex->get_next();
 
 		while (*format != '\0') {
 			if (*format == 'd') {
 				if (va_arg(args, int) == tok.number) {
-					Compiler::lex->put_back(tok);
+					lex->unget();
 					return true;
 				}
 			}
@@ -235,12 +169,12 @@ namespace xlang {
 	}
 
 	void Parser::consume_next() {
-		Compiler::lex->get_next();
+		lex->get_next();
 	}
 
 	void Parser::consume_n(int n) {
 		while (n > 0) {
-			Compiler::lex->get_next();
+			lex->get_next();
 			n--;
 		}
 	}
@@ -248,21 +182,11 @@ namespace xlang {
 	void Parser::consume_till(terminator_t &terminator) {
 		Token tok;
 		std::sort(terminator.begin(), terminator.end());
-		while ((tok = Compiler::lex->get_next()).number != END) {
+		while ((tok = lex->get_next()).number != END) {
 			if (std::binary_search(terminator.begin(), terminator.end(), tok.number))
 				break;
 		}
-		Compiler::lex->put_back(tok);
-	}
-
-	bool Parser::check_parenth() {
-
-		//used in primary expression for () checking using stack
-		if (parenth_stack.size() > 0) {
-			parenth_stack.pop();
-			return true;
-		}
-		return false;
+		lex->unget();
 	}
 
 	bool Parser::matches_terminator(terminator_t &tkv, TokenId tk) {
@@ -295,10 +219,7 @@ namespace xlang {
 	}
 
 	bool Parser::peek_unary_operator() {
-		Token tok = Compiler::lex->get_next();
-		TokenId tk = tok.number;
-		Compiler::lex->put_back(tok);
-		return unary_operator(tk);
+		return unary_operator(get_peek_token());
 	}
 
 	bool Parser::binary_operator(TokenId tk) {
@@ -352,10 +273,7 @@ namespace xlang {
 	}
 
 	bool Parser::peek_binary_operator() {
-		Token tok = Compiler::lex->get_next();
-		TokenId tk = tok.number;
-		Compiler::lex->put_back(tok);
-		return binary_operator(tk);
+		return binary_operator(get_peek_token());
 	}
 
 	bool Parser::peek_literal() {
@@ -490,8 +408,7 @@ namespace xlang {
 
 	bool Parser::peek_type_specifier(std::vector<Token> &tokens) {
 
-		Token tok;
-		tok = Compiler::lex->get_next();
+		const Token &tok = lex->peek();
 
 		if (tok.number == KEY_VOID ||
 			tok.number == KEY_CHAR ||
@@ -503,11 +420,9 @@ namespace xlang {
 			tok.number == IDENTIFIER) {
 
 			tokens.push_back(tok);
-			Compiler::lex->put_back(tok);
 			return true;
 		}
 
-		Compiler::lex->put_back(tok);
 		return false;
 	}
 
@@ -533,325 +448,15 @@ namespace xlang {
 	}
 
 	bool Parser::peek_type_specifier_from(int n) {
-		Token *tok = new Token[n];
-
-		TokenId tk;
-		for (int i = 0; i < n; i++)
-			tok[i] = Compiler::lex->get_next();
-
-		tk = tok[n - 1].number;
-		for (int i = n - 1; i >= 0; i--) {
-			Compiler::lex->put_back(tok[i]);
-		}
-
-		delete[] tok;
-		return (type_specifier(tk));
+		return type_specifier(get_nth_token(n));
 	}
 
-	void Parser::primary_expr(terminator_t &terminator) {
-
-		// infix expressions are hard to parse so there is the possibility that we may
-		// discard some valid expressions. Also some unary operators are not handled
-		// at the final parsing state. Some are hardcoded for expecting the tokens
-		// because of recursion.
-
-		terminator_t terminator2;
-		Token tok = Compiler::lex->get_next();
-		Token tok2;
-
-		if (matches_terminator(terminator, tok.number)) {
-			expr_list.push_back(tok);
-			return;
-		}
+	NodeIndex Parser::primary_expr(terminator_t &terminator) {
 
-		switch (tok.number) {
-
-			case PARENTH_OPEN :
-
-				expr_list.push_back(tok);
-				parenth_stack.push(tok);
-
-				if (peek_token(PARENTH_CLOSE)) {
-					tok2 = Compiler::lex->get_next();
-					Log::error_at(tok2.loc, "expression expected ", tok2.string);
-				}
-
-				primary_expr(terminator); //call same function as per the grammar
-
-				if (parenth_stack.size() > 0 && expect(PARENTH_CLOSE)) {
-
-					if (!check_parenth())
-						Log::error_at(tok.loc, "unbalanced parenthesis");
-
-					tok2 = Compiler::lex->get_next();
-					expr_list.push_back(tok2);
-
-					if (peek_binary_operator() || peek_unary_operator())
-						sub_primary_expr(terminator);
-					else if (peek_token(terminator)) {
-						if (check_parenth())
-							Log::error_at(tok2.loc, "unbalanced parenthesis");
-
-						tok2 = Compiler::lex->get_next();
-						is_expr_terminator_consumed = true;
-						consumed_terminator = tok2;
-						is_expr_terminator_got = true;
-					}
-					else if (peek_token(PARENTH_CLOSE)) {
-						tok2 = Compiler::lex->get_next();
-						if (!check_parenth())
-							Log::error_at(tok2.loc, "unbalanced parenthesis ", tok2.string);
-
-						expr_list.push_back(tok2);
-						primary_expr(terminator);
-					}
-					else {
-						tok = Compiler::lex->get_next();
-						if (!is_expr_terminator_consumed || !is_expr_terminator_got)
-							Log::error_at(tok.loc, get_terminator(terminator) + "expected");
-
-						if (check_parenth())
-							Log::error("unbalanced parenthesis");
-
-						if (tok.number == END)
-							return;
-						Log::error(get_terminator(terminator) + "expected but found " + tok.string);
-					}
-				}
-				break;
-
-			case PARENTH_CLOSE :
-
-				if (!check_parenth())
-					Log::error("unbalanced parenthesis");
-
-				expr_list.push_back(tok); // push ')' on expression list
-
-				if (peek_binary_operator())
-					primary_expr(terminator);
-				else if (peek_token(terminator)) {
-					is_expr_terminator_got = true;
-					tok2 = Compiler::lex->get_next();
-					is_expr_terminator_consumed = true;
-					consumed_terminator = tok2;
-					return;
-				}
-				else if (peek_token(PARENTH_CLOSE))
-					primary_expr(terminator);
-				else {
-					Log::error(get_terminator(terminator) + "expected ");
-					Log::print_tokens(expr_list);
-					return;
-				}
-				return;
-				break;
-
-			case LIT_DECIMAL :
-			case LIT_OCTAL :
-			case LIT_HEX :
-			case LIT_BIN :
-			case LIT_FLOAT :
-			case LIT_CHAR :
-
-				expr_list.push_back(tok); // push literal
-
-				if (peek_binary_operator() || peek_unary_operator()) {
-					if (expect_binary_operator()) {
-						tok2 = Compiler::lex->get_next();
-						expr_list.push_back(tok2);
-					}
-
-					if (peek_token(PARENTH_OPEN) || peek_token(IDENTIFIER))
-						primary_expr(terminator);
-					else if (peek_expr_literal()) {
-						if (expect_literal()) {
-							tok2 = Compiler::lex->get_next();
-							expr_list.push_back(tok2);
-						}
-					}
-					else if (peek_unary_operator())
-						sub_primary_expr(terminator);
-					else {
-						tok2 = Compiler::lex->get_next();
-						Log::error_at(tok2.loc, "literal or expression expected ", tok2.string);
-						for (const auto &e: expr_list) {
-							Log::error(e.number, e.string, "\n");
-						}
-						std::cout << std::endl;
-						return;
-					}
-				}
-				else if (peek_token(terminator)) {
-
-					if (check_parenth())
-						Log::error("unbalanced parenthesis");
-
-
-					tok2 = Compiler::lex->get_next();
-					//expr_list.push_back(tok2);
-					is_expr_terminator_got = true;
-					is_expr_terminator_consumed = true;
-					consumed_terminator = tok2;
-					return;
-				}
-				else if (peek_token(PARENTH_CLOSE))
-					primary_expr(terminator);
-				else {
-					tok2 = Compiler::lex->get_next();
-					if (!is_expr_terminator_got) {
-						Log::error(get_terminator(terminator) + " expected ");
-						Log::print_tokens(expr_list);
-						Compiler::lex->put_back(tok2);
-						return;
-					}
-
-					if (!check_parenth())
-						Log::error("unbalanced parenthesis");
-				}
-
-				if (peek_token(terminator)) {
-					tok2 = Compiler::lex->get_next();
-					is_expr_terminator_got = true;
-					is_expr_terminator_consumed = true;
-					consumed_terminator = tok2;
-					return;
-				}
-				else if (peek_binary_operator())
-					sub_primary_expr(terminator);
-				else {
-					if (peek_token(PARENTH_CLOSE)) {
-						if (parenth_stack.size() == 0) {
-							tok2 = Compiler::lex->get_next();
-							Log::error_at(tok2.loc, "error ", tok2.string);
-						}
-					}
-					else if (peek_token(END)) {
-						tok2 = Compiler::lex->get_next();
-						if (check_parenth())
-							Log::error("unbalanced parenthesis");
-
-						if (!is_expr_terminator_consumed) {
-							Log::error_at(tok2.loc, get_terminator(terminator) + "expected");
-							return;
-						}
-					}
-					else if (peek_expr_literal()) {
-						tok2 = Compiler::lex->get_next();
-						if (check_parenth())
-							Log::error("unbalanced parenthesis");
-
-						if (!is_expr_terminator_got)
-							Log::error_at(tok2.loc, get_terminator(terminator) + "expected");
-
-						Compiler::lex->put_back(tok2);
-					}
-					else {
-						if (!is_expr_terminator_consumed) {
-							Log::error(get_terminator(terminator) + "expected ");
-							Log::print_tokens(expr_list);
-							return;
-						}
-					}
-				}
-
-				break;
-
-			case ARTHM_ADD :
-			case ARTHM_SUB :
-			case ARTHM_MUL :
-			case ARTHM_DIV :
-			case ARTHM_MOD :
-			case LOG_AND :
-			case LOG_OR :
-			case COMP_LESS :
-			case COMP_LESS_EQ :
-			case COMP_GREAT :
-			case COMP_GREAT_EQ :
-			case COMP_EQ :
-			case COMP_NOT_EQ :
-			case LOG_NOT :
-			case BIT_AND :
-			case BIT_OR :
-			case BIT_EXOR :
-			case BIT_LSHIFT :
-			case BIT_RSHIFT :
-			case BIT_COMPL :
-
-				if (is_expr_terminator_got) {
-					Compiler::lex->put_back(tok);
-					return;
-				}
-
-				if (unary_operator(tok.number)) {
-					expr_list.push_back(tok);
-					if (peek_token(PARENTH_OPEN) ||
-						peek_expr_literal() ||
-						peek_binary_operator() ||
-						peek_unary_operator() ||
-						peek_token(IDENTIFIER)) {
-						sub_primary_expr(terminator);
-					}
-					else if (peek_token(INCR_OP))
-						prefix_incr_expr(terminator);
-					else if (peek_token(DECR_OP))
-						prefix_decr_expr(terminator);
-					else {
-						tok2 = Compiler::lex->get_next();
-						Log::error_at(tok2.loc, "expression expected ", tok2.string);
-					}
-				}
-				else {
-					if (peek_token(PARENTH_OPEN) || peek_expr_literal() || peek_token(IDENTIFIER)) {
-						expr_list.push_back(tok);
-						sub_primary_expr(terminator);
-					}
-					else {
-						tok2 = Compiler::lex->get_next();
-						Log::error_at(tok2.loc, "literal expected ", tok2.string);
-					}
-				}
-				break;
-
-			case IDENTIFIER :
-
-				if (peek_binary_operator()) {
-					expr_list.push_back(tok);
-					sub_primary_expr(terminator);
-				}
-				else if (peek_token(terminator)) {
-					expr_list.push_back(tok);
-					tok = Compiler::lex->get_next();
-					is_expr_terminator_consumed = true;
-					consumed_terminator = tok;
-					return;
-				}
-				else if (peek_token(END)) {
-					expr_list.push_back(tok);
-					Log::error_at(tok.loc, get_terminator(terminator) + "expected");
-					return;
-				}
-				else {
-					Compiler::lex->put_back(tok, true);
-					if (parenth_stack.size() > 0) {
-						terminator2.push_back(PARENTH_CLOSE);
-						id_expr(terminator2);
-					}
-					else
-						id_expr(terminator);
-				}
-				break;
-
-			default :
-				Log::error_at(tok.loc, "primaryexpr invalid Token ", tok.string);
-				break;
-		}
+		// literals, identifiers, ( ) and the operators of tree_operator()
+		// up to the terminator
+		return climb_tree(false, terminator);
 	}
-
-	void Parser::sub_primary_expr(terminator_t &terminator) {
-		if (expr_list.size() > 0)
-			primary_expr(terminator);
-	}
-
 	int Parser::precedence(TokenId opr) {
 
 		// ()                 Parentheses: grouping or function call
@@ -953,16 +558,87 @@ namespace xlang {
 		}
 	}
 
-	void Parser::postfix_expression(std::list<Token> &postfix_expr) {
+	bool Parser::tree_operator(TokenId tk) {
+		return (binary_operator(tk) ||
+				tk == LOG_NOT ||
+				tk == BIT_COMPL ||
+				tk == DOT_OP ||
+				tk == ARROW_OP ||
+				tk == INCR_OP ||
+				tk == DECR_OP ||
+				tk == ADDROF_OP);
+	}
+
+	NodeIndex Parser::climb_tree(bool id_tree, terminator_t &terminator, const Token *prefix) {
+
+		// builds the tree of an expression by precedence climbing as its
+		// tokens are read. every operator is read as if it were binary,
+		// one with nothing on a side (! ~ ++ & ...) just has a missing
+		// operand there. what an operator makes of the nodes is up to
+		// make_operator(), it is called for the operators in the order of
+		// their reverse polish notation. a prefix ++ -- & is read by the
+		// caller
+
+		build.id_tree = id_tree;
+		build.terminated = false;
+		build.depth = 0;
+		build.terminator = &terminator;
+		build.has_unary = false;
+		build.primary.clear();
+		build.id.clear();
+
+		if (prefix != nullptr) {
+			build.tok = *prefix;
+			build.state = ExprState::PREFIX;
+		}
+		else {
+			build.state = ExprState::START;
+			next_expr_token();
+		}
+
+		climb_expr(0);
+
+		if (id_tree)
+			return build.id.empty() ? NO_NODE : build.id.back();
 
-		//converts primary expression into its reverse polish notation
-		//by checking the precedency of an operator
+		// the last ! or ~ read is put over the whole tree
+		if (build.has_unary) {
+			NodeIndex oprtr = Tree::get_primary_expr_mem();
+			PrimaryExpression *node = Tree::primary_expr(oprtr);
+			node->tok = build.unary;
+			node->is_id = false;
+			node->is_oprtr = true;
+			node->oprtr_kind = OperatorType::UNARY;
 
-		std::stack<Token> post_stack;
-		auto expr_it = expr_list.begin();
+			if (!build.primary.empty())
+				node->unary_node = build.primary.back();
 
-		while (expr_it != expr_list.end()) {
-			switch ((*expr_it).number) {
+			return oprtr;
+		}
+
+		return build.primary.empty() ? NO_NODE : build.primary.back();
+	}
+
+	void Parser::climb_expr(int min_prec) {
+
+		// an operand and the operators after it that bind at least as
+		// tight as min_prec. the right side of an operator is what binds
+		// tighter than it, so operators of the same precedence go left
+		// to right
+
+		climb_operand();
+
+		while (tree_operator(build.tok.number) && precedence(build.tok.number) >= min_prec) {
+			Token op = build.tok;
+			next_expr_token();
+			climb_expr(precedence(op.number) + 1);
+			make_operator(op);
+		}
+	}
+
+	void Parser::climb_operand() {
+		while (true) {
+			switch (build.tok.number) {
 				case LIT_DECIMAL :
 				case LIT_OCTAL :
 				case LIT_HEX :
@@ -970,463 +646,283 @@ namespace xlang {
 				case LIT_FLOAT :
 				case LIT_CHAR :
 				case IDENTIFIER :
-					postfix_expr.push_back(*expr_it);
+					make_leaf(build.tok);
+					next_expr_token();
 					break;
-				case ARTHM_ADD :
-				case ARTHM_SUB :
-				case ARTHM_MUL :
-				case ARTHM_DIV :
-				case ARTHM_MOD :
-				case LOG_AND :
-				case LOG_OR :
-				case COMP_LESS :
-				case COMP_LESS_EQ :
-				case COMP_GREAT :
-				case COMP_GREAT_EQ :
-				case COMP_EQ :
-				case COMP_NOT_EQ :
-				case LOG_NOT :
-				case BIT_AND :
-				case BIT_OR :
-				case BIT_EXOR :
-				case BIT_LSHIFT :
-				case BIT_RSHIFT :
-				case BIT_COMPL :
-				case DOT_OP :
-				case ARROW_OP :
-				case INCR_OP :
-				case DECR_OP :
-				case ADDROF_OP :
-					if (post_stack.empty() || post_stack.top().number == PARENTH_OPEN)
-						post_stack.push(*expr_it);
-					else {
-						if (!post_stack.empty() && (precedence((*expr_it).number) > precedence(post_stack.top().number)))
-							post_stack.push(*expr_it);
-						else {
-							while (!post_stack.empty() && (precedence((*expr_it).number) <= precedence(post_stack.top().number))) {
-								postfix_expr.push_back(post_stack.top());
-								post_stack.pop();
-							}
-							post_stack.push(*expr_it);
-						}
-					}
-					break;
-				case PARENTH_OPEN :
-					post_stack.push(*expr_it);
-					break;
-				case PARENTH_CLOSE :
-					while (!post_stack.empty() && post_stack.top().number != PARENTH_OPEN) {
-						postfix_expr.push_back(post_stack.top());
-						post_stack.pop();
-					}
-
-					if (!post_stack.empty() && post_stack.top().number == PARENTH_OPEN)
-						post_stack.pop();
 
-					break;
 				case SQUARE_OPEN :
-					while (expr_it != expr_list.end() && (*expr_it).number != SQUARE_CLOSE) {
-						postfix_expr.push_back(*expr_it);
-						expr_it++;
+					// the index goes in the node of the identifier before it
+					if (!build.id.empty()) {
+						IdentifierExpression *node = Tree::id_expr(build.id.back());
+						node->is_subscript = true;
+						node->subscript.push_back(build.index);
 					}
-
-					postfix_expr.push_back(*expr_it);
+					next_expr_token();
 					break;
 
-				case SEMICOLON :
-				case COMMA_OP :
-					goto exit; //if ; , then exit
+				case PARENTH_OPEN :
+					next_expr_token();
+					climb_expr(0);
+					if (build.tok.number == PARENTH_CLOSE)
+						next_expr_token();
+					break;
 
 				default :
-					Log::error_at((*expr_it).loc, "error in conversion into postfix expression ", (*expr_it).string);
 					return;
 			}
-			expr_it++;
-		}
-
-		exit :
-		while (!post_stack.empty()) {
-			postfix_expr.push_back(post_stack.top());
-			post_stack.pop();
 		}
 	}
 
-	PrimaryExpression *Parser::get_primary_expr_tree() {
+	void Parser::next_expr_token() {
 
-		// returns primary expression tree
-		// by building it from reverse polish notation
-		// of an primary expression
+		// reads the next token of the expression into build.tok, NONE at
+		// its end. the token is checked against what came before it so a
+		// bad expression is reported where it goes wrong. a terminator the
+		// expression ends at is consumed, an assignment operator or the (
+		// of a call after an identifier expression is left for the caller
 
-		std::stack<PrimaryExpression *> extree_stack;
-		std::list<Token>::iterator post_it;
-		PrimaryExpression *Expression = nullptr, *oprtr = nullptr;
-		std::list<Token> postfix_expr;
-		Token unary_tok = nulltoken;
+		terminator_t &terminator = build.depth > 0 ? build.parenth : *build.terminator;
+		Token tok = lex->peek();
+		TokenId tk = tok.number;
+		bool operand = expr_literal(tk) || tk == IDENTIFIER || tk == PARENTH_OPEN;
+		ExprState state = build.state;
 
-		postfix_expression(postfix_expr);
+		switch (build.state) {
+			case ExprState::START :
+			case ExprState::OPEN :
+				if (build.id_tree && build.state == ExprState::START && tk != IDENTIFIER)
+					Log::error_at(tok.loc, " identifier expected but found ", tok.string);
 
-		//first check for size, there could be only an identifier
-		if (postfix_expr.size() == 1) {
-			Expression = Tree::get_primary_expr_mem();
-			Expression->tok = postfix_expr.front();
-			Expression->is_oprtr = false;
-			post_it = postfix_expr.begin();
-			if (post_it->number == IDENTIFIER)
-				Expression->is_id = true;
-			else
-				Expression->is_id = false;
-			return Expression;
-		}
-
-		for (post_it = postfix_expr.begin(); post_it != postfix_expr.end(); post_it++) {
-			//if literal/identifier is found, push it onto stack
-			if (expr_literal((*post_it).number)) {
-				Expression = Tree::get_primary_expr_mem();
-				Expression->tok = *post_it;
-				Expression->is_id = false;
-				Expression->is_oprtr = false;
-				extree_stack.push(Expression);
-				Expression = nullptr;
-			}
-			else if ((*post_it).number == IDENTIFIER) {
-				Expression = Tree::get_primary_expr_mem();
-				Expression->tok = *post_it;
-				Expression->is_id = true;
-				Expression->is_oprtr = false;
-				extree_stack.push(Expression);
-				Expression = nullptr;
-				//if operator is found, pop last two entries from stack,
-				//assign left and right nodes and push the generated tree into stack again
-			}
-			else if (binary_operator((*post_it).number) || (*post_it).number == DOT_OP || (*post_it).number == ARROW_OP) {
-				oprtr = Tree::get_primary_expr_mem();
-				oprtr->tok = *post_it;
-				oprtr->is_id = false;
-				oprtr->is_oprtr = true;
-				oprtr->oprtr_kind = OperatorType::BINARY;
-				if (extree_stack.size() > 1) {
-					oprtr->right = extree_stack.top();
-					extree_stack.pop();
-					oprtr->left = extree_stack.top();
-					extree_stack.pop();
-					extree_stack.push(oprtr);
-				}
-			}
-			else if ((*post_it).number == BIT_COMPL || (*post_it).number == LOG_NOT)
-				unary_tok = *post_it;
-		}
-
-		postfix_expr.clear();
-
-		if (unary_tok.number != NONE) {
-			oprtr = Tree::get_primary_expr_mem();
-			oprtr->tok = unary_tok;
-			oprtr->is_id = false;
-			oprtr->is_oprtr = true;
-			oprtr->oprtr_kind = OperatorType::UNARY;
-
-			if (!extree_stack.empty())
-				oprtr->unary_node = extree_stack.top();
+				if (build.state == ExprState::OPEN && (tk == PARENTH_CLOSE || matches_terminator(*build.terminator, tk)))
+					Log::error_at(tok.loc, "expression expected ", tok.string);
 
-			return oprtr;
-		}
-
-		if (!extree_stack.empty())
-			return extree_stack.top();
-
-		return nullptr;
-	}
+				if (!operand && !binary_operator(tk) && tk != LOG_NOT && tk != BIT_COMPL)
+					Log::error_at(tok.loc, "primaryexpr invalid Token ", tok.string);
+				break;
 
-	IdentifierExpression *Parser::get_id_expr_tree() {
+			case ExprState::LIT_OPERATOR :
+				if (!operand && !unary_operator(tk))
+					Log::error_at(tok.loc, "literal or expression expected ", tok.string);
+				break;
 
-		// returns identifier expression tree
-		// this is same as primary expression tree generation
-		// only just handling member access operators as well as
-		// increment/decrement/addressof operators
+			case ExprState::UNARY :
+				if (!operand && !binary_operator(tk) && !unary_operator(tk) && tk != INCR_OP && tk != DECR_OP)
+					Log::error_at(tok.loc, "expression expected ", tok.string);
+				break;
 
-		std::stack<IdentifierExpression *> extree_stack;
-		std::list<Token>::iterator post_it;
-		std::list<Token> postfix_expr;
-		IdentifierExpression *Expression = nullptr, *oprtr = nullptr;
-		IdentifierExpression *temp = nullptr;
+			case ExprState::OPERATOR :
+				if (!operand)
+					Log::error_at(tok.loc, "literal expected ", tok.string);
+				break;
 
-		postfix_expression(postfix_expr);
+			case ExprState::PREFIX :
+				if (tk != IDENTIFIER) {
+					if (build.tok.number == ADDROF_OP)
+						Log::error_at(tok.loc, " identifier expected but found ", tok.string);
+					Log::error("identifier expected ");
+				}
+				break;
 
-		for (post_it = postfix_expr.begin(); post_it != postfix_expr.end(); post_it++) {
-			if ((*post_it).number == IDENTIFIER) {
-				Expression = Tree::get_id_expr_mem();
-				Expression->tok = *post_it;
-				Expression->is_id = true;
-				Expression->is_oprtr = false;
+			case ExprState::MEMBER :
+				if (tk != IDENTIFIER)
+					Log::error_at(tok.loc, " identifier expected but found ", tok.string);
+				break;
 
-				post_it++;
-				if (post_it != postfix_expr.end()) {
-					if ((*post_it).number == SQUARE_OPEN)
-						Expression->is_subscript = true;
+			default :
+				// after an operand, a ) closes the innermost ( and the
+				// terminator ends the expression
+				if (tk == PARENTH_CLOSE && build.depth > 0) {
+					state = ExprState::CLOSE;
+					build.depth--;
 				}
+				else if (matches_terminator(*build.terminator, tk)) {
+					if (build.depth > 0)
+						Log::error_at(build.tok.loc, "expected ", ")");
 
-				post_it--;
-				extree_stack.push(Expression);
-				Expression = nullptr;
-			}
-			else if (binary_operator((*post_it).number) || (*post_it).number == DOT_OP || (*post_it).number == ARROW_OP) {
-				oprtr = Tree::get_id_expr_mem();
-				oprtr->tok = *post_it;
-				oprtr->is_id = false;
-				oprtr->is_oprtr = true;
-				oprtr->is_subscript = false;
-				if (extree_stack.size() > 1) {
-					oprtr->right = extree_stack.top();
-					extree_stack.pop();
-					oprtr->left = extree_stack.top();
-					extree_stack.pop();
-					extree_stack.push(oprtr);
+					lex->get_next();
+					is_expr_terminator_consumed = true;
+					consumed_terminator = tok;
+					build.terminated = true;
+					build.tok.number = NONE;
+					return;
 				}
-			}
-			else if ((*post_it).number == INCR_OP || (*post_it).number == DECR_OP || (*post_it).number == ADDROF_OP) {
-				oprtr = Tree::get_id_expr_mem();
-				oprtr->tok = *post_it;
-				oprtr->is_id = false;
-				oprtr->is_oprtr = true;
-				oprtr->is_subscript = false;
-				oprtr->unary = Tree::get_id_expr_mem();
-				if (extree_stack.size() > 0) {
-					oprtr->unary = extree_stack.top();
-					extree_stack.pop();
-					extree_stack.push(oprtr);
+				else if (build.state == ExprState::LITERAL) {
+					if (unary_operator(tk) && !binary_operator(tk))
+						Log::error_at(tok.loc, "expected ");
+					else if (tk == PARENTH_CLOSE)
+						Log::error_at(tok.loc, "error ", tok.string);
+					else if (!binary_operator(tk))
+						Log::error(get_terminator(terminator) + " expected ");
+					state = ExprState::LIT_OPERATOR;
 				}
-			}
-			else if ((*post_it).number == SQUARE_OPEN) {
-				post_it++;
-				if (!extree_stack.empty()) {
-					temp = extree_stack.top();
-					(temp->subscript).push_back(*post_it);
+				else if (build.state == ExprState::POSTFIX) {
+					if (build.tok.number == INCR_OP)
+						Log::error_at(tok.loc, "; , ) expected but found " + std::string(tok.string));
+					Log::error("; , ) expected ");
 				}
-				post_it++;
-			}
-		}
-
-		postfix_expr.clear();
-
-		if (!extree_stack.empty())
-			return extree_stack.top();
-
-		return nullptr;
-	}
+				else if (build.state == ExprState::SUBSCRIPT && tk != SQUARE_OPEN && !member_access_operator(tk)) {
+					if (build.id_tree && build.depth == 0 && assignment_operator(tk)) {
+						build.tok.number = NONE;
+						return;
+					}
+					Log::error("; , ) expected ");
+				}
+				else if (binary_operator(tk) || unary_operator(tk))
+					state = unary_operator(tk) ? ExprState::UNARY : ExprState::OPERATOR;
+				else if (build.state == ExprState::CLOSE) {
+					if (tk == PARENTH_CLOSE)
+						Log::error_at(tok.loc, "unbalanced parenthesis ", tok.string);
+					Log::error_at(tok.loc, get_terminator(terminator) + "expected");
+				}
+				else if (member_access_operator(tk))
+					state = ExprState::MEMBER;
+				else if (tk == SQUARE_OPEN) {
+					if (!build.id_tree)
+						Log::error_at(tok.loc, "subscript in primary expression ", tok.string);
 
-	void Parser::id_expr(terminator_t &terminator) {
-		Token tok = Compiler::lex->get_next();
+					// the index and ] are read with the [
+					lex->get_next();
+					build.index = lex->get_next();
+					if (!constant_expr(build.index.number) && build.index.number != IDENTIFIER)
+						Log::error("constant expression expected ", build.index.string);
 
-		if (tok.number == IDENTIFIER) {
-			expr_list.push_back(tok);
+					if (!peek_token(SQUARE_CLOSE))
+						Log::error_at(build.index.loc, "expected ", "]");
 
-			if (peek_token(terminator)) {
-				Token tok2 = Compiler::lex->get_next();
-				if (parenth_stack.size() > 0) {
-					Compiler::lex->put_back(tok2);
+					lex->get_next();
+					build.tok = tok;
+					build.state = ExprState::SUBSCRIPT;
+					return;
+				}
+				else if (tk == INCR_OP || tk == DECR_OP)
+					state = ExprState::POSTFIX;
+				else if (build.id_tree && build.depth == 0 && (assignment_operator(tk) || tk == PARENTH_OPEN)) {
+					build.tok.number = NONE;
 					return;
 				}
+				else
+					Log::error_at(tok.loc, get_terminator(terminator) + " expected in id expression but found ", tok.string);
 
-				is_expr_terminator_consumed = true;
-				consumed_terminator = tok2;
+				lex->get_next();
+				build.tok = tok;
+				build.state = state;
 				return;
-			}
-			else if (peek_token(SQUARE_OPEN))
-				subscript_id_access(terminator);
-			else if (peek_binary_operator() || peek_unary_operator()) //peek for binary/unary operators
-				primary_expr(terminator);
-			else if (peek_token(INCR_OP)) //peek for ++
-				postfix_incr_expr(terminator);
-			else if (peek_token(DECR_OP)) //peek for --
-				postfix_decr_expr(terminator);
-			else if (peek_token(DOT_OP) || peek_token(ARROW_OP)) { //peek for . ->
-				Token tok2 = Compiler::lex->get_next();
-				expr_list.push_back(tok2);
-				id_expr(terminator);
-			}
-			else if (peek_assignment_operator() || peek_token(PARENTH_OPEN))
-				return;  //if found do nothing
-			else {
-				tok = Compiler::lex->get_next();
-				std::string st = get_terminator(terminator);
-				Log::error_at(tok.loc, st + " expected in id expression but found ", tok.string);
-				Log::print_tokens(expr_list);
-			}
-			return;
 		}
 
-		Log::print_tokens(expr_list);
-		Log::error_at(tok.loc, " identifier expected but found ", tok.string);
-	}
-
-	void Parser::subscript_id_access(terminator_t &terminator) {
-
-		if (!expect(SQUARE_OPEN))
-			return;
-
-		Token tok = Compiler::lex->get_next();
-		expr_list.push_back(tok);
+		// an operand or an operator before one
+		lex->get_next();
+		build.tok = tok;
 
-		if (peek_constant_expr() || peek_identifier()) {
-			tok = Compiler::lex->get_next();
-			expr_list.push_back(tok);
-
-			if (expect(SQUARE_CLOSE)) {
-				tok = Compiler::lex->get_next();
-				expr_list.push_back(tok);
+		if (expr_literal(tk))
+			build.state = ExprState::LITERAL;
+		else if (tk == IDENTIFIER)
+			build.state = ExprState::IDENT;
+		else if (tk == PARENTH_OPEN) {
+			build.state = ExprState::OPEN;
+			build.depth++;
+		}
+		else if (tk == INCR_OP || tk == DECR_OP)
+			build.state = ExprState::PREFIX;
+		else
+			build.state = unary_operator(tk) ? ExprState::UNARY : ExprState::OPERATOR;
+	}
+
+	void Parser::make_leaf(const Token &tok) {
+
+		// literals and identifiers are pushed, an identifier expression
+		// has no node for a literal
+		if (!build.id_tree) {
+			NodeIndex leaf = Tree::get_primary_expr_mem();
+			PrimaryExpression *node = Tree::primary_expr(leaf);
+			node->tok = tok;
+			node->is_id = tok.number == IDENTIFIER;
+			node->is_oprtr = false;
+			build.primary.push_back(leaf);
+		}
+		else if (tok.number == IDENTIFIER) {
+			NodeIndex leaf = Tree::get_id_expr_mem();
+			IdentifierExpression *node = Tree::id_expr(leaf);
+			node->tok = tok;
+			node->is_id = true;
+			node->is_oprtr = false;
+			build.id.push_back(leaf);
+		}
+	}
+
+	void Parser::make_operator(const Token &tok) {
+
+		// a binary operator takes the last two nodes. ! and ~ don't take
+		// anything, the last one read is put over the whole tree
+		if (!build.id_tree) {
+			if (binary_operator(tok.number) || tok.number == DOT_OP || tok.number == ARROW_OP) {
+				if (build.primary.size() > 1) {
+					NodeIndex oprtr = Tree::get_primary_expr_mem();
+					PrimaryExpression *node = Tree::primary_expr(oprtr);
+					node->tok = tok;
+					node->is_id = false;
+					node->is_oprtr = true;
+					node->oprtr_kind = OperatorType::BINARY;
+					node->right = build.primary.back();
+					build.primary.pop_back();
+					node->left = build.primary.back();
+					build.primary.back() = oprtr;
+				}
+			}
+			else if (tok.number == BIT_COMPL || tok.number == LOG_NOT) {
+				build.has_unary = true;
+				build.unary = tok;
 			}
+			return;
+		}
 
-			//check for multi-dimensional array
-			if (peek_token(SQUARE_OPEN))
-				subscript_id_access(terminator);
-			else if (peek_token(DOT_OP) || peek_token(ARROW_OP)) {
-				Token tok2 = Compiler::lex->get_next();
-				expr_list.push_back(tok2);
-				id_expr(terminator);
+		// same for identifier expressions, with ++ -- & taking the last
+		// node
+		if (binary_operator(tok.number) || tok.number == DOT_OP || tok.number == ARROW_OP) {
+			if (build.id.size() > 1) {
+				NodeIndex oprtr = Tree::get_id_expr_mem();
+				IdentifierExpression *node = Tree::id_expr(oprtr);
+				node->tok = tok;
+				node->is_id = false;
+				node->is_oprtr = true;
+				node->is_subscript = false;
+				node->right = build.id.back();
+				build.id.pop_back();
+				node->left = build.id.back();
+				build.id.back() = oprtr;
 			}
-			else if (peek_token(terminator)) {
-				is_expr_terminator_consumed = false;
-				return;
+		}
+		else if (tok.number == INCR_OP || tok.number == DECR_OP || tok.number == ADDROF_OP) {
+			if (!build.id.empty()) {
+				NodeIndex oprtr = Tree::get_id_expr_mem();
+				IdentifierExpression *node = Tree::id_expr(oprtr);
+				node->tok = tok;
+				node->is_id = false;
+				node->is_oprtr = true;
+				node->is_subscript = false;
+				node->unary = build.id.back();
+				build.id.back() = oprtr;
 			}
-			else if (peek_assignment_operator())
-				return;
-
-			Log::print_tokens(expr_list);
-			Log::error("; , ) expected ");
 		}
-
-		Token tok2 = Compiler::lex->get_next();
-		Log::print_tokens(expr_list);
-		Log::error("constant expression expected ", tok2.string);
 	}
 
-	void Parser::pointer_operator_sequence() {
-		Token tok;
-		//here ARTHM_MUL Token will be changed to PTR_OP
-		while ((tok = Compiler::lex->get_next()).number == ARTHM_MUL) {
-			tok.number = PTR_OP;
-			expr_list.push_back(tok);
-		}
-		Compiler::lex->put_back(tok);
+	NodeIndex Parser::id_expr(terminator_t &terminator) {
+
+		// an identifier with [ ] . -> ++ -- and operators after it, up to
+		// the terminator, an assignment operator or the ( of a call
+		return climb_tree(true, terminator);
 	}
 
 	int Parser::get_pointer_operator_sequence() {
 		int ptr_count = 0;
 		Token tok;
 		//here ARTHM_MUL Token will be changed to PTR_OP
-		while ((tok = Compiler::lex->get_next()).number == ARTHM_MUL)
+		while ((tok = lex->get_next()).number == ARTHM_MUL)
 			ptr_count++;
 
-		Compiler::lex->put_back(tok);
+		lex->unget();
 		return ptr_count;
 	}
 
-	void Parser::pointer_indirection_access(terminator_t &terminator) {
-		// pointer-indirection-access : pointer-operator-sequence id-expression
-		pointer_operator_sequence();
-		if (peek_token(IDENTIFIER))
-			id_expr(terminator);
-		else {
-			Log::error("identifier expected in pointer indirection");
-			Log::print_tokens(expr_list);
-		}
-	}
-
-	IdentifierExpression *Parser::prefix_incr_expr(terminator_t &terminator) {
-
-		// prefix-incr-expression : incr-operator id-expression
-		IdentifierExpression *pridexpr = nullptr;
-
-		if (expect(INCR_OP)) {
-			Token tok = Compiler::lex->get_next();
-			expr_list.push_back(tok);
-		}
-
-		if (peek_token(IDENTIFIER)) {
-			id_expr(terminator);
-			pridexpr = get_id_expr_tree();
-			return pridexpr;
-		}
-
-		Log::print_tokens(expr_list);
-		Log::error("identifier expected ");
-		return nullptr;
-	}
-
-	IdentifierExpression *Parser::prefix_decr_expr(terminator_t &terminator) {
-		IdentifierExpression *pridexpr = nullptr;
-		if (expect(DECR_OP)) {
-			Token tok = Compiler::lex->get_next();
-			expr_list.push_back(tok);
-		}
-		if (peek_token(IDENTIFIER)) {
-			id_expr(terminator);
-			pridexpr = get_id_expr_tree();
-			return pridexpr;
-		}
-
-		Log::print_tokens(expr_list);
-		Log::error("identifier expected ");
-		return nullptr;
-	}
-
-	void Parser::postfix_incr_expr(terminator_t &terminator) {
-
-		Token tok;
-		if (expect(INCR_OP)) {
-			tok = Compiler::lex->get_next();
-			expr_list.push_back(tok);
-		}
-
-		if (peek_token(terminator)) {
-			tok = Compiler::lex->get_next();
-			is_expr_terminator_consumed = true;
-			consumed_terminator = tok;
-			return;
-		}
-
-		tok = Compiler::lex->get_next();
-		Log::print_tokens(expr_list);
-		Log::error_at(tok.loc, "; , ) expected but found " + tok.string);
-
-		return;
-	}
-
-	void Parser::postfix_decr_expr(terminator_t &terminator) {
-
-		if (expect(DECR_OP)) {
-			Token tok = Compiler::lex->get_next();
-			expr_list.push_back(tok);
-		}
-
-		if (peek_token(terminator)) {
-			Token tok = Compiler::lex->get_next();
-			//expr_list.push_back(tok);
-			is_expr_terminator_consumed = true;
-			consumed_terminator = tok;
-			return;
-		}
-
-		Log::print_tokens(expr_list);
-		Log::error("; , ) expected ");
-	}
-
-	IdentifierExpression *Parser::address_of_expr(terminator_t &terminator) {
-		IdentifierExpression *addrexpr = nullptr;
-
-		if (!expect(BIT_AND))
-			return nullptr;
-
-		Token tok = Compiler::lex->get_next();
-		//change Token bitwise and to address of operator
-		tok.number = ADDROF_OP;
-		expr_list.push_back(tok);
-		id_expr(terminator);
-		addrexpr = Tree::get_id_expr_mem();
-		addrexpr = get_id_expr_tree();
-		return addrexpr;
-	}
-
 	SizeOfExpression *Parser::sizeof_expr(terminator_t &terminator) {
 
 		SizeOfExpression *sizeofexpr = Tree::get_sizeof_expr_mem();
@@ -1469,12 +965,11 @@ namespace xlang {
 		expect(PARENTH_CLOSE, true);
 		if (peek_token(terminator)) {
 			is_expr_terminator_consumed = true;
-			consumed_terminator = Compiler::lex->get_next();
+			consumed_terminator = lex->get_next();
 			return sizeofexpr;
 		}
 
-		tok = Compiler::lex->get_next();
-		delete sizeofexpr;
+		tok = lex->get_next();
 		Log::error_at(tok.loc, " ; , expected but found ", tok.string);
 		return nullptr;
 	}
@@ -1486,15 +981,13 @@ namespace xlang {
 		cast_type_specifier(&cstexpr);
 		expect(PARENTH_CLOSE, true);
 		if (peek_token(IDENTIFIER)) {
-			id_expr(terminator);
-			cstexpr->target = get_id_expr_tree();
+			cstexpr->target = id_expr(terminator);
 			return cstexpr;
 		}
 		else {
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			Log::error_at(tok.loc, " identifier expected in cast expression");
 		}
-		delete cstexpr;
 		return nullptr;
 	}
 
@@ -1519,7 +1012,7 @@ namespace xlang {
 			simple_types.clear();
 		}
 		else {
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			Log::error_at(tok.loc, "simple type or record name for casting ");
 			terminator2.clear();
 			terminator2.push_back(PARENTH_CLOSE);
@@ -1533,52 +1026,47 @@ namespace xlang {
 			cstexpr->ptr_oprtr_count = get_pointer_operator_sequence();
 	}
 
-	AssignmentExpression *Parser::assignment_expr(terminator_t &terminator, bool is_left_side_handled) {
+	AssignmentExpression *Parser::assignment_expr(terminator_t &terminator, NodeIndex idexprtree, bool is_left_side_handled) {
 
 		AssignmentExpression *assexpr = nullptr;
-		IdentifierExpression *idexprtree = nullptr;
 		Expression *_expr = nullptr;
-		IdentifierExpression *ptr_ind = nullptr;
+		NodeIndex ptr_ind = NO_NODE;
 
 		Token tok;
 		if (expect_assignment_operator()) {
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			assexpr = Tree::get_assgn_expr_mem();
 			assexpr->tok = tok;
 
 			if (!is_left_side_handled) {
-				idexprtree = get_id_expr_tree();
-
 				if (ptr_oprtr_count > 0) {
 					ptr_ind = Tree::get_id_expr_mem();
-					ptr_ind->is_ptr = true;
-					ptr_ind->ptr_oprtr_count = ptr_oprtr_count;
-					ptr_ind->unary = idexprtree;
+					IdentifierExpression *node = Tree::id_expr(ptr_ind);
+					node->is_ptr = true;
+					node->ptr_oprtr_count = ptr_oprtr_count;
+					node->unary = idexprtree;
 					idexprtree = ptr_ind;
 				}
 				assexpr->id_expr = idexprtree;
 			}
 
-			expr_list.clear();
 			_expr = expression(terminator);
 			assexpr->expression = _expr;
 			return assexpr;
 		}
 
-		tok = Compiler::lex->get_next();
+		tok = lex->get_next();
 		Log::error_at(tok.loc, " assignment operator expected but found ", tok.string);
 
 		return nullptr;
 	}
 
-	CallExpression *Parser::call_expr(terminator_t &terminator) {
+	CallExpression *Parser::call_expr(NodeIndex idexpr, terminator_t &terminator) {
 
 		CallExpression *funccallexp = nullptr;
-		std::list<Expression *> exprlist;
-		IdentifierExpression *idexpr = nullptr;
+		std::vector<Expression *> exprlist;
 		Token tok;
 
-		idexpr = get_id_expr_tree();
 		funccallexp = Tree::get_func_call_expr_mem();
 		funccallexp->function = idexpr;
 
@@ -1591,50 +1079,48 @@ namespace xlang {
 				return funccallexp;
 			}
 			else {
-				tok = Compiler::lex->get_next();
-				Log::error_at(tok.loc, get_terminator(terminator) + " expected in function call but found: " + tok.string);
+				tok = lex->get_next();
+				Log::error_at(tok.loc, get_terminator(terminator) + " expected in function call but found: " + std::string(tok.string));
 			}
 		}
 		else {
 			is_expr_terminator_consumed = false;
-			expr_list.clear();
 			func_call_expr_list(exprlist, terminator);
 
 			if (is_expr_terminator_consumed) {
 				if (consumed_terminator.number == PARENTH_CLOSE) {
 					if (peek_token(terminator)) {
 						consume_next();
-						funccallexp->expression_list = exprlist;
+						funccallexp->expression_list = std::move(exprlist);
 						return funccallexp;
 					}
 					else {
-						tok = Compiler::lex->get_next();
-						Log::error_at(tok.loc, get_terminator(terminator) + " expected in function call but found " + tok.string);
+						tok = lex->get_next();
+						Log::error_at(tok.loc, get_terminator(terminator) + " expected in function call but found " + std::string(tok.string));
 					}
 				}
 				else {
-					tok = Compiler::lex->get_next();
-					Log::error_at(tok.loc, get_terminator(terminator) + " expected in function call but found " + tok.string);
+					tok = lex->get_next();
+					Log::error_at(tok.loc, get_terminator(terminator) + " expected in function call but found " + std::string(tok.string));
 				}
 			}
 			else {
 				expect(PARENTH_CLOSE, true);
 				if (peek_token(terminator)) {
 					consume_next();
-					funccallexp->expression_list = exprlist;
+					funccallexp->expression_list = std::move(exprlist);
 					return funccallexp;
 				}
 
-				tok = Compiler::lex->get_next();
-				Log::error_at(tok.loc, get_terminator(terminator) + " expected in function call but found " + tok.string);
+				tok = lex->get_next();
+				Log::error_at(tok.loc, get_terminator(terminator) + " expected in function call but found " + std::string(tok.string));
 			}
 		}
 
-		Tree::delete_func_call_expr(&funccallexp);
 		return nullptr;
 	}
 
-	void Parser::func_call_expr_list(std::list<Expression *> &exprlist, terminator_t &orig_terminator) {
+	void Parser::func_call_expr_list(std::vector<Expression *> &exprlist, terminator_t &orig_terminator) {
 
 		Expression *_expr = nullptr;
 		Token tok;
@@ -1648,7 +1134,7 @@ namespace xlang {
 				if (consumed_terminator.number == PARENTH_CLOSE) {
 					exprlist.push_back(_expr);
 					//is_expr_terminator_consumed = true;
-					//consumed_terminator = Compiler::lex->get_next();
+					//consumed_terminator = lex->get_next();
 					return;
 				}
 				else if (consumed_terminator.number == COMMA_OP) {
@@ -1667,17 +1153,17 @@ namespace xlang {
 				return;
 			}
 			else {
-				tok = Compiler::lex->get_next();
+				tok = lex->get_next();
 				if (is_expr_terminator_consumed) {
 					if (consumed_terminator.number == PARENTH_CLOSE)
 						return;
 
-					tok = Compiler::lex->get_next();
-					Log::error_at(tok.loc, "invalid Token found in function call parameters " + tok.string);
+					tok = lex->get_next();
+					Log::error_at(tok.loc, "invalid Token found in function call parameters " + std::string(tok.string));
 				}
 				else {
-					tok = Compiler::lex->get_next();
-					Log::error_at(tok.loc, get_terminator(terminator) + " expected in function call but found " + tok.string);
+					tok = lex->get_next();
+					Log::error_at(tok.loc, get_terminator(terminator) + " expected in function call but found " + std::string(tok.string));
 				}
 			}
 		}
@@ -1686,13 +1172,13 @@ namespace xlang {
 				if (consumed_terminator.number == PARENTH_CLOSE)
 					return;
 				else {
-					tok = Compiler::lex->get_next();
-					Log::error_at(tok.loc, "invalid Token found in function call parameters " + tok.string);
+					tok = lex->get_next();
+					Log::error_at(tok.loc, "invalid Token found in function call parameters " + std::string(tok.string));
 				}
 			}
 			else {
-				tok = Compiler::lex->get_next();
-				Log::error_at(tok.loc, get_terminator(terminator) + " expected in function call but found " + tok.string);
+				tok = lex->get_next();
+				Log::error_at(tok.loc, get_terminator(terminator) + " expected in function call but found " + std::string(tok.string));
 			}
 		}
 	}
@@ -1700,13 +1186,10 @@ namespace xlang {
 	Expression *Parser::expression(terminator_t &terminator) {
 
 		Token tok, tok2;
-		std::vector<Token> specifier;
-		std::vector<Token>::iterator lst_it;
-		terminator_t terminator2;
 		SizeOfExpression *sizeofexpr = nullptr;
 		CastExpression *castexpr = nullptr;
-		PrimaryExpression *pexpr = nullptr;
-		IdentifierExpression *idexpr = nullptr;
+		NodeIndex pexpr = NO_NODE;
+		NodeIndex idexpr = NO_NODE;
 		AssignmentExpression *assgnexpr = nullptr;
 		CallExpression *funcclexpr = nullptr;
 		Expression *_expr = Tree::get_expr_mem();
@@ -1714,7 +1197,7 @@ namespace xlang {
 		if (peek_token(terminator))
 			return nullptr;
 
-		tok = Compiler::lex->get_next();
+		tok = lex->get_next();
 
 		switch (tok.number) {
 			case LIT_DECIMAL :
@@ -1727,157 +1210,83 @@ namespace xlang {
 			case ARTHM_SUB :
 			case LOG_NOT :
 			case BIT_COMPL :
-				Compiler::lex->put_back(tok);
-				primary_expr(terminator);
-				pexpr = get_primary_expr_tree();
+				lex->unget();
+				pexpr = primary_expr(terminator);
 
-				if (pexpr == nullptr) {
-					Tree::delete_expr(&_expr);
+				if (pexpr == NO_NODE) {
 					Log::error_at(tok.loc, "unable to parse primary expression");
 				}
 
 				_expr->expr_kind = ExpressionType::PRIMARY_EXPR;
 				_expr->primary_expr = pexpr;
-				expr_list.clear();
-				is_expr_terminator_got = false;
 				break;
 
 			case LIT_STRING :
 				pexpr = Tree::get_primary_expr_mem();
-				pexpr->is_id = false;
-				pexpr->tok = tok;
-				pexpr->is_oprtr = false;
+				Tree::primary_expr(pexpr)->is_id = false;
+				Tree::primary_expr(pexpr)->tok = tok;
+				Tree::primary_expr(pexpr)->is_oprtr = false;
 				_expr->expr_kind = ExpressionType::PRIMARY_EXPR;
 				_expr->primary_expr = pexpr;
 
 				if (!peek_token(terminator)) {
-					Tree::delete_expr(&_expr);
-					Log::error_at(tok.loc, "semicolon expected " + tok.string);
+					Log::error_at(tok.loc, "semicolon expected " + std::string(tok.string));
 				}
-
-				expr_list.clear();
-				is_expr_terminator_got = false;
 				break;
 
 			case IDENTIFIER :
-				//peek for . -> [
-				if (peek_token(DOT_OP) || peek_token(ARROW_OP) || peek_token(SQUARE_OPEN)) {
-					Compiler::lex->put_back(tok, true);
+				//peek for . -> [ ( ++ -- and assignment
+				if (peek_token(DOT_OP) || peek_token(ARROW_OP) || peek_token(SQUARE_OPEN) ||
+					peek_token(PARENTH_OPEN) || peek_token(INCR_OP) || peek_token(DECR_OP) ||
+					peek_assignment_operator()) {
+
+					lex->unget();
+					idexpr = id_expr(terminator);    //get id expression
 
-					id_expr(terminator);    //get id expression
-					if (peek_assignment_operator()) {
-						assgnexpr = assignment_expr(terminator, false);
+					if (!build.terminated && peek_assignment_operator()) {
+						assgnexpr = assignment_expr(terminator, idexpr, false);
 						if (assgnexpr == nullptr) {
-							Log::error("error to parse assignment expression");
-							Tree::delete_expr(&_expr);
+							Log::error_at(tok.loc, "unable to parse assignment expression");
 							return nullptr;
 						}
 						_expr->expr_kind = ExpressionType::ASSGN_EXPR;
 						_expr->assgn_expr = assgnexpr;
 					}
-					else if (peek_token(terminator)) {
-						tok2 = Compiler::lex->get_next();
-						is_expr_terminator_consumed = true;
-						consumed_terminator = tok2;
-						//get id expression tree
-						idexpr = get_id_expr_tree();
-						if (idexpr == nullptr) {
-							Tree::delete_expr(&_expr);
-							Log::error_at(tok.loc, "unable to parse id expression");
-						}
-						_expr->expr_kind = ExpressionType::ID_EXPR;
-						_expr->id_expr = idexpr;
-					}
-					else if (peek_token(PARENTH_OPEN)) {
-						funcclexpr = call_expr(terminator);
+					else if (!build.terminated && peek_token(PARENTH_OPEN)) {
+						funcclexpr = call_expr(idexpr, terminator);
 						if (funcclexpr == nullptr) {
-							Tree::delete_expr(&_expr);
-							Log::error_at(tok.loc, "error to parse function call expression");
+							Log::error_at(tok.loc, "unable to parse function call expression");
 							return nullptr;
 						}
-
 						_expr->expr_kind = ExpressionType::FUNC_CALL_EXPR;
 						_expr->call_expr = funcclexpr;
 					}
-					else if (peek_token(PARENTH_CLOSE)) {
-						// nothing
-					}
 					else {
-						idexpr = get_id_expr_tree();
-						if (idexpr == nullptr) {
-							Tree::delete_expr(&_expr);
+						if (idexpr == NO_NODE) {
 							Log::error_at(tok.loc, "unable to parse id expression");
 						}
 						_expr->expr_kind = ExpressionType::ID_EXPR;
 						_expr->id_expr = idexpr;
 					}
-
-					expr_list.clear();
-					is_expr_terminator_got = false;
-				}
-				else if (peek_token(PARENTH_OPEN)) {
-
-					Compiler::lex->put_back(tok, true);
-					id_expr(terminator);
-					funcclexpr = call_expr(terminator);
-					if (funcclexpr == nullptr) {
-						Tree::delete_expr(&_expr);
-						Log::error_at(tok.loc, "unable to parse function call expression");
-					}
-					_expr->expr_kind = ExpressionType::FUNC_CALL_EXPR;
-					_expr->call_expr = funcclexpr;
-				}
-				else if (peek_token(INCR_OP) || peek_token(DECR_OP)) {
-
-					Compiler::lex->put_back(tok, true);
-					id_expr(terminator);
-					idexpr = get_id_expr_tree();
-					if (idexpr == nullptr) {
-						Tree::delete_expr(&_expr);
-						Log::error_at(tok.loc, "unable to parse id expression");
-
-					}
-					_expr->expr_kind = ExpressionType::ID_EXPR;
-					_expr->id_expr = idexpr;
 				}
 				else {
-
-					Compiler::lex->put_back(tok, true);
-					primary_expr(terminator);
-					if (peek_assignment_operator()) {
-						assgnexpr = assignment_expr(terminator, false);
-						if (assgnexpr == nullptr) {
-							Tree::delete_expr(&_expr);
-							Log::error_at(tok.loc, "unable to parse assignment expression");
-							return nullptr;
-						}
-						_expr->expr_kind = ExpressionType::ASSGN_EXPR;
-						_expr->assgn_expr = assgnexpr;
-					}
-					else {
-						pexpr = get_primary_expr_tree();
-						if (pexpr == nullptr) {
-							Tree::delete_expr(&_expr);
-							Log::error_at(tok.loc, "unable to parse primary expression");
-						}
-						_expr->expr_kind = ExpressionType::PRIMARY_EXPR;
-						_expr->primary_expr = pexpr;
-						is_expr_terminator_got = false;
+					lex->unget();
+					pexpr = primary_expr(terminator);
+					if (pexpr == NO_NODE) {
+						Log::error_at(tok.loc, "unable to parse primary expression");
 					}
+					_expr->expr_kind = ExpressionType::PRIMARY_EXPR;
+					_expr->primary_expr = pexpr;
 				}
-				expr_list.clear();
-				is_expr_terminator_got = false;
 				break;
 
 			case PARENTH_OPEN :
-				tok2 = Compiler::lex->get_next();
+				tok2 = lex->get_next();
 
-				if (type_specifier(tok2.number) || SymbolTable::search_record(Compiler::record_table, tok2.string)) {
-					Compiler::lex->put_back(tok);
-					Compiler::lex->put_back(tok2);
+				if (type_specifier(tok2.number) || known_record(tok2)) {
+					lex->unget(2);
 					castexpr = cast_expr(terminator);
 					if (castexpr == nullptr) {
-						Tree::delete_expr(&_expr);
 						Log::error_at(tok.loc, "unable to parse cast expression");
 					}
 					_expr->expr_kind = ExpressionType::CAST_EXPR;
@@ -1886,103 +1295,57 @@ namespace xlang {
 				else if (tok2.number == END)
 					return nullptr;
 				else {
-					Compiler::lex->put_back(tok);
-					Compiler::lex->put_back(tok2);
-					primary_expr(terminator);
-					pexpr = get_primary_expr_tree();
-					if (pexpr == nullptr) {
-						Tree::delete_expr(&_expr);
+					lex->unget(2);
+					pexpr = primary_expr(terminator);
+					if (pexpr == NO_NODE) {
 						Log::error_at(tok.loc, "unable to parse primary expression");
 					}
 					_expr->expr_kind = ExpressionType::PRIMARY_EXPR;
 					_expr->primary_expr = pexpr;
 				}
-
-				expr_list.clear();
-				is_expr_terminator_got = false;
 				break;
 
 			case ARTHM_MUL :
-				Compiler::lex->put_back(tok);
-				pointer_indirection_access(terminator);
-
-				lst_it = expr_list.begin();
-				while (lst_it != expr_list.end()) {
-					if ((*lst_it).number == PTR_OP) {
-						ptr_oprtr_count++;
-						expr_list.erase(lst_it);
-						lst_it = expr_list.begin();
-					}
-					else
-						break;
-				}
+				// pointer-indirection-access : pointer-operator-sequence id-expression
+				lex->unget();
+				ptr_oprtr_count += get_pointer_operator_sequence();
+				if (!peek_token(IDENTIFIER))
+					Log::error("identifier expected in pointer indirection");
 
-				if (peek_assignment_operator()) {
-					assgnexpr = assignment_expr(terminator, false);
+				idexpr = id_expr(terminator);
+
+				if (!build.terminated && peek_assignment_operator()) {
+					assgnexpr = assignment_expr(terminator, idexpr, false);
 					if (assgnexpr == nullptr) {
-						Tree::delete_expr(&_expr);
 						Log::error_at(tok.loc, "unable to parse assignment expression");
 					}
 					_expr->expr_kind = ExpressionType::ASSGN_EXPR;
 					_expr->assgn_expr = assgnexpr;
 				}
 				else {
-					idexpr = get_id_expr_tree();
-					if (idexpr == nullptr) {
-						Tree::delete_expr(&_expr);
+					if (idexpr == NO_NODE) {
 						Log::error("error to parse pointer indirection expression");
 					}
 
-					idexpr->is_ptr = true;
-					idexpr->ptr_oprtr_count = ptr_oprtr_count;
+					Tree::id_expr(idexpr)->is_ptr = true;
+					Tree::id_expr(idexpr)->ptr_oprtr_count = ptr_oprtr_count;
 					_expr->expr_kind = ExpressionType::ID_EXPR;
 					_expr->id_expr = idexpr;
 					ptr_oprtr_count = 0;
 				}
-
-				expr_list.clear();
-				is_expr_terminator_got = false;
 				break;
 
 			case INCR_OP :
-				Compiler::lex->put_back(tok);
-				idexpr = prefix_incr_expr(terminator);
-				if (idexpr == nullptr) {
-					Tree::delete_expr(&_expr);
-					Log::error_at(tok.loc, "unable to parse increment expression");
-				}
-
-				if (peek_assignment_operator()) {
-					assgnexpr = assignment_expr(terminator, true);
-					if (assgnexpr == nullptr) {
-						Tree::delete_expr(&_expr);
-						Log::error_at(tok.loc, "error to parse passignment expression");
-					}
-					_expr->expr_kind = ExpressionType::ASSGN_EXPR;
-					assgnexpr->id_expr = idexpr;
-					_expr->assgn_expr = assgnexpr;
-				}
-				else {
-					_expr->expr_kind = ExpressionType::ID_EXPR;
-					_expr->id_expr = idexpr;
-				}
-				expr_list.clear();
-				is_expr_terminator_got = false;
-				break;
-
 			case DECR_OP :
-				Compiler::lex->put_back(tok);
-				idexpr = prefix_decr_expr(terminator);
-				if (idexpr == nullptr) {
-					Tree::delete_expr(&_expr);
-					Log::error_at(tok.loc, "error to parse decrement expression");
+				// prefix-incr-expression : incr-operator id-expression
+				idexpr = climb_tree(true, terminator, &tok);
+				if (idexpr == NO_NODE) {
+					Log::error_at(tok.loc, "unable to parse increment expression");
 				}
 
-				//peek for assignment operator
-				if (peek_assignment_operator()) {
-					assgnexpr = assignment_expr(terminator, true);
+				if (!build.terminated && peek_assignment_operator()) {
+					assgnexpr = assignment_expr(terminator, idexpr, true);
 					if (assgnexpr == nullptr) {
-						Tree::delete_expr(&_expr);
 						Log::error_at(tok.loc, "unable to parse assignment expression");
 					}
 					_expr->expr_kind = ExpressionType::ASSGN_EXPR;
@@ -1993,29 +1356,24 @@ namespace xlang {
 					_expr->expr_kind = ExpressionType::ID_EXPR;
 					_expr->id_expr = idexpr;
 				}
-				expr_list.clear();
-				is_expr_terminator_got = false;
 				break;
 
 			case BIT_AND :
-				Compiler::lex->put_back(tok);
-				idexpr = address_of_expr(terminator);
-				if (idexpr == nullptr) {
-					Tree::delete_expr(&_expr);
+				//change Token bitwise and to address of operator
+				tok.number = ADDROF_OP;
+				idexpr = climb_tree(true, terminator, &tok);
+				if (idexpr == NO_NODE) {
 					Log::error_at(tok.loc, "error to parse addressof expression");
 				}
 
 				_expr->expr_kind = ExpressionType::ID_EXPR;
 				_expr->id_expr = idexpr;
-				expr_list.clear();
-				is_expr_terminator_got = false;
 				break;
 
 			case KEY_SIZEOF :
-				Compiler::lex->put_back(tok);
+				lex->unget();
 				sizeofexpr = sizeof_expr(terminator);
 				if (sizeofexpr == nullptr) {
-					Tree::delete_expr(&_expr);
 					Log::error_at(tok.loc, "error to parse sizeof expression");
 				}
 				_expr->expr_kind = ExpressionType::SIZEOF_EXPR;
@@ -2024,9 +1382,6 @@ namespace xlang {
 
 			case PARENTH_CLOSE :
 			case SEMICOLON :
-				Tree::delete_expr(&_expr);
-				expr_list.clear();
-				is_expr_terminator_got = false;
 				is_expr_terminator_consumed = true;
 				consumed_terminator = tok;
 				return nullptr;
@@ -2048,11 +1403,11 @@ namespace xlang {
 		bool isextrn = false;
 
 		if (record_head(&tok, &isglob, &isextrn)) {
-			if (SymbolTable::search_record(Compiler::record_table, tok.string))
-				Log::error_at(tok.loc, "record " + tok.string + " already exists");
+			if (SymbolTable::search_record(comp->record_table, tok.name))
+				Log::error_at(tok.loc, "record " + std::string(tok.string) + " already exists");
 
-			SymbolTable::insert_record(&Compiler::record_table, tok.string);
-			rec = Compiler::last_rec_node;
+			last_rec_node = SymbolTable::insert_record(&comp->record_table, tok);
+			rec = last_rec_node;
 			rec->is_global = isglob;
 			rec->is_extern = isextrn;
 			rec->recordtok = tok;
@@ -2077,7 +1432,7 @@ namespace xlang {
 		}
 		if (expect(KEY_RECORD, true)) {
 			if (expect(IDENTIFIER, false)) {
-				*tok = Compiler::lex->get_next();
+				*tok = lex->get_next();
 				return true;
 			}
 		}
@@ -2090,8 +1445,8 @@ namespace xlang {
 		std::vector<Token> types;
 		TypeInfo *typeinf = nullptr;
 
-		while ((tok = Compiler::lex->get_next()).number != END) {
-			Compiler::lex->put_back(tok);
+		while ((tok = lex->get_next()).number != END) {
+			lex->unget();
 			if (peek_type_specifier() || peek_token(IDENTIFIER)) {
 				get_type_specifier(types);
 				typeinf = SymbolTable::get_type_info_mem();
@@ -2099,13 +1454,13 @@ namespace xlang {
 				typeinf->type_specifier.simple_type.clear();
 				typeinf->type_specifier.simple_type.assign(types.begin(), types.end());
 				if (types.size() == 1 && types[0].number == IDENTIFIER) {
-					if (SymbolTable::search_record(Compiler::record_table, types[0].string)) {
+					if (SymbolTable::search_record(comp->record_table, types[0].name)) {
 						typeinf->type = NodeType::RECORD;
 						typeinf->type_specifier.record_type = types[0];
 						typeinf->type_specifier.simple_type.clear();
 					}
 					else
-						Log::error_at(types[0].loc, "record '" + types[0].string + "' does not exists");
+						Log::error_at(types[0].loc, "record '" + std::string(types[0].string) + "' does not exists");
 				}
 				consume_n(types.size());
 				rec_id_list(rec, &typeinf);
@@ -2127,24 +1482,24 @@ namespace xlang {
 		if (peek_token(IDENTIFIER)) {
 
 			expect(IDENTIFIER, false);
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 
-			if (SymbolTable::search_symbol((*rec)->symtab, tok.string))
-				Log::error_at(tok.loc, "redeclaration of " + tok.string);
+			if (SymbolTable::search_symbol((*rec)->symtab, tok.name))
+				Log::error_at(tok.loc, "redeclaration of " + std::string(tok.string));
 			else {
-				SymbolTable::insert_symbol(&symt, tok.string);
-				assert(Compiler::last_symbol != nullptr);
-				Compiler::last_symbol->type_info = *typeinf;
-				Compiler::last_symbol->symbol = tok.string;
-				Compiler::last_symbol->tok = tok;
+				last_symbol = SymbolTable::insert_symbol(&symt, tok);
+				assert(last_symbol != nullptr);
+				last_symbol->type_info = *typeinf;
+				last_symbol->symbol = tok.string;
+				last_symbol->tok = tok;
 			}
 
 			if (peek_token(SQUARE_OPEN)) {
 				sublst.clear();
 				rec_subscript_member(sublst);
-				assert(Compiler::last_symbol != nullptr);
-				Compiler::last_symbol->is_array = true;
-				Compiler::last_symbol->arr_dimension_list.assign(sublst.begin(), sublst.end());
+				assert(last_symbol != nullptr);
+				last_symbol->is_array = true;
+				last_symbol->arr_dimension_list.assign(sublst.begin(), sublst.end());
 				sublst.clear();
 			}
 			else if (peek_token(COMMA_OP)) {
@@ -2161,25 +1516,25 @@ namespace xlang {
 			else {
 
 				expect(IDENTIFIER, false);
-				tok = Compiler::lex->get_next();
-				if (SymbolTable::search_symbol((*rec)->symtab, tok.string))
-					Log::error_at(tok.loc, "redeclaration of " + tok.string);
+				tok = lex->get_next();
+				if (SymbolTable::search_symbol((*rec)->symtab, tok.name))
+					Log::error_at(tok.loc, "redeclaration of " + std::string(tok.string));
 				else {
-					SymbolTable::insert_symbol(&symt, tok.string);
-					assert(Compiler::last_symbol != nullptr);
-					Compiler::last_symbol->type_info = *typeinf;
-					Compiler::last_symbol->symbol = tok.string;
-					Compiler::last_symbol->tok = tok;
-					Compiler::last_symbol->is_ptr = true;
-					Compiler::last_symbol->ptr_oprtr_count = ptr_seq;
+					last_symbol = SymbolTable::insert_symbol(&symt, tok);
+					assert(last_symbol != nullptr);
+					last_symbol->type_info = *typeinf;
+					last_symbol->symbol = tok.string;
+					last_symbol->tok = tok;
+					last_symbol->is_ptr = true;
+					last_symbol->ptr_oprtr_count = ptr_seq;
 				}
 
 				if (peek_token(SQUARE_OPEN)) {
 					sublst.clear();
 					rec_subscript_member(sublst);
-					assert(Compiler::last_symbol != nullptr);
-					Compiler::last_symbol->is_array = true;
-					Compiler::last_symbol->arr_dimension_list.assign(sublst.begin(), sublst.end());
+					assert(last_symbol != nullptr);
+					last_symbol->is_array = true;
+					last_symbol->arr_dimension_list.assign(sublst.begin(), sublst.end());
 					sublst.clear();
 				}
 				else if (peek_token(COMMA_OP)) {
@@ -2191,8 +1546,8 @@ namespace xlang {
 		else if (peek_token(PARENTH_OPEN))
 			rec_func_pointer_member(&(*rec), &ptr_seq, &(*typeinf));
 		else {
-			tok = Compiler::lex->get_next();
-			Log::error_at(tok.loc, "identifier expected in record member definition but found " + tok.string);
+			tok = lex->get_next();
+			Log::error_at(tok.loc, "identifier expected in record member definition but found " + std::string(tok.string));
 		}
 	}
 
@@ -2201,12 +1556,12 @@ namespace xlang {
 		Token tok;
 		expect(SQUARE_OPEN, true);
 		if (peek_constant_expr()) {
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			sublst.push_back(tok);
 		}
 		else {
-			tok = Compiler::lex->get_next();
-			Log::error_at(tok.loc, "constant expression expected but found " + tok.string);
+			tok = lex->get_next();
+			Log::error_at(tok.loc, "constant expression expected but found " + std::string(tok.string));
 		}
 
 		expect(SQUARE_CLOSE, true);
@@ -2225,18 +1580,18 @@ namespace xlang {
 
 		if (peek_token(IDENTIFIER)) {
 			expect(IDENTIFIER, false);
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 
-			if (SymbolTable::search_symbol((*rec)->symtab, tok.string))
-				Log::error_at(tok.loc, "redeclaration of func pointer " + tok.string);
+			if (SymbolTable::search_symbol((*rec)->symtab, tok.name))
+				Log::error_at(tok.loc, "redeclaration of func pointer " + std::string(tok.string));
 			else {
-				SymbolTable::insert_symbol(&symt, tok.string);
-				assert(Compiler::last_symbol != nullptr);
-				Compiler::last_symbol->type_info = *typeinf;
-				Compiler::last_symbol->is_func_ptr = true;
-				Compiler::last_symbol->symbol = tok.string;
-				Compiler::last_symbol->tok = tok;
-				Compiler::last_symbol->ret_ptr_count = *ptrseq;
+				last_symbol = SymbolTable::insert_symbol(&symt, tok);
+				assert(last_symbol != nullptr);
+				last_symbol->type_info = *typeinf;
+				last_symbol->is_func_ptr = true;
+				last_symbol->symbol = tok.string;
+				last_symbol->tok = tok;
+				last_symbol->ret_ptr_count = *ptrseq;
 
 				expect(PARENTH_CLOSE, true);
 				expect(PARENTH_OPEN, true);
@@ -2244,14 +1599,14 @@ namespace xlang {
 				if (peek_token(PARENTH_CLOSE))
 					consume_next();
 				else {
-					rec_func_pointer_params(&(Compiler::last_symbol));
+					rec_func_pointer_params(&(last_symbol));
 					expect(PARENTH_CLOSE, true);
 				}
 			}
 			return;
 		}
 
-		tok = Compiler::lex->get_next();
+		tok = lex->get_next();
 		Log::error_at(tok.loc, "identifier expected in record func pointer member definition");
 	}
 
@@ -2292,7 +1647,7 @@ namespace xlang {
 			return;
 		}
 		else if (peek_token(IDENTIFIER)) {
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			rectype->type = NodeType::RECORD;
 			rectype->type_specifier.record_type = tok;
 			(*stinf)->func_ptr_params_list.push_back(rectype);
@@ -2311,9 +1666,8 @@ namespace xlang {
 			return;
 		}
 
-		SymbolTable::delete_rec_type_info(&rectype);
-		tok = Compiler::lex->get_next();
-		Log::error_at(tok.loc, "type specifier expected in record func ptr member definition but found " + tok.string);
+		tok = lex->get_next();
+		Log::error_at(tok.loc, "type specifier expected in record func ptr member definition but found " + std::string(tok.string));
 	}
 
 	void Parser::simple_declaration(Token scope, std::vector<Token> &types, bool is_record_type, Node **st) {
@@ -2374,23 +1728,22 @@ namespace xlang {
 			return;
 
 		if (peek_token(IDENTIFIER)) {
-			Compiler::lex->reverse_tokens_queue();
-			tok = Compiler::lex->get_next();
-			if (SymbolTable::search_symbol((*st), tok.string)) {
-				Log::error_at(tok.loc, "redeclaration/conflicting types of " + tok.string);
+			tok = lex->get_next();
+			if (SymbolTable::search_symbol((*st), tok.name)) {
+				Log::error_at(tok.loc, "redeclaration/conflicting types of " + std::string(tok.string));
 				return;
 			}
 			else {
-				SymbolTable::insert_symbol(&(*st), tok.string);
-				if (Compiler::last_symbol == nullptr)
+				last_symbol = SymbolTable::insert_symbol(&(*st), tok);
+				if (last_symbol == nullptr)
 					return;
-				Compiler::last_symbol->symbol = tok.string;
-				Compiler::last_symbol->tok = tok;
-				Compiler::last_symbol->type_info = *stinf;
+				last_symbol->symbol = tok.string;
+				last_symbol->tok = tok;
+				last_symbol->type_info = *stinf;
 			}
 			if (peek_token(SQUARE_OPEN)) {
-				Compiler::last_symbol->is_array = true;
-				subscript_declarator(&Compiler::last_symbol);
+				last_symbol->is_array = true;
+				subscript_declarator(&last_symbol);
 			}
 			if (peek_token(COMMA_OP)) {
 				consume_next();
@@ -2403,29 +1756,29 @@ namespace xlang {
 			ptr_seq = get_pointer_operator_sequence();
 			ptr_oprtr_count = ptr_seq;
 			if (peek_token(IDENTIFIER)) {
-				tok = Compiler::lex->get_next();
-				if (SymbolTable::search_symbol((*st), tok.string)) {
-					Log::error_at(tok.loc, "redeclaration/conflicting types of " + tok.string);
+				tok = lex->get_next();
+				if (SymbolTable::search_symbol((*st), tok.name)) {
+					Log::error_at(tok.loc, "redeclaration/conflicting types of " + std::string(tok.string));
 					return;
 				}
 				else {
-					SymbolTable::insert_symbol(&(*st), tok.string);
-					if (Compiler::last_symbol == nullptr)
+					last_symbol = SymbolTable::insert_symbol(&(*st), tok);
+					if (last_symbol == nullptr)
 						return;
-					Compiler::last_symbol->symbol = tok.string;
-					Compiler::last_symbol->tok = tok;
-					Compiler::last_symbol->type_info = *stinf;
-					Compiler::last_symbol->is_ptr = true;
-					Compiler::last_symbol->ptr_oprtr_count = ptr_seq;
+					last_symbol->symbol = tok.string;
+					last_symbol->tok = tok;
+					last_symbol->type_info = *stinf;
+					last_symbol->is_ptr = true;
+					last_symbol->ptr_oprtr_count = ptr_seq;
 				}
 
 				if (peek_token(SQUARE_OPEN)) {
-					Compiler::last_symbol->is_array = true;
-					subscript_declarator(&Compiler::last_symbol);
+					last_symbol->is_array = true;
+					subscript_declarator(&last_symbol);
 				}
 				else if (peek_token(ASSGN)) {
 					consume_next();
-					subscript_initializer(Compiler::last_symbol->arr_init_list);
+					subscript_initializer(last_symbol->arr_init_list);
 				}
 				else if (peek_token(SEMICOLON)) {
 					return;
@@ -2441,15 +1794,15 @@ namespace xlang {
 				}
 			}
 			else {
-				tok = Compiler::lex->get_next();
+				tok = lex->get_next();
 				Log::error_at(tok.loc, "identifier expected in declaration");
 				return;
 			}
 		}
 		else {
-			tok = Compiler::lex->get_next();
-			Log::error_at(tok.loc, "identifier expected in declaration but found " + tok.string);
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
+			Log::error_at(tok.loc, "identifier expected in declaration but found " + std::string(tok.string));
+			tok = lex->get_next();
 			return;
 		}
 	}
@@ -2458,14 +1811,14 @@ namespace xlang {
 		Token tok;
 		expect(SQUARE_OPEN, true);
 		if (peek_constant_expr()) {
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			(*stsinf)->arr_dimension_list.push_back(tok);
 		}
 		else if (peek_token(SQUARE_CLOSE)) { ;
 		}
 		else {
-			tok = Compiler::lex->get_next();
-			Log::error_at(tok.loc, "constant expression expected but found " + tok.string);
+			tok = lex->get_next();
+			Log::error_at(tok.loc, "constant expression expected but found " + std::string(tok.string));
 		}
 
 		expect(SQUARE_CLOSE, true);
@@ -2485,7 +1838,7 @@ namespace xlang {
 		Token tok;
 		std::vector<Token> ltrl;
 		if (peek_token(LIT_STRING)) {
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			ltrl.push_back(tok);
 			arrinit.push_back(ltrl);
 			ltrl.clear();
@@ -2500,8 +1853,8 @@ namespace xlang {
 			else if (peek_token(CURLY_OPEN))
 				subscript_initializer(arrinit);
 			else {
-				tok = Compiler::lex->get_next();
-				Log::error_at(tok.loc, "literal expected in array initializer but found " + tok.string);
+				tok = lex->get_next();
+				Log::error_at(tok.loc, "literal expected in array initializer but found " + std::string(tok.string));
 			}
 
 			expect(CURLY_CLOSE, true);
@@ -2515,12 +1868,12 @@ namespace xlang {
 	void Parser::literal_list(std::vector<Token> &ltrl) {
 		Token tok;
 		if (peek_literal_string()) {
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			ltrl.push_back(tok);
 		}
 		else {
-			tok = Compiler::lex->get_next();
-			Log::error_at(tok.loc, "literal expected in array initializer but found " + tok.string);
+			tok = lex->get_next();
+			Log::error_at(tok.loc, "literal expected in array initializer but found " + std::string(tok.string));
 		}
 
 		if (peek_token(COMMA_OP)) {
@@ -2553,7 +1906,7 @@ namespace xlang {
 			(*stfinf)->return_type->type = NodeType::SIMPLE;
 			(*stfinf)->return_type->type_specifier.simple_type.assign(types.begin(), types.end());
 
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			(*stfinf)->func_name = _funcname.string;
 			(*stfinf)->tok = _funcname;
 
@@ -2576,7 +1929,7 @@ namespace xlang {
 			(*stfinf)->return_type->type = NodeType::RECORD;
 			(*stfinf)->return_type->type_specifier.record_type = types[0];
 
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			(*stfinf)->func_name = _funcname.string;
 			(*stfinf)->tok = _funcname;
 
@@ -2615,7 +1968,7 @@ namespace xlang {
 			}
 
 			if (peek_token(IDENTIFIER)) {
-				tok = Compiler::lex->get_next();
+				tok = lex->get_next();
 				funcparam->symbol_info->symbol = tok.string;
 				funcparam->symbol_info->tok = tok;
 			}
@@ -2628,7 +1981,7 @@ namespace xlang {
 			return;
 		}
 		else if (peek_token(IDENTIFIER)) {
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			funcparam->type_info->type = NodeType::RECORD;
 			funcparam->type_info->type_specifier.record_type = tok;
 			funcparam->symbol_info->type_info = funcparam->type_info;
@@ -2642,7 +1995,7 @@ namespace xlang {
 			}
 
 			if (peek_token(IDENTIFIER)) {
-				tok = Compiler::lex->get_next();
+				tok = lex->get_next();
 				funcparam->symbol_info->symbol = tok.string;
 				funcparam->symbol_info->tok = tok;
 			}
@@ -2655,16 +2008,15 @@ namespace xlang {
 			return;
 		}
 
-		SymbolTable::delete_func_param_info(&funcparam);
-		tok = Compiler::lex->get_next();
-		Log::error_at(tok.loc, "type specifier expected in function declaration parameters but found " + tok.string);
+		tok = lex->get_next();
+		Log::error_at(tok.loc, "type specifier expected in function declaration parameters but found " + std::string(tok.string));
 	}
 
 	LabelStatement *Parser::labled_statement() {
 		LabelStatement *labstmt = Tree::get_label_stmt_mem();
 		Token tok;
 		expect(IDENTIFIER, false);
-		tok = Compiler::lex->get_next();
+		tok = lex->get_next();
 		labstmt->label = tok;
 		expect(COLON_OP, true);
 		return labstmt;
@@ -2683,7 +2035,7 @@ namespace xlang {
 		SelectStatement *selstmt = Tree::get_select_stmt_mem();
 
 		expect(KEY_IF, false);
-		tok = Compiler::lex->get_next();
+		tok = lex->get_next();
 
 		selstmt->iftok = tok;
 		expect(PARENTH_OPEN, true);
@@ -2698,7 +2050,7 @@ namespace xlang {
 			expect(CURLY_CLOSE, true);
 		}
 		if (peek_token(KEY_ELSE)) {
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			selstmt->elsetok = tok;
 			expect(CURLY_OPEN, true);
 			if (peek_token(CURLY_CLOSE))
@@ -2721,7 +2073,7 @@ namespace xlang {
 
 			expect(KEY_WHILE, false);
 			itstmt->type = IterationType::WHILE;
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			itstmt->_while.whiletok = tok;
 			expect(PARENTH_OPEN, true);
 			itstmt->_while.condition = expression(terminator);
@@ -2744,7 +2096,7 @@ namespace xlang {
 		else if (peek_token(KEY_DO)) {
 			expect(KEY_DO, false);
 			itstmt->type = IterationType::DOWHILE;
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			itstmt->_dowhile.dotok = tok;
 			expect(CURLY_OPEN, true);
 
@@ -2756,7 +2108,7 @@ namespace xlang {
 			}
 
 			expect(KEY_WHILE, false);
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			itstmt->_dowhile.whiletok = tok;
 			expect(PARENTH_OPEN, true);
 			itstmt->_dowhile.condition = expression(terminator);
@@ -2772,7 +2124,7 @@ namespace xlang {
 		else if (peek_token(KEY_FOR)) {
 			itstmt->type = IterationType::FOR;
 			expect(KEY_FOR, false);
-			tok = Compiler::lex->get_next();
+			tok = lex->get_next();
 			itstmt->_for.fortok = tok;
 			expect(PARENTH_OPEN, true);
 			terminator.clear();
@@ -2783,7 +2135,7 @@ namespace xlang {
 			else if (peek_expr_token())
 				itstmt->_for.init_expr = expression(terminator);
 			else {
-				tok = Compiler::lex->get_next();
+				tok = lex->get_next();
 				Log::error_at(tok.loc, "expression or ; expected in for()");
 			}
 
@@ -2792,7 +2144,7 @@ namespace xlang {
 			terminator.push_back(PARENTH_CLOSE);
 
 			if (peek_token(PARENTH_CLOSE)) {
-				tok = Compiler::lex->get_next();
+				tok = lex->get_next();
 				is_expr_terminator_consumed = true;
 				consumed_terminator = tok;
 			}
@@ -2840,21 +2192,21 @@ namespace xlang {
 		switch (get_peek_token()) {
 			case KEY_BREAK :
 				jmpstmt->type = JumpType::BREAK;
-				tok = Compiler::lex->get_next();
+				tok = lex->get_next();
 				jmpstmt->tok = tok;
 				expect(SEMICOLON, true, ";", " in break statement");
 				break;
 
 			case KEY_CONTINUE :
 				jmpstmt->type = JumpType::CONTINUE;
-				tok = Compiler::lex->get_next();
+				tok = lex->get_next();
 				jmpstmt->tok = tok;
 				expect(SEMICOLON, true, ";", " in continue statement");
 				break;
 
 			case KEY_RETURN :
 				jmpstmt->type = JumpType::RETURN;
-				tok = Compiler::lex->get_next();
+				tok = lex->get_next();
 				jmpstmt->tok = tok;
 
 				if (peek_token(SEMICOLON))
@@ -2865,10 +2217,10 @@ namespace xlang {
 
 			case KEY_GOTO :
 				jmpstmt->type = JumpType::GOTO;
-				tok = Compiler::lex->get_next();
+				tok = lex->get_next();
 				jmpstmt->tok = tok;
 				expect(IDENTIFIER, false, "", "label in goto statement");
-				tok = Compiler::lex->get_next();
+				tok = lex->get_next();
 				jmpstmt->goto_id = tok;
 				expect(SEMICOLON, true, ";", " in goto statement");
 				break;
@@ -2890,8 +2242,8 @@ namespace xlang {
 		if (peek_token(CURLY_CLOSE))
 			consume_next();
 		else {
-			tok = Compiler::lex->get_next();
-			Log::error_at(tok.loc, ", or } expected before \"" + tok.string + "\" in asm statement ");
+			tok = lex->get_next();
+			Log::error_at(tok.loc, ", or } expected before \"" + std::string(tok.string) + "\" in asm statement ");
 		}
 
 		return asmhead;
@@ -2903,7 +2255,7 @@ namespace xlang {
 		AsmStatement *asmstmt = Tree::get_asm_stmt_mem();
 
 		expect(LIT_STRING, false);
-		tok = Compiler::lex->get_next();
+		tok = lex->get_next();
 		asmstmt->asm_template = tok;
 
 		if (peek_token(SQUARE_OPEN)) {
@@ -2916,8 +2268,8 @@ namespace xlang {
 				expect(COLON_OP, true);
 			}
 			else {
-				tok = Compiler::lex->get_next();
-				Log::error_at(tok.loc, "output Operand expected " + tok.string);
+				tok = lex->get_next();
+				Log::error_at(tok.loc, "output Operand expected " + std::string(tok.string));
 				return;
 			}
 
@@ -2928,8 +2280,8 @@ namespace xlang {
 				expect(SQUARE_CLOSE, true);
 			}
 			else {
-				tok = Compiler::lex->get_next();
-				Log::error_at(tok.loc, "input Operand expected " + tok.string);
+				tok = lex->get_next();
+				Log::error_at(tok.loc, "input Operand expected " + std::string(tok.string));
 				return;
 			}
 
@@ -2954,7 +2306,7 @@ namespace xlang {
 		terminator_t terminator = {PARENTH_CLOSE};
 		AsmOperand *asmoprd = Tree::get_asm_operand_mem();
 		expect(LIT_STRING, false);
-		tok = Compiler::lex->get_next();
+		tok = lex->get_next();
 		asmoprd->constraint = tok;
 		expect(PARENTH_OPEN, true);
 
@@ -2978,8 +2330,8 @@ namespace xlang {
 			return;
 		}
 		else {
-			tok = Compiler::lex->get_next();
-			Log::error_at(tok.loc, " expression expected " + tok.string);
+			tok = lex->get_next();
+			Log::error_at(tok.loc, " expression expected " + std::string(tok.string));
 			return;
 		}
 	}
@@ -2992,11 +2344,11 @@ namespace xlang {
 		Statement *stmthead = nullptr;
 		Statement *statement = nullptr;
 
-		while ((tok = Compiler::lex->get_next()).number != END) {
+		while ((tok = lex->get_next()).number != END) {
 
 			if (type_specifier(tok.number)) {
 
-				Compiler::lex->put_back(tok);
+				lex->unget();
 				get_type_specifier(types);
 				consume_n(types.size());
 				simple_declaration(scope, types, false, &(*symtab));
@@ -3016,7 +2368,7 @@ namespace xlang {
 						return stmthead;
 				}
 				else if (peek_token(COLON_OP)) {
-					Compiler::lex->put_back(tok);
+					lex->unget();
 					statement = Tree::get_stmt_mem();
 					statement->type = StatementType::LABEL;
 					statement->labled_statement = labled_statement();
@@ -3026,7 +2378,7 @@ namespace xlang {
 						return stmthead;
 				}
 				else {
-					Compiler::lex->put_back(tok);
+					lex->unget();
 					statement = Tree::get_stmt_mem();
 					statement->type = StatementType::EXPR;
 					statement->expression_statement = expression_statement();
@@ -3037,7 +2389,7 @@ namespace xlang {
 				}
 			}
 			else if (expression_token(tok.number)) {
-				Compiler::lex->put_back(tok);
+				lex->unget();
 				statement = Tree::get_stmt_mem();
 				statement->type = StatementType::EXPR;
 				statement->expression_statement = expression_statement();
@@ -3047,7 +2399,7 @@ namespace xlang {
 					return stmthead;
 			}
 			else if (tok.number == KEY_IF) {
-				Compiler::lex->put_back(tok);
+				lex->unget();
 				statement = Tree::get_stmt_mem();
 				statement->type = StatementType::SELECT;
 				statement->selection_statement = selection_statement(&(*symtab));
@@ -3060,7 +2412,7 @@ namespace xlang {
 					 tok.number == KEY_DO ||
 					 tok.number == KEY_FOR) {
 
-				Compiler::lex->put_back(tok);
+				lex->unget();
 				statement = Tree::get_stmt_mem();
 				statement->type = StatementType::ITER;
 				statement->iteration_statement = iteration_statement(&(*symtab));
@@ -3074,7 +2426,7 @@ namespace xlang {
 					 tok.number == KEY_RETURN ||
 					 tok.number == KEY_GOTO) {
 
-				Compiler::lex->put_back(tok);
+				lex->unget();
 				statement = Tree::get_stmt_mem();
 				statement->type = StatementType::JUMP;
 				statement->jump_statement = jump_statement();
@@ -3085,7 +2437,7 @@ namespace xlang {
 
 			}
 			else if (tok.number == KEY_ASM) {
-				Compiler::lex->put_back(tok);
+				lex->unget();
 				statement = Tree::get_stmt_mem();
 				statement->type = StatementType::ASM;
 				statement->asm_statement = asm_statement();
@@ -3094,13 +2446,13 @@ namespace xlang {
 					return stmthead;
 			}
 			else if (tok.number == CURLY_CLOSE || tok.number == PARENTH_CLOSE) {
-				Compiler::lex->put_back(tok);
+				lex->unget();
 				return stmthead;
 			}
 			else if (tok.number == SEMICOLON)
 				continue;
 			else {
-				Log::error_at(tok.loc, "invalid Token in statement " + tok.string);
+				Log::error_at(tok.loc, "invalid Token in statement " + std::string(tok.string));
 				return nullptr;
 			}
 		}
@@ -3126,111 +2478,100 @@ namespace xlang {
 		(*func_info)->is_global = is_glob;
 	}
 
-	TreeNode *Parser::parse() {
+	TreeNode *Parser::parse_file() {
 
 		Token tok[5];
 		std::vector<Token> types;
-		std::map<std::string, FunctionInfo *>::iterator funcit;
+		FunctionMap::iterator funcit;
 		terminator_t terminator = {SEMICOLON};
-		Statement *_stmt = nullptr;
 		Node *symtab = nullptr;
 		FunctionInfo *funcinfo = nullptr;
 		TreeNode *tree_head = nullptr;
 		TreeNode *_tree = nullptr;
 
 
-		while ((tok[0] = Compiler::lex->get_next()).number != END) {
+		while ((tok[0] = lex->get_next()).number != END) {
 			if (tok[0].number == KEY_GLOBAL) {
-				tok[1] = Compiler::lex->get_next();
+				tok[1] = lex->get_next();
 
 				if (tok[1].number == END)
 					return tree_head;
 
 				if (tok[1].number == KEY_RECORD) {
-					Compiler::lex->put_back(tok[0]);
-					Compiler::lex->put_back(tok[1]);
+					lex->unget(2);
 					record_specifier();
 				}
 				else if (type_specifier(tok[1].number)) {
-					Compiler::lex->put_back(tok[1]);
+					lex->unget();
 					types.clear();
 					get_type_specifier(types);
 					consume_n(types.size());
 
-					tok[2] = Compiler::lex->get_next();
+					tok[2] = lex->get_next();
 					if (tok[2].number == END)
 						return tree_head;
 
 					if (tok[2].number == IDENTIFIER) {
-						tok[3] = Compiler::lex->get_next();
+						tok[3] = lex->get_next();
 
 						if (tok[3].number == END)
 							return tree_head;
 
 						if (tok[3].number == PARENTH_OPEN) {
-							Compiler::lex->put_back(tok[3]);
+							lex->unget();
 
 							symtab = SymbolTable::get_node_mem();
 							funcinfo = SymbolTable::get_func_info_mem();
 							func_head(&funcinfo, tok[2], tok[0], types, false);
-							funcit = Compiler::func_table->find(tok[2].string);
+							funcit = comp->func_table->find(tok[2].name);
 
-							if (funcit == Compiler::func_table->end()) {
-								Compiler::func_table->insert(std::pair<std::string, FunctionInfo *>(tok[2].string, funcinfo));
+							if (funcit == comp->func_table->end()) {
+								comp->func_table->insert(std::pair<NameId, FunctionInfo *>(tok[2].name, funcinfo));
 								expect(CURLY_OPEN, true);
 								_tree = Tree::get_tree_node_mem();
 								_tree->symtab = symtab;
 								get_func_info(&funcinfo, tok[2], NodeType::SIMPLE, types, false, true);
 								_tree->symtab->func_info = funcinfo;
-								_stmt = statement(&symtab);
-								_tree->statement = _stmt;
-								_tree->symtab = symtab;
 								Tree::add_tree_node(&tree_head, &_tree);
-								expect(CURLY_CLOSE, true);
+								func_body(_tree, symtab);
 							}
 							else {
-								Log::error_at(tok[2].loc, "redeclaration of function " + tok[2].string);
-								SymbolTable::delete_func_info(&funcinfo);
+								Log::error_at(tok[2].loc, "redeclaration of function " + std::string(tok[2].string));
 								return tree_head;
 							}
 							types.clear();
 						}
 						else {
-							Compiler::lex->put_back(tok[2]);
-							Compiler::lex->put_back(tok[3]);
-							simple_declaration(tok[0], types, false, &Compiler::symtab);
+							lex->unget(2);
+							simple_declaration(tok[0], types, false, &comp->symtab);
 							types.clear();
 							ptr_oprtr_count = 0;
 						}
 					}
 					else if (tok[2].number == ARTHM_MUL) {
-						Compiler::lex->put_back(tok[2]);
-						simple_declaration(tok[0], types, false, &Compiler::symtab);
+						lex->unget();
+						simple_declaration(tok[0], types, false, &comp->symtab);
 						if (peek_token(PARENTH_OPEN)) {
-							SymbolTable::remove_symbol(&Compiler::symtab, funcname.string);
+							SymbolTable::remove_symbol(&comp->symtab, funcname.name);
 							symtab = SymbolTable::get_node_mem();
 							funcinfo = SymbolTable::get_func_info_mem();
 							func_head(&funcinfo, funcname, tok[0], types, false);
 							funcinfo->ptr_oprtr_count = ptr_oprtr_count;
 							symtab->func_info = funcinfo;
 
-							funcit = Compiler::func_table->find(funcname.string);
-							if (funcit == Compiler::func_table->end()) {
-								Compiler::func_table->insert(std::pair<std::string, FunctionInfo *>(funcname.string, funcinfo));
+							funcit = comp->func_table->find(funcname.name);
+							if (funcit == comp->func_table->end()) {
+								comp->func_table->insert(std::pair<NameId, FunctionInfo *>(funcname.name, funcinfo));
 								expect(CURLY_OPEN, true);
 								_tree = Tree::get_tree_node_mem();
 								_tree->symtab = symtab;
 								get_func_info(&funcinfo, funcname, NodeType::SIMPLE, types, false, true);
 								_tree->symtab->func_info = funcinfo;
-								_stmt = statement(&symtab);
-								_tree->statement = _stmt;
-								_tree->symtab = symtab;
 								Tree::add_tree_node(&tree_head, &_tree);
-								expect(CURLY_CLOSE, true);
+								func_body(_tree, symtab);
 							}
 							else {
-								Log::error_at(funcname.loc, "redeclaration of function " + funcname.string);
-								SymbolTable::delete_func_info(&funcinfo);
+								Log::error_at(funcname.loc, "redeclaration of function " + std::string(funcname.string));
 								return tree_head;
 							}
 						}
@@ -3242,60 +2583,55 @@ namespace xlang {
 				else if (tok[1].number == IDENTIFIER) {
 
 					types.push_back(tok[1]);
-					tok[2] = Compiler::lex->get_next();
+					tok[2] = lex->get_next();
 
 					if (tok[2].number == END)
 						return tree_head;
 
 					if (tok[2].number == IDENTIFIER) {
-						tok[3] = Compiler::lex->get_next();
+						tok[3] = lex->get_next();
 
 						if (tok[3].number == END)
 							return tree_head;
 
 						if (tok[3].number == PARENTH_OPEN) {
-							Compiler::lex->put_back(tok[3]);
+							lex->unget();
 
 							symtab = SymbolTable::get_node_mem();
 							funcinfo = SymbolTable::get_func_info_mem();
 							func_head(&funcinfo, tok[2], tok[0], types, true);
-							funcit = Compiler::func_table->find(tok[2].string);
-							if (funcit == Compiler::func_table->end()) {
-								Compiler::func_table->insert(std::pair<std::string, FunctionInfo *>(tok[2].string, funcinfo));
+							funcit = comp->func_table->find(tok[2].name);
+							if (funcit == comp->func_table->end()) {
+								comp->func_table->insert(std::pair<NameId, FunctionInfo *>(tok[2].name, funcinfo));
 								expect(CURLY_OPEN, true);
 								_tree = Tree::get_tree_node_mem();
 								_tree->symtab = symtab;
 								get_func_info(&funcinfo, tok[2], NodeType::RECORD, types, false, true);
 								_tree->symtab->func_info = funcinfo;
-								_stmt = statement(&symtab);
-								_tree->statement = _stmt;
-								_tree->symtab = symtab;
 								Tree::add_tree_node(&tree_head, &_tree);
-								expect(CURLY_CLOSE, true);
+								func_body(_tree, symtab);
 							}
 							else {
-								Log::error_at(tok[2].loc, "redeclaration of function " + tok[2].string);
-								SymbolTable::delete_func_info(&funcinfo);
+								Log::error_at(tok[2].loc, "redeclaration of function " + std::string(tok[2].string));
 
 								return tree_head;
 							}
 							types.clear();
 						}
 						else {
-							Compiler::lex->put_back(tok[2]);
-							Compiler::lex->put_back(tok[3]);
-							simple_declaration(tok[0], types, true, &Compiler::symtab);
+							lex->unget(2);
+							simple_declaration(tok[0], types, true, &comp->symtab);
 							types.clear();
 							ptr_oprtr_count = 0;
 						}
 
 					}
 					else if (tok[2].number == ARTHM_MUL) {
-						Compiler::lex->put_back(tok[2]);
-						simple_declaration(tok[0], types, false, &Compiler::symtab);
+						lex->unget();
+						simple_declaration(tok[0], types, false, &comp->symtab);
 
 						if (peek_token(PARENTH_OPEN)) {
-							SymbolTable::remove_symbol(&Compiler::symtab, funcname.string);
+							SymbolTable::remove_symbol(&comp->symtab, funcname.name);
 
 							symtab = SymbolTable::get_node_mem();
 							funcinfo = SymbolTable::get_func_info_mem();
@@ -3303,23 +2639,19 @@ namespace xlang {
 							funcinfo->ptr_oprtr_count = ptr_oprtr_count;
 							symtab->func_info = funcinfo;
 
-							funcit = Compiler::func_table->find(funcname.string);
-							if (funcit == Compiler::func_table->end()) {
-								Compiler::func_table->insert(std::pair<std::string, FunctionInfo *>(funcname.string, funcinfo));
+							funcit = comp->func_table->find(funcname.name);
+							if (funcit == comp->func_table->end()) {
+								comp->func_table->insert(std::pair<NameId, FunctionInfo *>(funcname.name, funcinfo));
 								expect(CURLY_OPEN, true);
 								_tree = Tree::get_tree_node_mem();
 								_tree->symtab = symtab;
 								get_func_info(&funcinfo, funcname, NodeType::RECORD, types, false, true);
 								_tree->symtab->func_info = funcinfo;
-								_stmt = statement(&symtab);
-								_tree->statement = _stmt;
-								_tree->symtab = symtab;
 								Tree::add_tree_node(&tree_head, &_tree);
-								expect(CURLY_CLOSE, true);
+								func_body(_tree, symtab);
 							}
 							else {
-								Log::error_at(funcname.loc, "redeclaration of function " + funcname.string);
-								SymbolTable::delete_func_info(&funcinfo);
+								Log::error_at(funcname.loc, "redeclaration of function " + std::string(funcname.string));
 
 								return tree_head;
 							}
@@ -3331,40 +2663,39 @@ namespace xlang {
 				}
 			}
 			else if (tok[0].number == KEY_EXTERN) {
-				tok[1] = Compiler::lex->get_next();
+				tok[1] = lex->get_next();
 
 				if (tok[1].number == END)
 					return tree_head;
 
 				if (tok[1].number == KEY_RECORD) {
-					Compiler::lex->put_back(tok[1]);
-					Compiler::lex->put_back(tok[0]);
+					lex->unget(2);
 					record_specifier();
 				}
 				else if (type_specifier(tok[1].number)) {
 
-					Compiler::lex->put_back(tok[1]);
+					lex->unget();
 					types.clear();
 					get_type_specifier(types);
 					consume_n(types.size());
 
-					tok[2] = Compiler::lex->get_next();
+					tok[2] = lex->get_next();
 					if (tok[2].number == END)
 						return tree_head;
 
 					if (tok[2].number == IDENTIFIER) {
-						tok[3] = Compiler::lex->get_next();
+						tok[3] = lex->get_next();
 						if (tok[3].number == END)
 							return tree_head;
 
 						if (tok[3].number == PARENTH_OPEN) {
-							Compiler::lex->put_back(tok[3]);
+							lex->unget();
 							funcinfo = SymbolTable::get_func_info_mem();
 							func_head(&funcinfo, tok[2], tok[0], types, false);
-							funcit = Compiler::func_table->find(tok[2].string);
-							if (funcit == Compiler::func_table->end()) {
+							funcit = comp->func_table->find(tok[2].name);
+							if (funcit == comp->func_table->end()) {
 								expect(SEMICOLON, true);
-								Compiler::func_table->insert(std::pair<std::string, FunctionInfo *>(tok[2].string, funcinfo));
+								comp->func_table->insert(std::pair<NameId, FunctionInfo *>(tok[2].name, funcinfo));
 								get_func_info(&funcinfo, tok[2], NodeType::SIMPLE, types, true, false);
 								_tree = Tree::get_tree_node_mem();
 								symtab = SymbolTable::get_node_mem();
@@ -3373,35 +2704,33 @@ namespace xlang {
 								Tree::add_tree_node(&tree_head, &_tree);
 							}
 							else {
-								Log::error_at(tok[2].loc, "redeclaration of function " + tok[2].string);
-								SymbolTable::delete_func_info(&funcinfo);
+								Log::error_at(tok[2].loc, "redeclaration of function " + std::string(tok[2].string));
 								return tree_head;
 							}
 							types.clear();
 						}
 						else {
-							Compiler::lex->put_back(tok[2]);
-							Compiler::lex->put_back(tok[3]);
-							simple_declaration(tok[0], types, false, &Compiler::symtab);
+							lex->unget(2);
+							simple_declaration(tok[0], types, false, &comp->symtab);
 							types.clear();
 							ptr_oprtr_count = 0;
 						}
 					}
 					else if (tok[2].number == ARTHM_MUL) {
 
-						Compiler::lex->put_back(tok[2]);
-						simple_declaration(tok[0], types, false, &Compiler::symtab);
+						lex->unget();
+						simple_declaration(tok[0], types, false, &comp->symtab);
 
 						if (peek_token(PARENTH_OPEN)) {
-							SymbolTable::remove_symbol(&Compiler::symtab, funcname.string);
+							SymbolTable::remove_symbol(&comp->symtab, funcname.name);
 
 							funcinfo = SymbolTable::get_func_info_mem();
 							func_head(&funcinfo, funcname, tok[0], types, false);
 							funcinfo->ptr_oprtr_count = ptr_oprtr_count;
 
-							funcit = Compiler::func_table->find(funcname.string);
-							if (funcit == Compiler::func_table->end()) {
-								Compiler::func_table->insert(std::pair<std::string, FunctionInfo *>(funcname.string, funcinfo));
+							funcit = comp->func_table->find(funcname.name);
+							if (funcit == comp->func_table->end()) {
+								comp->func_table->insert(std::pair<NameId, FunctionInfo *>(funcname.name, funcinfo));
 								expect(SEMICOLON, true);
 								get_func_info(&funcinfo, funcname, NodeType::SIMPLE, types, true, false);
 								_tree = Tree::get_tree_node_mem();
@@ -3411,8 +2740,7 @@ namespace xlang {
 								Tree::add_tree_node(&tree_head, &_tree);
 							}
 							else {
-								Log::error_at(funcname.loc, "redeclaration of function " + funcname.string);
-								SymbolTable::delete_func_info(&funcinfo);
+								Log::error_at(funcname.loc, "redeclaration of function " + std::string(funcname.string));
 
 								return tree_head;
 							}
@@ -3425,24 +2753,24 @@ namespace xlang {
 				else if (tok[1].number == IDENTIFIER) {
 					types.push_back(tok[1]);
 
-					tok[2] = Compiler::lex->get_next();
+					tok[2] = lex->get_next();
 					if (tok[2].number == END)
 						return tree_head;
 
 					if (tok[2].number == IDENTIFIER) {
-						tok[3] = Compiler::lex->get_next();
+						tok[3] = lex->get_next();
 
 						if (tok[3].number == END)
 							return tree_head;
 
 						if (tok[3].number == PARENTH_OPEN) {
-							Compiler::lex->put_back(tok[3]);
+							lex->unget();
 							funcinfo = SymbolTable::get_func_info_mem();
 							func_head(&funcinfo, tok[2], tok[0], types, true);
-							funcit = Compiler::func_table->find(tok[2].string);
-							if (funcit == Compiler::func_table->end()) {
+							funcit = comp->func_table->find(tok[2].name);
+							if (funcit == comp->func_table->end()) {
 								expect(SEMICOLON, true);
-								Compiler::func_table->insert(std::pair<std::string, FunctionInfo *>(tok[2].string, funcinfo));
+								comp->func_table->insert(std::pair<NameId, FunctionInfo *>(tok[2].name, funcinfo));
 								get_func_info(&funcinfo, tok[2], NodeType::RECORD, types, true, false);
 								_tree = Tree::get_tree_node_mem();
 								symtab = SymbolTable::get_node_mem();
@@ -3451,8 +2779,7 @@ namespace xlang {
 								Tree::add_tree_node(&tree_head, &_tree);
 							}
 							else {
-								Log::error_at(tok[2].loc, "redeclaration of function " + tok[2].string);
-								SymbolTable::delete_func_info(&funcinfo);
+								Log::error_at(tok[2].loc, "redeclaration of function " + std::string(tok[2].string));
 
 								return tree_head;
 							}
@@ -3461,28 +2788,27 @@ namespace xlang {
 							funcname = nulltoken;
 						}
 						else {
-							Compiler::lex->put_back(tok[2]);
-							Compiler::lex->put_back(tok[3]);
-							simple_declaration(tok[0], types, true, &Compiler::symtab);
+							lex->unget(2);
+							simple_declaration(tok[0], types, true, &comp->symtab);
 							types.clear();
 							ptr_oprtr_count = 0;
 							funcname = nulltoken;
 						}
 					}
 					else if (tok[2].number == ARTHM_MUL) {
-						Compiler::lex->put_back(tok[2]);
+						lex->unget();
 
-						simple_declaration(tok[0], types, true, &Compiler::symtab);
+						simple_declaration(tok[0], types, true, &comp->symtab);
 						if (peek_token(PARENTH_OPEN)) {
-							SymbolTable::remove_symbol(&Compiler::symtab, funcname.string);
+							SymbolTable::remove_symbol(&comp->symtab, funcname.name);
 
 							funcinfo = SymbolTable::get_func_info_mem();
 							func_head(&funcinfo, funcname, tok[0], types, true);
 							funcinfo->ptr_oprtr_count = ptr_oprtr_count;
 
-							funcit = Compiler::func_table->find(funcname.string);
-							if (funcit == Compiler::func_table->end()) {
-								Compiler::func_table->insert(std::pair<std::string, FunctionInfo *>(funcname.string, funcinfo));
+							funcit = comp->func_table->find(funcname.name);
+							if (funcit == comp->func_table->end()) {
+								comp->func_table->insert(std::pair<NameId, FunctionInfo *>(funcname.name, funcinfo));
 								expect(SEMICOLON, true);
 								get_func_info(&funcinfo, funcname, NodeType::RECORD, types, true, false);
 								_tree = Tree::get_tree_node_mem();
@@ -3492,8 +2818,7 @@ namespace xlang {
 								Tree::add_tree_node(&tree_head, &_tree);
 							}
 							else {
-								Log::error_at(funcname.loc, "redeclaration of function " + funcname.string);
-								SymbolTable::delete_func_info(&funcinfo);
+								Log::error_at(funcname.loc, "redeclaration of function " + std::string(funcname.string));
 
 								return tree_head;
 							}
@@ -3506,44 +2831,41 @@ namespace xlang {
 			}
 			else if (type_specifier(tok[0].number)) {
 
-				Compiler::lex->put_back(tok[0]);
+				lex->unget();
 				types.clear();
 				get_type_specifier(types);
 				consume_n(types.size());
 
-				tok[1] = Compiler::lex->get_next();
+				tok[1] = lex->get_next();
 				if (tok[1].number == END)
 					return tree_head;
 
 				if (tok[1].number == IDENTIFIER) {
-					tok[2] = Compiler::lex->get_next();
+					tok[2] = lex->get_next();
 
 					if (tok[2].number == END)
 						return tree_head;
 
 					if (tok[2].number == PARENTH_OPEN) {
-						Compiler::lex->put_back(tok[2]);
+						lex->unget();
 
 						symtab = SymbolTable::get_node_mem();
 						funcinfo = SymbolTable::get_func_info_mem();
 						func_head(&funcinfo, tok[1], tok[0], types, false);
-						funcit = Compiler::func_table->find(tok[1].string);
+						funcit = comp->func_table->find(tok[1].name);
 
-						if (funcit == Compiler::func_table->end()) {
-							Compiler::func_table->insert(std::pair<std::string, FunctionInfo *>(tok[1].string, funcinfo));
+						if (funcit == comp->func_table->end()) {
+							comp->func_table->insert(std::pair<NameId, FunctionInfo *>(tok[1].name, funcinfo));
 							expect(CURLY_OPEN, true);
 							_tree = Tree::get_tree_node_mem();
 							_tree->symtab = symtab;
 							get_func_info(&funcinfo, tok[1], NodeType::SIMPLE, types, false, false);
 							_tree->symtab->func_info = funcinfo;
-							_stmt = statement(&symtab);
-							_tree->statement = _stmt;
-							_tree->symtab = symtab;
 							Tree::add_tree_node(&tree_head, &_tree);
-							expect(CURLY_CLOSE, true);
+							func_body(_tree, symtab);
 						}
 						else {
-							Log::error_at(tok[1].loc, "redeclaration of function " + tok[1].string);
+							Log::error_at(tok[1].loc, "redeclaration of function " + std::string(tok[1].string));
 
 							return tree_head;
 						}
@@ -3553,20 +2875,19 @@ namespace xlang {
 
 					}
 					else {
-						Compiler::lex->put_back(tok[1]);
-						Compiler::lex->put_back(tok[2]);
-						simple_declaration(tok[0], types, false, &Compiler::symtab);
+						lex->unget(2);
+						simple_declaration(tok[0], types, false, &comp->symtab);
 						types.clear();
 						ptr_oprtr_count = 0;
 						funcname = nulltoken;
 					}
 				}
 				else if (tok[1].number == ARTHM_MUL) {
-					Compiler::lex->put_back(tok[1]);
-					simple_declaration(tok[0], types, false, &Compiler::symtab);
+					lex->unget();
+					simple_declaration(tok[0], types, false, &comp->symtab);
 
 					if (peek_token(PARENTH_OPEN) && funcname.number != NONE) {
-						SymbolTable::remove_symbol(&Compiler::symtab, funcname.string);
+						SymbolTable::remove_symbol(&comp->symtab, funcname.name);
 
 						symtab = SymbolTable::get_node_mem();
 						funcinfo = SymbolTable::get_func_info_mem();
@@ -3574,23 +2895,19 @@ namespace xlang {
 						funcinfo->ptr_oprtr_count = ptr_oprtr_count;
 						symtab->func_info = funcinfo;
 
-						funcit = Compiler::func_table->find(funcname.string);
-						if (funcit == Compiler::func_table->end()) {
-							Compiler::func_table->insert(std::pair<std::string, FunctionInfo *>(funcname.string, funcinfo));
+						funcit = comp->func_table->find(funcname.name);
+						if (funcit == comp->func_table->end()) {
+							comp->func_table->insert(std::pair<NameId, FunctionInfo *>(funcname.name, funcinfo));
 							expect(CURLY_OPEN, true);
 							_tree = Tree::get_tree_node_mem();
 							_tree->symtab = symtab;
 							get_func_info(&funcinfo, funcname, NodeType::SIMPLE, types, false, false);
 							_tree->symtab->func_info = funcinfo;
-							_stmt = statement(&symtab);
-							_tree->statement = _stmt;
-							_tree->symtab = symtab;
 							Tree::add_tree_node(&tree_head, &_tree);
-							expect(CURLY_CLOSE, true);
+							func_body(_tree, symtab);
 						}
 						else {
-							Log::error_at(funcname.loc, "redeclaration of function " + funcname.string);
-							SymbolTable::delete_func_info(&funcinfo);
+							Log::error_at(funcname.loc, "redeclaration of function " + std::string(funcname.string));
 							return tree_head;
 						}
 					}
@@ -3603,39 +2920,35 @@ namespace xlang {
 				types.clear();
 				types.push_back(tok[0]);
 
-				tok[1] = Compiler::lex->get_next();
+				tok[1] = lex->get_next();
 				if (tok[1].number == END)
 					return tree_head;
 
 				if (tok[1].number == IDENTIFIER) {
 
-					tok[2] = Compiler::lex->get_next();
+					tok[2] = lex->get_next();
 					if (tok[2].number == END)
 						return tree_head;
 
 					if (tok[2].number == PARENTH_OPEN) {
-						Compiler::lex->put_back(tok[2]);
+						lex->unget();
 
 						symtab = SymbolTable::get_node_mem();
 						funcinfo = SymbolTable::get_func_info_mem();
 						func_head(&funcinfo, tok[1], tok[0], types, true);
-						funcit = Compiler::func_table->find(tok[2].string);
-						if (funcit == Compiler::func_table->end()) {
-							Compiler::func_table->insert(std::pair<std::string, FunctionInfo *>(tok[1].string, funcinfo));
+						funcit = comp->func_table->find(tok[2].name);
+						if (funcit == comp->func_table->end()) {
+							comp->func_table->insert(std::pair<NameId, FunctionInfo *>(tok[1].name, funcinfo));
 							expect(CURLY_OPEN, true);
 							_tree = Tree::get_tree_node_mem();
 							_tree->symtab = symtab;
 							get_func_info(&funcinfo, tok[1], NodeType::RECORD, types, false, false);
 							_tree->symtab->func_info = funcinfo;
-							_stmt = statement(&symtab);
-							_tree->statement = _stmt;
-							_tree->symtab = symtab;
 							Tree::add_tree_node(&tree_head, &_tree);
-							expect(CURLY_CLOSE, true);
+							func_body(_tree, symtab);
 						}
 						else {
-							Log::error_at(tok[1].loc, "redeclaration of function " + tok[1].string);
-							SymbolTable::delete_func_info(&funcinfo);
+							Log::error_at(tok[1].loc, "redeclaration of function " + std::string(tok[1].string));
 
 							return tree_head;
 						}
@@ -3643,17 +2956,15 @@ namespace xlang {
 
 					}
 					else {
-						Compiler::lex->put_back(tok[1]);
-						Compiler::lex->put_back(tok[2]);
-						simple_declaration(tok[0], types, true, &Compiler::symtab);
+						lex->unget(2);
+						simple_declaration(tok[0], types, true, &comp->symtab);
 						types.clear();
 						ptr_oprtr_count = 0;
 					}
 				}
 				else if (tok[1].number == ARTHM_MUL) {
-					if (!SymbolTable::search_record(Compiler::record_table, tok[0].string)) {
-						Compiler::lex->put_back(tok[1]);
-						Compiler::lex->put_back(tok[0]);
+					if (!SymbolTable::search_record(comp->record_table, tok[0].name)) {
+						lex->unget(2);
 						_tree = Tree::get_tree_node_mem();
 						_tree->statement = Tree::get_stmt_mem();
 						_tree->statement->type = StatementType::EXPR;
@@ -3674,34 +2985,30 @@ namespace xlang {
 						Tree::add_tree_node(&tree_head, &_tree);
 					}
 					else {
-						Compiler::lex->put_back(tok[1]);
-						simple_declaration(tok[0], types, true, &Compiler::symtab);
+						lex->unget();
+						simple_declaration(tok[0], types, true, &comp->symtab);
 
 						if (peek_token(PARENTH_OPEN)) {
-							SymbolTable::remove_symbol(&Compiler::symtab, funcname.string);
+							SymbolTable::remove_symbol(&comp->symtab, funcname.name);
 							symtab = SymbolTable::get_node_mem();
 							funcinfo = SymbolTable::get_func_info_mem();
 							func_head(&funcinfo, funcname, tok[0], types, true);
 							funcinfo->ptr_oprtr_count = ptr_oprtr_count;
 							symtab->func_info = funcinfo;
 
-							funcit = Compiler::func_table->find(funcname.string);
-							if (funcit == Compiler::func_table->end()) {
-								Compiler::func_table->insert(std::pair<std::string, FunctionInfo *>(funcname.string, funcinfo));
+							funcit = comp->func_table->find(funcname.name);
+							if (funcit == comp->func_table->end()) {
+								comp->func_table->insert(std::pair<NameId, FunctionInfo *>(funcname.name, funcinfo));
 								expect(CURLY_OPEN, true);
 								_tree = Tree::get_tree_node_mem();
 								_tree->symtab = symtab;
 								get_func_info(&funcinfo, funcname, NodeType::SIMPLE, types, false, false);
 								_tree->symtab->func_info = funcinfo;
-								_stmt = statement(&symtab);
-								_tree->statement = _stmt;
-								_tree->symtab = symtab;
 								Tree::add_tree_node(&tree_head, &_tree);
-								expect(CURLY_CLOSE, true);
+								func_body(_tree, symtab);
 							}
 							else {
-								Log::error_at(funcname.loc, "redeclaration of function " + funcname.string);
-								SymbolTable::delete_func_info(&funcinfo);
+								Log::error_at(funcname.loc, "redeclaration of function " + std::string(funcname.string));
 								return tree_head;
 							}
 						}
@@ -3711,10 +3018,9 @@ namespace xlang {
 					types.clear();
 				}
 				else if (assignment_operator(tok[1].number) || tok[1].number == SQUARE_OPEN) {
-					Compiler::lex->put_back(tok[1]);
-					Compiler::lex->put_back(tok[0]);
+					lex->unget(2);
 					_tree = Tree::get_tree_node_mem();
-					SymbolTable::delete_node(&(_tree->symtab));
+					_tree->symtab = nullptr;
 					_tree->statement = Tree::get_stmt_mem();
 					_tree->statement->type = StatementType::EXPR;
 					_tree->statement->expression_statement = Tree::get_expr_stmt_mem();
@@ -3729,8 +3035,7 @@ namespace xlang {
 					Tree::add_tree_node(&tree_head, &_tree);
 				}
 				else if (binary_operator(tok[1].number) || tok[1].number == INCR_OP || tok[1].number == DECR_OP) {
-					Compiler::lex->put_back(tok[1]);
-					Compiler::lex->put_back(tok[0]);
+					lex->unget(2);
 					_tree = Tree::get_tree_node_mem();
 					_tree->statement = Tree::get_stmt_mem();
 					_tree->statement->type = StatementType::EXPR;
@@ -3752,8 +3057,7 @@ namespace xlang {
 					Tree::add_tree_node(&tree_head, &_tree);
 				}
 				else if (tok[1].number == PARENTH_OPEN) {
-					Compiler::lex->put_back(tok[1]);
-					Compiler::lex->put_back(tok[0]);
+					lex->unget(2);
 					_tree = Tree::get_tree_node_mem();
 					_tree->statement = Tree::get_stmt_mem();
 					_tree->statement->type = StatementType::EXPR;
@@ -3762,18 +3066,18 @@ namespace xlang {
 					Tree::add_tree_node(&tree_head, &_tree);
 				}
 				else {
-					Log::error_at(tok[1].loc, "invalid Token found while parsing '" + tok[1].string + "'");
+					Log::error_at(tok[1].loc, "invalid Token found while parsing '" + std::string(tok[1].string) + "'");
 					return tree_head;
 				}
 			}
 			else if (tok[0].number == KEY_RECORD) {
-				Compiler::lex->put_back(tok[0]);
+				lex->unget();
 				record_specifier();
 			}
 			else if (expression_token(tok[0].number)) {
-				Compiler::lex->put_back(tok[0]);
+				lex->unget();
 				_tree = Tree::get_tree_node_mem();
-				SymbolTable::delete_node(&(_tree->symtab));
+				_tree->symtab = nullptr;
 				_tree->statement = Tree::get_stmt_mem();
 				_tree->statement->type = StatementType::EXPR;
 				_tree->statement->expression_statement = Tree::get_expr_stmt_mem();
@@ -3793,9 +3097,9 @@ namespace xlang {
 				Tree::add_tree_node(&tree_head, &_tree);
 			}
 			else if (tok[0].number == KEY_ASM) {
-				Compiler::lex->put_back(tok[0]);
+				lex->unget();
 				_tree = Tree::get_tree_node_mem();
-				SymbolTable::delete_node(&(_tree->symtab));
+				_tree->symtab = nullptr;
 				_tree->statement = Tree::get_stmt_mem();
 				_tree->statement->type = StatementType::ASM;
 				_tree->statement->asm_statement = asm_statement();
@@ -3805,10 +3109,255 @@ namespace xlang {
 				consume_next();
 			}
 			else {
-				Log::error_at(tok[0].loc, "invalid Token found while parsing '" + tok[0].string + "'");
+				Log::error_at(tok[0].loc, "invalid Token found while parsing '" + std::string(tok[0].string) + "'");
 				return tree_head;
 			}
 		}
 		return tree_head;
 	}
-}
\ No newline at end of file
+
+	TreeNode *Parser::parse() {
+		if (comp->global.parse_threads > 1)
+			return parse_in_parallel(comp->global.parse_threads);
+		return parse_file();
+	}
+
+	TreeNode *Parser::parse_in_parallel(unsigned threads) {
+
+		// declarations, records and the heads of functions are parsed
+		// here, the bodies are skipped. then the bodies are parsed on up
+		// to threads threads and put in their trees
+		//
+		// nothing is printed until that worked. after an error anywhere,
+		// or a body that doesn't end at the } the pre-scan matched, the
+		// file is parsed again from the start on this thread alone, so
+		// the messages are those of a serial run in the same order
+
+		if (!prescan())
+			return parse_file();
+
+		std::ostringstream messages;
+		std::ostream *out = Log::out;
+		Log::out = &messages;
+		defer_bodies = true;
+
+		TreeNode *tree_head = nullptr;
+		bool parsed = false;
+		try {
+			tree_head = parse_file();
+			parsed = true;
+		}
+		catch (CompileError &) {
+		}
+
+		Log::out = out;
+		defer_bodies = false;
+		if (parsed && parse_bodies(threads))
+			return tree_head;
+
+		// what was made so far stays in the arena, unused
+		comp->symtab = SymbolTable::get_node_mem();
+		comp->record_table = SymbolTable::get_record_symtab_mem();
+		comp->func_table = SymbolTable::get_func_table_mem();
+		last_rec_node = nullptr;
+		last_symbol = nullptr;
+		load_state(BodyState());
+		jobs.clear();
+		next_range = 0;
+		lex->replay(tokens.data(), tokens.size(), lex_error);
+		return parse_file();
+	}
+
+	bool Parser::prescan() {
+
+		// reads all tokens of the file, the parser reads them again from
+		// here. a body is the tokens in a { after a ) outside of any
+		// braces up to its matching }. false if there are less than two
+		//
+		// a lexer error ends the tokens, it is reported when the parser
+		// gets to it
+
+		std::ostringstream messages;
+		std::ostream *out = Log::out;
+		Log::out = &messages;
+		try {
+			do
+				tokens.push_back(lex->get_next());
+			while (tokens.back().number != END);
+		}
+		catch (CompileError &) {
+			lex_error = messages.str();
+		}
+		Log::out = out;
+		lex->replay(tokens.data(), tokens.size(), lex_error);
+
+		size_t depth = 0;
+		size_t begin = 0;
+		for (size_t i = 0; i < tokens.size(); i++) {
+			if (tokens[i].number == CURLY_OPEN) {
+				if (depth++ == 0)
+					begin = (i > 0 && tokens[i - 1].number == PARENTH_CLOSE) ? i + 1 : 0;
+			}
+			else if (tokens[i].number == CURLY_CLOSE && depth > 0) {
+				if (--depth == 0 && begin != 0)
+					body_ranges.emplace_back(begin, i + 1);
+			}
+		}
+		return body_ranges.size() > 1;
+	}
+
+	bool Parser::parse_bodies(unsigned threads) {
+
+		// every thread takes the next body there is, reads its tokens with
+		// a lexer of its own and makes its tree in an arena of its own,
+		// the arenas are given to the compilation after. the expression
+		// nodes go in the pools of the compilation. a body sees the
+		// tokens after its } and the records before its { as it would
+		// here, it has to stop right after the }
+		//
+		// false if a body failed or didn't end at its }
+
+		std::atomic<size_t> next{0};
+		std::atomic<bool> failed{false};
+		std::vector<Arena> arenas(std::min<size_t>(threads, jobs.size()));
+
+		auto work = [&](Arena &arena) {
+			std::ostringstream messages;
+			Log::out = &messages;
+			Log::level = comp->global.log_level;
+			Log::source = comp->global.file.buffer.get();
+			Arena::active = &arena;
+			TreePools::active = &comp->pools;
+
+			size_t i;
+			while (!failed && (i = next++) < jobs.size()) {
+				BodyJob &job = jobs[i];
+				size_t last = std::min(tokens.size(), job.end + Lexer::LOOKAHEAD);
+				Lexer body_lex(comp->global.file);
+				body_lex.replay(tokens.data() + job.begin, last - job.begin,
+								last == tokens.size() ? std::string_view(lex_error) : std::string_view());
+
+				Parser body(comp, &body_lex, tokens[job.begin - 1].loc.offset);
+				body.load_state(job.state);
+				try {
+					body.func_body(job.tree, job.symtab);
+					if (body_lex.mark() != job.end - job.begin)
+						failed = true;
+				}
+				catch (CompileError &) {
+					failed = true;
+				}
+			}
+		};
+
+		std::vector<std::thread> pool;
+		for (auto &arena: arenas)
+			pool.emplace_back(work, std::ref(arena));
+		for (auto &t: pool)
+			t.join();
+
+		if (failed)
+			return false;
+		for (auto &arena: arenas)
+			comp->arena.adopt(arena);
+		return true;
+	}
+
+	void Parser::func_body(TreeNode *tree, Node *symtab) {
+
+		// the statements of a function after its {, up to and with its }.
+		// a body the pre-scan found is skipped while deferring, it is
+		// left for parse_bodies(). with --stream every body is skipped
+		// and left for parse_body()
+		//
+		// what a body leaves in the parser is dropped, the declarations
+		// after it are parsed the same either way
+
+		size_t at = lex->mark();
+		while (next_range < body_ranges.size() && body_ranges[next_range].first < at)
+			next_range++;
+
+		if (defer_bodies && next_range < body_ranges.size() && body_ranges[next_range].first == at) {
+			size_t end = body_ranges[next_range].second;
+			jobs.push_back({at, end, tree, symtab, save_state()});
+			lex->skip(end - at);
+		}
+		else if (skip_bodies) {
+			uint32_t offset = lex->peek().loc.offset;
+			BodyState state = save_state();
+			size_t count = skip_body();
+			stream_bodies.push_back({offset, count, tree, symtab, std::move(state)});
+			tree->symtab = symtab;
+		}
+		else {
+			tree->statement = statement(&symtab);
+			tree->symtab = symtab;
+			expect(CURLY_CLOSE, true);
+		}
+		load_state(BodyState());
+	}
+
+	size_t Parser::skip_body() {
+
+		// the tokens of a body up to and with its }, counted. a file that
+		// ends before is compiled again without --stream, which reports it
+
+		size_t count = 0;
+		for (size_t depth = 1; depth > 0; count++) {
+			TokenId id = lex->get_next().number;
+			if (id == END)
+				throw CompileError();
+			if (id == CURLY_OPEN)
+				depth++;
+			else if (id == CURLY_CLOSE)
+				depth--;
+		}
+		return count;
+	}
+
+	TreeNode *Parser::parse_declarations() {
+		skip_bodies = true;
+		TreeNode *tree_head = parse_file();
+		skip_bodies = false;
+		return tree_head;
+	}
+
+	bool Parser::parse_body(size_t i) {
+
+		// a lexer of its own reads the body again from its first token,
+		// the parser starts from what there was at its { and knows the
+		// records before it, as parse_bodies() does
+
+		StreamBody &body = stream_bodies[i];
+		Lexer body_lex(comp->global.file);
+		body_lex.stats = lex->stats;
+		body_lex.names = lex->names;
+		body_lex.init(body.offset);
+
+		Parser parser(comp, &body_lex, body.offset);
+		parser.load_state(body.state);
+		parser.func_body(body.tree, body.symtab);
+		return body_lex.mark() == body.count;
+	}
+
+	Parser::BodyState Parser::save_state() {
+		BodyState state;
+		state.is_expr_terminator_consumed = is_expr_terminator_consumed;
+		state.ptr_oprtr_count = ptr_oprtr_count;
+		state.funcname = funcname;
+		state.consumed_terminator = consumed_terminator;
+		return state;
+	}
+
+	void Parser::load_state(const BodyState &state) {
+		is_expr_terminator_consumed = state.is_expr_terminator_consumed;
+		ptr_oprtr_count = state.ptr_oprtr_count;
+		funcname = state.funcname;
+		consumed_terminator = state.consumed_terminator;
+	}
+
+	bool Parser::known_record(const Token &tok) {
+		RecordNode *rec = SymbolTable::search_record_node(comp->record_table, tok.name);
+		return rec != nullptr && rec->recordtok.loc.offset < records_before;
+	}
+}
@@ -10,6 +10,8 @@
 #include <vector>
 #include <stack>
 #include <map>
+#include <string>
+#include <cstdint>
 #include "token.hpp"
 #include "lex.hpp"
 #include "tree.hpp"
@@ -18,12 +20,33 @@ namespace xlang {
 	
 	typedef std::vector<TokenId> terminator_t;
 	
+	class Compiler;
+	
 	class Parser {
 		public:
 		
-		Parser();
+		explicit Parser(Compiler *);
 		
+		// with GlobalConfig::parse_threads above 1 the bodies of functions
+		// are parsed on that many threads, the tree and messages are the
+		// same as parsing on this one
 		TreeNode *parse();
+
+		// --stream: the file is parsed with the bodies of its functions
+		// skipped, parse_body() then parses one of them in the arena of
+		// the thread. body() is the tree node it goes in
+		TreeNode *parse_declarations();
+
+		size_t body_count() const {
+			return stream_bodies.size();
+		}
+
+		TreeNode *body(size_t i) const {
+			return stream_bodies[i].tree;
+		}
+
+		// false if the body didn't end at the } it was skipped to
+		bool parse_body(size_t);
 		
 		friend std::ostream &operator<<(std::ostream &, const std::vector<Token> &);
 		
@@ -31,7 +54,58 @@ namespace xlang {
 		
 		private:
 		
-		bool is_expr_terminator_got{false};
+		Compiler *comp;
+		Lexer *lex;
+		
+		RecordNode *last_rec_node{nullptr};
+		SymbolInfo *last_symbol{nullptr};
+
+		// records declared at or after this offset aren't known yet, the
+		// ones of a body parsed on another thread are those before it
+		uint32_t records_before{UINT32_MAX};
+
+		// what the parser carries from one expression to the next. a body
+		// parsed on another thread starts with what there was at its {
+		struct BodyState {
+			bool is_expr_terminator_consumed{false};
+			int ptr_oprtr_count{0};
+			Token funcname{};
+			Token consumed_terminator{};
+		};
+
+		// a function body left for parse_bodies(), tokens [begin, end)
+		// are the ones after its { up to and with its }
+		struct BodyJob {
+			size_t begin;
+			size_t end;
+			TreeNode *tree;
+			Node *symtab;
+			BodyState state;
+		};
+
+		// the tokens of the file and where the bodies in them are, found
+		// by the pre-scan. lex_error is the message of a lexer error after
+		// the last one
+		std::vector<Token> tokens;
+		std::string lex_error;
+		std::vector<std::pair<size_t, size_t>> body_ranges;
+		size_t next_range{0};
+		bool defer_bodies{false};
+		std::vector<BodyJob> jobs;
+
+		// a body skipped by parse_declarations(), count tokens from the
+		// one at offset up to and with its }
+		struct StreamBody {
+			uint32_t offset;
+			size_t count;
+			TreeNode *tree;
+			Node *symtab;
+			BodyState state;
+		};
+
+		bool skip_bodies{false};
+		std::vector<StreamBody> stream_bodies;
+		
 		bool is_expr_terminator_consumed{false};
 		int ptr_oprtr_count{0};
 		
@@ -39,8 +113,39 @@ namespace xlang {
 		Token consumed_terminator;
 		Token nulltoken;
 
-		std::stack<Token> parenth_stack;
-		std::vector<Token> expr_list;
+		// what the last token of an expression was, it decides what may
+		// come after it
+		enum class ExprState {
+			START,
+			OPEN,           // (
+			OPERATOR,
+			LIT_OPERATOR,   // a binary operator after a literal
+			UNARY,          // + - ! ~ where an operand may follow
+			PREFIX,         // ++ -- & before an identifier
+			MEMBER,         // . ->
+			LITERAL,
+			IDENT,
+			CLOSE,          // )
+			SUBSCRIPT,      // ]
+			POSTFIX         // ++ -- after an identifier
+		};
+
+		// an expression tree being built as its tokens are read, see
+		// climb_tree()
+		struct TreeBuild {
+			bool id_tree{false};
+			bool terminated{false};       // it ended at the terminator, which is consumed
+			ExprState state{ExprState::START};
+			int depth{0};                 // ( not closed yet
+			terminator_t *terminator{nullptr};
+			terminator_t parenth{PARENTH_CLOSE};   // the one inside ( )
+			Token tok{};                  // where the climber is, NONE at the end
+			Token index{};                // of the [ ] at tok
+			bool has_unary{false};
+			Token unary{};                // the last ! or ~, it takes the whole tree
+			std::vector<NodeIndex> primary;
+			std::vector<NodeIndex> id;
+		} build;
 
         //token_lexeme_table used for string of special symbols
 		std::map<TokenId, std::string> token_lexeme_table = {
@@ -60,12 +165,12 @@ namespace xlang {
 		    {SEMICOLON,     ";"}
         };
 		
-		std::string s_quotestring(std::string str) {
-			return "'" + str + "'";
+		std::string s_quotestring(std::string_view str) {
+			return "'" + std::string(str) + "'";
 		}
 		
-		std::string d_quotestring(std::string str) {
-			return "\"" + str + "\"";
+		std::string d_quotestring(std::string_view str) {
+			return "\"" + std::string(str) + "\"";
 		}
 		
 		bool peek_token(TokenId);
@@ -84,8 +189,6 @@ namespace xlang {
 		
 		bool peek_expr_literal();
 		
-		bool expect(TokenId);
-		
 		bool expect(TokenId, bool);
 		
 		bool expect(TokenId, bool, std::string);
@@ -104,8 +207,6 @@ namespace xlang {
 		
 		bool expect_literal();
 		
-		bool check_parenth();
-		
 		bool matches_terminator(terminator_t &, TokenId);
 		
 		std::string get_terminator(terminator_t &);
@@ -150,44 +251,34 @@ namespace xlang {
 		
 		Expression *expression(terminator_t &);
 		
-		void primary_expr(terminator_t &);
-		
-		void sub_primary_expr(terminator_t &);
+		NodeIndex primary_expr(terminator_t &);
 		
 		int precedence(TokenId);
 		
-		void postfix_expression(std::list<Token> &);
+		bool tree_operator(TokenId);
 		
-		PrimaryExpression *get_primary_expr_tree();
+		NodeIndex climb_tree(bool, terminator_t &, const Token * = nullptr);
 		
-		IdentifierExpression *get_id_expr_tree();
+		void climb_expr(int);
 		
-		bool peek_identifier();
-		
-		void id_expr(terminator_t &);
-		
-		void subscript_id_access(terminator_t &);
+		void climb_operand();
 		
-		void pointer_indirection_access(terminator_t &);
+		void next_expr_token();
 		
-		void pointer_operator_sequence();
-		
-		int get_pointer_operator_sequence();
+		void make_leaf(const Token &);
 		
-		IdentifierExpression *prefix_incr_expr(terminator_t &);
+		void make_operator(const Token &);
 		
-		void postfix_incr_expr(terminator_t &);
+		bool peek_identifier();
 		
-		IdentifierExpression *prefix_decr_expr(terminator_t &);
+		NodeIndex id_expr(terminator_t &);
 		
-		void postfix_decr_expr(terminator_t &);
+		int get_pointer_operator_sequence();
 		
 		bool member_access_operator(TokenId);
 		
 		bool peek_member_access_operator();
 		
-		IdentifierExpression *address_of_expr(terminator_t &);
-		
 		bool peek_type_specifier(std::vector<Token> &);
 		
 		bool type_specifier(TokenId);
@@ -204,11 +295,11 @@ namespace xlang {
 		
 		void cast_type_specifier(CastExpression **);
 		
-		AssignmentExpression *assignment_expr(terminator_t &, bool);
+		AssignmentExpression *assignment_expr(terminator_t &, NodeIndex, bool);
 		
-		CallExpression *call_expr(terminator_t &);
+		CallExpression *call_expr(NodeIndex, terminator_t &);
 		
-		void func_call_expr_list(std::list<Expression *> &, terminator_t &);
+		void func_call_expr_list(std::vector<Expression *> &, terminator_t &);
 		
 		void record_specifier();
 		
@@ -257,5 +348,25 @@ namespace xlang {
 		void asm_operand(std::vector<AsmOperand *> &);
 		
 		void get_func_info(FunctionInfo **, Token, NodeType, std::vector<Token> &, bool, bool);
+		
+		Parser(Compiler *, Lexer *, uint32_t);
+		
+		TreeNode *parse_file();
+		
+		TreeNode *parse_in_parallel(unsigned);
+		
+		bool prescan();
+		
+		bool parse_bodies(unsigned);
+		
+		void func_body(TreeNode *, Node *);
+
+		size_t skip_body();
+		
+		BodyState save_state();
+		
+		void load_state(const BodyState &);
+		
+		bool known_record(const Token &);
 	};
 }
\ No newline at end of file
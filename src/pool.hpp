@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace xlang {
+
+	// index of a node in the pool of its kind, 0 is no node
+	typedef uint32_t NodeIndex;
+	constexpr NodeIndex NO_NODE = 0;
+
+	// nodes of one kind of one compilation, one after another in the
+	// order they are made and found by a 32 bit index
+	//
+	// they are kept in chunks that double in size, a chunk never moves
+	// so a pointer to a node stays good until it is truncated. several
+	// threads can make nodes at the same time (--parse-jobs), one that
+	// reads a node another thread made has to sync with it first
+
+	template<typename T>
+	class NodePool {
+	public:
+
+		static constexpr uint32_t FIRST_CHUNK = 256;
+
+		// chunk k has FIRST_CHUNK << k nodes, 25 of them pass 2^32
+		static constexpr int CHUNKS = 25;
+
+		NodePool() = default;
+
+		~NodePool() {
+			truncate(1);
+			for (auto &c: chunks)
+				::operator delete(c.load(std::memory_order_relaxed));
+		}
+
+		NodePool(const NodePool &) = delete;
+
+		NodePool &operator=(const NodePool &) = delete;
+
+		// a value initialized T, like new T()
+		NodeIndex make() {
+			NodeIndex i = count.fetch_add(1, std::memory_order_relaxed);
+			if (i == NO_NODE)
+				throw std::bad_alloc();
+			uint32_t offset;
+			int k = chunk_of(i, offset);
+			T *chunk = chunks[k].load(std::memory_order_acquire);
+			if (chunk == nullptr) {
+				T *fresh = static_cast<T *>(::operator new(sizeof(T) * (size_t(FIRST_CHUNK) << k)));
+				if (chunks[k].compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel))
+					chunk = fresh;
+				else
+					::operator delete(fresh);
+			}
+			new(&chunk[offset]) T();
+			return i;
+		}
+
+		// nullptr for NO_NODE
+		T *get(NodeIndex i) const {
+			if (i == NO_NODE)
+				return nullptr;
+			uint32_t offset;
+			int k = chunk_of(i, offset);
+			return &chunks[k].load(std::memory_order_acquire)[offset];
+		}
+
+		// one past the last index made
+		NodeIndex size() const {
+			return count.load(std::memory_order_relaxed);
+		}
+
+		// destroys the nodes from index n on, their memory is used again.
+		// nothing may make nodes at the same time
+		void truncate(NodeIndex n) {
+			NodeIndex end = size();
+			if constexpr (!std::is_trivially_destructible_v<T>) {
+				for (NodeIndex i = end; i > n; i--)
+					get(i - 1)->~T();
+			}
+			if (n < end)
+				count.store(n, std::memory_order_relaxed);
+		}
+
+		// memory of the nodes made, for --mem-stats
+		size_t used() const {
+			return sizeof(T) * (size() - 1);
+		}
+
+	private:
+
+		// index 0 is never made
+		std::atomic<NodeIndex> count{1};
+		std::atomic<T *> chunks[CHUNKS]{};
+
+		// chunk k starts at FIRST_CHUNK * (2^k - 1)
+		static int chunk_of(NodeIndex i, uint32_t &offset) {
+			int k = 31 - __builtin_clz(i / FIRST_CHUNK + 1);
+			offset = i - FIRST_CHUNK * ((1u << k) - 1);
+			return k;
+		}
+	};
+}
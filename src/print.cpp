@@ -79,7 +79,7 @@ namespace xlang {
 		Log::line("  identifier = ", identifier.string);
 		Log::line("  ptr_oprtr_count = ", ptr_oprtr_count);
 		Log::line("  target : ");
-		target->print();
+		Tree::id_expr(target)->print();
 	}
 	
 	void AssignmentExpression::print() {
@@ -89,11 +89,11 @@ namespace xlang {
 		Log::line("  id_expr : ", id_expr);
 		Log::line("  expression : ", expression);
 		Log::line("}\n");
-		if (id_expr == nullptr)
+		if (id_expr == NO_NODE)
 			return;
 		if (expression == nullptr)
 			return;
-		id_expr->print();
+		Tree::id_expr(id_expr)->print();
 		expression->print();
 	}
 	
@@ -125,12 +125,7 @@ namespace xlang {
 			Log::line("||||||||||||||||||||||| statement ||||||||||||||||||||");
 			Log::line("ptr : ", curr);
 			Log::line("type : ",(uint8_t) curr->type);
-			Log::line("labled_statement : ", curr->labled_statement);
-			Log::line("expression_statement : ", curr->expression_statement);
-			Log::line("selection_statement : ", curr->selection_statement);
-			Log::line("iteration_statement : ", curr->iteration_statement);
-			Log::line("jump_statement : ", curr->jump_statement);
-			Log::line("asm statement : ", curr->asm_statement);
+			Log::line("statement node : ", curr->labled_statement);
 			Log::line("p_next : ", curr->p_next);
 			Log::line("p_prev : ", curr->p_prev);
 			switch (curr->type) {
@@ -171,7 +166,7 @@ namespace xlang {
 		}
 		
 		Log::line("}");
-		function->print();
+		Tree::id_expr(function)->print();
 		for (auto &e: expression_list) {
 			e->print();
 		}
@@ -232,7 +227,7 @@ namespace xlang {
 		switch (expr_kind) {
 			case ExpressionType::PRIMARY_EXPR :
 				Log::line("  [primary expression : ", primary_expr, "]");
-				primary_expr->print();
+				Tree::primary_expr(primary_expr)->print();
 				break;
 			case ExpressionType::ASSGN_EXPR :
 				Log::line("  [assignment expression : ", assgn_expr, "]");
@@ -248,7 +243,7 @@ namespace xlang {
 				break;
 			case ExpressionType::ID_EXPR :
 				Log::line("  [id expression : ", id_expr, "]");
-				id_expr->print();
+				Tree::id_expr(id_expr)->print();
 				break;
 			case ExpressionType::FUNC_CALL_EXPR :
 				Log::line("funccall expression : ", call_expr);
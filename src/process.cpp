@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "process.hpp"
+
+extern char **environ;
+
+namespace xlang {
+
+	bool Process::run(const std::vector<std::string> &args, ProcessResult &result, const std::string *input) {
+		result = ProcessResult();
+		if (args.empty()) {
+			errno = EINVAL;
+			return false;
+		}
+
+		std::vector<char *> argv;
+		for (const auto &a: args)
+			argv.push_back(const_cast<char *>(a.c_str()));
+		argv.push_back(nullptr);
+
+		// close on exec so children spawned by other threads at
+		// the same time don't keep our pipes open
+		int out[2] = {-1, -1}, err[2] = {-1, -1}, in[2] = {-1, -1};
+		if (pipe2(out, O_CLOEXEC) < 0 || pipe2(err, O_CLOEXEC) < 0
+			|| (input != nullptr && pipe2(in, O_CLOEXEC) < 0)) {
+			for (int fd: {out[0], out[1], err[0], err[1], in[0], in[1]}) {
+				if (fd >= 0)
+					close(fd);
+			}
+			return false;
+		}
+
+		posix_spawn_file_actions_t actions;
+		posix_spawn_file_actions_init(&actions);
+		posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+		posix_spawn_file_actions_adddup2(&actions, err[1], STDERR_FILENO);
+		if (input != nullptr)
+			posix_spawn_file_actions_adddup2(&actions, in[0], STDIN_FILENO);
+
+		pid_t pid;
+		int rc = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+		posix_spawn_file_actions_destroy(&actions);
+		close(out[1]);
+		close(err[1]);
+		if (input != nullptr)
+			close(in[0]);
+		if (rc != 0) {
+			close(out[0]);
+			close(err[0]);
+			if (input != nullptr)
+				close(in[1]);
+			errno = rc;
+			return false;
+		}
+
+		// input is written while output is read, a child that
+		// answers before it read everything can't block us
+
+		pollfd fds[3] = {{out[0], POLLIN, 0}, {err[0], POLLIN, 0}, {in[1], POLLOUT, 0}};
+		std::string *text[2] = {&result.out, &result.err};
+		size_t written = 0;
+		char buffer[16384];
+		if (input != nullptr && input->empty()) {
+			close(in[1]);
+			fds[2].fd = -1;
+		}
+		while (fds[0].fd >= 0 || fds[1].fd >= 0) {
+			if (poll(fds, 3, -1) < 0) {
+				if (errno == EINTR)
+					continue;
+				break;
+			}
+			for (int i = 0; i < 2; i++) {
+				if (fds[i].fd < 0 || fds[i].revents == 0)
+					continue;
+				ssize_t n = read(fds[i].fd, buffer, sizeof(buffer));
+				if (n < 0 && errno == EINTR)
+					continue;
+				if (n <= 0) {
+					close(fds[i].fd);
+					fds[i].fd = -1;
+					continue;
+				}
+				text[i]->append(buffer, n);
+			}
+			if (fds[2].fd >= 0 && fds[2].revents != 0) {
+				// no more than PIPE_BUF, POLLOUT only promises that much won't block
+				size_t size = std::min<size_t>(PIPE_BUF, input->size() - written);
+				ssize_t n = (fds[2].revents & POLLOUT) ? write(fds[2].fd, input->data() + written, size) : -1;
+				if (n > 0)
+					written += n;
+				if ((n < 0 && errno != EINTR && errno != EAGAIN) || written == input->size()) {
+					close(fds[2].fd);
+					fds[2].fd = -1;
+				}
+			}
+		}
+		for (auto &f: fds) {
+			if (f.fd >= 0)
+				close(f.fd);
+		}
+
+		int status;
+		while (waitpid(pid, &status, 0) < 0) {
+			if (errno != EINTR)
+				return true;
+		}
+		if (WIFEXITED(status)) {
+			result.status = WEXITSTATUS(status);
+		}
+		else if (WIFSIGNALED(status)) {
+			result.signal = WTERMSIG(status);
+			result.status = 128 + result.signal;
+		}
+		return true;
+	}
+
+	std::string Process::command_line(const std::vector<std::string> &args) {
+		std::string line;
+		for (const auto &a: args) {
+			if (!line.empty())
+				line += ' ';
+			if (a.find_first_of(" \t'\"\\$") == std::string::npos && !a.empty())
+				line += a;
+			else {
+				line += '\'';
+				for (char c: a)
+					line += (c == '\'' ? std::string("'\\''") : std::string(1, c));
+				line += '\'';
+			}
+		}
+		return line;
+	}
+}
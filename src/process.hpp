@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace xlang {
+
+	struct ProcessResult {
+		int status{-1};     // exit code, 128 + signal number if it was killed
+		int signal{0};
+		std::string out;
+		std::string err;
+	};
+
+	// runs the tools (nasm, gcc) with posix_spawn, no shell in between
+	//
+	// the program is looked up in PATH, its stdout and stderr are read
+	// separately until both are closed. stdin is inherited unless input
+	// is given. safe to call from several threads
+
+	class Process {
+	public:
+		// false if the program couldn't be started, callers
+		// passing input should ignore SIGPIPE
+		static bool run(const std::vector<std::string> &, ProcessResult &, const std::string *input = nullptr);
+
+		// argv as it would be typed in a shell, for messages
+		static std::string command_line(const std::vector<std::string> &);
+	};
+}
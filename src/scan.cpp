@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include "scan.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SCAN_X86 1
+#endif
+
+namespace xlang {
+
+	struct ScanImpl {
+		const char *name;
+		size_t (*spaces)(const char *, size_t);
+		size_t (*identifier)(const char *, size_t);
+		size_t (*find)(const char *, size_t, char, char, char);
+	};
+
+	// scalar, the class table one character at a time
+
+	static size_t spaces_scalar(const char *text, size_t size) {
+		size_t i = 0;
+		while (i < size && Scan::is(text[i], CHAR_SPACE))
+			i++;
+		return i;
+	}
+
+	static size_t identifier_scalar(const char *text, size_t size) {
+		size_t i = 0;
+		while (i < size && Scan::is(text[i], CHAR_NONDIGIT | CHAR_DIGIT))
+			i++;
+		return i;
+	}
+
+	static size_t find_scalar(const char *text, size_t size, char a, char b, char c) {
+		size_t i = 0;
+		while (i < size && text[i] != a && text[i] != b && text[i] != c)
+			i++;
+		return i;
+	}
+
+#ifdef SCAN_X86
+
+	// the vector versions look at whole blocks and leave the rest to the
+	// scalar ones, nothing past size is read. characters are compared as
+	// signed bytes, anything above 127 is below every range
+
+	__attribute__((target("sse2")))
+	static inline __m128i in_range_sse2(__m128i v, char lo, char hi) {
+		return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+	}
+
+	__attribute__((target("sse2")))
+	static size_t spaces_sse2(const char *text, size_t size) {
+		size_t i = 0;
+		for (; i + 16 <= size; i += 16) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i));
+			__m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+			unsigned other = ~static_cast<unsigned>(_mm_movemask_epi8(m)) & 0xffff;
+			if (other != 0)
+				return i + __builtin_ctz(other);
+		}
+		return i + spaces_scalar(text + i, size - i);
+	}
+
+	__attribute__((target("sse2")))
+	static size_t identifier_sse2(const char *text, size_t size) {
+		size_t i = 0;
+		for (; i + 16 <= size; i += 16) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i));
+			__m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+			__m128i m = _mm_or_si128(in_range_sse2(lower, 'a', 'z'), in_range_sse2(v, '0', '9'));
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('$')));
+			unsigned other = ~static_cast<unsigned>(_mm_movemask_epi8(m)) & 0xffff;
+			if (other != 0)
+				return i + __builtin_ctz(other);
+		}
+		return i + identifier_scalar(text + i, size - i);
+	}
+
+	__attribute__((target("sse2")))
+	static size_t find_sse2(const char *text, size_t size, char a, char b, char c) {
+		size_t i = 0;
+		__m128i va = _mm_set1_epi8(a), vb = _mm_set1_epi8(b), vc = _mm_set1_epi8(c);
+		for (; i + 16 <= size; i += 16) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i));
+			__m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)), _mm_cmpeq_epi8(v, vc));
+			unsigned found = static_cast<unsigned>(_mm_movemask_epi8(m));
+			if (found != 0)
+				return i + __builtin_ctz(found);
+		}
+		return i + find_scalar(text + i, size - i, a, b, c);
+	}
+
+	__attribute__((target("avx2")))
+	static inline __m256i in_range_avx2(__m256i v, char lo, char hi) {
+		return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(lo - 1)),
+								_mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), v));
+	}
+
+	__attribute__((target("avx2")))
+	static size_t spaces_avx2(const char *text, size_t size) {
+		size_t i = 0;
+		for (; i + 32 <= size; i += 32) {
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + i));
+			__m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+			unsigned other = ~static_cast<unsigned>(_mm256_movemask_epi8(m));
+			if (other != 0)
+				return i + __builtin_ctz(other);
+		}
+		return i + spaces_sse2(text + i, size - i);
+	}
+
+	__attribute__((target("avx2")))
+	static size_t identifier_avx2(const char *text, size_t size) {
+		size_t i = 0;
+		for (; i + 32 <= size; i += 32) {
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + i));
+			__m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+			__m256i m = _mm256_or_si256(in_range_avx2(lower, 'a', 'z'), in_range_avx2(v, '0', '9'));
+			m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+			m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('$')));
+			unsigned other = ~static_cast<unsigned>(_mm256_movemask_epi8(m));
+			if (other != 0)
+				return i + __builtin_ctz(other);
+		}
+		return i + identifier_sse2(text + i, size - i);
+	}
+
+	__attribute__((target("avx2")))
+	static size_t find_avx2(const char *text, size_t size, char a, char b, char c) {
+		size_t i = 0;
+		__m256i va = _mm256_set1_epi8(a), vb = _mm256_set1_epi8(b), vc = _mm256_set1_epi8(c);
+		for (; i + 32 <= size; i += 32) {
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + i));
+			__m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb)),
+										_mm256_cmpeq_epi8(v, vc));
+			unsigned found = static_cast<unsigned>(_mm256_movemask_epi8(m));
+			if (found != 0)
+				return i + __builtin_ctz(found);
+		}
+		return i + find_sse2(text + i, size - i, a, b, c);
+	}
+
+#endif
+
+	static const ScanImpl scalar_impl = {"scalar", spaces_scalar, identifier_scalar, find_scalar};
+
+	static ScanImpl pick() {
+
+		// XLANG_SCAN=scalar|sse2|avx2 asks for one, for testing and
+		// benchmarks. one the cpu doesn't have is never used
+
+		const char *want = getenv("XLANG_SCAN");
+#ifdef SCAN_X86
+		__builtin_cpu_init();
+		bool avx2 = __builtin_cpu_supports("avx2");
+		bool sse2 = __builtin_cpu_supports("sse2");
+		if (want != nullptr && strcmp(want, "scalar") == 0)
+			return scalar_impl;
+		if (avx2 && (want == nullptr || strcmp(want, "avx2") == 0))
+			return {"avx2", spaces_avx2, identifier_avx2, find_avx2};
+		if (sse2)
+			return {"sse2", spaces_sse2, identifier_sse2, find_sse2};
+#endif
+		(void) want;
+		return scalar_impl;
+	}
+
+	static const ScanImpl &impl() {
+		static const ScanImpl chosen = pick();
+		return chosen;
+	}
+
+	size_t Scan::long_spaces(const char *text, size_t size) {
+		return impl().spaces(text, size);
+	}
+
+	size_t Scan::long_identifier(const char *text, size_t size) {
+		return impl().identifier(text, size);
+	}
+
+	size_t Scan::long_find(const char *text, size_t size, char a, char b, char c) {
+		return impl().find(text, size, a, b, c);
+	}
+
+	const char *Scan::name() {
+		return impl().name;
+	}
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace xlang {
+
+	// classes of a character, a character can be in several
+	enum CharClass : uint8_t {
+		CHAR_SYMBOL = 1,     // ends identifiers and literals
+		CHAR_DIGIT = 2,
+		CHAR_OCTAL = 4,
+		CHAR_HEX = 8,
+		CHAR_NONDIGIT = 16,  // starts an identifier
+		CHAR_SPACE = 32,     // blank inside a line
+	};
+
+	// the class table, built at compile time
+	constexpr std::array<uint8_t, 256> char_classes() {
+		std::array<uint8_t, 256> t{};
+		for (const char *s = "\t\n !\"%&'()*+,-./:;<=>?@[\\]^`{|}~"; *s; s++)
+			t[(unsigned char) *s] |= CHAR_SYMBOL;
+		for (int c = '0'; c <= '9'; c++)
+			t[c] |= CHAR_DIGIT | CHAR_HEX | (c <= '7' ? CHAR_OCTAL : 0);
+		for (int c = 'a'; c <= 'z'; c++) {
+			t[c] |= CHAR_NONDIGIT | (c <= 'f' ? CHAR_HEX : 0);
+			t[c - 'a' + 'A'] |= CHAR_NONDIGIT | (c <= 'f' ? CHAR_HEX : 0);
+		}
+		t['_'] |= CHAR_NONDIGIT;
+		t['$'] |= CHAR_NONDIGIT;
+		t[' '] |= CHAR_SPACE;
+		t['\t'] |= CHAR_SPACE;
+		return t;
+	}
+
+	// character classes for the lexer and runs of characters found 16 or
+	// 32 at a time with SSE2 or AVX2, whichever the cpu has. others use
+	// the class table one character at a time
+
+	class Scan {
+	public:
+
+		static constexpr std::array<uint8_t, 256> classes = char_classes();
+
+		static constexpr bool is(char ch, uint8_t cls) {
+			return (classes[(unsigned char) ch] & cls) != 0;
+		}
+
+		// most runs in a program are a few characters long, those are
+		// found here before calling the vector code
+
+		// length of the run of spaces and tabs at the start of text
+		static size_t spaces(const char *text, size_t size) {
+			size_t i = 0;
+			for (; i < size && i < 8; i++) {
+				if (!is(text[i], CHAR_SPACE))
+					return i;
+			}
+			return i < size ? i + long_spaces(text + i, size - i) : i;
+		}
+
+		// length of the run of identifier characters, letters, digits, _ and $
+		static size_t identifier(const char *text, size_t size) {
+			size_t i = 0;
+			for (; i < size && i < 8; i++) {
+				if (!is(text[i], CHAR_NONDIGIT | CHAR_DIGIT))
+					return i;
+			}
+			return i < size ? i + long_identifier(text + i, size - i) : i;
+		}
+
+		// index of the first a, b or c, size if there is none
+		static size_t find(const char *text, size_t size, char a, char b, char c) {
+			size_t i = 0;
+			for (; i < size && i < 8; i++) {
+				if (text[i] == a || text[i] == b || text[i] == c)
+					return i;
+			}
+			return i < size ? i + long_find(text + i, size - i, a, b, c) : i;
+		}
+
+		// which implementation is used, for benchmarks
+		static const char *name();
+
+	private:
+
+		static size_t long_spaces(const char *, size_t);
+
+		static size_t long_identifier(const char *, size_t);
+
+		static size_t long_find(const char *, size_t, char, char, char);
+	};
+}
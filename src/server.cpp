@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include <cstring>
+#include <csignal>
+#include <exception>
+#include <cstdint>
+#include <iostream>
+#include <streambuf>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "server.hpp"
+#include "cache.hpp"
+#include "log.hpp"
+
+namespace xlang {
+
+	// message kinds
+	static const char MSG_ARG = 'a';      // client: working directory, then arguments
+	static const char MSG_RUN = 'r';      // client: end of request
+	static const char MSG_OUTPUT = 'o';   // server: output text
+	static const char MSG_STATUS = 's';   // server: exit status, last message
+
+	static const size_t MAX_MESSAGE = 64 << 20;
+
+	// a client that connects has this long to send each message of its
+	// request, one that sends nothing can't hold up the others
+	static const int RECEIVE_TIMEOUT = 10;   // seconds
+
+	static char socket_path[sizeof(sockaddr_un::sun_path)];
+
+	static void stop_server(int) {
+		unlink(socket_path);
+		_exit(0);
+	}
+
+	// sends output to the client a line at a time so
+	// diagnostics show up while the compilation runs
+
+	class SocketBuf : public std::streambuf {
+	public:
+		typedef std::function<bool(const std::string &)> Sender;
+
+		explicit SocketBuf(Sender s) : send(std::move(s)) {}
+
+		~SocketBuf() override {
+			sync();
+		}
+
+	protected:
+		int overflow(int ch) override {
+			if (ch == traits_type::eof())
+				return traits_type::not_eof(ch);
+			buffer += static_cast<char>(ch);
+			if (ch == '\n' || buffer.size() >= 4096)
+				sync();
+			return ch;
+		}
+
+		std::streamsize xsputn(const char *s, std::streamsize n) override {
+			buffer.append(s, n);
+			if (buffer.find('\n') != std::string::npos || buffer.size() >= 4096)
+				sync();
+			return n;
+		}
+
+		int sync() override {
+			if (!buffer.empty()) {
+				send(buffer);
+				buffer.clear();
+			}
+			return 0;
+		}
+
+	private:
+		Sender send;
+		std::string buffer;
+	};
+
+	bool Server::read_all(int fd, void *data, size_t size) {
+		char *p = static_cast<char *>(data);
+		while (size > 0) {
+			ssize_t n = read(fd, p, size);
+			if (n < 0 && errno == EINTR)
+				continue;
+			if (n <= 0)
+				return false;
+			p += n;
+			size -= n;
+		}
+		return true;
+	}
+
+	bool Server::write_all(int fd, const void *data, size_t size) {
+		const char *p = static_cast<const char *>(data);
+		while (size > 0) {
+			ssize_t n = write(fd, p, size);
+			if (n < 0 && errno == EINTR)
+				continue;
+			if (n <= 0)
+				return false;
+			p += n;
+			size -= n;
+		}
+		return true;
+	}
+
+	bool Server::send_message(int fd, char kind, const std::string &payload) {
+		uint32_t size = payload.size();
+		return write_all(fd, &kind, 1) && write_all(fd, &size, sizeof(size))
+			   && write_all(fd, payload.data(), payload.size());
+	}
+
+	bool Server::receive_message(int fd, char &kind, std::string &payload) {
+		uint32_t size;
+		if (!read_all(fd, &kind, 1) || !read_all(fd, &size, sizeof(size)) || size > MAX_MESSAGE)
+			return false;
+		payload.resize(size);
+		return read_all(fd, payload.data(), size);
+	}
+
+	static int open_socket(const std::string &path, sockaddr_un &addr) {
+		if (path.size() >= sizeof(addr.sun_path)) {
+			Log::line("socket path too long: ", path);
+			return -1;
+		}
+		std::memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		std::strcpy(addr.sun_path, path.c_str());
+		return socket(AF_UNIX, SOCK_STREAM, 0);
+	}
+
+	int Server::serve(const std::string &path, const Handler &handler) {
+		sockaddr_un addr;
+		int fd = open_socket(path, addr);
+		if (fd < 0)
+			return -1;
+
+		// only the owner may connect, a request runs as the owner in
+		// the directory it names
+		unlink(path.c_str());
+		mode_t mask = umask(0177);
+		int bound = bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+		umask(mask);
+		if (bound < 0 || listen(fd, 16) < 0) {
+			Log::line("can't listen on ", path, ": ", std::strerror(errno));
+			close(fd);
+			return -1;
+		}
+
+		std::strcpy(socket_path, path.c_str());
+		signal(SIGINT, stop_server);
+		signal(SIGTERM, stop_server);
+		signal(SIGPIPE, SIG_IGN);
+
+		while (true) {
+			int client = accept(fd, nullptr, nullptr);
+			if (client < 0) {
+				if (errno == EINTR)
+					continue;
+				break;
+			}
+
+			timeval timeout = {RECEIVE_TIMEOUT, 0};
+			setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+			std::vector<std::string> args;
+			char kind = 0;
+			std::string payload;
+			while (receive_message(client, kind, payload) && kind == MSG_ARG)
+				args.push_back(payload);
+
+			if (kind == MSG_RUN && !args.empty()) {
+				int status;
+				{
+					SocketBuf buf([client](const std::string &s) { return send_message(client, MSG_OUTPUT, s); });
+					std::ostream out(&buf);
+					std::ostream *prev_out = Log::out;
+					Log::out = &out;
+
+					if (chdir(args[0].c_str()) == 0) {
+						// a request that fails fails alone, the server goes on
+						try {
+							Cache::reset_stats();
+							status = handler(std::vector<std::string>(args.begin() + 1, args.end()), out);
+						}
+						catch (const std::exception &e) {
+							Log::line(e.what());
+							status = -1;
+						}
+					}
+					else {
+						Log::line("can't change to ", args[0], ": ", std::strerror(errno));
+						status = -1;
+					}
+					out.flush();
+					Log::out = prev_out;
+				}
+				int32_t s = status;
+				send_message(client, MSG_STATUS, std::string(reinterpret_cast<char *>(&s), sizeof(s)));
+			}
+			close(client);
+		}
+
+		close(fd);
+		unlink(path.c_str());
+		return -1;
+	}
+
+	bool Server::connect(const std::string &path, const std::vector<std::string> &args, int &status) {
+		sockaddr_un addr;
+		int fd = open_socket(path, addr);
+		if (fd < 0)
+			return false;
+		if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+			close(fd);
+			return false;
+		}
+		signal(SIGPIPE, SIG_IGN);
+
+		char cwd[4096];
+		bool sent = getcwd(cwd, sizeof(cwd)) != nullptr && send_message(fd, MSG_ARG, cwd);
+		for (size_t i = 0; sent && i < args.size(); i++)
+			sent = send_message(fd, MSG_ARG, args[i]);
+		if (!sent || !send_message(fd, MSG_RUN, "")) {
+			close(fd);
+			return false;
+		}
+
+		// once the request is out the server owns it, a lost
+		// connection is a failed compilation, not a reason to retry
+
+		status = -1;
+		char kind;
+		std::string payload;
+		while (receive_message(fd, kind, payload)) {
+			if (kind == MSG_OUTPUT) {
+				std::cout << payload << std::flush;
+			}
+			else if (kind == MSG_STATUS && payload.size() == sizeof(int32_t)) {
+				int32_t s;
+				std::memcpy(&s, payload.data(), sizeof(s));
+				status = s;
+				break;
+			}
+		}
+		close(fd);
+		return true;
+	}
+}
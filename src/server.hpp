@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <functional>
+
+namespace xlang {
+
+	// compile server (--server) and its client (--connect)
+	//
+	// a request is the client's working directory and command line, the
+	// reply is the output of the command as it is produced, then its exit
+	// status. requests are served one at a time because output files are
+	// written relative to the working directory, each one can still use -j.
+	//
+	// every message is a one byte kind, a 32 bit length and the payload
+
+	class Server {
+	public:
+		typedef std::function<int(const std::vector<std::string> &, std::ostream &)> Handler;
+
+		// runs until killed
+		static int serve(const std::string &, const Handler &);
+
+		// false if the server can't be reached
+		static bool connect(const std::string &, const std::vector<std::string> &, int &);
+
+	private:
+		static bool send_message(int, char, const std::string &);
+
+		static bool receive_message(int, char &, std::string &);
+
+		static bool read_all(int, void *, size_t);
+
+		static bool write_all(int, const void *, size_t);
+	};
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "source.hpp"
+#include "scan.hpp"
+
+namespace xlang {
+
+	SourceBuffer::~SourceBuffer() {
+		if (mapped)
+			munmap(const_cast<char *>(data), size);
+	}
+
+	std::shared_ptr<SourceBuffer> SourceBuffer::map(const std::string &path) {
+		int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return nullptr;
+
+		struct stat st;
+		if (fstat(fd, &st) < 0 || S_ISDIR(st.st_mode)) {
+			int err = S_ISDIR(st.st_mode) ? EISDIR : errno;
+			close(fd);
+			errno = err;
+			return nullptr;
+		}
+
+		std::shared_ptr<SourceBuffer> buffer(new SourceBuffer());
+
+		// empty files can't be mapped, pipes and the like aren't regular
+		// files and are read instead
+
+		if (S_ISREG(st.st_mode) && st.st_size > 0) {
+			void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (p != MAP_FAILED) {
+				madvise(p, st.st_size, MADV_SEQUENTIAL);
+				buffer->data = static_cast<const char *>(p);
+				buffer->size = st.st_size;
+				buffer->mapped = true;
+				close(fd);
+				return buffer;
+			}
+		}
+
+		char chunk[16384];
+		ssize_t n;
+		while ((n = read(fd, chunk, sizeof(chunk))) != 0) {
+			if (n < 0 && errno == EINTR)
+				continue;
+			if (n < 0) {
+				int err = errno;
+				close(fd);
+				errno = err;
+				return nullptr;
+			}
+			buffer->owned.append(chunk, n);
+		}
+		close(fd);
+		buffer->data = buffer->owned.data();
+		buffer->size = buffer->owned.size();
+		return buffer;
+	}
+
+	std::shared_ptr<SourceBuffer> SourceBuffer::copy(std::string_view text) {
+		std::shared_ptr<SourceBuffer> buffer(new SourceBuffer());
+		buffer->owned = text;
+		buffer->data = buffer->owned.data();
+		buffer->size = buffer->owned.size();
+		return buffer;
+	}
+
+	std::string_view SourceBuffer::keep(std::string text) {
+		// a deque doesn't move its elements when it grows
+		std::lock_guard<std::mutex> lock(keeping);
+		kept.push_back(std::move(text));
+		return kept.back();
+	}
+
+	SourcePosition SourceBuffer::position(TokenLocation loc) const {
+		if (loc.offset == TokenLocation::NO_OFFSET)
+			return {};
+		std::call_once(lines_found, [this]() {
+			line_starts.push_back(0);
+			for (size_t i = 0; i < size;) {
+				i += Scan::find(data + i, size - i, '\n', '\n', '\n') + 1;
+				if (i <= size)
+					line_starts.push_back(i);
+			}
+		});
+		size_t offset = std::min<size_t>(loc.offset, size);
+		auto next = std::upper_bound(line_starts.begin(), line_starts.end(), offset);
+		uint32_t line = next - line_starts.begin();
+		return {line, static_cast<uint32_t>(offset - *(next - 1) + 1)};
+	}
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "token.hpp"
+
+namespace xlang {
+
+	// line and column of a place in the source, both count from 1. a
+	// location without an offset is at 0:0
+	struct SourcePosition {
+		uint32_t line{0};
+		uint32_t col{0};
+	};
+
+	// text of one source file, read only for the whole compilation
+	//
+	// files are mapped with mmap, tokens are views into it so nothing is
+	// copied while lexing. text made up by later passes (folded constants
+	// and the like) is kept here too so it lives as long as the tokens
+
+	class SourceBuffer {
+	public:
+
+		~SourceBuffer();
+
+		SourceBuffer(const SourceBuffer &) = delete;
+
+		SourceBuffer &operator=(const SourceBuffer &) = delete;
+
+		// nullptr if the file can't be opened or read, errno tells why
+		static std::shared_ptr<SourceBuffer> map(const std::string &path);
+
+		// for sources that are not in a file
+		static std::shared_ptr<SourceBuffer> copy(std::string_view);
+
+		std::string_view text() const { return {data, size}; }
+
+		// stays valid until the buffer is destroyed, lexer threads
+		// may keep text at the same time
+		std::string_view keep(std::string);
+
+		// where a token is, from a table of the offsets lines start at.
+		// the table is made the first time, from any thread
+		SourcePosition position(TokenLocation) const;
+
+	private:
+
+		SourceBuffer() = default;
+
+		const char *data{""};
+		size_t size{0};
+		bool mapped{false};
+		std::string owned;
+		std::deque<std::string> kept;
+		std::mutex keeping;
+		mutable std::vector<uint32_t> line_starts;
+		mutable std::once_flag lines_found;
+	};
+}
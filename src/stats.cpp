@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <sys/resource.h>
+#include "stats.hpp"
+
+namespace xlang {
+
+	void Stats::count_allocation(size_t size, size_t usable) {
+		allocations++;
+		allocated_bytes += size;
+		live_bytes += usable;
+		peak_live_bytes = std::max(peak_live_bytes, live_bytes);
+	}
+
+	void Stats::count_free(size_t usable) {
+		live_bytes -= usable;
+	}
+
+	Usage Usage::now(bool children) {
+		Usage u;
+		auto wall = std::chrono::steady_clock::now().time_since_epoch();
+		u.wall_ms = std::chrono::duration<double, std::milli>(wall).count();
+
+		timespec ts{};
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+		u.cpu_ms = ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+		if (children) {
+			rusage ru{};
+			getrusage(RUSAGE_CHILDREN, &ru);
+			u.cpu_ms += (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1e3
+						+ (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e3;
+		}
+
+		u.allocations = Stats::allocations;
+		u.allocated_bytes = Stats::allocated_bytes;
+		return u;
+	}
+
+	long Usage::peak_rss_kb() {
+		rusage ru{};
+		getrusage(RUSAGE_SELF, &ru);
+		return ru.ru_maxrss;
+	}
+
+	Usage Usage::operator-(const Usage &o) const {
+		Usage u;
+		u.wall_ms = wall_ms - o.wall_ms;
+		u.cpu_ms = cpu_ms - o.cpu_ms;
+		u.allocations = allocations - o.allocations;
+		u.allocated_bytes = allocated_bytes - o.allocated_bytes;
+		return u;
+	}
+
+	Usage &Usage::operator+=(const Usage &o) {
+		wall_ms += o.wall_ms;
+		cpu_ms += o.cpu_ms;
+		allocations += o.allocations;
+		allocated_bytes += o.allocated_bytes;
+		return *this;
+	}
+
+	PassStats &Stats::pass(const char *name) {
+		for (auto &p: passes) {
+			if (p.name == name)
+				return p;
+		}
+		passes.push_back(PassStats{name});
+		return passes.back();
+	}
+
+	StatsScope::StatsScope(Stats &s, const char *n, bool ch) : stats(s), name(n), children(ch) {
+		if (!stats.enabled)
+			return;
+		stats.pass(name);
+		parent = stats.current;
+		stats.current = this;
+		start = Usage::now(children);
+
+		// the high water mark starts again here, the one of an outer
+		// pass goes on from where it was when this is done
+		start_live = Stats::live_bytes;
+		outer_peak = Stats::peak_live_bytes;
+		Stats::peak_live_bytes = start_live;
+	}
+
+	StatsScope::~StatsScope() {
+		if (!stats.enabled || stats.current != this)
+			return;
+
+		Usage used = Usage::now(children) - start;
+		PassStats &p = stats.pass(name);
+		p.used += used - inner;
+		p.peak_growth_bytes = std::max<uint64_t>(p.peak_growth_bytes, Stats::peak_live_bytes - start_live);
+		Stats::peak_live_bytes = std::max(outer_peak, Stats::peak_live_bytes);
+
+		if (parent != nullptr)
+			parent->inner += used;
+		stats.current = parent;
+	}
+
+	void Stats::print_times(std::ostream &out, const std::string &file) const {
+		Usage total;
+		out << "time passes: " << file << "\n";
+		out << "  " << std::left << std::setw(16) << "pass" << std::right
+			<< std::setw(12) << "wall ms" << std::setw(12) << "cpu ms" << "\n";
+		out << std::fixed << std::setprecision(3);
+		for (const auto &p: passes) {
+			out << "  " << std::left << std::setw(16) << p.name << std::right
+				<< std::setw(12) << p.used.wall_ms << std::setw(12) << p.used.cpu_ms << "\n";
+			total += p.used;
+		}
+		out << "  " << std::left << std::setw(16) << "total" << std::right
+			<< std::setw(12) << total.wall_ms << std::setw(12) << total.cpu_ms << "\n";
+		out << std::defaultfloat;
+	}
+
+	void Stats::print_memory(std::ostream &out, const std::string &file) const {
+		Usage total;
+		out << "mem stats: " << file << "\n";
+		out << "  " << std::left << std::setw(16) << "pass" << std::right
+			<< std::setw(12) << "allocs" << std::setw(14) << "bytes" << std::setw(14) << "peak growth" << "\n";
+		for (const auto &p: passes) {
+			out << "  " << std::left << std::setw(16) << p.name << std::right
+				<< std::setw(12) << p.used.allocations << std::setw(14) << p.used.allocated_bytes
+				<< std::setw(14) << p.peak_growth_bytes << "\n";
+			total += p.used;
+		}
+		out << "  " << std::left << std::setw(16) << "total" << std::right
+			<< std::setw(12) << total.allocations << std::setw(14) << total.allocated_bytes << "\n";
+		out << "  peak rss of the process: " << Usage::peak_rss_kb() << " kB\n";
+	}
+
+	std::string Stats::json(const std::string &file, int status) const {
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(3);
+		out << "{\"file\": " << json_string(file) << ", \"status\": " << status << ", \"passes\": [";
+		for (size_t i = 0; i < passes.size(); i++) {
+			const PassStats &p = passes[i];
+			out << (i > 0 ? ", " : "")
+				<< "{\"name\": " << json_string(p.name)
+				<< ", \"wall_ms\": " << p.used.wall_ms
+				<< ", \"cpu_ms\": " << p.used.cpu_ms
+				<< ", \"allocations\": " << p.used.allocations
+				<< ", \"allocated_bytes\": " << p.used.allocated_bytes
+				<< ", \"peak_growth_bytes\": " << p.peak_growth_bytes << "}";
+		}
+		out << "]}";
+		return out.str();
+	}
+
+	std::string json_string(const std::string &s) {
+		std::string out = "\"";
+		for (char c: s) {
+			switch (c) {
+				case '"':
+					out += "\\\"";
+					break;
+				case '\\':
+					out += "\\\\";
+					break;
+				case '\n':
+					out += "\\n";
+					break;
+				case '\t':
+					out += "\\t";
+					break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20) {
+						char buf[8];
+						std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+						out += buf;
+					}
+					else
+						out += c;
+					break;
+			}
+		}
+		return out + "\"";
+	}
+}
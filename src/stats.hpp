@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdint>
+
+namespace xlang {
+
+	// what the process (or thread) has used up to some point
+
+	struct Usage {
+		double wall_ms{0};
+		double cpu_ms{0};
+		uint64_t allocations{0};
+		uint64_t allocated_bytes{0};
+
+		// cpu time is the calling thread's, plus finished child
+		// processes if children is set
+		static Usage now(bool children);
+
+		// of the whole process, every file compiled so far included
+		static long peak_rss_kb();
+
+		Usage operator-(const Usage &) const;
+
+		Usage &operator+=(const Usage &);
+	};
+
+	struct PassStats {
+		std::string name;
+		Usage used;
+		uint64_t peak_growth_bytes{0};   // most the heap of the thread grew over the start of one run of the pass
+	};
+
+	class StatsScope;
+
+	// per pass cost of one compilation (--time-passes, --mem-stats)
+	//
+	// passes are measured with StatsScope, a pass running inside another
+	// one (lexing while parsing) is taken out of the outer pass so the
+	// numbers add up to the total
+
+	class Stats {
+	public:
+		bool enabled{false};
+		std::vector<PassStats> passes;
+
+		void print_times(std::ostream &, const std::string &) const;
+
+		void print_memory(std::ostream &, const std::string &) const;
+
+		std::string json(const std::string &, int) const;
+
+		// every operator new and delete of this thread ends up here,
+		// usable is what malloc gave or takes back
+		static void count_allocation(size_t size, size_t usable);
+
+		static void count_free(size_t usable);
+
+	private:
+		friend class StatsScope;
+
+		StatsScope *current{nullptr};
+
+		PassStats &pass(const char *);
+
+		static inline thread_local uint64_t allocations{0};
+		static inline thread_local uint64_t allocated_bytes{0};
+
+		// memory freed on another thread than it was allocated on makes
+		// the count of either thread off, a compilation stays on its own
+		static inline thread_local int64_t live_bytes{0};
+		static inline thread_local int64_t peak_live_bytes{0};
+
+		friend struct Usage;
+	};
+
+	class StatsScope {
+	public:
+		StatsScope(Stats &, const char *, bool children = false);
+
+		~StatsScope();
+
+		StatsScope(const StatsScope &) = delete;
+
+		StatsScope &operator=(const StatsScope &) = delete;
+
+	private:
+		Stats &stats;
+		const char *name;
+		bool children;
+		StatsScope *parent{nullptr};
+		Usage start;
+		Usage inner;
+		int64_t start_live{0};
+		int64_t outer_peak{0};
+	};
+
+	std::string json_string(const std::string &);
+}
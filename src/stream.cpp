@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include <algorithm>
+#include <sstream>
+#include "stream.hpp"
+#include "lex.hpp"
+#include "log.hpp"
+
+namespace xlang {
+
+	// a piece of the file and the tokens that start in it. the lexer
+	// goes on to the first token that starts after the piece, that is
+	// where the next piece has to be in step with it
+
+	struct TokenStream::Piece {
+		size_t begin{0};
+		size_t end{0};
+		std::unique_ptr<Lexer> lex;
+		std::vector<Token> tokens;
+		Token next;
+		bool done{false};    // got to END
+		std::string error;   // lexing failed after the tokens
+	};
+
+	TokenStream::TokenStream(SourceFile &file, unsigned jobs) : text(file.buffer->text()) {
+		if (jobs > 1 && text.size() >= 2 * MIN_PIECE)
+			producer = std::thread(&TokenStream::produce_pieces, this, std::ref(file), Log::level, jobs);
+		else
+			producer = std::thread(&TokenStream::produce, this, std::ref(file), Log::level);
+	}
+
+	TokenStream::~TokenStream() {
+		stop = true;
+		producer.join();
+		TokenChunk *chunk;
+		while (queue.pop(chunk))
+			delete chunk;
+	}
+
+	void TokenStream::produce(SourceFile &file, int level) {
+
+		// a lexer error is thrown, its message is kept in the chunk
+		// after the last token that was made
+
+		std::ostringstream messages;
+		Log::out = &messages;
+		Log::level = level;
+
+		Lexer lex(file);
+		auto chunk = std::make_unique<TokenChunk>();
+		try {
+			lex.init();
+			for (;;) {
+				Token tok = lex.scan();
+				if (!add(chunk, tok))
+					return;
+				if (tok.number == END)
+					break;
+			}
+		}
+		catch (CompileError &) {
+			chunk->error = messages.str();
+		}
+		chunk->last = true;
+		hand_over(chunk.release());
+	}
+
+	void TokenStream::produce_pieces(SourceFile &file, int level, unsigned jobs) {
+
+		// pieces end after a newline. tokens know their offset in the
+		// whole file, where a piece starts doesn't matter to them
+
+		size_t count = std::min<size_t>(jobs, text.size() / MIN_PIECE);
+		std::vector<Piece> pieces;
+		for (size_t i = 0; i < count; i++) {
+			size_t end = text.size();
+			if (i + 1 < count) {
+				end = text.find('\n', text.size() / count * (i + 1));
+				end = (end == std::string_view::npos ? text.size() : end + 1);
+			}
+			size_t begin = pieces.empty() ? 0 : pieces.back().end;
+			if (begin >= end)
+				continue;
+			pieces.emplace_back();
+			pieces.back().begin = begin;
+			pieces.back().end = end;
+			pieces.back().lex = std::make_unique<Lexer>(file);
+			pieces.back().lex->init();
+			pieces.back().lex->buffer_index = begin;
+		}
+
+		std::vector<std::thread> workers;
+		for (size_t i = 1; i < pieces.size(); i++)
+			workers.emplace_back(&TokenStream::lex_piece, std::ref(pieces[i]), level);
+		lex_piece(pieces[0], level);
+		for (auto &w: workers)
+			w.join();
+
+		auto chunk = std::make_unique<TokenChunk>();
+		size_t from = 0;
+		for (size_t i = 0;; i++) {
+			Piece &piece = pieces[i];
+			for (size_t t = from; t < piece.tokens.size(); t++) {
+				if (!add(chunk, piece.tokens[t]))
+					return;
+			}
+			if (!piece.error.empty()) {
+				chunk->error = piece.error;
+				break;
+			}
+			if (piece.done)
+				break;
+
+			// the next piece is in step if its lexer made the same token
+			// at the same place, from there on they make the same ones
+
+			Piece &following = pieces[i + 1];
+			auto at = std::lower_bound(following.tokens.begin(), following.tokens.end(), piece.next.loc.offset,
+									   [](const Token &tok, uint32_t offset) { return tok.loc.offset < offset; });
+			if (following.error.empty() && at != following.tokens.end() &&
+				at->loc.offset == piece.next.loc.offset &&
+				at->number == piece.next.number &&
+				at->string == piece.next.string) {
+				from = at - following.tokens.begin();
+				continue;
+			}
+
+			// it isn't (it starts in a comment or literal) or it failed,
+			// this lexer goes on over it
+
+			following.lex = std::move(piece.lex);
+			following.tokens.assign(1, piece.next);
+			following.done = false;
+			following.error.clear();
+			lex_piece(following, level);
+			from = 0;
+		}
+		chunk->last = true;
+		hand_over(chunk.release());
+	}
+
+	void TokenStream::lex_piece(Piece &piece, int level) {
+		std::ostringstream messages;
+		std::ostream *out = Log::out;
+		int prev_level = Log::level;
+		const SourceBuffer *source = Log::source;
+		Log::out = &messages;
+		Log::level = level;
+		Log::source = piece.lex->file.buffer.get();
+
+		Lexer &lex = *piece.lex;
+		try {
+			for (;;) {
+				Token tok = lex.scan();
+				if (tok.number != END && lex.token_start >= piece.end) {
+					piece.next = tok;
+					break;
+				}
+				piece.tokens.push_back(tok);
+				if (tok.number == END) {
+					piece.done = true;
+					break;
+				}
+			}
+		}
+		catch (CompileError &) {
+			piece.error = messages.str();
+		}
+
+		Log::out = out;
+		Log::level = prev_level;
+		Log::source = source;
+	}
+
+	bool TokenStream::add(std::unique_ptr<TokenChunk> &chunk, const Token &tok) {
+		size_t i = chunk->count++;
+		chunk->ids[i] = tok.number;
+		chunk->widths[i] = tok.width;
+		chunk->locs[i] = tok.loc;
+		chunk->values[i] = tok.value;
+		if (tok.string.empty() || (tok.string.data() >= text.data() && tok.string.data() < text.data() + text.size())) {
+			chunk->offsets[i] = tok.string.empty() ? 0 : tok.string.data() - text.data();
+			chunk->lengths[i] = tok.string.size();
+		}
+		else {
+			chunk->offsets[i] = chunk->made.size();
+			chunk->lengths[i] = tok.string.size() | TokenChunk::MADE;
+			chunk->made.push_back(tok.string);
+		}
+
+		if (chunk->count < TokenChunk::SIZE)
+			return true;
+		if (!hand_over(chunk.release()))
+			return false;
+		chunk = std::make_unique<TokenChunk>();
+		return true;
+	}
+
+	bool TokenStream::hand_over(TokenChunk *chunk) {
+		while (!queue.push(chunk)) {
+			if (stop) {
+				delete chunk;
+				return false;
+			}
+			std::this_thread::yield();
+		}
+		return true;
+	}
+
+	Token TokenStream::get(size_t i) {
+		size_t n = i / TokenChunk::SIZE;
+		size_t at = i % TokenChunk::SIZE;
+
+		while (n >= chunks.size() && (chunks.empty() || !chunks.back()->last)) {
+			TokenChunk *chunk;
+			if (queue.pop(chunk))
+				chunks.emplace_back(chunk);
+			else
+				std::this_thread::yield();
+		}
+
+		Token tok;
+		if (n < chunks.size() && at < chunks[n]->count) {
+			const TokenChunk &c = *chunks[n];
+			tok.number = c.ids[at];
+			tok.width = c.widths[at];
+			tok.loc = c.locs[at];
+			tok.value = c.values[at];
+			if (c.lengths[at] & TokenChunk::MADE)
+				tok.string = c.made[c.offsets[at]];
+			else
+				tok.string = text.substr(c.offsets[at], c.lengths[at]);
+			return tok;
+		}
+
+		if (!chunks.back()->error.empty()) {
+			*Log::out << chunks.back()->error;
+			throw CompileError();
+		}
+		tok.number = END;
+		return tok;
+	}
+}
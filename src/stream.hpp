@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "file.hpp"
+#include "token.hpp"
+
+namespace xlang {
+
+	// fixed size queue between one producer and one consumer thread.
+	// push and pop never lock or wait, they fail when it is full or
+	// empty and the caller decides what to do
+
+	template<typename T, size_t N>
+	class SpscQueue {
+	public:
+
+		bool push(T value) {
+			size_t t = tail.load(std::memory_order_relaxed);
+			if (t - head.load(std::memory_order_acquire) == N)
+				return false;
+			items[t % N] = std::move(value);
+			tail.store(t + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool pop(T &value) {
+			size_t h = head.load(std::memory_order_relaxed);
+			if (tail.load(std::memory_order_acquire) == h)
+				return false;
+			value = std::move(items[h % N]);
+			head.store(h + 1, std::memory_order_release);
+			return true;
+		}
+
+	private:
+
+		std::array<T, N> items;
+		alignas(64) std::atomic<size_t> head{0};
+		alignas(64) std::atomic<size_t> tail{0};
+	};
+
+	// a run of tokens in columns, the text of a token is an offset and
+	// length in the source. text that isn't in the source (made up while
+	// recovering from errors) is in made, with MADE set in the length
+
+	struct TokenChunk {
+		static constexpr size_t SIZE = 4096;
+		static constexpr uint32_t MADE = 0x80000000u;
+
+		size_t count{0};
+		std::array<TokenId, SIZE> ids;
+		std::array<uint8_t, SIZE> widths;
+		std::array<uint32_t, SIZE> offsets;
+		std::array<uint32_t, SIZE> lengths;
+		std::array<TokenLocation, SIZE> locs;
+		std::array<LiteralValue, SIZE> values;
+		std::vector<std::string_view> made;
+
+		// the chunk with END, or the one where lexing failed
+		bool last{false};
+		std::string error;
+	};
+
+	// the tokens of a file, lexed ahead on a thread of its own
+	//
+	// the lexer thread fills chunks and hands them over through a
+	// queue, get() takes them as the parser gets to them. tokens are
+	// numbered from the start of the file so going back is arithmetic
+	//
+	// with more than one job a large file is cut in pieces at newlines
+	// and the pieces are lexed at the same time. a piece that starts in
+	// a comment or literal is lexed again after the one before it, the
+	// tokens are the same as lexing the whole file in one go
+
+	class TokenStream {
+	public:
+
+		// pieces of a file are at least this long
+		static constexpr size_t MIN_PIECE = 64 * 1024;
+
+		// the buffer of the file has to be loaded already
+		TokenStream(SourceFile &, unsigned jobs);
+
+		~TokenStream();
+
+		TokenStream(const TokenStream &) = delete;
+
+		TokenStream &operator=(const TokenStream &) = delete;
+
+		// token i of the file, END past the end. a lexer error is
+		// reported when its token is asked for, as it would be lexing
+		// on this thread
+		Token get(size_t i);
+
+	private:
+
+		std::string_view text;
+		std::vector<std::unique_ptr<TokenChunk>> chunks;
+		SpscQueue<TokenChunk *, 64> queue;
+		std::atomic<bool> stop{false};
+		std::thread producer;
+
+		struct Piece;
+
+		void produce(SourceFile &, int);
+
+		void produce_pieces(SourceFile &, int, unsigned);
+
+		static void lex_piece(Piece &, int);
+
+		bool add(std::unique_ptr<TokenChunk> &, const Token &);
+
+		bool hand_over(TokenChunk *);
+	};
+}
@@ -9,8 +9,9 @@
 
 #include <list>
 #include "symtab.hpp"
-#include "compiler.hpp"
+#include "log.hpp"
 #include "murmurhash3.hpp"
+#include "arena.hpp"
 
 namespace xlang {
 	//each inserted symbol node and record node can be accessed
@@ -26,17 +27,17 @@ namespace xlang {
 	
 	//memory allocation functions
 	TypeInfo *SymbolTable::get_type_info_mem() {
-		TypeInfo *newst = new TypeInfo();
+		TypeInfo *newst = Arena::current().make<TypeInfo>();
 		return newst;
 	}
 	
 	RecordTypeInfo *SymbolTable::get_rec_type_info_mem() {
-		RecordTypeInfo *newst = new RecordTypeInfo;
+		RecordTypeInfo *newst = Arena::current().make<RecordTypeInfo>();
 		return newst;
 	}
 	
 	SymbolInfo *SymbolTable::get_symbol_info_mem() {
-		SymbolInfo *newst = new SymbolInfo();
+		SymbolInfo *newst = Arena::current().make<SymbolInfo>();
 		newst->type_info = nullptr;
 		newst->p_next = nullptr;
 		newst->is_array = false;
@@ -45,7 +46,7 @@ namespace xlang {
 	}
 	
 	FuncParamInfo *SymbolTable::get_func_param_info_mem() {
-		FuncParamInfo *newst = new FuncParamInfo();
+		FuncParamInfo *newst = Arena::current().make<FuncParamInfo>();
 		newst->symbol_info = get_symbol_info_mem();
 		newst->symbol_info->tok.number = NONE;
 		newst->type_info = get_type_info_mem();
@@ -53,19 +54,19 @@ namespace xlang {
 	}
 	
 	FunctionInfo *SymbolTable::get_func_info_mem() {
-		FunctionInfo *newst = new FunctionInfo();
+		FunctionInfo *newst = Arena::current().make<FunctionInfo>();
 		newst->return_type = nullptr;
 		return newst;
 	}
 	
-	std::map<std::string, FunctionInfo *> *SymbolTable::get_func_table_mem() {
-		std::map<std::string, FunctionInfo *> *newst = new std::map<std::string, FunctionInfo *>();
+	FunctionMap *SymbolTable::get_func_table_mem() {
+		FunctionMap *newst = Arena::current().make<FunctionMap>();
 		return newst;
 	}
 	
 	Node *SymbolTable::get_node_mem() {
 		unsigned i;
-		Node *newst = new Node();
+		Node *newst = Arena::current().make<Node>();
 		newst->func_info = nullptr;
 		for (i = 0; i < ST_SIZE; i++)
 			newst->symbol_info[i] = nullptr;
@@ -73,7 +74,7 @@ namespace xlang {
 	}
 	
 	RecordNode *SymbolTable::get_record_node_mem() {
-		RecordNode *newrst = new RecordNode();
+		RecordNode *newrst = Arena::current().make<RecordNode>();
 		newrst->p_next = nullptr;
 		newrst->symtab = get_node_mem();
 		return newrst;
@@ -81,7 +82,7 @@ namespace xlang {
 	
 	RecordSymtab *SymbolTable::get_record_symtab_mem() {
 		unsigned i;
-		RecordSymtab *recsymt = new RecordSymtab();
+		RecordSymtab *recsymt = Arena::current().make<RecordSymtab>();
 		for (i = 0; i < ST_RECORD_SIZE; i++)
 			recsymt->recordinfo[i] = nullptr;
 		return recsymt;
@@ -89,182 +90,63 @@ namespace xlang {
 	
 	//memory deallocation functions
 	
-	void SymbolTable::delete_type_info(TypeInfo **stinf) {
-		if (*stinf == nullptr)
-			return;
-		//delete *stinf;
-		*stinf = nullptr;
-	}
-	
-	void SymbolTable::delete_rec_type_info(RecordTypeInfo **stinf) {
-		if (*stinf == nullptr)
-			return;
-		//delete *stinf;
-		*stinf = nullptr;
-	}
-	
-	void SymbolTable::delete_symbol_info(SymbolInfo **stinf) {
-		if (*stinf == nullptr)
-			return;
-		SymbolInfo *temp = *stinf;
-		std::list<RecordTypeInfo *>::iterator it;
-		while (temp != nullptr) {
-			delete_type_info(&(temp->type_info));
-			it = temp->func_ptr_params_list.begin();
-			while (it != temp->func_ptr_params_list.end()) {
-				delete_rec_type_info(&(*it));
-				it++;
-			}
-			temp->arr_dimension_list.clear();
-			temp = temp->p_next;
-		}
-		*stinf = nullptr;
-	}
-	
-	void SymbolTable::delete_func_param_info(FuncParamInfo **stinf) {
-		if (*stinf == nullptr)
-			return;
-		delete_type_info(&((*stinf)->type_info));
-		delete_symbol_info(&((*stinf)->symbol_info));
-		delete *stinf;
-		*stinf = nullptr;
-	}
-	
-	void SymbolTable::delete_func_info(FunctionInfo **stinf) {
-		if (*stinf == nullptr)
-			return;
-		delete_type_info(&((*stinf)->return_type));
-		std::list<FuncParamInfo *>::iterator it;
-		it = (*stinf)->param_list.begin();
-		while (it != (*stinf)->param_list.end()) {
-			delete_func_param_info(&(*it));
-			it++;
-		}
-		delete *stinf;
-		*stinf = nullptr;
-	}
-	
-	void SymbolTable::delete_node(Node **stinf) {
-		Node *temp = *stinf;
-		unsigned i;
-		if (temp == nullptr)
-			return;
-		delete_func_info(&(temp->func_info));
-		for (i = 0; i < ST_SIZE; i++) {
-			delete_symbol_info(&(temp->symbol_info[i]));
-		}
-		delete *stinf;
-		*stinf = nullptr;
-	}
-	
-	void SymbolTable::delete_record_node(RecordNode **stinf) {
-		RecordNode *temp = *stinf;
-		if (*stinf == nullptr)
-			return;
-		while (temp != nullptr) {
-			delete_node(&temp->symtab);
-			temp = temp->p_next;
-		}
-		delete *stinf;
-		*stinf = nullptr;
-	}
-	
-	void SymbolTable::delete_record_symtab(RecordSymtab **stinf) {
-		RecordSymtab *temp = *stinf;
-		if (temp == nullptr)
-			return;
-		unsigned i;
-		for (i = 0; i < ST_RECORD_SIZE; i++) {
-			delete_record_node(&temp->recordinfo[i]);
-		}
-	}
-	
-	void SymbolTable::delete_func_symtab(std::map<std::string, FunctionInfo *> **stinf) {
-		std::map<std::string, FunctionInfo *> *temp = *stinf;
-		
-		if (temp == nullptr)
-			return;
-		
-		for (const auto &f: *temp) {
-			if (f.second->return_type != nullptr)
-				delete f.second->return_type;
-			
-			for (const auto &p: f.second->param_list)
-				delete p;
-			
-			delete f.second;
-		}
-		
-	}
-	
 	
 	//hashing functions
-	unsigned int SymbolTable::st_hash_code(std::string lxt) {
-		void *key = (void *) lxt.c_str();
+	unsigned int SymbolTable::st_hash_code(std::string_view lxt) {
+		const void *key = lxt.data();
 		unsigned int murhash = MurmurHash3_x86_32(key, lxt.size(), 4);
 		
 		return murhash % ST_SIZE;
 	}
 	
-	unsigned int SymbolTable::st_rec_hash_code(std::string lxt) {
-		void *key = (void *) lxt.c_str();
+	unsigned int SymbolTable::st_rec_hash_code(std::string_view lxt) {
+		const void *key = lxt.data();
 		unsigned int murhash = MurmurHash3_x86_32(key, lxt.size(), 4);
 		return murhash % ST_RECORD_SIZE;
 	}
 	
 	//table operations
-	void SymbolTable::add_sym_node(SymbolInfo **symnode) {
+	SymbolInfo *SymbolTable::add_sym_node(SymbolInfo **symnode) {
 		SymbolInfo *temp = *symnode;
 		if (temp == nullptr) {
 			*symnode = get_symbol_info_mem();
-			Compiler::last_symbol = *symnode;
+			return *symnode;
 		}
-		else {
-			while (temp->p_next != nullptr) {
-				temp = temp->p_next;
-			}
-			temp->p_next = get_symbol_info_mem();
-			Compiler::last_symbol = temp->p_next;
+		
+		while (temp->p_next != nullptr) {
+			temp = temp->p_next;
 		}
+		temp->p_next = get_symbol_info_mem();
+		return temp->p_next;
 	}
 	
-	void SymbolTable::insert_symbol(Node **symtab, std::string symbol) {
+	// symbols stay in the buckets in the order they were declared, the
+	// code generator lays out memory in that order. lookups go through
+	// ids, the bucket is only hashed when a symbol is inserted or removed
+	
+	SymbolInfo *SymbolTable::insert_symbol(Node **symtab, const Token &tok) {
 		Node *symtemp = *symtab;
 		if (symtemp == nullptr)
-			return;
+			return nullptr;
 	
-		add_sym_node(&(symtemp->symbol_info[st_hash_code(symbol)]));
-		if (Compiler::last_symbol == nullptr) {
-			std::cout << "error in inserting symbol into symbol table" << std::endl;
+		SymbolInfo *syminf = add_sym_node(&(symtemp->symbol_info[st_hash_code(tok.string)]));
+		if (syminf == nullptr) {
+			Log::line("error in inserting symbol into symbol table");
+			return nullptr;
 		}
+		symtemp->ids.emplace(tok.name, syminf);
+		return syminf;
 	}
 	
-	bool SymbolTable::search_symbol(Node *st, std::string symbol) {
-		if (st == nullptr)
-			return false;
-		SymbolInfo *temp = nullptr;
-		temp = st->symbol_info[st_hash_code(symbol)];
-		while (temp != nullptr) {
-			if (temp->symbol == symbol)
-				return true;
-			else
-				temp = temp->p_next;
-		}
-		return false;
+	bool SymbolTable::search_symbol(Node *st, NameId symbol) {
+		return search_symbol_node(st, symbol) != nullptr;
 	}
 	
-	SymbolInfo *SymbolTable::search_symbol_node(Node *st, std::string symbol) {
-		if (st == nullptr)
+	SymbolInfo *SymbolTable::search_symbol_node(Node *st, NameId symbol) {
+		if (st == nullptr || symbol == NO_NAME)
 			return nullptr;
-		SymbolInfo *temp = nullptr;
-		temp = st->symbol_info[st_hash_code(symbol)];
-		while (temp != nullptr) {
-			if (temp->symbol == symbol)
-				return temp;
-			else
-				temp = temp->p_next;
-		}
-		return nullptr;
+		auto it = st->ids.find(symbol);
+		return it != st->ids.end() ? it->second : nullptr;
 	}
 	
 	void SymbolTable::insert_symbol_node(Node **symtab, SymbolInfo **syminf) {
@@ -272,32 +154,45 @@ namespace xlang {
 		if (*symtab == nullptr || *syminf == nullptr)
 			return;
 		
-		SymbolInfo *temp = SymbolTable::search_symbol_node(*symtab, (*syminf)->symbol);
+		SymbolInfo *temp = SymbolTable::search_symbol_node(*symtab, (*syminf)->tok.name);
 		if (temp != nullptr)
 			temp = *syminf;
 	}
 	
-	bool SymbolTable::remove_symbol(Node **symtab, std::string symbol) {
+	// what is left of removed symbols and the ones chained after them,
+	// the memory stays in the arena until the compilation is over
+	static void clear_symbol_info(SymbolInfo *syminf) {
+		for (; syminf != nullptr; syminf = syminf->p_next) {
+			syminf->type_info = nullptr;
+			for (auto &param: syminf->func_ptr_params_list)
+				param = nullptr;
+			syminf->arr_dimension_list.clear();
+		}
+	}
+
+	bool SymbolTable::remove_symbol(Node **symtab, NameId symbol) {
 		SymbolInfo *temp = nullptr;
 		SymbolInfo *curr = nullptr;
 		if (*symtab == nullptr)
 			return false;
-		curr = (*symtab)->symbol_info[st_hash_code(symbol)];
+		curr = search_symbol_node(*symtab, symbol);
 		if (curr == nullptr)
 			return false;
-		if (curr->symbol == symbol) {
+		curr = (*symtab)->symbol_info[st_hash_code(curr->symbol)];
+		if (curr->tok.name == symbol) {
 			temp = curr->p_next;
-			delete_symbol_info(&curr);
+			clear_symbol_info(curr);
 			curr = nullptr;
 			curr = temp;
 		}
 		else {
 			temp = curr;
 			while (curr->p_next != nullptr) {
-				if (curr->symbol == symbol) {
+				if (curr->tok.name == symbol) {
 					temp->p_next = curr->p_next;
-					delete_symbol_info(&curr);
+					clear_symbol_info(curr);
 					curr = nullptr;
+					(*symtab)->ids.erase(symbol);
 					return true;
 				}
 				else {
@@ -309,57 +204,42 @@ namespace xlang {
 		return false;
 	}
 	
-	void SymbolTable::add_rec_node(RecordNode **recnode) {
+	RecordNode *SymbolTable::add_rec_node(RecordNode **recnode) {
 		RecordNode *temp = *recnode;
 		if (temp == nullptr) {
 			*recnode = get_record_node_mem();
-			Compiler::last_rec_node = *recnode;
-		}
-		else {
-			while (temp->p_next != nullptr)
-				temp = temp->p_next;
-			
-			temp->p_next = get_record_node_mem();
-			Compiler::last_rec_node = temp;
+			return *recnode;
 		}
+		
+		while (temp->p_next != nullptr)
+			temp = temp->p_next;
+		
+		temp->p_next = get_record_node_mem();
+		return temp->p_next;
 	}
 	
-	void SymbolTable::insert_record(RecordSymtab **recsymtab, std::string recordname) {
+	RecordNode *SymbolTable::insert_record(RecordSymtab **recsymtab, const Token &recordtok) {
 		RecordSymtab *rectemp = *recsymtab;
 		if (rectemp == nullptr)
-			return;
-		add_rec_node(&(rectemp->recordinfo[st_rec_hash_code(recordname)]));
-		if (Compiler::last_rec_node == nullptr) {
-			std::cout << "error in inserting record into record table" << std::endl;
+			return nullptr;
+		RecordNode *recnode = add_rec_node(&(rectemp->recordinfo[st_rec_hash_code(recordtok.string)]));
+		if (recnode == nullptr) {
+			Log::line("error in inserting record into record table");
+			return nullptr;
 		}
+		rectemp->ids.emplace(recordtok.name, recnode);
+		return recnode;
 	}
 	
-	bool SymbolTable::search_record(RecordSymtab *rec, std::string recordname) {
-		if (rec == nullptr)
-			return false;
-		RecordNode *temp = nullptr;
-		temp = rec->recordinfo[st_rec_hash_code(recordname)];
-		while (temp != nullptr) {
-			if (temp->recordname == recordname)
-				return true;
-			else
-				temp = temp->p_next;
-		}
-		return false;
+	bool SymbolTable::search_record(RecordSymtab *rec, NameId recordname) {
+		return search_record_node(rec, recordname) != nullptr;
 	}
 	
-	RecordNode *SymbolTable::search_record_node(RecordSymtab *rec, std::string recordname) {
-		if (rec == nullptr)
+	RecordNode *SymbolTable::search_record_node(RecordSymtab *rec, NameId recordname) {
+		if (rec == nullptr || recordname == NO_NAME)
 			return nullptr;
-		RecordNode *temp = nullptr;
-		temp = rec->recordinfo[st_rec_hash_code(recordname)];
-		while (temp != nullptr) {
-			if (temp->recordname == recordname)
-				return temp;
-			else
-				temp = temp->p_next;
-		}
-		return nullptr;
+		auto it = rec->ids.find(recordname);
+		return it != rec->ids.end() ? it->second : nullptr;
 	}
 	
 }
\ No newline at end of file
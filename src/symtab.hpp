@@ -12,6 +12,7 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <unordered_map>
 #include "token.hpp"
 
 //symbol table and record table size
@@ -80,11 +81,15 @@ namespace xlang {
 		TypeInfo *return_type;  // function return type info
 		std::list<FuncParamInfo *> param_list; //list of function parameters
 	};
+
+	// keyed on the interned name of the function
+	typedef std::unordered_map<NameId, FunctionInfo *> FunctionMap;
 	
 	struct Node {
 		int node_type;           // table type, which is not considered yet
 		FunctionInfo *func_info; // function info in which function does this table belong
 		SymbolInfo *symbol_info[ST_SIZE];  //buckets of symbol info
+		std::unordered_map<NameId, SymbolInfo *> ids;  //symbols of the buckets by interned name
 		void print();
 	};
 	
@@ -99,6 +104,7 @@ namespace xlang {
 	
 	struct RecordSymtab { 
 		RecordNode *recordinfo[ST_RECORD_SIZE]; //buckets of record info
+		std::unordered_map<NameId, RecordNode *> ids;  //records of the buckets by interned name
 		void print();
 	};
 	
@@ -111,7 +117,7 @@ namespace xlang {
 		
 		static RecordTypeInfo *get_rec_type_info_mem();
 		
-		static std::map<std::string, FunctionInfo *> *get_func_table_mem();
+		static FunctionMap *get_func_table_mem();
 		
 		static SymbolInfo *get_symbol_info_mem();
 		
@@ -125,47 +131,29 @@ namespace xlang {
 		
 		static RecordSymtab *get_record_symtab_mem();
 		
-		static void delete_type_info(TypeInfo **);
-		
-		static void delete_rec_type_info(RecordTypeInfo **);
-		
-		static void delete_symbol_info(SymbolInfo **);
-		
-		static void delete_func_param_info(FuncParamInfo **);
-		
-		static void delete_func_info(FunctionInfo **);
-		
-		static void delete_node(Node **);
-		
-		static void delete_record_node(RecordNode **);
-		
-		static void delete_record_symtab(RecordSymtab **);
-		
-		static void delete_func_symtab(std::map<std::string, FunctionInfo *> **stinf);
-
-		static void insert_symbol(Node **, std::string);
+		static SymbolInfo *insert_symbol(Node **, const Token &);
 		
-		static bool search_symbol(Node *, std::string);
+		static bool search_symbol(Node *, NameId);
 		
-		static SymbolInfo *search_symbol_node(Node *, std::string);
+		static SymbolInfo *search_symbol_node(Node *, NameId);
 		
 		static void insert_symbol_node(Node **, SymbolInfo **);
 		
-		static bool remove_symbol(Node **, std::string);
+		static bool remove_symbol(Node **, NameId);
 		
-		static void insert_record(RecordSymtab **, std::string);
+		static RecordNode *insert_record(RecordSymtab **, const Token &);
 		
-		static bool search_record(RecordSymtab *, std::string);
+		static bool search_record(RecordSymtab *, NameId);
 		
-		static RecordNode *search_record_node(RecordSymtab *, std::string);
+		static RecordNode *search_record_node(RecordSymtab *, NameId);
 		
     private:
-		static unsigned int st_hash_code(std::string);
+		static unsigned int st_hash_code(std::string_view);
 		
-		static unsigned int st_rec_hash_code(std::string);
+		static unsigned int st_rec_hash_code(std::string_view);
 		
-		static void add_sym_node(SymbolInfo **);
+		static SymbolInfo *add_sym_node(SymbolInfo **);
 		
-		static void add_rec_node(RecordNode **);
+		static RecordNode *add_rec_node(RecordNode **);
 	};
 }
@@ -9,7 +9,9 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <cstdint>
+
 namespace xlang {
 	
 	/*
@@ -150,15 +152,32 @@ namespace xlang {
 
     typedef uint8_t TokenId;
 	
+	// byte offset of a token in its file, SourceBuffer::position()
+	// turns it into a line and column when one is needed
 	struct TokenLocation {
-		int line{0};
-		int col{0};
+		static constexpr uint32_t NO_OFFSET = UINT32_MAX;
+		uint32_t offset{NO_OFFSET};
 	};
 	
+	// interned identifier, see Interner
+	typedef uint32_t NameId;
+	constexpr NameId NO_NAME = 0;
+
+	// value of a number or character literal, decoded once by the lexer.
+	// LIT_FLOAT has f, the others i
+	union LiteralValue {
+		int64_t i{0};
+		double f;
+	};
+
 	struct Token {
 		TokenId number;   //Token number
+		uint8_t width{0};         // literals only, bytes of the smallest type that holds value
 		TokenLocation loc;        // location of Token/lexeme
-		std::string string;  //original string
+		NameId name{NO_NAME};     // identifiers only, set by the lexer
+		std::string_view string;  //original string, points into the SourceBuffer.
+		                          //empty for a value made by the optimizer
+		LiteralValue value;       // literals only
 	};
 	
 }
\ No newline at end of file
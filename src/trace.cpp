@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include <chrono>
+#include <iomanip>
+#include "trace.hpp"
+#include "stats.hpp"
+
+namespace xlang {
+
+	static const auto trace_epoch = std::chrono::steady_clock::now();
+
+	double Trace::now_us() {
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - trace_epoch).count();
+	}
+
+	void Trace::write_events(std::ostream &out, int tid, const std::string &file) const {
+		out << std::fixed << std::setprecision(3);
+		out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << tid
+			<< ", \"args\": {\"name\": " << json_string(file) << "}}";
+		for (const auto &e: events) {
+			out << ",\n  {\"name\": " << json_string(e.name)
+				<< ", \"cat\": \"" << e.category << "\""
+				<< ", \"ph\": \"X\", \"ts\": " << e.start_us
+				<< ", \"dur\": " << e.duration_us
+				<< ", \"pid\": 1, \"tid\": " << tid << "}";
+		}
+		out << std::defaultfloat;
+	}
+
+	void TraceScope::begin(std::string name, const char *category) {
+		index = trace.events.size();
+		trace.events.push_back(TraceEvent{std::move(name), category, Trace::now_us(), 0});
+	}
+
+	void TraceScope::end() {
+		TraceEvent &e = trace.events[index];
+		e.duration_us = Trace::now_us() - e.start_us;
+	}
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdint>
+
+namespace xlang {
+
+	struct TraceEvent {
+		std::string name;
+		const char *category;
+		double start_us;
+		double duration_us;
+	};
+
+	// chrome trace-event spans of one compilation (--trace)
+	//
+	// events are kept per Compiler and written out together by the driver,
+	// each input file is its own track, times count from process start so
+	// files compiled in parallel line up. load the file in Perfetto or
+	// chrome://tracing
+
+	class Trace {
+	public:
+		bool enabled{false};
+		std::vector<TraceEvent> events;
+
+		static double now_us();
+
+		// events of one file as a json array body, tid is the track
+		void write_events(std::ostream &, int, const std::string &) const;
+	};
+
+	// a span from here to the end of the scope, without --trace it is
+	// one test of Trace::enabled and nothing else
+
+	class TraceScope {
+	public:
+		TraceScope(Trace &t, const std::string &name, const char *category) : trace(t) {
+			if (trace.enabled)
+				begin(name, category);
+		}
+
+		TraceScope(Trace &t, const char *name, const char *category) : trace(t) {
+			if (trace.enabled)
+				begin(name, category);
+		}
+
+		~TraceScope() {
+			if (trace.enabled)
+				end();
+		}
+
+		TraceScope(const TraceScope &) = delete;
+
+		TraceScope &operator=(const TraceScope &) = delete;
+
+	private:
+		Trace &trace;
+		size_t index{0};
+
+		void begin(std::string, const char *);
+
+		void end();
+	};
+}
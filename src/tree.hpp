@@ -12,41 +12,71 @@
 #include "types.hpp"
 
 namespace xlang {
+
+	// the pools primary and identifier expressions are made in, one per
+	// compilation. Compiler::run() makes its own the one of the thread it
+	// runs on and the threads parsing bodies for it share it, like
+	// Arena::active
+	//
+	// with --stream the nodes of a function go when the next one starts,
+	// mark() before it and truncate() to it
+
+	struct TreePools {
+		NodePool<PrimaryExpression> primary;
+		NodePool<IdentifierExpression> id;
+
+		static inline thread_local TreePools *active = nullptr;
+
+		// a thread without one uses one of its own
+		static TreePools &current() {
+			if (active != nullptr)
+				return *active;
+			static thread_local TreePools own;
+			return own;
+		}
+
+		struct Mark {
+			NodeIndex primary;
+			NodeIndex id;
+		};
+
+		Mark mark() const {
+			return {primary.size(), id.size()};
+		}
+
+		void truncate(const Mark &m) {
+			primary.truncate(m.primary);
+			id.truncate(m.id);
+		}
+	};
 	
 	class Tree {
     public:
 		static SizeOfExpression *get_sizeof_expr_mem();
 		
-		static void delete_sizeof_expr(SizeOfExpression **);
-		
 		static CastExpression *get_cast_expr_mem();
 		
-		static void delete_cast_expr(CastExpression **);
-		
-		static PrimaryExpression *get_primary_expr_mem();
-		
-		static void delete_primary_expr(PrimaryExpression **);
-		
-		static IdentifierExpression *get_id_expr_mem();
+		static NodeIndex get_primary_expr_mem();
 		
-		static void delete_id_expr(IdentifierExpression **);
+		static NodeIndex get_id_expr_mem();
+
+		// the node of an index, nullptr for NO_NODE
+		static PrimaryExpression *primary_expr(NodeIndex i) {
+			return TreePools::current().primary.get(i);
+		}
+
+		static IdentifierExpression *id_expr(NodeIndex i) {
+			return TreePools::current().id.get(i);
+		}
 		
 		static Expression *get_expr_mem();
 		
-		static void delete_expr(Expression **);
-		
 		static AssignmentExpression *get_assgn_expr_mem();
 		
-		static void delete_assgn_expr(AssignmentExpression **);
-		
 		static CallExpression *get_func_call_expr_mem();
 		
-		static void delete_func_call_expr(CallExpression **);
-		
 		static AsmOperand *get_asm_operand_mem();
 		
-		static void delete_asm_operand(AsmOperand **);
-		
 		static LabelStatement *get_label_stmt_mem();
 		
 		static ExpressionStatement *get_expr_stmt_mem();
@@ -63,33 +93,10 @@ namespace xlang {
 		
 		static TreeNode *get_tree_node_mem();
 		
-		static void delete_label_stmt(LabelStatement **);
-		
-		static void delete_expr_stmt(ExpressionStatement **);
-		
-		static void delete_select_stmt(SelectStatement **);
-		
-		static void delete_iter_stmt(IterationStatement **);
-		
-		static void delete_jump_stmt(JumpStatement **);
-		
-		static void delete_asm_stmt(AsmStatement **);
-		
-		static void delete_stmt(Statement **);
-		
-		static void delete_tree(TreeNode **);
-		
-		static void delete_tree_node(TreeNode **);
-		
-		static void get_inorder_primary_expr(PrimaryExpression **);
-		
 		static void add_asm_statement(AsmStatement **, AsmStatement **);
 		
 		static void add_statement(Statement **, Statement **);
 		
 		static void add_tree_node(TreeNode **, TreeNode **);
-		
-    private:
-		static std::stack<PrimaryExpression *> pexpr_stack;
 	};
 }
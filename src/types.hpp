@@ -6,6 +6,7 @@
 #include <map>
 #include <list>
 #include "token.hpp"
+#include "pool.hpp"
 
 namespace xlang {
 	
@@ -24,43 +25,47 @@ namespace xlang {
 	};
 	
 	//operator types
-	enum class OperatorType {
+	enum class OperatorType : uint8_t {
 		UNARY,
         BINARY
 	};
 	
+	// primary and identifier expressions are most of a tree, they are
+	// made in the pools of TreePools and point to each other by index,
+	// Tree::primary_expr() and Tree::id_expr() give the node of one
+
 	//primary expression
 	struct PrimaryExpression {
 		Token tok;    //expression Token(could be literal, operator, identifier)
-		bool is_oprtr;      //is operator
-		OperatorType oprtr_kind; //operator type
-		bool is_id;   //is identifier
 		SymbolInfo *id_info; //if id, then pointer in symbol table
 		//left & right nodes of parse tree
 		//if operator is binary
-		PrimaryExpression *left;
-		PrimaryExpression *right;
+		NodeIndex left;
+		NodeIndex right;
 		//unary node of parse tree
 		//if operator is unary
-		PrimaryExpression *unary_node;
+		NodeIndex unary_node;
+		bool is_oprtr;      //is operator
+		OperatorType oprtr_kind; //operator type
+		bool is_id;   //is identifier
 		
 		void print();
 	};
 	
 	struct IdentifierExpression {
 		Token tok;
+		SymbolInfo *id_info;
+		std::vector<Token> subscript; //array subscripts(could be literals or identifiers)
+
+		//left and right sides of parse tree if not then unary
+		NodeIndex left;
+		NodeIndex right;
+		NodeIndex unary;
+		int ptr_oprtr_count;  //pointer operator count
 		bool is_oprtr;
 		bool is_id;
-		SymbolInfo *id_info;
 		bool is_subscript;    //is array
-		std::list<Token> subscript; //list of array subscripts(could be literals or identifiers)
 		bool is_ptr;         //is pointer operator defined
-		int ptr_oprtr_count;  //pointer operator count
-
-		//left and right sides of parse tree if not then unary
-		IdentifierExpression *left;
-		IdentifierExpression *right;
-		IdentifierExpression *unary;
 		
 		void print();
 	};
@@ -80,7 +85,7 @@ namespace xlang {
 		std::vector<Token> simple_type;
 		Token identifier;
 		int ptr_oprtr_count;    //if pointer operator is defined then its count
-		IdentifierExpression *target; //identifier expression that need to be cast
+		NodeIndex target; //identifier expression that need to be cast
 		void print();
 	};
 	
@@ -88,25 +93,29 @@ namespace xlang {
 	
 	struct AssignmentExpression {
 		Token tok;    //assignment operator Token
-		IdentifierExpression *id_expr;  //left side
+		NodeIndex id_expr;  //left side
 		Expression *expression;  //right side
 		void print();
 	};
 	
 	struct CallExpression {
-		IdentifierExpression *function;     //function name(could be simple or from record member(e.g x.y->func()))
-		std::list<Expression *> expression_list;  //fuction expression list
+		NodeIndex function;     //function name(could be simple or from record member(e.g x.y->func()))
+		std::vector<Expression *> expression_list;  //fuction expression list
 		void print();
 	};
 	
 	struct Expression {
 		ExpressionType expr_kind;   //expression type
-		PrimaryExpression *primary_expr;
-		AssignmentExpression *assgn_expr;
-		SizeOfExpression *sizeof_expr;
-		CastExpression *cast_expr;
-		IdentifierExpression *id_expr;
-		CallExpression *call_expr;
+
+		// only the one of expr_kind is set
+		union {
+			NodeIndex primary_expr;
+			AssignmentExpression *assgn_expr;
+			SizeOfExpression *sizeof_expr;
+			CastExpression *cast_expr;
+			NodeIndex id_expr;
+			CallExpression *call_expr;
+		};
 		
 		void print();
 	};
@@ -237,12 +246,16 @@ namespace xlang {
 	*/
 	struct Statement {
 		StatementType type;
-		LabelStatement *labled_statement;
-		ExpressionStatement *expression_statement;
-		SelectStatement *selection_statement;
-		IterationStatement *iteration_statement;
-		JumpStatement *jump_statement;
-		AsmStatement *asm_statement;
+
+		// only the one of type is set
+		union {
+			LabelStatement *labled_statement;
+			ExpressionStatement *expression_statement;
+			SelectStatement *selection_statement;
+			IterationStatement *iteration_statement;
+			JumpStatement *jump_statement;
+			AsmStatement *asm_statement;
+		};
 		
 		Statement *p_next;
 		Statement *p_prev;
@@ -260,7 +273,5 @@ namespace xlang {
 		void print() {
 		}
 	};
-
-    typedef std::map<std::string, FunctionInfo *> FunctionMap;
 }
 
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include <sstream>
+#include "xlang.hpp"
+#include "compiler.hpp"
+
+namespace xlang {
+
+	CompileResult Xlang::compile(std::string_view source, const GlobalConfig &options) {
+		GlobalConfig cfg = options;
+		cfg.in_memory = true;
+		cfg.compile = true;
+		cfg.link = false;
+		cfg.use_nasm = false;
+		cfg.emit_ast = false;
+		cfg.load_ast = false;
+		cfg.cache_dir.clear();
+		cfg.stats_file.clear();
+		cfg.trace_file.clear();
+		if (cfg.file.name.empty())
+			cfg.file.name = "source.x";
+
+		cfg.file.buffer = SourceBuffer::copy(source);
+
+		Compiler comp(cfg);
+		std::ostringstream out;
+
+		CompileResult result;
+		result.status = comp.run(out);
+		result.diagnostics = out.str();
+		result.assembly = std::move(comp.assembly);
+		result.object = std::move(comp.object);
+		return result;
+	}
+}
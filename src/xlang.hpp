@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2023, Aaron Clark Diaz.
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "global.hpp"
+
+namespace xlang {
+
+	struct CompileResult {
+		int status{0};                  // 0 on success, same values as the driver
+		std::string diagnostics;        // everything the compiler printed
+		std::string assembly;           // nasm source
+		std::vector<uint8_t> object;    // elf object, empty unless options.assemble
+	};
+
+	// libxlang entry point for programs embedding the compiler
+	//
+	// compiles source text without touching the file system: no source
+	// file is read, no asm or object file is written and nothing is linked.
+	// options.file.name is only used in messages and the object's file
+	// symbol. calls share no state, they can run on several threads at once
+
+	class Xlang {
+	public:
+		static CompileResult compile(std::string_view, const GlobalConfig &);
+	};
+}
@@ -0,0 +1,45 @@
+#!/bin/sh
+# assembles each example with the built-in encoder and with nasm and
+# compares the bytes of .text and .data
+#
+# usage: encoder_vs_nasm.sh XLANG FILE...
+# exits with 77 (skipped) when nasm or objcopy isn't installed
+
+xlang=$1
+shift
+
+command -v nasm >/dev/null 2>&1 || { echo "nasm not found, skipped"; exit 77; }
+command -v objcopy >/dev/null 2>&1 || { echo "objcopy not found, skipped"; exit 77; }
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+status=0
+
+for file in "$@"; do
+	name=$(basename "$file" .x)
+	for how in encoder nasm; do
+		mkdir -p "$work/$how"
+		cp "$file" "$work/$how/"
+		flag=
+		[ "$how" = nasm ] && flag=--use-nasm
+		# linking may fail, the object file is kept either way
+		(cd "$work/$how" && "$xlang" ok $flag "$name.x" >/dev/null 2>&1)
+	done
+
+	if [ ! -f "$work/encoder/$name.o" ] || [ ! -f "$work/nasm/$name.o" ]; then
+		echo "$name: no object file"
+		status=1
+		continue
+	fi
+
+	for section in .text .data; do
+		objcopy -O binary -j $section "$work/encoder/$name.o" "$work/encoder/$name$section"
+		objcopy -O binary -j $section "$work/nasm/$name.o" "$work/nasm/$name$section"
+		if ! cmp -s "$work/encoder/$name$section" "$work/nasm/$name$section"; then
+			echo "$name: $section differs"
+			status=1
+		fi
+	done
+done
+
+exit $status
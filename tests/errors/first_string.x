@@ -0,0 +1,4 @@
+"a string that is never closed
+global int main() {
+	return 0;
+}
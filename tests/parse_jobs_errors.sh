@@ -0,0 +1,35 @@
+#!/bin/sh
+# compiles each file with one parse thread and with two, both have to
+# fail with the same messages
+#
+# usage: parse_jobs_errors.sh XLANG FILE...
+
+xlang=$1
+shift
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+status=0
+
+for file in "$@"; do
+	name=$(basename "$file")
+	for jobs in 1 2; do
+		mkdir -p "$work/$jobs"
+		cp "$file" "$work/$jobs/"
+		if (cd "$work/$jobs" && "$xlang" --parse-jobs $jobs "$name" >out 2>&1); then
+			echo "$name: compiled with --parse-jobs $jobs"
+			status=1
+		fi
+	done
+
+	if [ ! -s "$work/1/out" ]; then
+		echo "$name: no message"
+		status=1
+	elif ! cmp -s "$work/1/out" "$work/2/out"; then
+		echo "$name: messages differ with --parse-jobs 2"
+		diff "$work/1/out" "$work/2/out"
+		status=1
+	fi
+done
+
+exit $status